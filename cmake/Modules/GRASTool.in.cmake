@@ -58,6 +58,17 @@ if (NOT GRAS_LIBRARIES)
     )
 endif()
 
+#locate the module index generator
+if (TARGET gras_module_index)
+    get_target_property(GRAS_TOOL_MODULE_INDEX gras_module_index LOCATION)
+elseif (NOT GRAS_TOOL_MODULE_INDEX)
+    find_program(
+        GRAS_TOOL_MODULE_INDEX
+        NAMES gras_module_index
+        PATHS ${GRAS_ROOT}/bin
+    )
+endif()
+
 ########################################################################
 ## GRAS_TOOL cmake function - the swiss army knife for GRAS users
 ##
@@ -142,6 +153,13 @@ function(GRAS_TOOL)
             RUNTIME DESTINATION ${GRAS_TOOL_MOD_DIR} COMPONENT ${GRAS_TOOL_COMPONENT} # .dll file
         )
 
+        #regenerate the factory index so the loader can load this module lazily
+        if (GRAS_TOOL_MODULE_INDEX)
+            install(CODE "execute_process(COMMAND \"${GRAS_TOOL_MODULE_INDEX}\" \"\$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/${GRAS_TOOL_MOD_DIR}\")"
+                COMPONENT ${GRAS_TOOL_COMPONENT}
+            )
+        endif()
+
         #export global variables for help locating build targets
         get_target_property(module_location ${GRAS_TOOL_TARGET} LOCATION)
         string(REGEX REPLACE "\\$\\(.*\\)" ${CMAKE_BUILD_TYPE} module_location ${module_location})
@@ -142,6 +142,8 @@ struct GRAS_API Block : Element
      * Send a message to the given input port on this block.
      * This is a thread-safe way for external scheduler
      * entities to post messages into the input of a block.
+     * On a block without inputs, the message only wakes the block
+     * after a call to mark_input_fail() and is not stored.
      * \param which_input an input port on this block
      * \param msg the message to post to the input port
      */
@@ -188,6 +190,10 @@ struct GRAS_API Block : Element
      * - If the input buffer at the maximum size, this call will throw.
      * In this case, the user should set larger maximum_items on this port.
      *
+     * - If the block has no inputs, the scheduler stops calling work()
+     * until a message is posted to the block with post_input_msg().
+     * Sources that wait on an external event use this to sleep.
+     *
      * \param which_input the input port index
      */
     void mark_input_fail(const size_t which_input);
@@ -62,6 +62,19 @@ struct GRAS_API GlobalBlockConfig
      * Default = null thread pool.
      */
     ThreadPool thread_pool;
+
+    /*!
+     * Limit the rate at which the block processes items.
+     * Items are counted on output port 0 (input port 0 for sinks).
+     * Work is offered at most the items due plus a short burst.
+     * When the block gets ahead of schedule, the scheduler
+     * holds off calling work and sets a timer to kick the block
+     * when it is due again; no thread sleeps inside of work.
+     * Rate changes take effect on the next work call.
+     *
+     * Default = 0.0 aka disabled.
+     */
+    double maximum_items_per_sec;
 };
 
 //! Configuration parameters for an input port
@@ -0,0 +1,89 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_GRAS_THREAD_BUDGET_HPP
+#define INCLUDED_GRAS_THREAD_BUDGET_HPP
+
+#include <gras/gras.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace gras
+{
+
+/*!
+ * The thread budget coordinates blocks that parallelize inside of work,
+ * such as large FFTs, so that together they do not oversubscribe the CPUs.
+ *
+ * The budget is a process-wide count of helper threads.
+ * A block asks for parallelism with a ThreadGrant,
+ * and gets as many helpers as are still free, possibly none.
+ * The helpers are one shared pool of threads that run parallel_for jobs;
+ * the calling thread always takes part, so a grant of size N
+ * runs at most N jobs at once: the caller and N-1 helpers.
+ */
+struct GRAS_API ThreadBudget
+{
+    /*!
+     * Set the number of helper threads shared by all grants.
+     * Default is the number of CPUs on the system minus one.
+     * Grants already given out keep their size.
+     */
+    static void set_capacity(const size_t threads);
+
+    //! Get the number of helper threads shared by all grants
+    static size_t capacity(void);
+
+    //! Get the number of helper threads not held by any grant
+    static size_t available(void);
+
+    /*!
+     * Get the parallelism granted to an owner, summed over its grants.
+     * This counts the calling thread of each grant, 0 means no grants.
+     */
+    static size_t granted(const std::string &owner);
+
+    /*!
+     * Call fn(i) for every i in [0, n) and return when all calls are done.
+     * The calls run on the calling thread and on idle helper threads.
+     * The caller is expected to hold a grant for the parallelism it uses,
+     * this call itself does not check the budget.
+     * fn must not throw.
+     */
+    static void parallel_for(const size_t n, const boost::function<void(const size_t)> &fn);
+};
+
+/*!
+ * A ThreadGrant holds helper threads from the ThreadBudget.
+ * The threads return to the budget when the last copy is destroyed.
+ */
+struct GRAS_API ThreadGrant
+{
+    //! Create an empty grant: the calling thread only
+    ThreadGrant(void);
+
+    /*!
+     * Request parallelism from the budget.
+     * \param owner the name reported in the stats, usually the block uid
+     * \param parallelism the threads wanted, the calling thread included
+     */
+    ThreadGrant(const std::string &owner, const size_t parallelism);
+
+    //! The parallelism granted, at least 1
+    size_t size(void) const;
+
+    //! The owner name given at construction
+    const std::string &owner(void) const;
+
+    /*!
+     * Call fn(i) for every i in [0, n) with at most size() calls at once.
+     * Returns when all calls are done. fn must not throw.
+     */
+    void parallel_for(const size_t n, const boost::function<void(const size_t)> &fn) const;
+
+    boost::shared_ptr<void> _impl;
+};
+
+} //namespace gras
+
+#endif /*INCLUDED_GRAS_THREAD_BUDGET_HPP*/
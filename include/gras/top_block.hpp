@@ -27,8 +27,14 @@ struct GRAS_API TopBlock : HierBlock
      * Commit changes to the overall flow graph.
      * Call this after modifying connections.
      * Commit is called automatically by start/stop/run.
+     *
+     * On a running flow graph, commit only sets up what changed:
+     * new blocks are started, and existing blocks re-token and
+     * re-allocate just the ports on the ends of added or removed flows.
+     * Other buffers stay in flight. A changed global config
+     * makes the commit a full start.
      */
-    void commit(void);
+    virtual void commit(void);
 
     /*!
      * Run is for finite flow graph executions.
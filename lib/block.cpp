@@ -26,6 +26,8 @@ Block::Block(const std::string &name):
 
     //setup some state variables
     (*this)->block_data->block_state = BLOCK_STATE_INIT;
+    (*this)->block_data->rate_kick_time = 0;
+    (*this)->block_data->rate_allowance = 0;
 }
 
 Block::~Block(void)
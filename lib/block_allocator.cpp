@@ -53,14 +53,16 @@ static size_t recommend_length(
 
 #define my_round_up_mult(num, mult) (((num)*(mult))+(mult)-1)/(mult)
 
-void BlockActor::handle_top_alloc(const TopAllocMessage &, const Theron::Address from)
+void BlockActor::handle_top_alloc(const TopAllocMessage &message, const Theron::Address from)
 {
     MESSAGE_TRACER();
 
     //allocate output buffers which will also wake up the task
+    //ports untouched by a commit keep their pool and in-flight buffers
     const size_t num_outputs = worker->get_num_outputs();
     for (size_t i = 0; i < num_outputs; i++)
     {
+        if (not message.ports.output(i)) continue;
         size_t reserve_items = data->output_configs[i].reserve_items;
         size_t maximum_items = data->output_configs[i].maximum_items;
         if (maximum_items == 0) maximum_items = data->block->global_config().maximum_output_items;
@@ -84,10 +86,10 @@ void BlockActor::handle_top_alloc(const TopAllocMessage &, const Theron::Address
         BufferQueueSptr queue = data->block->output_buffer_allocator(i, config);
         data->output_queues.set_buffer_queue(i, queue);
 
-        InputAllocMessage message;
-        message.config = config;
-        message.token = token;
-        worker->post_downstream(i, message);
+        InputAllocMessage alloc_msg;
+        alloc_msg.config = config;
+        alloc_msg.token = token;
+        worker->post_downstream(i, alloc_msg);
     }
 
     this->Send(0, from); //ACK
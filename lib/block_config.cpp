@@ -9,6 +9,7 @@ GlobalBlockConfig::GlobalBlockConfig(void)
     maximum_output_items = 0;
     buffer_affinity = -1;
     interruptible_work = false;
+    maximum_items_per_sec = 0.0;
 }
 
 void GlobalBlockConfig::merge(const GlobalBlockConfig &config)
@@ -36,6 +37,12 @@ void GlobalBlockConfig::merge(const GlobalBlockConfig &config)
     {
         this->thread_pool = config.thread_pool;
     }
+
+    //overwrite with config's rate limit if not set (zero)
+    if (this->maximum_items_per_sec == 0.0)
+    {
+        this->maximum_items_per_sec = config.maximum_items_per_sec;
+    }
 }
 
 InputPortConfig::InputPortConfig(void)
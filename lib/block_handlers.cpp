@@ -17,8 +17,14 @@ void BlockActor::handle_top_active(
     {
         data->block->notify_active();
         data->stats.start_time = time_now();
+
+        //the rate limit schedule starts with the run
+        data->stats.rate_start_time = data->stats.start_time;
+        data->stats.rate_items = 0;
     }
     data->block_state = BLOCK_STATE_LIVE;
+    if (worker->get_num_inputs() == 0) data->inputs_available.set(0); //wake up a sleeping source
+    this->publish_stats();
 
     this->Send(0, from); //ACK
 
@@ -44,9 +50,13 @@ void BlockActor::handle_top_token(
 ){
     MESSAGE_TRACER();
 
+    data->token_signal = message.token_signal;
+
     //create input tokens and send allocation hints
+    //(on a commit, only for the ports whose connections changed)
     for (size_t i = 0; i < worker->get_num_inputs(); i++)
     {
+        if (not message.ports.input(i)) continue;
         data->input_tokens[i] = Token::make();
         data->inputs_done.reset(i);
         OutputTokenMessage token_msg;
@@ -65,6 +75,7 @@ void BlockActor::handle_top_token(
     //create output token
     for (size_t i = 0; i < worker->get_num_outputs(); i++)
     {
+        if (not message.ports.output(i)) continue;
         data->output_tokens[i] = Token::make();
         data->outputs_done.reset(i);
         InputTokenMessage token_msg;
@@ -128,12 +139,27 @@ void BlockActor::handle_self_kick(
     this->task_main();
 }
 
-void BlockActor::handle_get_stats(
-    const GetStatsMessage &,
-    const Theron::Address from
+void BlockActor::handle_input_grace(
+    const InputGraceMessage &,
+    const Theron::Address
 ){
     MESSAGE_TRACER();
 
+    //the inputs may have been reconnected since the timer was set,
+    //a newer done input schedules its own timer
+    if (data->block_state == BLOCK_STATE_DONE) return;
+    if (not data->inputs_done.any()) return;
+    if (time_now() < data->input_grace_deadline) return;
+
+    //only give up on the block when the top block is waiting for it,
+    //otherwise TopBlock::wait() checks the grace period when it begins
+    if (not data->token_signal or not data->token_signal->is_waiting()) return;
+
+    this->mark_done();
+}
+
+void BlockActor::publish_stats(void)
+{
     //instantaneous states we update here,
     //and not interleaved with the rest of the code
     const size_t num_inputs = worker->get_num_inputs();
@@ -151,15 +177,6 @@ void BlockActor::handle_get_stats(
     data->stats.inputs_idle = data->input_queues.total_idle_times;
     data->stats.outputs_idle = data->output_queues.total_idle_times;
 
-    //create the message reply object
-    GetStatsMessage message;
-    message.block_id = data->block->get_uid();
-    message.stats = data->stats;
-    message.stats_time = time_now();
-
-    this->Send(message, from); //ACK
-
-    //work could have been skipped by a high prio msg
-    //forcefully kick the task to recheck in a new call
-    this->Send(SelfKickMessage(), this->GetAddress());
+    //the query thread reads this without a message round-trip
+    data->stats_snapshot.publish(data->stats, time_now());
 }
@@ -13,10 +13,27 @@
 #include <gras_impl/interruptible_thread.hpp>
 #include <boost/foreach.hpp>
 #include <map>
+#include <set>
 
 namespace gras
 {
 
+//! One flattened flow: a worker port on each end
+struct FlatFlow
+{
+    const Apology::Worker *src;
+    size_t src_index;
+    const Apology::Worker *dst;
+    size_t dst_index;
+    bool operator<(const FlatFlow &rhs) const
+    {
+        if (src != rhs.src) return src < rhs.src;
+        if (src_index != rhs.src_index) return src_index < rhs.src_index;
+        if (dst != rhs.dst) return dst < rhs.dst;
+        return dst_index < rhs.dst_index;
+    }
+};
+
 struct ElementImpl
 {
     //setup stuff
@@ -38,8 +55,15 @@ struct ElementImpl
     //top block stuff
     SharedThreadGroup thread_group;
     Token token;
+    SharedTokenSignal token_signal;
     GlobalBlockConfig global_config;
 
+    //what the last start or commit set up, so commit can diff against it
+    std::set<FlatFlow> committed_flows;
+    std::set<const Apology::Worker *> committed_workers;
+    GlobalBlockConfig committed_config;
+    void record_commit(void);
+
     //element tree stuff
     Element parent;
     std::map<std::string, Element> children;
@@ -77,6 +101,26 @@ struct ElementImpl
         }
     }
 
+    //like bcast_prio_msg, but each worker in the map gets its own message
+    template <typename MessageType>
+    void send_prio_msgs(const std::map<Apology::Worker *, MessageType> &msgs)
+    {
+        typedef typename std::map<Apology::Worker *, MessageType>::const_iterator iter_type;
+        Theron::Receiver receiver;
+        for (iter_type it = msgs.begin(); it != msgs.end(); ++it)
+        {
+            BlockActor *actor = dynamic_cast<BlockActor *>(it->first->get_actor());
+            MessageType message = it->second;
+            message.prio_token = actor->prio_token;
+            actor->GetFramework().Send(message, receiver.GetAddress(), actor->GetAddress());
+        }
+        size_t outstandingCount(msgs.size());
+        while (outstandingCount != 0)
+        {
+            outstandingCount -= receiver.Wait(outstandingCount);
+        }
+    }
+
 };
 
 } //namespace gras
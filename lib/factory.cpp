@@ -1,6 +1,7 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras/factory.hpp>
+#include <gras_impl/module_loader.hpp>
 #include <boost/format.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
@@ -44,10 +45,21 @@ void gras::_register_factory(const std::string &path, void *entry)
         std::cerr << "Warning: Factory - function already registered for path: " + path << std::endl;
     }
     get_factory_registry()[path].reset(reinterpret_cast<FactoryRegistryEntry *>(entry));
+    note_factory_registration(path);
+}
+
+static bool has_factory(const std::string &path)
+{
+    boost::mutex::scoped_lock l(mutex);
+    return get_factory_registry().count(path) != 0;
 }
 
 Element *gras::_handle_make(const std::string &path, const PMCC &args)
 {
+    //not registered yet? the library may be indexed but not loaded,
+    //loading it registers its factories, so the lock cannot be held
+    if (not has_factory(path)) load_module_for_factory_path(path);
+
     boost::mutex::scoped_lock l(mutex);
     if (get_factory_registry().count(path) == 0)
     {
@@ -54,7 +54,7 @@ struct BlockActor : Theron::Actor
 
         this->RegisterHandler(this, &BlockActor::handle_callable);
         this->RegisterHandler(this, &BlockActor::handle_self_kick);
-        this->RegisterHandler(this, &BlockActor::handle_get_stats);
+        this->RegisterHandler(this, &BlockActor::handle_input_grace);
     }
 
     //handlers
@@ -84,7 +84,7 @@ struct BlockActor : Theron::Actor
 
     void handle_callable(const CallableMessage &, const Theron::Address);
     void handle_self_kick(const SelfKickMessage &, const Theron::Address);
-    void handle_get_stats(const GetStatsMessage &, const Theron::Address);
+    void handle_input_grace(const InputGraceMessage &, const Theron::Address);
 
     //helpers
     void mark_done(void);
@@ -96,6 +96,8 @@ struct BlockActor : Theron::Actor
     void task_kicker(void);
     void update_input_avail(const size_t index);
     bool is_work_allowed(void);
+    bool is_rate_limited(void);
+    void publish_stats(void);
 
     //work helpers
     inline void task_work(void)
@@ -18,6 +18,10 @@
 namespace gras
 {
 
+//how long a block with a done input may keep working
+//once TopBlock::wait() is waiting for it to finish
+static const boost::posix_time::time_duration INPUT_DONE_GRACE_PERIOD = boost::posix_time::milliseconds(100);
+
 enum BlockState
 {
     BLOCK_STATE_INIT,
@@ -27,6 +31,14 @@ enum BlockState
 
 struct BlockData
 {
+    ~BlockData(void)
+    {
+        //a block removed by commit() may still hold the top token,
+        //release it and wake up TopBlock::wait() to recheck
+        token_pool.clear();
+        if (token_signal) token_signal->notify();
+    }
+
     //block pointer to call into parent
     Block *block;
 
@@ -44,7 +56,8 @@ struct BlockData
     BitSet inputs_done;
     BitSet outputs_done;
     std::set<Token> token_pool;
-    boost::system_time first_input_done_time;
+    SharedTokenSignal token_signal;
+    time_ticks_t input_grace_deadline; //time_now() ticks, like the timer service
 
     //buffer queues and ready conditions
     InputBufferQueues input_queues;
@@ -72,7 +85,12 @@ struct BlockData
 
     std::vector<std::vector<OutputHintMessage> > output_allocation_hints;
 
+    //rate limit state, see BlockActor::is_rate_limited
+    time_ticks_t rate_kick_time; //when the pending timer kick is due
+    size_t rate_allowance; //max items for this work call, 0 = no limit
+
     BlockStats stats;
+    BlockStatsSnapshot stats_snapshot;
 };
 
 } //namespace gras
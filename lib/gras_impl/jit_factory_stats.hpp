@@ -0,0 +1,33 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_JIT_FACTORY_STATS_HPP
+#define INCLUDED_LIBGRAS_IMPL_JIT_FACTORY_STATS_HPP
+
+#include <gras/chrono.hpp>
+
+namespace gras
+{
+
+//! Process-wide counters for the JIT factory, reported by /jit.json
+struct JITFactoryStats
+{
+    JITFactoryStats(void)
+    {
+        compile_count = 0;
+        cache_hit_count = 0;
+        memory_hit_count = 0;
+        total_compile_time = 0;
+    }
+
+    item_index_t compile_count; //!< sources compiled by clang
+    item_index_t cache_hit_count; //!< sources loaded from on-disk bitcode
+    item_index_t memory_hit_count; //!< sources already loaded in this process
+    time_ticks_t total_compile_time; //!< wall time spent in clang
+};
+
+//! Get a copy of the current JIT factory counters
+JITFactoryStats get_jit_factory_stats(void);
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_JIT_FACTORY_STATS_HPP*/
@@ -8,9 +8,9 @@
 #include <gras/tags.hpp>
 #include <gras/sbuffer.hpp>
 #include <gras_impl/token.hpp>
-#include <gras_impl/stats.hpp>
 #include <gras/block_config.hpp>
 #include <gras_impl/interruptible_thread.hpp>
+#include <set>
 
 namespace gras
 {
@@ -20,8 +20,20 @@ namespace gras
 //-- these messages must be ack'd
 //----------------------------------------------------------------------
 
+//! The ports of a block that a commit touched
+struct TopPortSelection
+{
+    TopPortSelection(void): all(true){}
+    bool all; //every port, as on a full start
+    std::set<size_t> inputs;
+    std::set<size_t> outputs;
+    bool input(const size_t i) const {return all or inputs.count(i) != 0;}
+    bool output(const size_t i) const {return all or outputs.count(i) != 0;}
+};
+
 struct TopAllocMessage
 {
+    TopPortSelection ports;
     Token prio_token;
 };
 
@@ -38,6 +50,8 @@ struct TopInertMessage
 struct TopTokenMessage
 {
     Token token;
+    SharedTokenSignal token_signal;
+    TopPortSelection ports;
     Token prio_token;
 };
 
@@ -160,12 +174,9 @@ struct SelfKickMessage
     //empty
 };
 
-struct GetStatsMessage
+struct InputGraceMessage
 {
-    Token prio_token;
-    std::string block_id;
-    BlockStats stats;
-    time_ticks_t stats_time;
+    //empty
 };
 
 } //namespace gras
@@ -196,6 +207,6 @@ THERON_DECLARE_REGISTERED_MESSAGE(gras::OutputUpdateMessage);
 
 THERON_DECLARE_REGISTERED_MESSAGE(gras::CallableMessage);
 THERON_DECLARE_REGISTERED_MESSAGE(gras::SelfKickMessage);
-THERON_DECLARE_REGISTERED_MESSAGE(gras::GetStatsMessage);
+THERON_DECLARE_REGISTERED_MESSAGE(gras::InputGraceMessage);
 
 #endif /*INCLUDED_LIBGRAS_IMPL_MESSAGES_HPP*/
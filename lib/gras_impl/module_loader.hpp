@@ -0,0 +1,46 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_MODULE_LOADER_HPP
+#define INCLUDED_LIBGRAS_IMPL_MODULE_LOADER_HPP
+
+#include <gras/gras.hpp>
+#include <gras/chrono.hpp>
+#include <string>
+
+namespace gras
+{
+
+//! Module loader counters, reported by /modules.json
+struct ModuleLoaderStats
+{
+    ModuleLoaderStats(void)
+    {
+        eager_load_count = 0;
+        lazy_load_count = 0;
+        indexed_path_count = 0;
+        startup_time = 0;
+        lazy_load_time = 0;
+    }
+
+    size_t eager_load_count; //!< libraries loaded at startup
+    size_t lazy_load_count; //!< libraries loaded on first factory lookup
+    size_t indexed_path_count; //!< factory paths known from index files
+    time_ticks_t startup_time; //!< time spent in the static loader
+    time_ticks_t lazy_load_time; //!< total time spent in lazy loads
+};
+
+//! Get a copy of the current module loader counters
+ModuleLoaderStats get_module_loader_stats(void);
+
+//! Load the indexed library that provides this factory path, false if none
+bool load_module_for_factory_path(const std::string &path);
+
+//! Called by the factory on registration to attribute paths to libraries
+void note_factory_registration(const std::string &path);
+
+//! Load all libraries in a directory and write its index file
+GRAS_API void write_module_index(const std::string &dir);
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_MODULE_LOADER_HPP*/
@@ -4,8 +4,17 @@
 #define INCLUDED_LIBGRAS_IMPL_STATS_HPP
 
 #include <gras/chrono.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
 #include <vector>
 
+#ifdef BOOST_MSVC
+#include <intrin.h>
+#define GRAS_STATS_BARRIER() _ReadWriteBarrier(), _mm_mfence()
+#else
+#define GRAS_STATS_BARRIER() __sync_synchronize()
+#endif
+
 namespace gras
 {
 
@@ -23,6 +32,10 @@ struct BlockStats
         total_time_post = 0;
         total_time_input = 0;
         total_time_output = 0;
+        rate_target = 0.0;
+        rate_start_time = 0;
+        rate_items = 0;
+        rate_wait_count = 0;
     }
 
     time_ticks_t init_time;
@@ -55,6 +68,151 @@ struct BlockStats
     time_ticks_t total_time_post;
     time_ticks_t total_time_input;
     time_ticks_t total_time_output;
+
+    //rate limiting, see GlobalBlockConfig::maximum_items_per_sec
+    double rate_target;
+    time_ticks_t rate_start_time;
+    item_index_t rate_items;
+    item_index_t rate_wait_count;
+};
+
+/*!
+ * A published copy of the block stats that the query thread can read
+ * without messaging the actor. The actor is the only writer.
+ *
+ * Two slots are used: the actor writes into the slot that is not
+ * published, bumping that slot's sequence number to odd while writing,
+ * and then flips the published index. A reader copies the published
+ * slot and retries if the sequence changed underneath it.
+ * The publish path never blocks, except when the port count changes
+ * and the vectors in the slot must be resized (topology changes only).
+ */
+struct BlockStatsSnapshot
+{
+    BlockStatsSnapshot(void)
+    {
+        published = 0;
+        slots[0].seq = 0;
+        slots[1].seq = 0;
+        slots[0].stats_time = 0;
+        slots[1].stats_time = 0;
+    }
+
+    //! Publish a new snapshot, called from the actor context only
+    void publish(const BlockStats &stats, const time_ticks_t stats_time)
+    {
+        const size_t index = published ^ 1;
+        Slot &slot = slots[index];
+
+        //resize under the shape lock so a reader never copies from freed memory
+        if GRAS_UNLIKELY(not slot.same_shape(stats))
+        {
+            boost::mutex::scoped_lock lock(shape_mutex);
+            slot.seq++;
+            GRAS_STATS_BARRIER();
+            slot.stats = stats;
+            slot.stats_time = stats_time;
+            GRAS_STATS_BARRIER();
+            slot.seq++;
+        }
+        else
+        {
+            slot.seq++;
+            GRAS_STATS_BARRIER();
+            slot.copy_values(stats);
+            slot.stats_time = stats_time;
+            GRAS_STATS_BARRIER();
+            slot.seq++;
+        }
+
+        GRAS_STATS_BARRIER();
+        published = index;
+    }
+
+    //! Copy out the most recent consistent snapshot from any thread
+    void read(BlockStats &stats, time_ticks_t &stats_time) const
+    {
+        boost::mutex::scoped_lock lock(shape_mutex);
+        while (true)
+        {
+            const Slot &slot = slots[published];
+            GRAS_STATS_BARRIER();
+            const size_t seq0 = slot.seq;
+            if GRAS_UNLIKELY(seq0 & 1) continue; //writer lapped us
+            GRAS_STATS_BARRIER();
+            stats = slot.stats;
+            stats_time = slot.stats_time;
+            GRAS_STATS_BARRIER();
+            if GRAS_LIKELY(slot.seq == seq0) return;
+        }
+    }
+
+    struct Slot
+    {
+        volatile size_t seq;
+        char seq_pad[GRAS_MAX_ALIGNMENT-sizeof(size_t)];
+        BlockStats stats;
+        time_ticks_t stats_time;
+        char stats_pad[GRAS_MAX_ALIGNMENT];
+
+        bool same_shape(const BlockStats &s) const
+        {
+            #define gras_stats_shape_check(l) if (stats.l.size() != s.l.size()) return false;
+            gras_stats_shape_check(items_consumed);
+            gras_stats_shape_check(tags_consumed);
+            gras_stats_shape_check(msgs_consumed);
+            gras_stats_shape_check(items_produced);
+            gras_stats_shape_check(tags_produced);
+            gras_stats_shape_check(msgs_produced);
+            gras_stats_shape_check(bytes_copied);
+            gras_stats_shape_check(inputs_idle);
+            gras_stats_shape_check(outputs_idle);
+            gras_stats_shape_check(items_enqueued);
+            gras_stats_shape_check(msgs_enqueued);
+            gras_stats_shape_check(tags_enqueued);
+            #undef gras_stats_shape_check
+            return true;
+        }
+
+        //element-wise copy: sizes match, so no vector storage is reallocated
+        void copy_values(const BlockStats &s)
+        {
+            #define gras_stats_copy_vec(l) std::copy(s.l.begin(), s.l.end(), stats.l.begin());
+            gras_stats_copy_vec(items_consumed);
+            gras_stats_copy_vec(tags_consumed);
+            gras_stats_copy_vec(msgs_consumed);
+            gras_stats_copy_vec(items_produced);
+            gras_stats_copy_vec(tags_produced);
+            gras_stats_copy_vec(msgs_produced);
+            gras_stats_copy_vec(bytes_copied);
+            gras_stats_copy_vec(inputs_idle);
+            gras_stats_copy_vec(outputs_idle);
+            gras_stats_copy_vec(items_enqueued);
+            gras_stats_copy_vec(msgs_enqueued);
+            gras_stats_copy_vec(tags_enqueued);
+            #undef gras_stats_copy_vec
+            stats.init_time = s.init_time;
+            stats.start_time = s.start_time;
+            stats.stop_time = s.stop_time;
+            stats.actor_queue_depth = s.actor_queue_depth;
+            stats.work_count = s.work_count;
+            stats.time_last_work = s.time_last_work;
+            stats.total_time_prep = s.total_time_prep;
+            stats.total_time_work = s.total_time_work;
+            stats.total_time_post = s.total_time_post;
+            stats.total_time_input = s.total_time_input;
+            stats.total_time_output = s.total_time_output;
+            stats.rate_target = s.rate_target;
+            stats.rate_start_time = s.rate_start_time;
+            stats.rate_items = s.rate_items;
+            stats.rate_wait_count = s.rate_wait_count;
+        }
+    };
+
+    volatile size_t published;
+    char published_pad[GRAS_MAX_ALIGNMENT-sizeof(size_t)];
+    Slot slots[2];
+    mutable boost::mutex shape_mutex;
 };
 
 } //namespace gras
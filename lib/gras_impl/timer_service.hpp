@@ -0,0 +1,41 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#ifndef INCLUDED_LIBGRAS_IMPL_TIMER_SERVICE_HPP
+#define INCLUDED_LIBGRAS_IMPL_TIMER_SERVICE_HPP
+
+#include <gras/chrono.hpp>
+#include <gras/thread_pool.hpp>
+#include <Theron/Address.h>
+
+namespace gras
+{
+
+/*!
+ * Send a SelfKickMessage to the actor at the given address
+ * once time_now() reaches the given time in ticks.
+ *
+ * All pending kicks in the process share one timer thread,
+ * so a block that must wait costs no thread pool thread.
+ * The thread pool is held until the kick is sent;
+ * a kick to an actor that has since gone away is dropped.
+ */
+void schedule_self_kick(
+    const ThreadPool &thread_pool,
+    const Theron::Address &address,
+    const time_ticks_t when
+);
+
+/*!
+ * Send an InputGraceMessage to the actor at the given address
+ * once time_now() reaches the given time in ticks.
+ * Same semantics as schedule_self_kick().
+ */
+void schedule_input_grace(
+    const ThreadPool &thread_pool,
+    const Theron::Address &address,
+    const time_ticks_t when
+);
+
+} //namespace gras
+
+#endif /*INCLUDED_LIBGRAS_IMPL_TIMER_SERVICE_HPP*/
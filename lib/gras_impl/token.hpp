@@ -5,6 +5,8 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 namespace gras
 {
@@ -21,6 +23,35 @@ struct Token : boost::shared_ptr<int>
     }
 };
 
+/*!
+ * Shared by a top block and its blocks.
+ * Blocks notify after releasing their tokens,
+ * so TopBlock::wait() can sleep until the top token is unique.
+ */
+struct TokenSignal
+{
+    TokenSignal(void): waiting(false){}
+
+    void notify(void)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        cond.notify_all();
+    }
+
+    //true while wait() wants blocks with done inputs to finish up
+    bool is_waiting(void)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        return waiting;
+    }
+
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    bool waiting; //protected by mutex
+};
+
+typedef boost::shared_ptr<TokenSignal> SharedTokenSignal;
+
 } //namespace gras
 
 #endif /*INCLUDED_LIBGRAS_IMPL_TOKEN_HPP*/
@@ -0,0 +1,35 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+// Generate the factory index for directories of GRAS modules.
+// The index lets the module loader defer loading a library
+// until the first gras::make() call for a path that it provides.
+// Usage: gras_module_index <module directory>...
+
+#include <gras_impl/module_loader.hpp>
+#include <stdexcept>
+#include <iostream>
+#include <cstdlib>
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <module directory>..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            gras::write_module_index(argv[i]);
+            std::cout << "GRAS Module index: wrote index for " << argv[i] << std::endl;
+        }
+    }
+    catch(const std::exception &ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,6 +1,7 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras_impl/block_actor.hpp>
+#include <gras_impl/timer_service.hpp>
 #include <boost/foreach.hpp>
 
 using namespace gras;
@@ -25,8 +26,16 @@ void BlockActor::handle_input_msg(const InputMsgMessage &message, const Theron::
 
     //handle incoming async message, push into the msg storage
     if GRAS_UNLIKELY(data->block_state == BLOCK_STATE_DONE) return;
-    data->input_msgs[index].push_back(message.msg);
-    this->update_input_avail(index);
+    if GRAS_UNLIKELY(worker->get_num_inputs() == 0)
+    {
+        //a block without inputs is only being woken up
+        if (data->inputs_available.size()) data->inputs_available.set(0);
+    }
+    else
+    {
+        data->input_msgs[index].push_back(message.msg);
+        this->update_input_avail(index);
+    }
 
     ta.done();
     this->task_main();
@@ -63,15 +72,19 @@ void BlockActor::handle_input_check(const InputCheckMessage &message, const Ther
     MESSAGE_TRACER();
     const size_t index = message.index;
 
-    //record time of the first input declared done
-    if (not data->inputs_done.any())
-    {
-        data->first_input_done_time = boost::get_system_time();
-    }
-
     //an upstream block declared itself done, recheck the token
+    const bool had_done_input = data->inputs_done.any();
     data->inputs_done.set(index, data->input_tokens[index].unique());
 
+    //record when the grace period of the first input declared done runs out,
+    //and come back at that time
+    if (not had_done_input and data->inputs_done.any())
+    {
+        const double grace_secs = INPUT_DONE_GRACE_PERIOD.total_microseconds()/1e6;
+        data->input_grace_deadline = time_now() + time_ticks_t(grace_secs*time_tps());
+        schedule_input_grace(this->thread_pool, this->GetAddress(), data->input_grace_deadline);
+    }
+
     //upstream done, give it one more attempt at task handling
     ta.done();
     this->task_main();
@@ -1,18 +1,40 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras/factory.hpp>
+#include <gras/chrono.hpp>
+#include <gras_impl/jit_factory_stats.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 #include <stdexcept>
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <algorithm>
+#include <set>
 #include <map>
 
+namespace fs = boost::filesystem;
+
 //defined in module loader
 std::string get_gras_runtime_include_path(void);
 
+/***********************************************************************
+ * Compile statistics for the query interface
+ **********************************************************************/
+static boost::mutex stats_mutex;
+static gras::JITFactoryStats jit_stats;
+
+gras::JITFactoryStats gras::get_jit_factory_stats(void)
+{
+    boost::mutex::scoped_lock l(stats_mutex);
+    return jit_stats;
+}
+
 #ifdef HAVE_CLANG
 #include <clang/CodeGen/CodeGenAction.h>
 #include <clang/Frontend/CompilerInstance.h>
@@ -83,19 +105,118 @@ static ExecutionEngineMonitor &get_eemon(void)
 #endif //HAVE_LLVM
 
 /***********************************************************************
- * Helper function to call a clang compliation -- execs clang
+ * Persistent bitcode cache:
+ * Bitcode is stored in GRAS_JIT_CACHE (default ~/.gras/jit_cache)
+ * under a key hashed from the source, the flags, clang's version,
+ * and the installed GRAS headers that the bitcode was compiled against.
+ * Set GRAS_JIT_CACHE to an empty string to disable the cache.
  **********************************************************************/
 #ifdef HAVE_LLVM
-static llvm::Module *call_clang_exe(const std::string &source_file, const std::vector<std::string> &flags)
+static std::string hash_to_hex(const std::string &s)
+{
+    //FNV-1a: stable across runs and boost versions, unlike boost::hash
+    unsigned long long h = 14695981039346656037ULL;
+    BOOST_FOREACH(const char ch, s)
+    {
+        h ^= (unsigned char)(ch);
+        h *= 1099511628211ULL;
+    }
+    return str(boost::format("%016x") % h);
+}
+
+static std::string get_clang_path(void)
+{
+    llvm::sys::Path clangPath = llvm::sys::Program::FindProgramByName("clang");
+    return clangPath.str();
+}
+
+static const std::string &get_clang_version(void)
+{
+    static boost::mutex mutex;
+    static std::string version;
+    boost::mutex::scoped_lock l(mutex);
+    if (not version.empty()) return version;
+
+    //key on the full version banner so any toolchain change invalidates the cache
+    const std::string command = get_clang_path() + " --version";
+    FILE *p = popen(command.c_str(), "r");
+    if (p != NULL)
+    {
+        char buff[256];
+        while (std::fgets(buff, sizeof(buff), p) != NULL) version += buff;
+        pclose(p);
+    }
+    if (version.empty()) version = "unknown";
+    return version;
+}
+
+static const std::string &get_runtime_headers_hash(void)
+{
+    static boost::mutex mutex;
+    static std::string hash;
+    boost::mutex::scoped_lock l(mutex);
+    if (not hash.empty()) return hash;
+
+    //the bitcode inlines the runtime headers, so any header change invalidates it
+    std::vector<std::string> files;
+    try
+    {
+        const fs::path gras_inc = fs::path(get_gras_runtime_include_path()) / "gras";
+        if (fs::is_directory(gras_inc))
+        {
+            fs::recursive_directory_iterator it(gras_inc), end;
+            for (; it != end; ++it)
+            {
+                if (fs::is_regular_file(it->path())) files.push_back(it->path().string());
+            }
+        }
+    }
+    catch(const std::exception &){}
+    std::sort(files.begin(), files.end());
+
+    std::string data;
+    BOOST_FOREACH(const std::string &file, files)
+    {
+        std::ifstream header_fstream(file.c_str(), std::ios::binary);
+        data += '\0' + file + '\0';
+        data += std::string((std::istreambuf_iterator<char>(header_fstream)), std::istreambuf_iterator<char>());
+    }
+    hash = hash_to_hex(data);
+    return hash;
+}
+
+static fs::path get_cache_dir(void)
 {
-    //make up bitcode file path
-    char bitcode_file[L_tmpnam];
-    if (std::tmpnam(bitcode_file) == NULL) throw std::runtime_error("GRAS compiler: tmp bitcode file path failed");
+    const char *env_cache = std::getenv("GRAS_JIT_CACHE");
+    if (env_cache != NULL) return fs::path(env_cache);
+    const char *env_home = std::getenv("HOME");
+    if (env_home == NULL) env_home = std::getenv("USERPROFILE");
+    if (env_home != NULL) return fs::path(env_home) / ".gras" / "jit_cache";
+    return fs::temp_directory_path() / "gras_jit_cache";
+}
+
+static std::string make_cache_key(const std::string &source, const std::vector<std::string> &flags)
+{
+    std::string key_data = get_clang_version();
+    key_data += '\0' + get_runtime_headers_hash();
+    BOOST_FOREACH(const std::string &flag, flags)
+    {
+        key_data += '\0' + flag;
+    }
+    key_data += '\0' + source;
+    return hash_to_hex(key_data);
+}
+#endif //HAVE_LLVM
 
+/***********************************************************************
+ * Helper function to call a clang compliation -- execs clang
+ **********************************************************************/
+#ifdef HAVE_LLVM
+static void call_clang_exe(const std::string &source_file, const std::string &bitcode_file, const std::vector<std::string> &flags)
+{
     //begin command setup
     std::vector<std::string> cmd;
-    llvm::sys::Path clangPath = llvm::sys::Program::FindProgramByName("clang");
-    cmd.push_back(clangPath.str());
+    cmd.push_back(get_clang_path());
     cmd.push_back("-emit-llvm");
 
     //inject source
@@ -126,9 +247,12 @@ static llvm::Module *call_clang_exe(const std::string &source_file, const std::v
     {
         throw std::runtime_error("GRAS compiler: error system exec clang");
     }
+}
 
+static llvm::Module *load_bitcode_file(const std::string &bitcode_file)
+{
     //readback bitcode for result
-    std::ifstream bitcode_fstream(bitcode_file);
+    std::ifstream bitcode_fstream(bitcode_file.c_str(), std::ios::binary);
     const std::string bitcode((std::istreambuf_iterator<char>(bitcode_fstream)), std::istreambuf_iterator<char>());
 
     //create a memory buffer from the bitcode
@@ -207,30 +331,180 @@ static llvm::Module *call_clang_api(const std::string &source_file, const std::v
  * factory compile implementation
  **********************************************************************/
 #ifdef HAVE_LLVM
-void gras::jit_factory(const std::string &source, const std::vector<std::string> &flags_)
+struct JITCompileJob
 {
-    //write source to tmp file
-    char source_file[L_tmpnam];
-    if (std::tmpnam(source_file) == NULL) throw std::runtime_error("GRAS compiler: tmp source file path failed");
-    std::ofstream source_fstream(source_file);
-    source_fstream << source;
-    source_fstream.close();
+    std::string source;
+    std::string key;
+    fs::path bitcode_path;
+    bool needs_compile;
+    std::string error;
+};
+
+static void compile_job(JITCompileJob &job, const std::vector<std::string> &flags)
+{
+    try
+    {
+        //write source and bitcode to unique paths, then rename into the cache,
+        //so concurrent processes never observe a partially written bitcode file
+        const fs::path tmp_dir = fs::temp_directory_path();
+        const fs::path source_file = tmp_dir / fs::unique_path("gras_jit_%%%%-%%%%-%%%%.cpp");
+        const fs::path bitcode_file = job.bitcode_path.parent_path() / fs::unique_path(".tmp_%%%%-%%%%-%%%%.bc");
+        {
+            std::ofstream source_fstream(source_file.string().c_str());
+            source_fstream << job.source;
+        }
+
+        const gras::time_ticks_t t0 = gras::time_now();
+        try
+        {
+            call_clang_exe(source_file.string(), bitcode_file.string(), flags);
+        }
+        catch(...)
+        {
+            //leave no partial output behind; the final cache path is not touched,
+            //another process may have just renamed a valid bitcode file there
+            boost::system::error_code ec;
+            fs::remove(source_file, ec);
+            fs::remove(bitcode_file, ec);
+            throw;
+        }
+        const gras::time_ticks_t t1 = gras::time_now();
+        fs::remove(source_file);
+        fs::rename(bitcode_file, job.bitcode_path);
+
+        boost::mutex::scoped_lock l(stats_mutex);
+        jit_stats.compile_count++;
+        jit_stats.total_compile_time += t1 - t0;
+    }
+    catch(const std::exception &ex)
+    {
+        job.error = ex.what();
+    }
+}
+
+static void compile_worker(
+    std::vector<JITCompileJob *> &pending, size_t &next,
+    boost::mutex &mutex, const std::vector<std::string> &flags
+)
+{
+    while (true)
+    {
+        JITCompileJob *job = NULL;
+        {
+            boost::mutex::scoped_lock l(mutex);
+            if (next == pending.size()) return;
+            job = pending[next++];
+        }
+        compile_job(*job, flags);
+    }
+}
+
+void gras::jit_factory(const std::string &source, const std::vector<std::string> &flags)
+{
+    gras::jit_factory_parallel(std::vector<std::string>(1, source), flags);
+}
+
+void gras::jit_factory_parallel(const std::vector<std::string> &sources, const std::vector<std::string> &flags_)
+{
+    //serialize callers: the modules share one LLVM context
+    static boost::mutex jit_mutex;
+    boost::mutex::scoped_lock jit_lock(jit_mutex);
+
+    //sources already loaded into this process are not loaded again
+    static std::set<std::string> loaded_keys;
 
     llvm::InitializeNativeTarget();
     llvm::llvm_start_multithreaded();
 
-    //use clang to compile source into bitcode
-    std::cout << "GRAS compiler: compile source into bitcode..." << std::endl;
     std::vector<std::string> flags = flags_;
     flags.push_back("-I"+get_gras_runtime_include_path()); //add root include path
-    llvm::Module *module = call_clang_exe(source_file, flags);
 
-    //create execution engine
-    std::string error;
-    boost::shared_ptr<llvm::ExecutionEngine> ee(llvm::ExecutionEngine::create(module, false, &error));
-    if (not error.empty()) throw std::runtime_error("GRAS compiler: ExecutionEngine " + error);
-    std::cout << "GRAS compiler: execute static constructors..." << std::endl;
-    get_eemon().add(ee);
+    //when the cache is disabled, bitcode goes into a scratch directory
+    fs::path cache_dir = get_cache_dir();
+    const bool cache_enabled = not cache_dir.empty();
+    if (not cache_enabled) cache_dir = fs::temp_directory_path() / fs::unique_path("gras_jit_%%%%-%%%%-%%%%");
+    fs::create_directories(cache_dir);
+
+    //sort the sources into cache hits and jobs that need a compile
+    std::vector<JITCompileJob> jobs;
+    std::set<std::string> batch_keys;
+    BOOST_FOREACH(const std::string &source, sources)
+    {
+        JITCompileJob job;
+        job.source = source;
+        job.key = make_cache_key(source, flags);
+        job.bitcode_path = cache_dir / (job.key + ".bc");
+        job.needs_compile = not (cache_enabled and fs::exists(job.bitcode_path));
+        boost::mutex::scoped_lock l(stats_mutex);
+        if (loaded_keys.count(job.key) != 0 or batch_keys.count(job.key) != 0)
+        {
+            jit_stats.memory_hit_count++;
+            continue;
+        }
+        if (not job.needs_compile) jit_stats.cache_hit_count++;
+        batch_keys.insert(job.key);
+        jobs.push_back(job);
+    }
+
+    //use clang to compile sources into bitcode -- at most one thread per core
+    std::vector<JITCompileJob *> pending;
+    BOOST_FOREACH(JITCompileJob &job, jobs)
+    {
+        if (job.needs_compile) pending.push_back(&job);
+    }
+    if (not pending.empty()) std::cout << "GRAS compiler: compile source into bitcode..." << std::endl;
+    const size_t max_threads = std::max<size_t>(1, boost::thread::hardware_concurrency());
+    size_t next_pending = 0;
+    boost::mutex pending_mutex;
+    boost::thread_group compile_threads;
+    for (size_t i = 0; i < std::min(pending.size(), max_threads); i++)
+    {
+        compile_threads.create_thread(boost::bind(&compile_worker,
+            boost::ref(pending), boost::ref(next_pending),
+            boost::ref(pending_mutex), boost::cref(flags)));
+    }
+    compile_threads.join_all();
+
+    BOOST_FOREACH(const JITCompileJob &job, jobs)
+    {
+        if (not job.error.empty()) throw std::runtime_error(job.error);
+    }
+
+    //JIT each module and run the static constructors (registers factories)
+    BOOST_FOREACH(JITCompileJob &job, jobs)
+    {
+        llvm::Module *module = NULL;
+        try
+        {
+            module = load_bitcode_file(job.bitcode_path.string());
+        }
+        catch(const std::exception &ex)
+        {
+            //a corrupt cache entry is deleted and compiled once more
+            if (job.needs_compile) throw;
+            std::cerr << "GRAS compiler: discard cached bitcode " << job.bitcode_path.string() << ": " << ex.what() << std::endl;
+            boost::system::error_code ec;
+            fs::remove(job.bitcode_path, ec);
+            {
+                boost::mutex::scoped_lock l(stats_mutex);
+                jit_stats.cache_hit_count--;
+            }
+            job.needs_compile = true;
+            compile_job(job, flags);
+            if (not job.error.empty()) throw std::runtime_error(job.error);
+            module = load_bitcode_file(job.bitcode_path.string());
+        }
+        if (not cache_enabled) fs::remove(job.bitcode_path);
+
+        //create execution engine
+        std::string error;
+        boost::shared_ptr<llvm::ExecutionEngine> ee(llvm::ExecutionEngine::create(module, false, &error));
+        if (not error.empty()) throw std::runtime_error("GRAS compiler: ExecutionEngine " + error);
+        std::cout << "GRAS compiler: execute static constructors..." << std::endl;
+        get_eemon().add(ee);
+        loaded_keys.insert(job.key);
+    }
+    if (not cache_enabled) fs::remove_all(cache_dir);
 }
 
 #else //HAVE_LLVM
@@ -240,4 +514,9 @@ void gras::jit_factory(const std::string &, const std::vector<std::string> &)
     throw std::runtime_error("GRAS compiler not built with Clang support!");
 }
 
+void gras::jit_factory_parallel(const std::vector<std::string> &, const std::vector<std::string> &)
+{
+    throw std::runtime_error("GRAS compiler not built with Clang support!");
+}
+
 #endif //HAVE_LLVM
@@ -1,12 +1,23 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras/gras.hpp>
+#include <gras/chrono.hpp>
+#include <gras_impl/module_loader.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/foreach.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
 #include <stdexcept>
 #include <iostream>
+#include <fstream>
 #include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <set>
 
 namespace fs = boost::filesystem;
 
@@ -26,32 +37,256 @@ namespace fs = boost::filesystem;
     }
 #endif
 
-static void load_all_modules_in_path(const fs::path &path)
+//! The index file that lives next to the module libraries in a directory
+static const char *INDEX_FILE_NAME = "gras_modules.index";
+
+/***********************************************************************
+ * Module bookkeeping:
+ * which libraries are loaded, which factory paths each library provides,
+ * and which factory paths can be satisfied by loading an indexed library.
+ **********************************************************************/
+struct ModuleRegistry
+{
+    boost::mutex mutex;
+    boost::mutex lazy_mutex;
+    std::set<std::string> loaded;
+    std::map<std::string, std::string> lazy_paths; //factory path -> library
+    std::map<std::string, std::vector<std::string> > provides; //library -> factory paths
+    gras::ModuleLoaderStats stats;
+};
+
+static ModuleRegistry &get_registry(void)
+{
+    static ModuleRegistry r;
+    return r;
+}
+
+//the library being loaded by this thread, so registrations can be attributed
+static boost::thread_specific_ptr<std::string> &get_loading_module(void)
+{
+    static boost::thread_specific_ptr<std::string> loading_module;
+    return loading_module;
+}
+
+static std::string module_key(const fs::path &path)
+{
+    try
+    {
+        return fs::canonical(path).string();
+    }
+    catch(...)
+    {
+        return fs::absolute(path).string();
+    }
+}
+
+void gras::note_factory_registration(const std::string &path)
+{
+    boost::thread_specific_ptr<std::string> &loading_module = get_loading_module();
+    if (loading_module.get() == NULL) return;
+    ModuleRegistry &r = get_registry();
+    boost::mutex::scoped_lock l(r.mutex);
+    r.provides[*loading_module].push_back(path);
+}
+
+static bool load_module(const std::string &mod_path)
+{
+    ModuleRegistry &r = get_registry();
+    {
+        boost::mutex::scoped_lock l(r.mutex);
+        if (r.loaded.count(mod_path) != 0) return true;
+        r.loaded.insert(mod_path);
+    }
+
+    get_loading_module().reset(new std::string(mod_path));
+    const bool ok = load_module_in_path(mod_path.c_str());
+    get_loading_module().reset();
+
+    if (not ok)
+    {
+        std::cerr << "GRAS Module loader fail: " << mod_path << std::endl;
+    }
+    return ok;
+}
+
+/***********************************************************************
+ * Index file parsing:
+ * Each line is a library file name relative to the index directory,
+ * followed by a tab and a factory path that it provides.
+ * Libraries that provide no factory paths are not listed,
+ * so that they are loaded up-front like any unindexed library.
+ * Entries for libraries newer than the index are considered stale.
+ **********************************************************************/
+static void read_module_index(const fs::path &dir, std::set<std::string> &indexed)
+{
+    const fs::path index_path = dir / INDEX_FILE_NAME;
+    if (not fs::exists(index_path)) return;
+    const std::time_t index_time = fs::last_write_time(index_path);
+
+    ModuleRegistry &r = get_registry();
+    std::ifstream index_fstream(index_path.string().c_str());
+    std::string line;
+    while (std::getline(index_fstream, line))
+    {
+        if (line.empty() or line[0] == '#') continue;
+        const size_t tab = line.find('\t');
+        const fs::path lib_path = dir / line.substr(0, tab);
+        if (not fs::exists(lib_path)) continue;
+        if (fs::last_write_time(lib_path) > index_time) continue;
+
+        //a library is only deferred when it has a path to be loaded by,
+        //bare entries from older index files stay on the eager path
+        if (tab == std::string::npos) continue;
+        const std::string key = module_key(lib_path);
+        indexed.insert(key);
+
+        boost::mutex::scoped_lock l(r.mutex);
+        r.lazy_paths[line.substr(tab+1)] = key;
+        r.stats.indexed_path_count++;
+    }
+}
+
+/***********************************************************************
+ * Directory walking: gather the libraries that must be loaded up-front
+ **********************************************************************/
+static void collect_modules_in_path(const fs::path &path, std::vector<std::string> &mods, const bool use_index)
 {
     if (not fs::exists(path)) return;
     if (fs::is_regular_file(path))
     {
-        const std::string mod_path = path.string();
-        if (not load_module_in_path(mod_path.c_str()))
-        {
-            std::cerr << "GRAS Module loader fail: " << mod_path << std::endl;
-        }
+        if (path.filename() == INDEX_FILE_NAME) return;
+        mods.push_back(module_key(path));
         return;
     }
-    if (fs::is_directory(path)) for(
+    if (not fs::is_directory(path)) return;
+
+    std::set<std::string> indexed;
+    if (use_index) read_module_index(path, indexed);
+    for(
         fs::directory_iterator dir_itr(path);
         dir_itr != fs::directory_iterator();
         ++dir_itr
-    ) load_all_modules_in_path(dir_itr->path());
+    ){
+        if (fs::is_regular_file(dir_itr->path()) and indexed.count(module_key(dir_itr->path())) != 0) continue;
+        collect_modules_in_path(dir_itr->path(), mods, use_index);
+    }
 }
 
-static void load_modules_from_paths(const std::string &paths, const fs::path &suffix)
+static void collect_modules_from_paths(const std::string &paths, const fs::path &suffix, std::vector<std::string> &mods, const bool use_index)
 {
     if (paths.empty()) return;
     BOOST_FOREACH(const std::string &path, boost::tokenizer<boost::char_separator<char> > (paths, boost::char_separator<char>(SEP)))
     {
         if (path.empty()) continue;
-        load_all_modules_in_path(fs::path(path) / suffix);
+        collect_modules_in_path(fs::path(path) / suffix, mods, use_index);
+    }
+}
+
+/***********************************************************************
+ * Load a list of libraries across a pool of threads
+ **********************************************************************/
+static void load_modules_strided(const std::vector<std::string> &mods, const size_t offset, const size_t stride)
+{
+    ModuleRegistry &r = get_registry();
+    for (size_t i = offset; i < mods.size(); i += stride)
+    {
+        if (not load_module(mods[i])) continue;
+        boost::mutex::scoped_lock l(r.mutex);
+        r.stats.eager_load_count++;
+    }
+}
+
+static void load_modules_parallel(const std::vector<std::string> &mods)
+{
+    const size_t hw_threads = std::max<size_t>(1, boost::thread::hardware_concurrency());
+    const size_t num_threads = std::min(mods.size(), hw_threads);
+    if (num_threads <= 1) return load_modules_strided(mods, 0, 1);
+
+    boost::thread_group tg;
+    for (size_t i = 0; i < num_threads; i++)
+    {
+        tg.create_thread(boost::bind(&load_modules_strided, boost::cref(mods), i, num_threads));
+    }
+    tg.join_all();
+}
+
+/***********************************************************************
+ * Lazy loading hook for the factory and stats for the query interface
+ **********************************************************************/
+bool gras::load_module_for_factory_path(const std::string &path)
+{
+    ModuleRegistry &r = get_registry();
+
+    //one lazy load at a time, so a concurrent lookup
+    //waits for the static constructors to finish registering
+    boost::mutex::scoped_lock lazy_lock(r.lazy_mutex);
+    std::string mod_path;
+    {
+        boost::mutex::scoped_lock l(r.mutex);
+        std::map<std::string, std::string>::const_iterator it = r.lazy_paths.find(path);
+        if (it == r.lazy_paths.end()) return false;
+        mod_path = it->second;
+        if (r.loaded.count(mod_path) != 0) return true;
+    }
+
+    const gras::time_ticks_t t0 = gras::time_now();
+    const bool ok = load_module(mod_path);
+    const gras::time_ticks_t t1 = gras::time_now();
+
+    boost::mutex::scoped_lock l(r.mutex);
+    if (ok) r.stats.lazy_load_count++;
+    r.stats.lazy_load_time += t1 - t0;
+    return ok;
+}
+
+gras::ModuleLoaderStats gras::get_module_loader_stats(void)
+{
+    ModuleRegistry &r = get_registry();
+    boost::mutex::scoped_lock l(r.mutex);
+    return r.stats;
+}
+
+/***********************************************************************
+ * Index generation, called by the gras_module_index tool at install time
+ **********************************************************************/
+void gras::write_module_index(const std::string &dir)
+{
+    const fs::path dir_path(dir);
+    if (not fs::is_directory(dir_path))
+    {
+        throw std::runtime_error("GRAS Module index: not a directory " + dir);
+    }
+
+    //load every library in the directory, recording what each registers
+    std::vector<fs::path> libs;
+    for(
+        fs::directory_iterator dir_itr(dir_path);
+        dir_itr != fs::directory_iterator();
+        ++dir_itr
+    ){
+        if (not fs::is_regular_file(dir_itr->path())) continue;
+        if (dir_itr->path().filename() == INDEX_FILE_NAME) continue;
+        libs.push_back(dir_itr->path());
+    }
+    std::sort(libs.begin(), libs.end());
+
+    const fs::path index_path = dir_path / INDEX_FILE_NAME;
+    std::ofstream index_fstream(index_path.string().c_str());
+    index_fstream << "# GRAS module index: <library>\\t<factory path>" << std::endl;
+
+    ModuleRegistry &r = get_registry();
+    BOOST_FOREACH(const fs::path &lib, libs)
+    {
+        const std::string key = module_key(lib);
+        if (not load_module(key)) continue;
+
+        //libraries without factory paths are left out and load eagerly
+        const std::string name = lib.filename().string();
+        boost::mutex::scoped_lock l(r.mutex);
+        BOOST_FOREACH(const std::string &path, r.provides[key])
+        {
+            index_fstream << name << "\t" << path << std::endl;
+        }
     }
 }
 
@@ -71,12 +306,25 @@ std::string get_gras_runtime_include_path(void)
 
 GRAS_STATIC_BLOCK(gras_module_loader)
 {
+    const gras::time_ticks_t t0 = gras::time_now();
+
+    //GRAS_MODULE_LOAD=eager loads every library and ignores the index files
+    const bool use_index = my_get_env("GRAS_MODULE_LOAD", "lazy") != "eager";
+    std::vector<std::string> mods;
+
     //!search the GRAS_ROOT directory for this install
-    load_modules_from_paths(my_get_env("GRAS_ROOT", "@GRAS_ROOT@"), fs::path("") / "lib@LIB_SUFFIX@" / "gras" / "modules");
+    collect_modules_from_paths(my_get_env("GRAS_ROOT", "@GRAS_ROOT@"), fs::path("") / "lib@LIB_SUFFIX@" / "gras" / "modules", mods, use_index);
 
     //!search the GRAS_PATH search directories for modules
-    load_modules_from_paths(my_get_env("GRAS_PATH", ""), fs::path("") / "lib@LIB_SUFFIX@" / "gras" / "modules");
+    collect_modules_from_paths(my_get_env("GRAS_PATH", ""), fs::path("") / "lib@LIB_SUFFIX@" / "gras" / "modules", mods, use_index);
 
     //!search the explicit module paths
-    load_modules_from_paths(my_get_env("GRAS_MODULE_PATH", ""), fs::path(""));
+    collect_modules_from_paths(my_get_env("GRAS_MODULE_PATH", ""), fs::path(""), mods, use_index);
+
+    //libraries without an index entry are loaded now, in parallel
+    load_modules_parallel(mods);
+
+    ModuleRegistry &r = get_registry();
+    boost::mutex::scoped_lock l(r.mutex);
+    r.stats.startup_time = gras::time_now() - t0;
 }
@@ -28,4 +28,4 @@ THERON_DEFINE_REGISTERED_MESSAGE(gras::OutputUpdateMessage);
 
 THERON_DEFINE_REGISTERED_MESSAGE(gras::CallableMessage);
 THERON_DEFINE_REGISTERED_MESSAGE(gras::SelfKickMessage);
-THERON_DEFINE_REGISTERED_MESSAGE(gras::GetStatsMessage);
+THERON_DEFINE_REGISTERED_MESSAGE(gras::InputGraceMessage);
@@ -37,6 +37,9 @@ void BlockActor::mark_done(void)
     //release upstream, downstream, and executor tokens
     data->token_pool.clear();
 
+    //wake up TopBlock::wait() to recheck the executor token
+    if (data->token_signal) data->token_signal->notify();
+
     //release all buffers in queues
     data->input_queues.flush_all();
     data->output_queues.flush_all();
@@ -50,6 +53,9 @@ void BlockActor::mark_done(void)
         data->num_input_msgs_read[i] = 0;
     }
 
+    //final counters for the query interface
+    this->publish_stats();
+
     //tell the upstream and downstram to re-check their tokens
     //this is how the other blocks know who is interested,
     //and can decide based on interest to set done or not
@@ -17,6 +17,13 @@ void Block::mark_input_fail(const size_t which_input)
 
 void BlockActor::input_fail(const size_t i)
 {
+    //a block without inputs sleeps until a message wakes it
+    if (worker->get_num_inputs() == 0)
+    {
+        data->inputs_available.reset(0);
+        return;
+    }
+
     //input failed, accumulate and try again
     if (not data->input_queues.is_accumulated(i))
     {
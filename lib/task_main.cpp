@@ -1,6 +1,7 @@
 // Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
 
 #include <gras_impl/block_actor.hpp>
+#include <gras_impl/timer_service.hpp>
 #include <algorithm>
 
 using namespace gras;
@@ -60,6 +61,63 @@ static GRAS_FORCE_INLINE void trim_buffs(boost::shared_ptr<BlockData> &data, con
     }
 }
 
+template <typename ItemsType>
+static GRAS_FORCE_INLINE void clamp_items(ItemsType &items, const size_t limit)
+{
+    items.min() = std::min(items.min(), limit);
+    items.max() = std::min(items.max(), limit);
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        items[i].size() = std::min(items[i].size(), limit);
+    }
+}
+
+/***********************************************************************
+ * rate limiting -- see GlobalBlockConfig::maximum_items_per_sec
+ **********************************************************************/
+static const double RATE_BURST_SECS = 0.005; //items allowed ahead of schedule
+static const double RATE_MAX_ALLOWANCE = 1e9; //keeps the cast in range
+
+bool BlockActor::is_rate_limited(void)
+{
+    BlockStats &stats = data->stats;
+    data->rate_allowance = 0;
+    const double rate = data->block->global_config().maximum_items_per_sec;
+    if GRAS_LIKELY(rate <= 0.0 and stats.rate_target <= 0.0) return false;
+    const time_ticks_t now = time_now();
+
+    //a new target restarts the schedule from now
+    if GRAS_UNLIKELY(rate != stats.rate_target)
+    {
+        stats.rate_target = rate;
+        stats.rate_start_time = now;
+        stats.rate_items = 0;
+        if (rate <= 0.0) return false;
+    }
+
+    //the time at which all items so far are due
+    const double ticks_per_item = time_tps()/rate;
+    const time_ticks_t due = stats.rate_start_time + time_ticks_t(stats.rate_items*ticks_per_item);
+
+    //on schedule: allow the items due by now plus a short burst
+    if (now >= due)
+    {
+        const double allowance = (now - due)/ticks_per_item + rate*RATE_BURST_SECS;
+        data->rate_allowance = size_t(std::min(allowance, RATE_MAX_ALLOWANCE)) + 1;
+        return false;
+    }
+
+    //ahead of schedule: a timer kicks the actor when due,
+    //unless a kick is already pending for that time or sooner
+    if (data->rate_kick_time <= now or data->rate_kick_time > due)
+    {
+        data->rate_kick_time = due;
+        stats.rate_wait_count++;
+        schedule_self_kick(this->thread_pool, this->GetAddress(), due);
+    }
+    return true;
+}
+
 /***********************************************************************
  * main task
  **********************************************************************/
@@ -73,6 +131,7 @@ void BlockActor::task_main(void)
     //-- however, not all ports may have available buffers.
     //------------------------------------------------------------------
     if GRAS_UNLIKELY(not this->is_work_allowed()) return;
+    if GRAS_UNLIKELY(this->is_rate_limited()) return;
 
     const size_t num_inputs = worker->get_num_inputs();
     const size_t num_outputs = worker->get_num_outputs();
@@ -136,6 +195,16 @@ void BlockActor::task_main(void)
         data->output_items.max() = std::max(data->output_items.max(), items);
     }
 
+    //------------------------------------------------------------------
+    //-- clamp the items offered to work to the rate limit allowance:
+    //-- the output ports, or the input ports when there are no outputs
+    //------------------------------------------------------------------
+    if GRAS_UNLIKELY(data->rate_allowance != 0)
+    {
+        if (num_outputs != 0) clamp_items(data->output_items, data->rate_allowance);
+        else clamp_items(data->input_items, data->rate_allowance);
+    }
+
     //------------------------------------------------------------------
     //-- the work
     //------------------------------------------------------------------
@@ -193,6 +262,16 @@ void BlockActor::task_main(void)
         data->total_items_produced[i] += data->num_output_items_read[i];
     }
 
+    //count items toward the rate limit: output 0, or input 0 for sinks
+    if GRAS_UNLIKELY(data->stats.rate_target > 0.0)
+    {
+        if (num_outputs != 0) data->stats.rate_items += data->num_output_items_read[0];
+        else if (num_inputs != 0) data->stats.rate_items += data->num_input_items_read[0];
+    }
+
+    //make the new counters visible to the query interface
+    this->publish_stats();
+
     //still have IO ready? kick off another task
     this->task_kicker();
 }
@@ -0,0 +1,247 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <gras/thread_budget.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <algorithm>
+#include <deque>
+#include <map>
+
+using namespace gras;
+
+typedef boost::function<void(const size_t)> LoopBody;
+
+/***********************************************************************
+ * One parallel_for call: jobs take the next index until none are left
+ **********************************************************************/
+struct ParallelLoop
+{
+    ParallelLoop(const size_t n, const LoopBody &fn):
+        n(n), next(0), done(0), fn(fn)
+    {
+        //pass
+    }
+
+    //run indexes until the loop is drained, true when this finished it
+    bool run(void)
+    {
+        size_t finished = 0;
+        while (true)
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            done += finished;
+            if (next == n) return finished != 0 and done == n;
+            const size_t i = next++;
+            lock.unlock();
+            fn(i);
+            finished = 1;
+        }
+    }
+
+    void wait(void)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        while (done != n) cond.wait(lock);
+    }
+
+    const size_t n;
+    size_t next;
+    size_t done;
+    const LoopBody fn;
+    boost::mutex mutex;
+    boost::condition_variable cond;
+};
+
+typedef boost::shared_ptr<ParallelLoop> ParallelLoopSptr;
+
+/***********************************************************************
+ * The budget: grant accounting and the helper threads
+ **********************************************************************/
+struct ThreadBudgetImpl
+{
+    ThreadBudgetImpl(void)
+    {
+        const size_t cpus = boost::thread::hardware_concurrency();
+        capacity = (cpus > 1)? cpus-1 : 0;
+        total_granted = 0;
+        num_threads = 0;
+        num_idle = 0;
+    }
+
+    size_t acquire(const std::string &owner, const size_t parallelism)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        const size_t free = (capacity > total_granted)? capacity-total_granted : 0;
+        const size_t helpers = std::min(free, (parallelism > 0)? parallelism-1 : 0);
+        total_granted += helpers;
+        granted[owner] += helpers+1;
+        return helpers;
+    }
+
+    void release(const std::string &owner, const size_t helpers)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        total_granted -= helpers;
+        if ((granted[owner] -= helpers+1) == 0) granted.erase(owner);
+    }
+
+    //queue jobs for a loop, growing the helper threads up to the capacity;
+    //never queue more jobs than there are threads to drain them
+    void post(const ParallelLoopSptr &loop, size_t jobs)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        while (num_threads < capacity and num_idle < queue.size()+jobs)
+        {
+            num_threads++;
+            num_idle++;
+            boost::thread(boost::bind(&ThreadBudgetImpl::run, this)).detach();
+        }
+        jobs = std::min(jobs, num_threads);
+        if (jobs == 0) return;
+        for (size_t i = 0; i < jobs; i++) queue.push_back(loop);
+        lock.unlock();
+        if (jobs == 1) cond.notify_one();
+        else cond.notify_all();
+    }
+
+    void run(void)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        while (true)
+        {
+            if (queue.empty())
+            {
+                cond.wait(lock);
+                continue;
+            }
+
+            //a job that finds the loop drained returns right away
+            const ParallelLoopSptr loop = queue.front();
+            queue.pop_front();
+            num_idle--;
+            lock.unlock();
+            if (loop->run()) loop->cond.notify_all();
+            lock.lock();
+            num_idle++;
+        }
+    }
+
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    size_t capacity;
+    size_t total_granted;
+    std::map<std::string, size_t> granted;
+    std::deque<ParallelLoopSptr> queue;
+    size_t num_threads;
+    size_t num_idle;
+};
+
+static ThreadBudgetImpl &get_thread_budget(void)
+{
+    //leaked on purpose: the detached helpers outlive static destruction
+    static ThreadBudgetImpl *budget = new ThreadBudgetImpl();
+    return *budget;
+}
+
+static void run_parallel(const size_t n, const size_t width, const LoopBody &fn)
+{
+    if (n == 0) return;
+    if (n == 1 or width <= 1)
+    {
+        for (size_t i = 0; i < n; i++) fn(i);
+        return;
+    }
+
+    //the caller runs jobs too, so the loop finishes even with no helpers free
+    ParallelLoopSptr loop(new ParallelLoop(n, fn));
+    get_thread_budget().post(loop, std::min(n, width)-1);
+    loop->run();
+    loop->wait();
+}
+
+/***********************************************************************
+ * ThreadBudget
+ **********************************************************************/
+void ThreadBudget::set_capacity(const size_t threads)
+{
+    ThreadBudgetImpl &budget = get_thread_budget();
+    boost::mutex::scoped_lock lock(budget.mutex);
+    budget.capacity = threads;
+}
+
+size_t ThreadBudget::capacity(void)
+{
+    ThreadBudgetImpl &budget = get_thread_budget();
+    boost::mutex::scoped_lock lock(budget.mutex);
+    return budget.capacity;
+}
+
+size_t ThreadBudget::available(void)
+{
+    ThreadBudgetImpl &budget = get_thread_budget();
+    boost::mutex::scoped_lock lock(budget.mutex);
+    return (budget.capacity > budget.total_granted)? budget.capacity-budget.total_granted : 0;
+}
+
+size_t ThreadBudget::granted(const std::string &owner)
+{
+    ThreadBudgetImpl &budget = get_thread_budget();
+    boost::mutex::scoped_lock lock(budget.mutex);
+    std::map<std::string, size_t>::const_iterator it = budget.granted.find(owner);
+    return (it == budget.granted.end())? 0 : it->second;
+}
+
+void ThreadBudget::parallel_for(const size_t n, const LoopBody &fn)
+{
+    run_parallel(n, n, fn);
+}
+
+/***********************************************************************
+ * ThreadGrant
+ **********************************************************************/
+struct ThreadGrantImpl
+{
+    ThreadGrantImpl(const std::string &owner, const size_t parallelism):
+        owner(owner)
+    {
+        helpers = get_thread_budget().acquire(owner, parallelism);
+    }
+
+    ~ThreadGrantImpl(void)
+    {
+        get_thread_budget().release(owner, helpers);
+    }
+
+    const std::string owner;
+    size_t helpers;
+};
+
+ThreadGrant::ThreadGrant(void)
+{
+    //pass
+}
+
+ThreadGrant::ThreadGrant(const std::string &owner, const size_t parallelism)
+{
+    _impl.reset(new ThreadGrantImpl(owner, parallelism));
+}
+
+size_t ThreadGrant::size(void) const
+{
+    if (not _impl) return 1;
+    return reinterpret_cast<const ThreadGrantImpl *>(_impl.get())->helpers+1;
+}
+
+const std::string &ThreadGrant::owner(void) const
+{
+    static const std::string none;
+    if (not _impl) return none;
+    return reinterpret_cast<const ThreadGrantImpl *>(_impl.get())->owner;
+}
+
+void ThreadGrant::parallel_for(const size_t n, const LoopBody &fn) const
+{
+    run_parallel(n, this->size(), fn);
+}
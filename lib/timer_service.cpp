@@ -0,0 +1,97 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <gras_impl/timer_service.hpp>
+#include <gras_impl/messages.hpp>
+#include <Theron/Framework.h>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <map>
+
+using namespace gras;
+
+//the bound send holds the thread pool alive until it is called
+typedef boost::function<void(void)> TimerEntry;
+
+typedef std::multimap<time_ticks_t, TimerEntry> TimerQueue;
+
+struct TimerService
+{
+    TimerService(void)
+    {
+        boost::thread(boost::bind(&TimerService::run, this)).detach();
+    }
+
+    void schedule(const TimerEntry &entry, const time_ticks_t when)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        const bool earliest = queue.empty() or when < queue.begin()->first;
+        queue.insert(std::make_pair(when, entry));
+        lock.unlock();
+        if (earliest) cond.notify_one();
+    }
+
+    void run(void)
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        while (true)
+        {
+            if (queue.empty())
+            {
+                cond.wait(lock);
+                continue;
+            }
+
+            //sleep until the earliest deadline or an earlier schedule
+            const time_ticks_t delta = queue.begin()->first - time_now();
+            if (delta > 0)
+            {
+                const double us = (delta*1e6)/time_tps();
+                cond.timed_wait(lock, boost::posix_time::microseconds((long long)(us) + 1));
+                continue;
+            }
+
+            //send outside of the lock
+            const TimerEntry entry = queue.begin()->second;
+            queue.erase(queue.begin());
+            lock.unlock();
+            entry();
+            lock.lock();
+        }
+    }
+
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    TimerQueue queue;
+};
+
+static TimerService &get_timer_service(void)
+{
+    //leaked on purpose: the detached thread outlives static destruction
+    static TimerService *service = new TimerService();
+    return *service;
+}
+
+template <typename MessageType>
+static void send_message(const ThreadPool &thread_pool, const Theron::Address &address)
+{
+    thread_pool->Send(MessageType(), Theron::Address::Null(), address);
+}
+
+void gras::schedule_self_kick(
+    const ThreadPool &thread_pool,
+    const Theron::Address &address,
+    const time_ticks_t when
+){
+    get_timer_service().schedule(boost::bind(&send_message<SelfKickMessage>, thread_pool, address), when);
+}
+
+void gras::schedule_input_grace(
+    const ThreadPool &thread_pool,
+    const Theron::Address &address,
+    const time_ticks_t when
+){
+    get_timer_service().schedule(boost::bind(&send_message<InputGraceMessage>, thread_pool, address), when);
+}
@@ -2,7 +2,9 @@
 
 #include "element_impl.hpp"
 #include <gras/top_block.hpp>
-#include <boost/thread/thread.hpp> //sleep
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <iterator>
 
 using namespace gras;
 
@@ -16,6 +18,7 @@ TopBlock::TopBlock(const std::string &name):
 {
     (*this)->executor.reset(new Apology::Executor((*this)->topology.get()));
     (*this)->token = Token::make();
+    (*this)->token_signal.reset(new TokenSignal());
     (*this)->thread_group = SharedThreadGroup(new boost::thread_group());
 }
 
@@ -36,10 +39,111 @@ void TopBlock::commit_config(void)
     HierBlock::commit_config();
 }
 
+void ElementImpl::record_commit(void)
+{
+    this->committed_flows.clear();
+    BOOST_FOREACH(const Apology::Flow &flow, this->topology->get_flat_flows())
+    {
+        FlatFlow f;
+        f.src = dynamic_cast<const Apology::Worker *>(flow.src.elem);
+        f.src_index = flow.src.index;
+        f.dst = dynamic_cast<const Apology::Worker *>(flow.dst.elem);
+        f.dst_index = flow.dst.index;
+        this->committed_flows.insert(f);
+    }
+
+    this->committed_workers.clear();
+    BOOST_FOREACH(Apology::Worker *w, this->topology->get_workers())
+    {
+        this->committed_workers.insert(w);
+    }
+
+    this->committed_config = this->global_config;
+}
+
+static bool same_config(const GlobalBlockConfig &a, const GlobalBlockConfig &b)
+{
+    return
+        a.maximum_output_items == b.maximum_output_items and
+        a.buffer_affinity == b.buffer_affinity and
+        a.interruptible_work == b.interruptible_work and
+        a.thread_pool == b.thread_pool and
+        a.maximum_items_per_sec == b.maximum_items_per_sec;
+}
+
 void TopBlock::commit(void)
 {
     this->commit_config();
-    this->start(); //ok to re-start, means update
+
+    //nothing to diff against yet, or every block needs the new config
+    if ((*this)->committed_workers.empty() or
+        not same_config((*this)->committed_config, (*this)->global_config))
+    {
+        this->start(); //ok to re-start, means update
+        return;
+    }
+
+    (*this)->executor->commit();
+    const std::set<FlatFlow> old_flows = (*this)->committed_flows;
+    const std::set<const Apology::Worker *> old_workers = (*this)->committed_workers;
+    (*this)->record_commit();
+
+    //flows that appeared or went away since the last commit
+    std::vector<FlatFlow> changed;
+    std::set_symmetric_difference(
+        old_flows.begin(), old_flows.end(),
+        (*this)->committed_flows.begin(), (*this)->committed_flows.end(),
+        std::back_inserter(changed));
+
+    //blocks new to the topology (or restarted) get the full treatment,
+    //other blocks only touch the ports on the ends of changed flows
+    std::map<const Apology::Worker *, Apology::Worker *> current;
+    std::map<Apology::Worker *, TopPortSelection> affected;
+    std::map<Apology::Worker *, TopThreadMessage> thread_msgs;
+    std::map<Apology::Worker *, TopConfigMessage> config_msgs;
+    BOOST_FOREACH(Apology::Worker *w, (*this)->topology->get_workers())
+    {
+        current[w] = w;
+        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
+        if (old_workers.count(w) != 0 and actor->data->block_state == BLOCK_STATE_LIVE) continue;
+        affected[w] = TopPortSelection();
+        thread_msgs[w].thread_group = (*this)->thread_group;
+        config_msgs[w].config = (*this)->global_config;
+    }
+    BOOST_FOREACH(const FlatFlow &f, changed)
+    {
+        if (current.count(f.src) != 0)
+        {
+            Apology::Worker *w = current[f.src];
+            if (affected.count(w) == 0) affected[w].all = false;
+            affected[w].outputs.insert(f.src_index);
+        }
+        if (current.count(f.dst) != 0)
+        {
+            Apology::Worker *w = current[f.dst];
+            if (affected.count(w) == 0) affected[w].all = false;
+            affected[w].inputs.insert(f.dst_index);
+        }
+    }
+
+    //the same phases as start, restricted to the affected blocks
+    std::map<Apology::Worker *, TopTokenMessage> token_msgs;
+    std::map<Apology::Worker *, TopAllocMessage> alloc_msgs;
+    std::map<Apology::Worker *, TopActiveMessage> active_msgs;
+    typedef std::pair<Apology::Worker * const, TopPortSelection> affected_type;
+    BOOST_FOREACH(const affected_type &a, affected)
+    {
+        token_msgs[a.first].token = (*this)->token;
+        token_msgs[a.first].token_signal = (*this)->token_signal;
+        token_msgs[a.first].ports = a.second;
+        alloc_msgs[a.first].ports = a.second;
+        active_msgs[a.first] = TopActiveMessage();
+    }
+    (*this)->send_prio_msgs(thread_msgs);
+    (*this)->send_prio_msgs(token_msgs);
+    (*this)->send_prio_msgs(config_msgs);
+    (*this)->send_prio_msgs(alloc_msgs);
+    (*this)->send_prio_msgs(active_msgs);
 }
 
 void TopBlock::start(void)
@@ -53,6 +157,7 @@ void TopBlock::start(void)
     {
         TopTokenMessage message;
         message.token = (*this)->token;
+        message.token_signal = (*this)->token_signal;
         (*this)->bcast_prio_msg(message);
     }
     {
@@ -67,6 +172,7 @@ void TopBlock::start(void)
     {
         (*this)->bcast_prio_msg(TopActiveMessage());
     }
+    (*this)->record_commit();
 }
 
 void TopBlock::stop(void)
@@ -84,15 +190,28 @@ void TopBlock::run(void)
     this->wait();
 }
 
-GRAS_FORCE_INLINE void wait_thread_yield(void)
+//poll interval for the lockup debug print, blocks notify the token signal when done
+static const boost::posix_time::time_duration CHECK_DONE_INTERVAL = boost::posix_time::milliseconds(100);
+
+//loop through blocks looking for non-done blocks with done inputs,
+//mark done the ones whose grace period ran out before wait() began
+//(blocks get a grace timer of their own, this catches the stragglers)
+static void check_done_inputs(ElementImpl &impl, const bool lockup_debug, bool &has_a_done)
 {
-    //boost::this_thread::yield();
-    boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    BOOST_FOREACH(Apology::Worker *w, impl.topology->get_workers())
+    {
+        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
+        if (actor->data->block_state == BLOCK_STATE_DONE) has_a_done = true;
+        if (actor->data->inputs_done.size() and actor->data->inputs_done.any())
+        {
+            if ((not lockup_debug) and (time_now() >= actor->data->input_grace_deadline))
+            {
+                actor->GetFramework().Send(TopInertMessage(), Theron::Address::Null(), actor->GetAddress());
+            }
+        }
+    }
 }
 
-static const boost::posix_time::time_duration CHECK_DONE_INTERVAL = boost::posix_time::milliseconds(100);
-static const boost::posix_time::time_duration INPUT_DONE_GRACE_PERIOD = boost::posix_time::milliseconds(100);
-
 void TopBlock::wait(void)
 {
     //We do not need to join "special" threads;
@@ -103,40 +222,45 @@ void TopBlock::wait(void)
 
     //QA lockup detection setup
     bool lockup_debug = getenv("GRAS_LOCKUP_DEBUG") != NULL;
-    boost::system_time check_done_time = boost::get_system_time();
     bool has_a_done = false;
 
-    //wait for all blocks to release the token
+    //the grace timers only mark blocks done while someone waits,
+    //unless lockup debug wants to see the stuck topology instead
+    TokenSignal &signal = *(*this)->token_signal;
+    boost::mutex::scoped_lock lock(signal.mutex);
+    signal.waiting = not lockup_debug;
+    lock.unlock();
+    check_done_inputs(**this, lockup_debug, has_a_done);
+    lock.lock();
+
+    //wait for all blocks to release the token,
+    //the grace timers and the scan above take care of done inputs
     while (not (*this)->token.unique())
     {
-        wait_thread_yield();
-
-        //determine if we should check on the done status
-        if (boost::get_system_time() < check_done_time) continue;
-        check_done_time += CHECK_DONE_INTERVAL;
-
-        //optional dot print to understand lockup condition
-        if (has_a_done and lockup_debug)
+        if (not lockup_debug)
         {
-            std::cerr << TopBlock::query("{\"path\":\"/topology.dot\"}") << std::endl;
-            lockup_debug = false;
+            signal.cond.wait(lock);
+            continue;
         }
+        if (signal.cond.timed_wait(lock, CHECK_DONE_INTERVAL)) continue;
+        lock.unlock();
 
-        //loop through blocks looking for non-done blocks with done inputs
-        BOOST_FOREACH(Apology::Worker *w, (*this)->topology->get_workers())
+        //optional dot print to understand lockup condition,
+        //then let the grace periods finish the blocks as usual
+        check_done_inputs(**this, lockup_debug, has_a_done);
+        if (has_a_done)
         {
-            BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
-            if (actor->data->block_state == BLOCK_STATE_DONE) has_a_done = true;
-            if (actor->data->inputs_done.size() and actor->data->inputs_done.any())
-            {
-                const boost::system_time grace_over = actor->data->first_input_done_time + INPUT_DONE_GRACE_PERIOD;
-                if ((not lockup_debug) and (boost::get_system_time() > grace_over))
-                {
-                    actor->GetFramework().Send(TopInertMessage(), Theron::Address::Null(), actor->GetAddress());
-                }
-            }
+            std::cerr << TopBlock::query("{\"path\":\"/topology.dot\"}") << std::endl;
+            lockup_debug = false;
+            lock.lock();
+            signal.waiting = true;
+            lock.unlock();
+            check_done_inputs(**this, lockup_debug, has_a_done);
         }
+        lock.lock();
     }
+
+    signal.waiting = false;
 }
 
 bool TopBlock::wait(const double timeout)
@@ -145,9 +269,11 @@ bool TopBlock::wait(const double timeout)
         boost::posix_time::microseconds(long(timeout*1e6));
 
     //wait for all blocks to release the token
-    while (not (*this)->token.unique() or boost::get_system_time() < exit_time)
+    TokenSignal &signal = *(*this)->token_signal;
+    boost::mutex::scoped_lock lock(signal.mutex);
+    while (not (*this)->token.unique())
     {
-        wait_thread_yield();
+        if (not signal.cond.timed_wait(lock, exit_time)) break;
     }
 
     return (*this)->token.unique();
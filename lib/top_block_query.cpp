@@ -2,6 +2,9 @@
 
 #include "gras_impl/query_common.hpp"
 #include "element_impl.hpp"
+#include <gras_impl/jit_factory_stats.hpp>
+#include <gras_impl/module_loader.hpp>
+#include <gras/thread_budget.hpp>
 #include <boost/foreach.hpp>
 #include <boost/format.hpp>
 #include <Theron/DefaultAllocator.h>
@@ -12,21 +15,6 @@ using namespace gras;
 
 using namespace boost::property_tree;
 
-struct GetStatsReceiver : Theron::Receiver
-{
-    GetStatsReceiver(void)
-    {
-        this->RegisterHandler(this, &GetStatsReceiver::handle_get_stats);
-    }
-
-    void handle_get_stats(const GetStatsMessage &message, const Theron::Address)
-    {
-        this->messages.push_back(message);
-    }
-
-    std::vector<GetStatsMessage> messages;
-};
-
 static ptree query_blocks(ElementImpl *self, const ptree &)
 {
     ptree root;
@@ -58,25 +46,6 @@ static ptree query_stats(ElementImpl *self, const ptree &query)
         }
     }
 
-    //get stats with custom receiver and set high prio
-    GetStatsReceiver receiver;
-    size_t outstandingCount(0);
-    BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
-    {
-        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
-
-        //filter workers not needed in query
-        const std::string id = actor->data->block->get_uid();
-        if (std::find(block_ids.begin(), block_ids.end(), id) == block_ids.end()) continue;
-
-        //send a message to the block's actor to query stats
-        GetStatsMessage message;
-        message.prio_token = actor->prio_token;
-        actor->GetFramework().Send(message, receiver.GetAddress(), actor->GetAddress());
-        outstandingCount++;
-    }
-    while (outstandingCount) outstandingCount -= receiver.Wait(outstandingCount);
-
     //create root level node
     ptree root;
     root.put("now", time_now());
@@ -111,14 +80,28 @@ static ptree query_stats(ElementImpl *self, const ptree &query)
     }
     root.push_back(std::make_pair("thread_pools", tp_e));
 
+    //helper threads shared by blocks that parallelize within work
+    root.put("thread_budget_capacity", ThreadBudget::capacity());
+    root.put("thread_budget_available", ThreadBudget::available());
+
     //iterate through blocks
     ptree blocks;
-    BOOST_FOREACH(const GetStatsMessage &message, receiver.messages)
+    BOOST_FOREACH(Apology::Worker *w, self->topology->get_workers())
     {
-        const BlockStats &stats = message.stats;
+        BlockActor *actor = dynamic_cast<BlockActor *>(w->get_actor());
+
+        //filter workers not needed in query
+        const std::string id = actor->data->block->get_uid();
+        if (std::find(block_ids.begin(), block_ids.end(), id) == block_ids.end()) continue;
+
+        //read the snapshot published by the actor, no messaging involved
+        BlockStats stats;
+        time_ticks_t stats_time;
+        actor->data->stats_snapshot.read(stats, stats_time);
+
         ptree block;
         block.put("tps", time_tps());
-        block.put("stats_time", message.stats_time);
+        block.put("stats_time", stats_time);
         block.put("init_time", stats.init_time);
         block.put("start_time", stats.start_time);
         block.put("stop_time", stats.stop_time);
@@ -130,6 +113,11 @@ static ptree query_stats(ElementImpl *self, const ptree &query)
         block.put("total_time_input", stats.total_time_input);
         block.put("total_time_output", stats.total_time_output);
         block.put("actor_queue_depth", stats.actor_queue_depth);
+        block.put("rate_target", stats.rate_target);
+        block.put("rate_start_time", stats.rate_start_time);
+        block.put("rate_items", stats.rate_items);
+        block.put("rate_wait_count", stats.rate_wait_count);
+        block.put("threads_granted", ThreadBudget::granted(id));
         #define my_block_ptree_append(l) { \
             ptree e; \
             for (size_t i = 0; i < stats.l.size(); i++) { \
@@ -150,12 +138,37 @@ static ptree query_stats(ElementImpl *self, const ptree &query)
         my_block_ptree_append(bytes_copied);
         my_block_ptree_append(inputs_idle);
         my_block_ptree_append(outputs_idle);
-        blocks.push_back(std::make_pair(message.block_id, block));
+        blocks.push_back(std::make_pair(id, block));
     }
     root.push_back(std::make_pair("blocks", blocks));
     return root;
 }
 
+static ptree query_jit(ElementImpl *, const ptree &)
+{
+    const JITFactoryStats stats = get_jit_factory_stats();
+    ptree root;
+    root.put("tps", time_tps());
+    root.put("compile_count", stats.compile_count);
+    root.put("cache_hit_count", stats.cache_hit_count);
+    root.put("memory_hit_count", stats.memory_hit_count);
+    root.put("total_compile_time", stats.total_compile_time);
+    return root;
+}
+
+static ptree query_modules(ElementImpl *, const ptree &)
+{
+    const ModuleLoaderStats stats = get_module_loader_stats();
+    ptree root;
+    root.put("tps", time_tps());
+    root.put("eager_load_count", stats.eager_load_count);
+    root.put("lazy_load_count", stats.lazy_load_count);
+    root.put("indexed_path_count", stats.indexed_path_count);
+    root.put("startup_time", stats.startup_time);
+    root.put("lazy_load_time", stats.lazy_load_time);
+    return root;
+}
+
 static ptree query_calls(ElementImpl *self, const ptree &query)
 {
     ptree root;
@@ -272,5 +285,7 @@ std::string TopBlock::query(const std::string &args)
     if (path == "/blocks.json") result = query_blocks(this->get(), query);
     if (path == "/stats.json") result = query_stats(this->get(), query);
     if (path == "/calls.json") result = query_calls(this->get(), query);
+    if (path == "/jit.json") result = query_jit(this->get(), query);
+    if (path == "/modules.json") result = query_modules(this->get(), query);
     return ptree_to_json(result);
 }
@@ -90,5 +90,7 @@ void BlockActor::handle_topology(
         this->handle_output_update(message, Theron::Address());
     }
 
+    this->publish_stats();
+
     this->Send(0, from); //ACK
 }
@@ -79,7 +79,7 @@ void
     ctaps[i] = d_proto_taps[i] * exp (gr_complex (0, i * fwT0));
 
   d_composite_fir->set_taps (gr_reverse(ctaps));
-  d_r.set_phase_incr (exp (gr_complex (0, fwT0 * decimation ())));
+  d_r.set_freq (2 * M_PI * d_center_freq / d_sampling_freq * decimation ());
 }
 
 void
@@ -115,9 +115,10 @@ int
 
   unsigned j = 0;
   for (int i = 0; i < noutput_items; i++){
-    out[i] = d_r.rotate (d_composite_fir->filter (&in[j]));
+    out[i] = d_composite_fir->filter (&in[j]);
     j += decimation ();
   }
+  d_r.rotate (out, out, noutput_items);
 
   return noutput_items;
 }
@@ -31,7 +31,7 @@
 
 #include <gr_core_api.h>
 #include <gr_sync_decimator.h>
-#include <gr_rotator.h>
+#include <gri_nco_engine.h>
 
 class @NAME@;
 typedef boost::shared_ptr<@NAME@> @SPTR_NAME@;
@@ -81,7 +81,7 @@ class GR_CORE_API @NAME@ : public gr_sync_decimator
  protected:
   std::vector<@TAP_TYPE@>	d_proto_taps;
   @FIR_TYPE@		       *d_composite_fir;
-  gr_rotator			d_r;
+  gri_nco_engine		d_r;
   double			d_center_freq;
   double			d_sampling_freq;
   bool				d_updated;
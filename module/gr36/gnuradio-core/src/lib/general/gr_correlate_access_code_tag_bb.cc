@@ -27,8 +27,8 @@
 #include <gr_correlate_access_code_tag_bb.h>
 #include <gr_io_signature.h>
 #include <stdexcept>
-#include <gr_count_bits.h>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 
 #define VERBOSE 0
@@ -46,8 +46,7 @@ gr_correlate_access_code_tag_bb::gr_correlate_access_code_tag_bb (
   : gr_sync_block ("correlate_access_code_tag_bb",
 		   gr_make_io_signature (1, 1, sizeof(char)),
 		   gr_make_io_signature (1, 1, sizeof(char))),
-    d_data_reg(0), d_mask(0),
-    d_threshold(threshold), d_len(0)
+    d_correlator(threshold)
 
 {
   if (!set_access_code(access_code)){
@@ -69,21 +68,7 @@ bool
 gr_correlate_access_code_tag_bb::set_access_code(
   const std::string &access_code)
 {
-  d_len = access_code.length();	// # of bytes in string
-  if (d_len > 64)
-    return false;
-
-  // set len top bits to 1.
-  d_mask = ((~0ULL) >> (64 - d_len)) << (64 - d_len);
-
-  d_access_code = 0;
-  for (unsigned i=0; i < 64; i++){
-    d_access_code <<= 1;
-    if (i < d_len)
-      d_access_code |= access_code[i] & 1;	// look at LSB only
-  }
-
-  return true;
+  return d_correlator.set_access_code(access_code);
 }
 
 int
@@ -96,34 +81,21 @@ gr_correlate_access_code_tag_bb::work (int noutput_items,
 
   uint64_t abs_out_sample_cnt = nitems_written(0);
 
-  for (int i = 0; i < noutput_items; i++){
-
-    out[i] = in[i];
+  memcpy(out, in, noutput_items);
 
-    // compute hamming distance between desired access code and current data
-    unsigned long long wrong_bits = 0;
-    unsigned int nwrong = d_threshold+1;
-    int new_flag = 0;
+  // tag the sample just past each access code with up to threshold errors
+  d_matches.clear();
+  d_correlator.search(in, noutput_items, d_matches);
 
-    wrong_bits  = (d_data_reg ^ d_access_code) & d_mask;
-    nwrong = gr_count_bits64(wrong_bits);
-
-    // test for access code with up to threshold errors
-    new_flag = (nwrong <= d_threshold);
-
-    // shift in new data and new flag
-    d_data_reg = (d_data_reg << 1) | (in[i] & 0x1);
-    if (new_flag) {
-      if(VERBOSE) std::cout << "writing tag at sample " << abs_out_sample_cnt + i << std::endl;
-      add_item_tag(0, //stream ID
-	    abs_out_sample_cnt + i - 64 + d_len, //sample
-	    d_key,      //frame info
-	    pmt::pmt_t(), //data (unused)
-        d_me        //block src id
-      );
-    }
+  for (size_t i = 0; i < d_matches.size(); i++){
+    if(VERBOSE) std::cout << "writing tag at sample " << abs_out_sample_cnt + d_matches[i] << std::endl;
+    add_item_tag(0, //stream ID
+	  abs_out_sample_cnt + d_matches[i], //sample
+	  d_key,      //frame info
+	  pmt::pmt_t(), //data (unused)
+	  d_me        //block src id
+    );
   }
 
   return noutput_items;
 }
-
@@ -25,7 +25,9 @@
 
 #include <gr_core_api.h>
 #include <gr_sync_block.h>
+#include <gri_access_code_correlator.h>
 #include <string>
+#include <vector>
 
 class gr_correlate_access_code_tag_bb;
 typedef boost::shared_ptr<gr_correlate_access_code_tag_bb> gr_correlate_access_code_tag_bb_sptr;
@@ -56,13 +58,8 @@ class GR_CORE_API gr_correlate_access_code_tag_bb : public gr_sync_block
   gr_make_correlate_access_code_tag_bb (const std::string &access_code, int threshold,
 					const std::string &tag_name);
  private:
-  unsigned long long d_access_code;	// access code to locate start of packet
-                                        //   access code is left justified in the word
-  unsigned long long d_data_reg;	// used to look for access_code
-  unsigned long long d_mask;		// masks access_code bits (top N bits are set where
-                                        //   N is the number of bits in the access code)
-  unsigned int	     d_threshold;	// how many bits may be wrong in sync vector
-  unsigned int       d_len;         //the length of the access code
+  gri_access_code_correlator d_correlator;
+  std::vector<int> d_matches;
 
   pmt::pmt_t d_key, d_me; //d_key is the tag name, d_me is the block name + unique ID
 
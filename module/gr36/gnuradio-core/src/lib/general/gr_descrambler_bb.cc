@@ -49,8 +49,7 @@ gr_descrambler_bb::work(int noutput_items,
   const unsigned char *in = (const unsigned char *) input_items[0];
   unsigned char *out = (unsigned char *) output_items[0];
 
-  for (int i = 0; i < noutput_items; i++)
-    out[i] = d_lfsr.next_bit_descramble(in[i]);
+  d_lfsr.next_bits_descramble(out, in, noutput_items);
 
   return noutput_items;
 }
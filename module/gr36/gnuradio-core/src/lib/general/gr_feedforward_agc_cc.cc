@@ -26,6 +26,8 @@
 
 #include <gr_feedforward_agc_cc.h>
 #include <gr_io_signature.h>
+#include <gri_agc_engine.h>
+#include <algorithm>
 #include <stdexcept>
 
 gr_feedforward_agc_cc_sptr
@@ -50,25 +52,6 @@ gr_feedforward_agc_cc::~gr_feedforward_agc_cc()
 {
 }
 
-inline static float
-mag_squared(gr_complex x)
-{
-  return x.real() * x.real() + x.imag() * x.imag();
-}
-
-// approximate sqrt(x^2 + y^2)
-inline static float
-envelope(gr_complex x)
-{
-  float r_abs = std::fabs(x.real());
-  float i_abs = std::fabs(x.imag());
-
-  if (r_abs > i_abs)
-    return r_abs + 0.4 * i_abs;
-  else
-    return i_abs + 0.4 * r_abs;
-}
-
 int
 gr_feedforward_agc_cc::work(int noutput_items,
 			    gr_vector_const_void_star &input_items,
@@ -76,16 +59,25 @@ gr_feedforward_agc_cc::work(int noutput_items,
 {
   const gr_complex *in = (const gr_complex *) input_items[0];
   gr_complex *out = (gr_complex *) output_items[0];
-  int	nsamples = d_nsamples;
-  float gain;
+  const size_t n = noutput_items;
+  const size_t len = n + d_nsamples - 1;
+
+  if (d_env.size() < len) {
+    d_env.resize(len);
+    d_scratch.resize(2*len);
+  }
+  if (d_gains.size() < n)
+    d_gains.resize(n);
+
+  // the max of the envelope over the nsamples window starting at each
+  // output, in O(1) per output whatever nsamples is
+  gri_agc_engine::envelope(&d_env[0], in, len);
+  gri_agc_engine::window_max(&d_gains[0], &d_env[0], n, d_nsamples, &d_scratch[0]);
 
-  for (int i = 0; i < noutput_items; i++){
-    //float max_env = 1e-12;	// avoid divide by zero
-    float max_env = 1e-4;	// avoid divide by zero, indirectly set max gain
-    for (int j = 0; j < nsamples; j++)
-      max_env = std::max(max_env, envelope(in[i+j]));
-    gain = d_reference / max_env;
-    out[i] = gain * in[i];
+  for (size_t i = 0; i < n; i++){
+    float max_env = std::max(d_gains[i], 1e-4f);	// avoid divide by zero, indirectly set max gain
+    d_gains[i] = d_reference / max_env;
   }
+  gri_agc_engine::apply(out, in, &d_gains[0], n);
   return noutput_items;
 }
@@ -27,11 +27,23 @@
 
 #include <gr_fmdet_cf.h>
 #include <gr_io_signature.h>
+#include <algorithm>
 #include <math.h>
-#include <gr_math.h>
 
 #define M_TWOPI (2*M_PI)
 
+// Slope of the phase at S2 from the samples two either side of it,
+// normalized by the power at S2. The differentiator was written as
+// -S0+8*S1-8*S1+S4; the S1 terms cancel.
+static inline float
+slope_detect (const gr_complex &S0, const gr_complex &S2, const gr_complex &S4,
+	      float scl)
+{
+  const gr_complex Sdot = scl * (S4 - S0);
+  return (S2.real()*Sdot.imag()-S2.imag()*Sdot.real())/
+    (S2.real()*S2.real()+S2.imag()*S2.imag());
+}
+
 gr_fmdet_cf_sptr
 gr_make_fmdet_cf (float samplerate, float freq_low, float freq_high, float scl)
 {
@@ -73,33 +85,25 @@ gr_fmdet_cf::work (int noutput_items,
 {
   const gr_complex *iptr = (gr_complex *) input_items[0];
   float *optr = (float *) output_items[0];
-  //  const gr_complex *scaleiptr = (gr_complex *) input_items[0];
-
-  int	size = noutput_items;
-
-  gr_complex Sdot,S0,S1=d_S1,S2=d_S2,S3=d_S3,S4=d_S4;
-  float d_8 = 8.0;
-
-  while (size-- > 0) {
-    S0=*iptr++;
-
-
-    Sdot = d_scl * (-S0+d_8*S1-d_8*S1+S4);
-
-    d_freq = (S2.real()*Sdot.imag()-S2.imag()*Sdot.real())/
-      (S2.real()*S2.real()+S2.imag()*S2.imag());
-
-    S4=S3;
-    S3=S2;
-    S2=S1;
-    S1=S0;
-
 
-    *optr++ = d_freq-d_bias;
-  }
-  d_S1=S1;
-  d_S2=S2;
-  d_S3=S3;
-  d_S4=S4;
+  // The first four outputs reach back into the previous call through
+  // the saved samples. Past those every output depends only on the
+  // input, so the main loop carries nothing from one sample to the
+  // next and the compiler is free to vectorize it.
+  gr_complex head[8] = { d_S4, d_S3, d_S2, d_S1 };
+  const int nhead = std::min (noutput_items, 4);
+  for (int i = 0; i < nhead; i++)
+    head[4+i] = iptr[i];
+  for (int i = 0; i < nhead; i++)
+    optr[i] = slope_detect (head[4+i], head[2+i], head[i], d_scl) - d_bias;
+
+  for (int i = 4; i < noutput_items; i++)
+    optr[i] = slope_detect (iptr[i], iptr[i-2], iptr[i-4], d_scl) - d_bias;
+
+  const gr_complex *tail = (noutput_items >= 4) ? iptr + noutput_items - 4 : head + noutput_items;
+  d_S4 = tail[0];
+  d_S3 = tail[1];
+  d_S2 = tail[2];
+  d_S1 = tail[3];
   return noutput_items;
 }
@@ -50,7 +50,7 @@ class GR_CORE_API gr_fmdet_cf : public gr_sync_block
 					    float freq_high, float scl);
 
   gr_complex d_S1,d_S2,d_S3,d_S4;
-  float d_freq,d_freqlo,d_freqhi,d_scl,d_bias;
+  float d_freqlo,d_freqhi,d_scl,d_bias;
   gr_fir_ccf* d_filter;
   gr_fmdet_cf (float samplerate, float freq_low, float freq_high, float scl);
 
@@ -26,9 +26,9 @@
 
 #include <gr_frequency_modulator_fc.h>
 #include <gr_io_signature.h>
-#include <gr_fxpt.h>
+#include <volk/volk.h>
+#include <algorithm>
 #include <math.h>
-#include <boost/math/special_functions/trunc.hpp>
 
 
 gr_frequency_modulator_fc_sptr gr_make_frequency_modulator_fc (double sensitivity)
@@ -52,19 +52,26 @@ gr_frequency_modulator_fc::work (int noutput_items,
   const float *in = (const float *) input_items[0];
   gr_complex *out = (gr_complex *) output_items[0];
 
-  for (int i = 0; i < noutput_items; i++){
-    d_phase = d_phase + d_sensitivity * in[i];
+  // the phase recursion is serial, the sin/cos of a chunk of it is not
+  float phase[CHUNK_SIZE], oi[CHUNK_SIZE], oq[CHUNK_SIZE];
 
-    while (d_phase > (float)(M_PI))
-      d_phase -= (float)(2.0 * M_PI);
-    while (d_phase < (float)(-M_PI))
-      d_phase += (float)(2.0 * M_PI);
+  for (int i = 0; i < noutput_items; i += CHUNK_SIZE){
+    const int n = std::min (noutput_items - i, (int) CHUNK_SIZE);
 
-    float oi, oq;
+    for (int k = 0; k < n; k++){
+      d_phase = d_phase + d_sensitivity * in[i+k];
 
-    gr_int32 angle = gr_fxpt::float_to_fixed (d_phase);
-    gr_fxpt::sincos (angle, &oq, &oi);
-    out[i] = gr_complex (oi, oq);
+      while (d_phase > M_PI)
+	d_phase -= 2.0 * M_PI;
+      while (d_phase < -M_PI)
+	d_phase += 2.0 * M_PI;
+
+      phase[k] = (float) d_phase;
+    }
+
+    volk_32f_sincos_32f_x2 (oq, oi, phase, n);
+    for (int k = 0; k < n; k++)
+      out[i+k] = gr_complex (oi[k], oq[k]);
   }
 
   return noutput_items;
@@ -39,8 +39,10 @@ GR_CORE_API gr_frequency_modulator_fc_sptr gr_make_frequency_modulator_fc (doubl
  */
 class GR_CORE_API gr_frequency_modulator_fc : public gr_sync_block
 {
+  enum { CHUNK_SIZE = 256 };
+
   float	d_sensitivity;
-  float	d_phase;
+  double	d_phase;
 
   friend GR_CORE_API gr_frequency_modulator_fc_sptr
   gr_make_frequency_modulator_fc (double sensitivity);
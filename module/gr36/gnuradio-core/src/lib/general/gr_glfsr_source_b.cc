@@ -66,15 +66,17 @@ gr_glfsr_source_b::work(int noutput_items,
   if ((d_index > d_length) && d_repeat == false)
     return -1; /* once through the sequence */
 
-  int i;
-  for (i = 0; i < noutput_items; i++) {
-    out[i] = d_glfsr->next_bit();
+  // the last bit of a single pass is generated but not counted
+  int n = noutput_items;
+  if (d_repeat == false && d_length - d_index < (unsigned int)n) {
+    n = d_length - d_index;
     d_index++;
-    if (d_index > d_length && d_repeat == false)
-      break;
   }
 
-  return i;
+  d_glfsr->next_bits((unsigned char *)out, n);
+  d_index += n;
+
+  return n;
 }
 
 int
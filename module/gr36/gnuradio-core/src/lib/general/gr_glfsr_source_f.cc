@@ -29,6 +29,7 @@
 #include <gri_glfsr.h>
 #include <gr_io_signature.h>
 #include <stdexcept>
+#include <algorithm>
 
 gr_glfsr_source_f_sptr
 gr_make_glfsr_source_f(int degree, bool repeat, int mask, int seed)
@@ -66,15 +67,23 @@ gr_glfsr_source_f::work(int noutput_items,
   if ((d_index > d_length) && d_repeat == false)
     return -1; /* once through the sequence */
 
-  int i;
-  for (i = 0; i < noutput_items; i++) {
-    out[i] = (float)d_glfsr->next_bit()*2.0-1.0;
+  // the last bit of a single pass is generated but not counted
+  int n = noutput_items;
+  if (d_repeat == false && d_length - d_index < (unsigned int)n) {
+    n = d_length - d_index;
     d_index++;
-    if (d_index > d_length && d_repeat == false)
-      break;
   }
 
-  return i;
+  unsigned char bits[1024];
+  for (int i = 0; i < n; i += sizeof(bits)) {
+    const int nbits = std::min(n - i, (int)sizeof(bits));
+    d_glfsr->next_bits(bits, nbits);
+    for (int j = 0; j < nbits; j++)
+      out[i+j] = (float)bits[j]*2.0-1.0;
+  }
+  d_index += n;
+
+  return n;
 }
 
 int
@@ -27,6 +27,8 @@
 #include <gr_sincos.h>
 #include <cmath>
 #include <gr_complex.h>
+#include <gri_nco_engine.h>
+#include <algorithm>
 
 /*!
  * \brief base class template for Numerically Controlled Oscillator (NCO)
@@ -39,7 +41,7 @@
 template<class o_type, class i_type>
 class gr_nco {
 public:
-  gr_nco () : phase (0), phase_inc(0) {}
+  gr_nco () : phase (0), phase_inc(0), d_engine_phase(0) {}
 
   virtual ~gr_nco () {}
 
@@ -115,6 +117,25 @@ public:
 protected:
   double phase;
   double phase_inc;
+
+private:
+  // the block methods run on a fixed point engine; its accumulator is
+  // only reloaded from phase when someone else moved phase in between,
+  // so consecutive blocks stay exact
+  gri_nco_engine d_engine;
+  double d_engine_phase;
+
+  void engine_load ()
+  {
+    if (phase != d_engine_phase)
+      d_engine.set_phase (phase);
+    d_engine.set_freq (phase_inc);
+  }
+
+  void engine_store ()
+  {
+    phase = d_engine_phase = d_engine.get_phase ();
+  }
 };
 
 template<class o_type, class i_type>
@@ -128,46 +149,61 @@ template<class o_type, class i_type>
 void
 gr_nco<o_type,i_type>::sin (float *output, int noutput_items, double ampl)
 {
-  for (int i = 0; i < noutput_items; i++){
-    output[i] = (float)(sin () * ampl);
-    step ();
-  }
+  engine_load ();
+  d_engine.sin (output, noutput_items, (float) ampl);
+  engine_store ();
 }
 
 template<class o_type, class i_type>
 void
 gr_nco<o_type,i_type>::cos (float *output, int noutput_items, double ampl)
 {
-  for (int i = 0; i < noutput_items; i++){
-    output[i] = (float)(cos () * ampl);
-    step ();
-  }
+  engine_load ();
+  d_engine.cos (output, noutput_items, (float) ampl);
+  engine_store ();
 }
 
 template<class o_type, class i_type>
 void
 gr_nco<o_type,i_type>::sin (short *output, int noutput_items, double ampl)
 {
-  for (int i = 0; i < noutput_items; i++){
-    output[i] = (short)(sin() * ampl);
-    step ();
+  float buf[gri_nco_engine::BLOCK_SIZE * 4];
+
+  engine_load ();
+  while (noutput_items > 0){
+    int n = std::min (noutput_items, (int)(sizeof (buf) / sizeof (buf[0])));
+    d_engine.sin (buf, n);
+    for (int i = 0; i < n; i++)
+      output[i] = (short)(buf[i] * ampl);
+    output += n;
+    noutput_items -= n;
   }
+  engine_store ();
 }
 
 template<class o_type, class i_type>
 void
 gr_nco<o_type,i_type>::cos (short *output, int noutput_items, double ampl)
 {
-  for (int i = 0; i < noutput_items; i++){
-    output[i] = (short)(cos () * ampl);
-    step ();
+  float buf[gri_nco_engine::BLOCK_SIZE * 4];
+
+  engine_load ();
+  while (noutput_items > 0){
+    int n = std::min (noutput_items, (int)(sizeof (buf) / sizeof (buf[0])));
+    d_engine.cos (buf, n);
+    for (int i = 0; i < n; i++)
+      output[i] = (short)(buf[i] * ampl);
+    output += n;
+    noutput_items -= n;
   }
+  engine_store ();
 }
 
 template<class o_type, class i_type>
 void
 gr_nco<o_type,i_type>::sin (int *output, int noutput_items, double ampl)
 {
+  // float carries too few bits for full scale int output
   for (int i = 0; i < noutput_items; i++){
     output[i] = (int)(sin () * ampl);
     step ();
@@ -178,6 +214,7 @@ template<class o_type, class i_type>
 void
 gr_nco<o_type,i_type>::cos (int *output, int noutput_items, double ampl)
 {
+  // float carries too few bits for full scale int output
   for (int i = 0; i < noutput_items; i++){
     output[i] = (int)(cos () * ampl);
     step ();
@@ -188,11 +225,8 @@ template<class o_type, class i_type>
 void
 gr_nco<o_type,i_type>::sincos (gr_complex *output, int noutput_items, double ampl)
 {
-  for (int i = 0; i < noutput_items; i++){
-    float cosx, sinx;
-    sincos (&sinx, &cosx);
-    output[i] = gr_complex(cosx * ampl, sinx * ampl);
-    step ();
-  }
+  engine_load ();
+  d_engine.sincos (output, noutput_items, (float) ampl);
+  engine_store ();
 }
 #endif /* _NCO_H_ */
@@ -26,8 +26,9 @@
 
 #include <gr_pll_freqdet_cf.h>
 #include <gr_io_signature.h>
+#include <volk/volk.h>
+#include <algorithm>
 #include <math.h>
-#include <gr_math.h>
 
 #ifndef M_TWOPI
 #define M_TWOPI (2.0f*M_PI)
@@ -59,10 +60,8 @@ gr_pll_freqdet_cf::mod_2pi (float in)
 }
 
 float
-gr_pll_freqdet_cf::phase_detector(gr_complex sample,float ref_phase)
+gr_pll_freqdet_cf::phase_detector(float sample_phase,float ref_phase)
 {
-  float sample_phase;
-  sample_phase = gr_fast_atan2f(sample.imag(),sample.real());
   return mod_2pi(sample_phase-ref_phase);
 }
 
@@ -74,17 +73,24 @@ gr_pll_freqdet_cf::work (int noutput_items,
   const gr_complex *iptr = (gr_complex *) input_items[0];
   float *optr = (float *) output_items[0];
 
+  // the phase of each sample doesn't depend on the loop, so it is
+  // taken a chunk at a time ahead of it
+  float sample_phase[CHUNK_SIZE];
   float error;
-  int	size = noutput_items;
 
-  while (size-- > 0) {
-    *optr++ = d_freq;
+  for (int i = 0; i < noutput_items; i += CHUNK_SIZE) {
+    const int n = std::min (noutput_items - i, (int) CHUNK_SIZE);
+    volk_32fc_s32f_atan2_32f (sample_phase, iptr + i, 1.0, n);
 
-    error = phase_detector(*iptr++,d_phase);
+    for (int k = 0; k < n; k++) {
+      *optr++ = d_freq;
 
-    advance_loop(error);
-    phase_wrap();
-    frequency_limit();
+      error = phase_detector(sample_phase[k],d_phase);
+
+      advance_loop(error);
+      phase_wrap();
+      frequency_limit();
+    }
   }
   return noutput_items;
 }
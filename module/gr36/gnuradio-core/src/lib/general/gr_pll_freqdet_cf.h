@@ -54,6 +54,8 @@ class GR_CORE_API gr_pll_freqdet_cf : public gr_sync_block, public gri_control_l
 							float max_freq,
 							float min_freq);
 
+  enum { CHUNK_SIZE = 256 };
+
   float mod_2pi (float in);
   gr_pll_freqdet_cf (float loop_bw, float max_freq, float min_freq);
 
@@ -61,7 +63,7 @@ class GR_CORE_API gr_pll_freqdet_cf : public gr_sync_block, public gri_control_l
 	    gr_vector_const_void_star &input_items,
 	    gr_vector_void_star &output_items);
 private:
-  float phase_detector(gr_complex sample,float ref_phase);
+  float phase_detector(float sample_phase,float ref_phase);
 };
 
 #endif
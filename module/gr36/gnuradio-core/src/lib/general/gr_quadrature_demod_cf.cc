@@ -26,7 +26,7 @@
 
 #include <gr_quadrature_demod_cf.h>
 #include <gr_io_signature.h>
-#include <gr_math.h>
+#include <volk/volk.h>
 
 gr_quadrature_demod_cf::gr_quadrature_demod_cf (float gain)
   : gr_sync_block ("quadrature_demod_cf",
@@ -52,11 +52,9 @@ gr_quadrature_demod_cf::work (int noutput_items,
   float *out = (float *) output_items[0];
   in++;				// ensure that in[-1] is valid
 
-  for (int i = 0; i < noutput_items; i++){
-    gr_complex product = in[i] * conj (in[i-1]);
-    // out[i] = d_gain * arg (product);
-    out[i] = d_gain * gr_fast_atan2f(imag(product), real(product));
-  }
+  // out[i] = d_gain * arg (in[i] * conj (in[i-1]));
+  // in and in-1 are never both aligned
+  volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_u (out, in, in-1, d_gain, noutput_items);
 
   return noutput_items;
 }
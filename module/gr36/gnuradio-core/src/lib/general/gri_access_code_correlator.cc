@@ -0,0 +1,190 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gri_access_code_correlator.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+gri_access_code_correlator::gri_access_code_correlator(unsigned int threshold)
+  : d_code(0), d_len(0), d_threshold(threshold), d_history(0)
+{
+}
+
+bool
+gri_access_code_correlator::set_access_code(const std::string &access_code)
+{
+  if (access_code.length() > 64)
+    return false;
+
+  d_len = access_code.length();
+  d_code = 0;
+  for (unsigned int j = 0; j < d_len; j++)
+    d_code |= (uint64_t)(access_code[j] & 1) << j;
+  return true;
+}
+
+// 64 bits of the packed stream starting at bit pos
+static inline uint64_t
+bits_at(const uint64_t *words, size_t pos)
+{
+  const size_t q = pos >> 6;
+  const unsigned int r = pos & 63;
+  return (words[q] >> r) | ((words[q+1] << 1) << (63 - r));
+}
+
+// word 0 is the history, the input starts at bit 64, two zero words
+// of padding follow
+void
+gri_access_code_correlator::pack(const unsigned char *in, int n)
+{
+  const size_t nwords = 1 + (n + 63) / 64 + 2;
+  if (d_words.size() < nwords)
+    d_words.resize(nwords);
+
+  uint64_t *w = &d_words[1];
+  int i = 0;
+
+#ifdef __SSE2__
+  // bit 0 of each byte up to its sign bit, sixteen at a time
+  for (; i + 64 <= n; i += 64) {
+    uint64_t word = 0;
+    for (int k = 0; k < 4; k++) {
+      const __m128i x = _mm_loadu_si128((const __m128i *)(in + i + 16*k));
+      word |= (uint64_t)(_mm_movemask_epi8(_mm_slli_epi64(x, 7)) & 0xffff) << (16*k);
+    }
+    *w++ = word;
+  }
+#endif
+
+  for (; i < n; i += 64) {
+    uint64_t word = 0;
+    const int m = n - i < 64 ? n - i : 64;
+    for (int k = 0; k < m; k++)
+      word |= (uint64_t)(in[i+k] & 1) << k;
+    *w++ = word;
+  }
+
+  d_words[0] = d_history;
+  *w++ = 0;
+  *w = 0;
+}
+
+void
+gri_access_code_correlator::search(const unsigned char *in, int n,
+                                   std::vector<int> &matches)
+{
+  if (n <= 0)
+    return;
+
+  pack(in, n);
+  const uint64_t *words = &d_words[0];
+
+  // counter bits m with 2^m >= threshold + 1, starting at
+  // 2^m - (threshold + 1) so the carry out marks threshold + 1 errors;
+  // a threshold of 64 already accepts everything
+  const unsigned int thr = d_threshold < 64 ? d_threshold : 64;
+  unsigned int m = 0;
+  while ((1u << m) < thr + 1)
+    m++;
+  const unsigned int start = (1u << m) - (thr + 1);
+
+  // candidate k ends at bit 64 + k of the buffer, so starts at
+  // 64 - len + k
+  const size_t first = 64 - d_len;
+
+  const uint64_t ones = ~(uint64_t)0;
+  int k0 = 0;
+
+#ifdef __SSE2__
+  // two runs of 64 candidates side by side; a shift count of 64
+  // clears the register, so no special case for aligned positions
+  const __m128i all = _mm_set1_epi32(-1);
+  for (; k0 + 64 < n; k0 += 128) {
+    const uint64_t valid[2] = { ones, (n - k0 >= 128) ? ones : (((uint64_t) 1 << (n - k0 - 64)) - 1) };
+    __m128i count[7];
+    for (unsigned int b = 0; b < m; b++)
+      count[b] = ((start >> b) & 1) ? all : _mm_setzero_si128();
+
+    __m128i over = _mm_andnot_si128(_mm_loadu_si128((const __m128i *) valid), all);
+    for (unsigned int j = 0; j < d_len; j++) {
+      const size_t pos = first + k0 + j;
+      const uint64_t *w = words + (pos >> 6);
+      const __m128i r = _mm_cvtsi32_si128(pos & 63);
+      const __m128i l = _mm_cvtsi32_si128(64 - (pos & 63));
+      const __m128i bits = _mm_or_si128(_mm_srl_epi64(_mm_loadu_si128((const __m128i *) w), r),
+                                        _mm_sll_epi64(_mm_loadu_si128((const __m128i *) (w + 1)), l));
+      const __m128i code = ((d_code >> j) & 1) ? all : _mm_setzero_si128();
+      __m128i carry = _mm_xor_si128(bits, code);
+      for (unsigned int b = 0; b < m; b++) {
+        const __m128i t = _mm_and_si128(count[b], carry);
+        count[b] = _mm_xor_si128(count[b], carry);
+        carry = t;
+      }
+      over = _mm_or_si128(over, carry);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi32(over, all)) == 0xffff)
+        break;
+    }
+
+    uint64_t hits[2];
+    _mm_storeu_si128((__m128i *) hits, _mm_andnot_si128(over, all));
+    for (int h = 0; h < 2; h++)
+      if (hits[h])
+        for (int t = 0; t < 64; t++)
+          if ((hits[h] >> t) & 1)
+            matches.push_back(k0 + 64*h + t);
+  }
+#endif
+
+  for (; k0 < n; k0 += 64) {
+    const uint64_t valid = (n - k0 >= 64) ? ones : (((uint64_t) 1 << (n - k0)) - 1);
+    uint64_t count[7];
+    for (unsigned int b = 0; b < m; b++)
+      count[b] = ((start >> b) & 1) ? ones : 0;
+
+    uint64_t over = ~valid;
+    for (unsigned int j = 0; j < d_len && over != ones; j++) {
+      const uint64_t code = ((d_code >> j) & 1) ? ones : 0;
+      uint64_t carry = bits_at(words, first + k0 + j) ^ code;
+      for (unsigned int b = 0; b < m; b++) {
+        const uint64_t t = count[b] & carry;
+        count[b] ^= carry;
+        carry = t;
+      }
+      over |= carry;
+    }
+
+    const uint64_t hits = ~over;
+    if (hits)
+      for (int t = 0; t < 64; t++)
+        if ((hits >> t) & 1)
+          matches.push_back(k0 + t);
+  }
+
+  d_history = bits_at(words, n);
+}
@@ -0,0 +1,86 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_GRI_ACCESS_CODE_CORRELATOR_H
+#define INCLUDED_GRI_ACCESS_CODE_CORRELATOR_H
+
+#include <gr_core_api.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Search an unpacked bit stream for an access code, 64
+ * offsets at a time
+ * \ingroup sync_blk
+ *
+ * The input (one bit per byte, in the LSB) is packed into 64 bit
+ * words. For a run of 64 candidate offsets, code bit j is compared
+ * against one shifted word holding stream bit (offset + j) of every
+ * candidate, and the mismatches go into a bit sliced counter, one
+ * lane per candidate. The counter starts at 2^m - (threshold + 1), so
+ * its carry out flags exactly the candidates with more than threshold
+ * errors; once every lane has carried the run is rejected without
+ * looking at the rest of the code. On random data a run is usually
+ * dismissed after a few code bits per allowed error.
+ *
+ * Bits before the first call count as zeros.
+ */
+class GR_CORE_API gri_access_code_correlator
+{
+ public:
+  gri_access_code_correlator(unsigned int threshold = 0);
+
+  /*!
+   * \param access_code one bit per byte, e.g. "0101011100", LSB only
+   * \return false if the code is longer than 64 bits
+   */
+  bool set_access_code(const std::string &access_code);
+
+  void set_threshold(unsigned int threshold) { d_threshold = threshold; }
+
+  unsigned int threshold() const { return d_threshold; }
+  unsigned int length() const { return d_len; }
+
+  //! forget the history, as if the stream started again
+  void reset() { d_history = 0; }
+
+  /*!
+   * Feed the next \p n bits. Each offset k in [0, n) where the code
+   * ends, that is in[k - length() .. k - 1] matches with at most
+   * threshold() wrong bits, is appended to \p matches. Bits of
+   * earlier calls take part, so codes spanning calls are found.
+   */
+  void search(const unsigned char *in, int n, std::vector<int> &matches);
+
+ private:
+  uint64_t d_code;        // bit j is code bit j
+  unsigned int d_len;
+  unsigned int d_threshold;
+  uint64_t d_history;     // the last 64 bits, oldest in the LSB
+  std::vector<uint64_t> d_words;
+
+  void pack(const unsigned char *in, int n);
+};
+
+#endif /* INCLUDED_GRI_ACCESS_CODE_CORRELATOR_H */
@@ -24,7 +24,9 @@
 #define _GRI_AGC2_CC_H_
 
 #include <gr_core_api.h>
+#include <gri_agc_engine.h>
 #include <math.h>
+#include <algorithm>
 
 /*!
  * \brief high performance Automatic Gain Control class
@@ -37,13 +39,14 @@ class GR_CORE_API gri_agc2_cc {
   gri_agc2_cc (float attack_rate = 1e-1, float decay_rate = 1e-2, float reference = 1.0,
 	       float gain = 1.0, float max_gain = 0.0)
     : _attack_rate(attack_rate), _decay_rate(decay_rate), _reference(reference),
-      _gain(gain), _max_gain(max_gain) {};
+      _gain(gain), _max_gain(max_gain), _block_mode(false) {};
 
   float decay_rate () const  { return _decay_rate; }
   float attack_rate () const { return _attack_rate; }
   float reference () const   { return _reference; }
   float gain () const 	     { return _gain;  }
   float max_gain() const     { return _max_gain; }
+  bool block_mode () const  { return _block_mode; }
 
   void set_decay_rate (float rate) { _decay_rate = rate; }
   void set_attack_rate (float rate) { _attack_rate = rate; }
@@ -51,6 +54,9 @@ class GR_CORE_API gri_agc2_cc {
   void set_gain (float gain) { _gain = gain; }
   void set_max_gain(float max_gain) { _max_gain = max_gain; }
 
+  //! hold the gain over short sub-blocks in scaleN, see gri_agc_engine
+  void set_block_mode (bool block_mode) { _block_mode = block_mode; }
+
   gr_complex scale (gr_complex input){
     gr_complex output = input * _gain;
 
@@ -76,8 +82,17 @@ class GR_CORE_API gri_agc2_cc {
   }
 
   void scaleN (gr_complex output[], const gr_complex input[], unsigned n){
-    for (unsigned i = 0; i < n; i++)
-      output[i] = scale (input[i]);
+    float mag[gri_agc_engine::CHUNK_SIZE], gains[gri_agc_engine::CHUNK_SIZE];
+    while (n > 0) {
+      const unsigned m = std::min(n, (unsigned) gri_agc_engine::CHUNK_SIZE);
+      gri_agc_engine::magnitude (mag, input, m);
+      _gain = gri_agc_engine::loop2 (gains, mag, m, _gain, _attack_rate, _decay_rate, _reference,
+				      _max_gain, false, _block_mode);
+      gri_agc_engine::apply (output, input, gains, m);
+      input += m;
+      output += m;
+      n -= m;
+    }
   }
 
  protected:
@@ -86,6 +101,7 @@ class GR_CORE_API gri_agc2_cc {
   float	_reference;		// reference value
   float	_gain;			// current gain
   float _max_gain;		// max allowable gain
+  bool _block_mode;		// piecewise constant gain in scaleN
 };
 
 #endif /* _GRI_AGC2_CC_H_ */
@@ -24,7 +24,9 @@
 #define _GRI_AGC2_FF_H_
 
 #include <gr_core_api.h>
+#include <gri_agc_engine.h>
 #include <math.h>
+#include <algorithm>
 
 /*!
  * \brief high performance Automatic Gain Control class with attack and decay rate
@@ -38,13 +40,14 @@ class GR_CORE_API gri_agc2_ff {
   gri_agc2_ff (float attack_rate = 1e-1, float decay_rate = 1e-2, float reference = 1.0,
 	       float gain = 1.0, float max_gain = 0.0)
     : _attack_rate(attack_rate), _decay_rate(decay_rate), _reference(reference),
-      _gain(gain), _max_gain(max_gain) {};
+      _gain(gain), _max_gain(max_gain), _block_mode(false) {};
 
   float attack_rate () const { return _attack_rate; }
   float decay_rate () const  { return _decay_rate; }
   float reference () const   { return _reference; }
   float gain () const 	     { return _gain;  }
   float max_gain () const    { return _max_gain; }
+  bool block_mode () const  { return _block_mode; }
 
   void set_attack_rate (float rate) { _attack_rate = rate; }
   void set_decay_rate (float rate) { _decay_rate = rate; }
@@ -52,6 +55,9 @@ class GR_CORE_API gri_agc2_ff {
   void set_gain (float gain) { _gain = gain; }
   void set_max_gain (float max_gain) { _max_gain = max_gain; }
 
+  //! hold the gain over short sub-blocks in scaleN, see gri_agc_engine
+  void set_block_mode (bool block_mode) { _block_mode = block_mode; }
+
   float scale (float input){
     float output = input * _gain;
 
@@ -75,8 +81,17 @@ class GR_CORE_API gri_agc2_ff {
   }
 
   void scaleN (float output[], const float input[], unsigned n){
-    for (unsigned i = 0; i < n; i++)
-      output[i] = scale (input[i]);
+    float mag[gri_agc_engine::CHUNK_SIZE], gains[gri_agc_engine::CHUNK_SIZE];
+    while (n > 0) {
+      const unsigned m = std::min(n, (unsigned) gri_agc_engine::CHUNK_SIZE);
+      gri_agc_engine::magnitude (mag, input, m);
+      _gain = gri_agc_engine::loop2 (gains, mag, m, _gain, _attack_rate, _decay_rate, _reference,
+				      _max_gain, true, _block_mode);
+      gri_agc_engine::apply (output, input, gains, m);
+      input += m;
+      output += m;
+      n -= m;
+    }
   }
 
  protected:
@@ -85,6 +100,7 @@ class GR_CORE_API gri_agc2_ff {
   float	_reference;		// reference value
   float	_gain;			// current gain
   float _max_gain;		// maximum gain
+  bool _block_mode;		// piecewise constant gain in scaleN
 };
 
 #endif /* _GRI_AGC2_FF_H_ */
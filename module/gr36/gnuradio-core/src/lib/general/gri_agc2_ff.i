@@ -44,4 +44,6 @@ class gri_agc2_ff {
   void set_reference (float reference);
   void set_gain (float gain);
   void set_max_gain (float max_gain);
+  bool block_mode ();
+  void set_block_mode (bool block_mode);
   };
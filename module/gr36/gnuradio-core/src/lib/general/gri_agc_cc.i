@@ -38,4 +38,6 @@ class gri_agc_cc {
   float reference ();
   float gain ();
   float max_gain ();
+  bool block_mode ();
+  void set_block_mode (bool block_mode);
   };
@@ -0,0 +1,284 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gri_agc_engine.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * sum of a sub-block of magnitudes
+ */
+static inline float
+block_sum(const float *x, size_t k)
+{
+  size_t i = 0;
+  float sum = 0.0f;
+#ifdef __SSE2__
+  if (k == gri_agc_engine::BLOCK_SIZE) {
+    __m128 s = _mm_setzero_ps();
+    for (; i < k; i += 4)
+      s = _mm_add_ps(s, _mm_loadu_ps(x + i));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+  }
+#endif
+  for (; i < k; i++)
+    sum += x[i];
+  return sum;
+}
+
+/*
+ * sum of the agc2 rates picked against gain, and of rate*magnitude
+ */
+static inline void
+rate_stats(const float *x, size_t k, float gain, float attack_rate,
+	   float decay_rate, float reference, bool abs_error,
+	   float &rate_sum, float &rate_mag_sum)
+{
+  size_t i = 0;
+  rate_sum = rate_mag_sum = 0.0f;
+#ifdef __SSE2__
+  if (k == gri_agc_engine::BLOCK_SIZE) {
+    const __m128 g = _mm_set1_ps(gain), ref = _mm_set1_ps(reference);
+    const __m128 attack = _mm_set1_ps(attack_rate), decay = _mm_set1_ps(decay_rate);
+    const __m128 abs_mask = abs_error ? _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))
+				      : _mm_castsi128_ps(_mm_set1_epi32(-1));
+    __m128 rs = _mm_setzero_ps(), rms = _mm_setzero_ps();
+    for (; i < k; i += 4) {
+      const __m128 m = _mm_loadu_ps(x + i);
+      const __m128 err = _mm_and_ps(abs_mask, _mm_sub_ps(_mm_mul_ps(g, m), ref));
+      const __m128 is_attack = _mm_cmpgt_ps(err, g);
+      const __m128 r = _mm_or_ps(_mm_and_ps(is_attack, attack), _mm_andnot_ps(is_attack, decay));
+      rs = _mm_add_ps(rs, r);
+      rms = _mm_add_ps(rms, _mm_mul_ps(r, m));
+    }
+    rs = _mm_add_ps(rs, _mm_movehl_ps(rs, rs));
+    rms = _mm_add_ps(rms, _mm_movehl_ps(rms, rms));
+    rate_sum = _mm_cvtss_f32(_mm_add_ss(rs, _mm_shuffle_ps(rs, rs, 1)));
+    rate_mag_sum = _mm_cvtss_f32(_mm_add_ss(rms, _mm_shuffle_ps(rms, rms, 1)));
+    return;
+  }
+#endif
+  for (; i < k; i++) {
+    float err = gain * x[i] - reference;
+    if (abs_error)
+      err = std::fabs(err);
+    const float r = err > gain ? attack_rate : decay_rate;
+    rate_sum += r;
+    rate_mag_sum += r * x[i];
+  }
+}
+
+/*
+ * k steps of g = a*g + b from g0 give a^k*g0 + b*(1 + a + ... + a^(k-1))
+ */
+static inline void
+geometric(float a, size_t k, float &ak, float &sum)
+{
+  if (k == gri_agc_engine::BLOCK_SIZE) {
+    // by doubling: sum_2j = sum_j*(1 + a^j)
+    ak = a;
+    sum = 1.0f;
+    for (size_t j = 1; j < k; j *= 2) {
+      sum += sum * ak;
+      ak *= ak;
+    }
+    return;
+  }
+  ak = 1.0f;
+  sum = 0.0f;
+  for (size_t j = 0; j < k; j++) {
+    sum += ak;
+    ak *= a;
+  }
+}
+
+float
+gri_agc_engine::loop(float *gains, const float *mag, size_t n, float gain,
+		     float rate, float reference, float max_gain,
+		     bool block_mode)
+{
+  if (!block_mode) {
+    for (size_t i = 0; i < n; i++) {
+      gains[i] = gain;
+      gain += rate * (reference - std::fabs(gain) * mag[i]);
+      if (max_gain > 0.0 && gain > max_gain)
+	gain = max_gain;
+    }
+    return gain;
+  }
+
+  for (size_t i = 0; i < n; i += BLOCK_SIZE) {
+    const size_t k = std::min(n - i, (size_t) BLOCK_SIZE);
+    std::fill(gains + i, gains + i + k, gain);
+
+    float ak, ak_sum;
+    geometric(1.0f - rate * block_sum(mag + i, k) / k, k, ak, ak_sum);
+    gain = ak * gain + rate * reference * ak_sum;
+    if (max_gain > 0.0 && gain > max_gain)
+      gain = max_gain;
+  }
+  return gain;
+}
+
+float
+gri_agc_engine::loop2(float *gains, const float *mag, size_t n, float gain,
+		      float attack_rate, float decay_rate, float reference,
+		      float max_gain, bool abs_error, bool block_mode)
+{
+  if (!block_mode) {
+    for (size_t i = 0; i < n; i++) {
+      gains[i] = gain;
+      const float tmp = std::fabs(gain) * mag[i] - reference;
+      const float err = abs_error ? std::fabs(tmp) : tmp;
+      gain -= tmp * (err > gain ? attack_rate : decay_rate);
+      if (gain < 0.0)
+	gain = 10e-5;
+      if (max_gain > 0.0 && gain > max_gain)
+	gain = max_gain;
+    }
+    return gain;
+  }
+
+  for (size_t i = 0; i < n; i += BLOCK_SIZE) {
+    const size_t k = std::min(n - i, (size_t) BLOCK_SIZE);
+    std::fill(gains + i, gains + i + k, gain);
+
+    // each sample picks its rate against the held gain; the sub-block
+    // then steps with the mean rate r and mean rate*magnitude rm:
+    // g' = (1 - rm)^k*g + r*reference*(1 + ... + (1 - rm)^(k-1))
+    float rate_sum, rate_mag_sum, ak, ak_sum;
+    rate_stats(mag + i, k, gain, attack_rate, decay_rate, reference,
+	       abs_error, rate_sum, rate_mag_sum);
+    geometric(1.0f - rate_mag_sum / k, k, ak, ak_sum);
+    gain = ak * gain + (rate_sum / k) * reference * ak_sum;
+    if (gain < 0.0)
+      gain = 10e-5;
+    if (max_gain > 0.0 && gain > max_gain)
+      gain = max_gain;
+  }
+  return gain;
+}
+
+void
+gri_agc_engine::magnitude(float *mag, const gr_complex *in, size_t n)
+{
+  volk_32fc_magnitude_32f_u(mag, (const lv_32fc_t *) in, n);
+}
+
+void
+gri_agc_engine::magnitude(float *mag, const float *in, size_t n)
+{
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(mag + i, _mm_andnot_ps(sign, _mm_loadu_ps(in + i)));
+#endif
+  for (; i < n; i++)
+    mag[i] = std::fabs(in[i]);
+}
+
+void
+gri_agc_engine::apply(gr_complex *out, const gr_complex *in, const float *gains, size_t n)
+{
+  float *o = (float *) out;
+  const float *x = (const float *) in;
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 4 <= n; i += 4) {
+    const __m128 g = _mm_loadu_ps(gains + i);
+    _mm_storeu_ps(o + 2*i, _mm_mul_ps(_mm_loadu_ps(x + 2*i), _mm_unpacklo_ps(g, g)));
+    _mm_storeu_ps(o + 2*i + 4, _mm_mul_ps(_mm_loadu_ps(x + 2*i + 4), _mm_unpackhi_ps(g, g)));
+  }
+#endif
+  for (; i < n; i++) {
+    o[2*i] = x[2*i] * gains[i];
+    o[2*i+1] = x[2*i+1] * gains[i];
+  }
+}
+
+void
+gri_agc_engine::apply(float *out, const float *in, const float *gains, size_t n)
+{
+  volk_32f_x2_multiply_32f_u(out, in, gains, n);
+}
+
+void
+gri_agc_engine::envelope(float *env, const gr_complex *in, size_t n)
+{
+  const float *x = (const float *) in;
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128 sign = _mm_set1_ps(-0.0f);
+  const __m128 k = _mm_set1_ps(0.4f);
+  for (; i + 4 <= n; i += 4) {
+    const __m128 x1 = _mm_loadu_ps(x + 2*i);
+    const __m128 x2 = _mm_loadu_ps(x + 2*i + 4);
+    const __m128 re = _mm_andnot_ps(sign, _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(2,0,2,0)));
+    const __m128 im = _mm_andnot_ps(sign, _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(3,1,3,1)));
+    const __m128 hi = _mm_max_ps(re, im), lo = _mm_min_ps(re, im);
+    _mm_storeu_ps(env + i, _mm_add_ps(hi, _mm_mul_ps(k, lo)));
+  }
+#endif
+  for (; i < n; i++) {
+    const float re = std::fabs(x[2*i]), im = std::fabs(x[2*i+1]);
+    env[i] = std::max(re, im) + 0.4f * std::min(re, im);
+  }
+}
+
+void
+gri_agc_engine::window_max(float *out, const float *in, size_t n,
+			   size_t window, float *scratch)
+{
+  if (window <= 1) {
+    std::copy(in, in + n, out);
+    return;
+  }
+
+  // running max forward and backward within blocks of one window;
+  // any window spans at most two blocks
+  const size_t len = n + window - 1;
+  float *fwd = scratch, *bwd = scratch + len;
+  for (size_t b = 0; b < len; b += window) {
+    const size_t e = std::min(b + window, len);
+    fwd[b] = in[b];
+    for (size_t i = b + 1; i < e; i++)
+      fwd[i] = std::max(fwd[i-1], in[i]);
+    bwd[e-1] = in[e-1];
+    for (size_t i = e - 1; i > b; i--)
+      bwd[i-1] = std::max(bwd[i], in[i-1]);
+  }
+
+  for (size_t i = 0; i < n; i++)
+    out[i] = std::max(bwd[i], fwd[i + window - 1]);
+}
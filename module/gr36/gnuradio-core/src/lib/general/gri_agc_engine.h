@@ -0,0 +1,94 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_GRI_AGC_ENGINE_H
+#define INCLUDED_GRI_AGC_ENGINE_H
+
+#include <gr_core_api.h>
+#include <gr_complex.h>
+#include <stddef.h>
+
+/*!
+ * \brief Vector kernels behind the gri_agc* classes
+ * \ingroup level_blk
+ *
+ * The AGC loops only depend on the input through |in[i]|, since
+ * |in[i]*gain| == gain*|in[i]|. The magnitudes are computed with VOLK
+ * ahead of the loop, the loop produces one gain per sample, and the
+ * gains are applied with VOLK; only the short gain update stays serial.
+ *
+ * Sample mode runs the original per sample update on the precomputed
+ * magnitudes. It matches gri_agc*::scale() to a few float ulp.
+ *
+ * Block mode holds the gain constant over sub-blocks of BLOCK_SIZE = K
+ * samples and advances it over the sub-block in closed form: with the
+ * mean magnitude m of the sub-block, K steps of
+ * g += rate*(reference - g*m) are g' = a^K*g + rate*reference*(1 + a +
+ * ... + a^(K-1)), a = 1 - rate*m. For a constant envelope this is the
+ * per sample result. Within a sub-block the held gain differs from the
+ * per sample gain by at most K*rate*|reference - |out||, so the output
+ * differs by at most K*rate*|reference - |out||*|in|; once the loop has
+ * settled on a steady envelope both agree to float rounding. agc2 picks
+ * the attack or decay rate per sample against the held gain and steps
+ * the sub-block with the mean of the picked rates.
+ */
+class GR_CORE_API gri_agc_engine
+{
+ public:
+  enum { BLOCK_SIZE = 16, CHUNK_SIZE = 256 };
+
+  //! gri_agc loop: gains[i] is the gain for sample i, returns the next gain
+  static float loop(float *gains, const float *mag, size_t n, float gain,
+		    float rate, float reference, float max_gain,
+		    bool block_mode);
+
+  /*!
+   * gri_agc2 loop: gains[i] is the gain for sample i, returns the next
+   * gain. The attack rate is used when the error exceeds the gain,
+   * abs_error compares |error| (the float version) instead of error.
+   */
+  static float loop2(float *gains, const float *mag, size_t n, float gain,
+		     float attack_rate, float decay_rate, float reference,
+		     float max_gain, bool abs_error, bool block_mode);
+
+  //! mag[i] = |in[i]|
+  static void magnitude(float *mag, const gr_complex *in, size_t n);
+  static void magnitude(float *mag, const float *in, size_t n);
+
+  //! out[i] = in[i] * gains[i], in may equal out
+  static void apply(gr_complex *out, const gr_complex *in, const float *gains, size_t n);
+  static void apply(float *out, const float *in, const float *gains, size_t n);
+
+  //! env[i] = max(|re|,|im|) + 0.4*min(|re|,|im|), the feedforward AGC envelope
+  static void envelope(float *env, const gr_complex *in, size_t n);
+
+  /*!
+   * out[i] = max(in[i], ..., in[i+window-1]) for i < n, in holds
+   * n+window-1 values. O(n) whatever the window (van Herk/Gil-Werman);
+   * scratch must hold 2*(n+window-1) floats.
+   */
+  static void window_max(float *out, const float *in, size_t n,
+			 size_t window, float *scratch);
+};
+
+#endif /* INCLUDED_GRI_AGC_ENGINE_H */
@@ -33,4 +33,6 @@ class gri_agc_ff {
  public:
   gri_agc_ff (float rate = 1e-4, float reference = 1.0,
 	      float gain = 1.0, float max_gain = 0.0);
+  bool block_mode ();
+  void set_block_mode (bool block_mode);
 };
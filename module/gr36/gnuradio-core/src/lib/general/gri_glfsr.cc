@@ -21,6 +21,7 @@
  */
 
 #include <gri_glfsr.h>
+#include <gri_lfsr_jump.h>
 #include <stdexcept>
 
 static int s_polynomial_masks[] = {
@@ -65,3 +66,44 @@ int gri_glfsr::glfsr_mask(int degree)
     throw std::runtime_error("gri_glfsr::glfsr_mask(): degree must be between 1 and 32 inclusive");
   return s_polynomial_masks[degree];
 }
+
+/*
+ * The register update (shift right, xor the mask when the output bit
+ * is set) is linear over GF(2), so the 64 step map follows from
+ * stepping each basis vector with next_bit() itself.
+ */
+const gri_lfsr_jump &
+gri_glfsr::jump()
+{
+  if (!d_jump) {
+    std::vector<uint64_t> basis_out(32, 0);
+    std::vector<uint32_t> basis_state(32, 0);
+    for (int j = 0; j < 32; j++) {
+      gri_glfsr glfsr(d_mask, (int)(1u << j));
+      for (int k = 0; k < 64; k++)
+	basis_out[j] |= (uint64_t)glfsr.next_bit() << k;
+      basis_state[j] = (uint32_t)glfsr.d_shift_register;
+    }
+    d_jump.reset(new gri_lfsr_jump(basis_out, basis_state));
+  }
+  return *d_jump;
+}
+
+void
+gri_glfsr::next_bits(unsigned char *out, int n)
+{
+  int i = 0;
+  if (n >= 64) {
+    const gri_lfsr_jump &tab = jump();
+    for (; i + 64 <= n; i += 64) {
+      uint64_t bits;
+      uint32_t state;
+      tab.apply((uint32_t)d_shift_register, bits, state);
+      d_shift_register = (int)state;
+      gri_unpack_bits64(out + i, bits);
+    }
+  }
+
+  for (; i < n; i++)
+    out[i] = next_bit();
+}
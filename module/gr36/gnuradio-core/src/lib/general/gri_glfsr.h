@@ -24,12 +24,18 @@
 #define INCLUDED_GRI_GLFSR_H
 
 #include <gr_core_api.h>
+#include <boost/shared_ptr.hpp>
+
+class gri_lfsr_jump;
 
 /*!
  * \brief Galois Linear Feedback Shift Register using specified polynomial mask
  * \ingroup misc
  *
  * Generates a maximal length pseudo-random sequence of length 2^degree-1
+ *
+ * next_bits() is a bit-identical block version of next_bit() that
+ * jumps the register 64 steps at a time with byte indexed tables.
  */
 
 class GR_CORE_API gri_glfsr
@@ -37,6 +43,9 @@ class GR_CORE_API gri_glfsr
  private:
   int d_shift_register;
   int d_mask;
+  boost::shared_ptr<gri_lfsr_jump> d_jump;
+
+  const gri_lfsr_jump &jump();
 
  public:
 
@@ -51,6 +60,8 @@ class GR_CORE_API gri_glfsr
     return bit;
   }
 
+  void next_bits(unsigned char *out, int n);
+
   int mask() const { return d_mask; }
 };
 
@@ -0,0 +1,152 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gri_lfsr.h>
+#include <gri_lfsr_jump.h>
+
+/*
+ * Inside the window of reg_len+1 bits the register update is
+ * (reg >> 1) ^ (newbit << reg_len), linear over GF(2), so the 64 step
+ * map follows from stepping each basis vector with next_bit() itself.
+ */
+const gri_lfsr_jump &
+gri_lfsr::generator_jump()
+{
+  if (!d_gen_jump) {
+    std::vector<uint64_t> basis_out(32, 0);
+    std::vector<uint32_t> basis_state(32, 0);
+    for (uint32_t j = 0; j <= d_shift_register_length; j++) {
+      gri_lfsr lfsr(d_mask, 1u << j, d_shift_register_length);
+      for (int k = 0; k < 64; k++)
+	basis_out[j] |= (uint64_t)lfsr.next_bit() << k;
+      basis_state[j] = lfsr.d_shift_register;
+    }
+    d_gen_jump.reset(new gri_lfsr_jump(basis_out, basis_state));
+  }
+  return *d_gen_jump;
+}
+
+/*
+ * Response of the scrambler to each of 64 input bits from a zero
+ * register; the register's own response is the generator's.
+ */
+const gri_lfsr_jump &
+gri_lfsr::scramble_jump()
+{
+  if (!d_scramble_jump) {
+    std::vector<uint64_t> basis_out(64, 0);
+    std::vector<uint32_t> basis_state(64, 0);
+    for (int j = 0; j < 64; j++) {
+      gri_lfsr lfsr(d_mask, 0, d_shift_register_length);
+      for (int k = 0; k < 64; k++)
+	basis_out[j] |= (uint64_t)lfsr.next_bit_scramble(k == j) << k;
+      basis_state[j] = lfsr.d_shift_register;
+    }
+    d_scramble_jump.reset(new gri_lfsr_jump(basis_out, basis_state));
+  }
+  return *d_scramble_jump;
+}
+
+void
+gri_lfsr::next_bits(unsigned char *out, int n)
+{
+  int i = 0;
+  for (; i < n && !in_window(); i++)
+    out[i] = next_bit();
+
+  if (n - i >= 64) {
+    const gri_lfsr_jump &gen = generator_jump();
+    for (; i + 64 <= n; i += 64) {
+      uint64_t bits;
+      gen.apply(d_shift_register, bits, d_shift_register);
+      gri_unpack_bits64(out + i, bits);
+    }
+  }
+
+  for (; i < n; i++)
+    out[i] = next_bit();
+}
+
+void
+gri_lfsr::next_bits_scramble(unsigned char *out, const unsigned char *in, int n)
+{
+  int i = 0;
+  for (; i < n && !in_window(); i++)
+    out[i] = next_bit_scramble(in[i]);
+
+  if (n - i >= 64) {
+    const gri_lfsr_jump &gen = generator_jump();
+    const gri_lfsr_jump &inj = scramble_jump();
+    for (; i + 64 <= n; i += 64) {
+      uint64_t reg_bits, in_bits;
+      uint32_t reg_state, in_state;
+      gen.apply(d_shift_register, reg_bits, reg_state);
+      inj.apply(gri_pack_lsbs64(in + i), in_bits, in_state);
+      d_shift_register = reg_state ^ in_state;
+      gri_unpack_bits64(out + i, reg_bits ^ in_bits);
+    }
+  }
+
+  for (; i < n; i++)
+    out[i] = next_bit_scramble(in[i]);
+}
+
+/*
+ * The descrambler register only holds past input bits. With the
+ * register and 64 input bits concatenated into the bit stream
+ * z = reg | in << (reg_len+1), output k is in[k] xor the parity of
+ * z[k+tap] over the mask taps, so each tap is one shifted xor.
+ */
+void
+gri_lfsr::next_bits_descramble(unsigned char *out, const unsigned char *in, int n)
+{
+  int i = 0;
+  for (; i < n && !in_window(); i++)
+    out[i] = next_bit_descramble(in[i]);
+
+  const int width = d_shift_register_length + 1;
+  int taps[32];
+  int ntaps = 0;
+  for (int t = 0; t < width; t++)
+    if ((d_mask >> t) & 1)
+      taps[ntaps++] = t;
+
+  for (; i + 64 <= n; i += 64) {
+    const uint64_t x = gri_pack_lsbs64(in + i);
+    const uint64_t lo = d_shift_register | (x << width);
+    const uint64_t hi = x >> (64 - width);
+    uint64_t bits = x;
+    for (int k = 0; k < ntaps; k++) {
+      const int t = taps[k];
+      bits ^= (t == 0) ? lo : ((lo >> t) | (hi << (64 - t)));
+    }
+    d_shift_register = (uint32_t)hi;
+    gri_unpack_bits64(out + i, bits);
+  }
+
+  for (; i < n; i++)
+    out[i] = next_bit_descramble(in[i]);
+}
@@ -24,9 +24,12 @@
 #define INCLUDED_GRI_LFSR_H
 
 #include <gr_core_api.h>
+#include <boost/shared_ptr.hpp>
 #include <stdexcept>
 #include <stdint.h>
 
+class gri_lfsr_jump;
+
 /*!
  * \brief Fibonacci Linear Feedback Shift Register using specified polynomial mask
  * \ingroup misc
@@ -80,6 +83,14 @@
  * See http://en.wikipedia.org/wiki/Scrambler for operation of these
  * last two functions (see multiplicative scrambler.)
  *
+ *  next_bits(), next_bits_scramble(), next_bits_descramble()
+ *
+ *      Bit-identical block versions of the above, one output byte per
+ *      bit. They step the register 64 bits at a time: the generator and
+ *      scrambler jump ahead with byte indexed tables of the 64 step
+ *      transition, the descrambler (which is not recursive) xors
+ *      shifted copies of the packed input word.
+ *
  */
 
 class GR_CORE_API gri_lfsr
@@ -89,6 +100,8 @@ class GR_CORE_API gri_lfsr
   uint32_t d_mask;
   uint32_t d_seed;
   uint32_t d_shift_register_length;	// less than 32
+  boost::shared_ptr<gri_lfsr_jump> d_gen_jump;
+  boost::shared_ptr<gri_lfsr_jump> d_scramble_jump;
 
   static uint32_t
   popCount(uint32_t x)
@@ -98,6 +111,14 @@ class GR_CORE_API gri_lfsr
     return ((r + (r >> 3)) & 030707070707) % 63;
   }
 
+  // the block methods need the register to fit in reg_len+1 bits
+  bool in_window() const {
+    return ((uint64_t)d_shift_register >> (d_shift_register_length+1)) == 0;
+  }
+
+  const gri_lfsr_jump &generator_jump();
+  const gri_lfsr_jump &scramble_jump();
+
  public:
 
   gri_lfsr(uint32_t mask, uint32_t seed, uint32_t reg_len)
@@ -131,6 +152,10 @@ class GR_CORE_API gri_lfsr
     return output;
   }
 
+  void next_bits(unsigned char *out, int n);
+  void next_bits_scramble(unsigned char *out, const unsigned char *in, int n);
+  void next_bits_descramble(unsigned char *out, const unsigned char *in, int n);
+
   /*!
    * Reset shift register to initial seed value
    */
@@ -0,0 +1,95 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gri_lfsr_jump.h>
+#include <stdexcept>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+gri_lfsr_jump::gri_lfsr_jump(const std::vector<uint64_t> &basis_out,
+			     const std::vector<uint32_t> &basis_state)
+  : d_nbytes(basis_out.size()/8),
+    d_out(d_nbytes*256, 0),
+    d_state(d_nbytes*256, 0)
+{
+  if (basis_out.size() != basis_state.size() || basis_out.size() % 8 != 0
+      || d_nbytes < 1 || d_nbytes > 8)
+    throw std::invalid_argument("gri_lfsr_jump: bad basis size");
+
+  // every table entry is the entry without its lowest set bit,
+  // plus the response to that bit
+  for (int b = 0; b < d_nbytes; b++) {
+    for (int v = 1; v < 256; v++) {
+      int low = 0;
+      while (((v >> low) & 1) == 0)
+	low++;
+      d_out[b*256 + v] = d_out[b*256 + (v & (v-1))] ^ basis_out[b*8 + low];
+      d_state[b*256 + v] = d_state[b*256 + (v & (v-1))] ^ basis_state[b*8 + low];
+    }
+  }
+}
+
+uint64_t
+gri_pack_lsbs64(const unsigned char *in)
+{
+#ifdef __SSE2__
+  // shift each LSB into its byte's MSB and collect those with movemask
+  uint64_t bits = 0;
+  for (int i = 0; i < 4; i++) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(in + 16*i));
+    v = _mm_slli_epi16(v, 7);
+    bits |= (uint64_t)(_mm_movemask_epi8(v) & 0xffff) << (16*i);
+  }
+  return bits;
+#else
+  uint64_t bits = 0;
+  for (int i = 0; i < 64; i++)
+    bits |= (uint64_t)(in[i] & 1) << i;
+  return bits;
+#endif
+}
+
+namespace {
+  struct unpack_table {
+    unsigned char bytes[256][8];
+    unpack_table() {
+      for (int v = 0; v < 256; v++)
+	for (int k = 0; k < 8; k++)
+	  bytes[v][k] = (v >> k) & 1;
+    }
+  };
+  const unpack_table s_unpack;
+}
+
+void
+gri_unpack_bits64(unsigned char *out, uint64_t bits)
+{
+  for (int i = 0; i < 8; i++, bits >>= 8)
+    memcpy(out + 8*i, s_unpack.bytes[bits & 0xff], 8);
+}
@@ -0,0 +1,78 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GRI_LFSR_JUMP_H
+#define INCLUDED_GRI_LFSR_JUMP_H
+
+#include <gr_core_api.h>
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \brief Byte indexed tables for jumping a shift register 64 steps
+ * \ingroup misc
+ *
+ * A shift register step is linear over GF(2), so 64 steps map an
+ * input word (the register and/or 64 input bits) to 64 output bits
+ * and a new 32 bit register. The map is stored as one table per
+ * input byte; applying it costs one lookup per input byte instead
+ * of a loop over 64 bits.
+ *
+ * The tables are built from the response to each input bit alone:
+ * basis_out[j] and basis_state[j] for input bit j. The input word
+ * is 8 * (number of basis entries / 8) bits wide.
+ */
+class GR_CORE_API gri_lfsr_jump
+{
+ private:
+  int d_nbytes;
+  std::vector<uint64_t> d_out;
+  std::vector<uint32_t> d_state;
+
+ public:
+  gri_lfsr_jump(const std::vector<uint64_t> &basis_out,
+		const std::vector<uint32_t> &basis_state);
+
+  void apply(uint64_t in, uint64_t &out, uint32_t &state) const {
+    const uint64_t *out_tab = &d_out[0];
+    const uint32_t *state_tab = &d_state[0];
+    out = 0;
+    state = 0;
+    for (int b = 0; b < d_nbytes; b++, in >>= 8) {
+      const unsigned int v = b*256 + (unsigned int)(in & 0xff);
+      out ^= out_tab[v];
+      state ^= state_tab[v];
+    }
+  }
+};
+
+/*!
+ * \brief Pack the LSB of 64 bytes into a word, in[0] goes to bit 0
+ */
+GR_CORE_API uint64_t gri_pack_lsbs64(const unsigned char *in);
+
+/*!
+ * \brief Unpack a word into 64 bytes of 0 or 1, bit 0 goes to out[0]
+ */
+GR_CORE_API void gri_unpack_bits64(unsigned char *out, uint64_t bits);
+
+#endif /* INCLUDED_GRI_LFSR_JUMP_H */
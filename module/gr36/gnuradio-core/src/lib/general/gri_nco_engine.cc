@@ -0,0 +1,245 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gri_nco_engine.h>
+#include <gr_sincos.h>
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+gri_nco_engine::gri_nco_engine()
+  : d_phase(0), d_phase_inc(0), d_table_inc(0), d_table_valid(false)
+{
+}
+
+uint64_t
+gri_nco_engine::to_fixed(double angle)
+{
+  // negative angles are reduced as positive ones so small negative
+  // frequencies keep their precision instead of sitting next to 1 turn
+  if (angle < 0)
+    return -to_fixed(-angle);
+
+  double turns = angle * (1.0 / (2 * M_PI));
+  turns -= std::floor(turns);
+
+  // 32 bits at a time, a fraction of exactly 1 wraps to 0
+  const double scaled = std::ldexp(turns, 32);
+  const double hi = std::floor(scaled);
+  const double lo = std::floor(std::ldexp(scaled - hi, 32));
+  return ((uint64_t) hi << 32) + (uint64_t) lo;
+}
+
+double
+gri_nco_engine::to_radians(uint64_t phase)
+{
+  return (double)(int64_t) phase * (2 * M_PI / 18446744073709551616.0);
+}
+
+void
+gri_nco_engine::set_freq(double angle_rate)
+{
+  d_phase_inc = to_fixed(angle_rate);
+}
+
+void
+gri_nco_engine::adjust_freq(double delta_angle_rate)
+{
+  d_phase_inc += to_fixed(delta_angle_rate);
+}
+
+void
+gri_nco_engine::build_table()
+{
+  // each entry from the exact phase of step k, not by recursion
+  for (unsigned int k = 0; k < BLOCK_SIZE; k++) {
+    double s, c;
+    gr_sincos(to_radians(d_phase_inc * k), &s, &c);
+    d_table_re[k] = (float) c;
+    d_table_im[k] = (float) s;
+  }
+  d_table_inc = d_phase_inc;
+  d_table_valid = true;
+}
+
+void
+gri_nco_engine::block_phasor(float ampl, float &re, float &im) const
+{
+  double s, c;
+  gr_sincos(to_radians(d_phase), &s, &c);
+  re = (float)(ampl * c);
+  im = (float)(ampl * s);
+}
+
+/*
+ * Each method walks the request in table sized blocks. Within a block
+ * output k is the block phasor b times table entry t[k]:
+ *   re = b.re*t.re - b.im*t.im,  im = b.re*t.im + b.im*t.re
+ */
+
+void
+gri_nco_engine::sincos(gr_complex *out, size_t n, float ampl)
+{
+  if (!d_table_valid || d_table_inc != d_phase_inc)
+    build_table();
+
+  float *o = (float *) out;
+  while (n > 0) {
+    const size_t m = std::min(n, (size_t) BLOCK_SIZE);
+    float br, bi;
+    block_phasor(ampl, br, bi);
+
+    size_t k = 0;
+#ifdef __SSE2__
+    const __m128 vbr = _mm_set1_ps(br), vbi = _mm_set1_ps(bi);
+    for (; k + 4 <= m; k += 4) {
+      const __m128 tr = _mm_loadu_ps(d_table_re + k);
+      const __m128 ti = _mm_loadu_ps(d_table_im + k);
+      const __m128 re = _mm_sub_ps(_mm_mul_ps(vbr, tr), _mm_mul_ps(vbi, ti));
+      const __m128 im = _mm_add_ps(_mm_mul_ps(vbr, ti), _mm_mul_ps(vbi, tr));
+      _mm_storeu_ps(o + 2*k, _mm_unpacklo_ps(re, im));
+      _mm_storeu_ps(o + 2*k + 4, _mm_unpackhi_ps(re, im));
+    }
+#endif
+    for (; k < m; k++) {
+      o[2*k] = br*d_table_re[k] - bi*d_table_im[k];
+      o[2*k+1] = br*d_table_im[k] + bi*d_table_re[k];
+    }
+
+    step(m);
+    o += 2*m;
+    n -= m;
+  }
+}
+
+void
+gri_nco_engine::sin(float *out, size_t n, float ampl)
+{
+  if (!d_table_valid || d_table_inc != d_phase_inc)
+    build_table();
+
+  while (n > 0) {
+    const size_t m = std::min(n, (size_t) BLOCK_SIZE);
+    float br, bi;
+    block_phasor(ampl, br, bi);
+
+    size_t k = 0;
+#ifdef __SSE2__
+    const __m128 vbr = _mm_set1_ps(br), vbi = _mm_set1_ps(bi);
+    for (; k + 4 <= m; k += 4) {
+      const __m128 tr = _mm_loadu_ps(d_table_re + k);
+      const __m128 ti = _mm_loadu_ps(d_table_im + k);
+      _mm_storeu_ps(out + k, _mm_add_ps(_mm_mul_ps(vbr, ti), _mm_mul_ps(vbi, tr)));
+    }
+#endif
+    for (; k < m; k++)
+      out[k] = br*d_table_im[k] + bi*d_table_re[k];
+
+    step(m);
+    out += m;
+    n -= m;
+  }
+}
+
+void
+gri_nco_engine::cos(float *out, size_t n, float ampl)
+{
+  if (!d_table_valid || d_table_inc != d_phase_inc)
+    build_table();
+
+  while (n > 0) {
+    const size_t m = std::min(n, (size_t) BLOCK_SIZE);
+    float br, bi;
+    block_phasor(ampl, br, bi);
+
+    size_t k = 0;
+#ifdef __SSE2__
+    const __m128 vbr = _mm_set1_ps(br), vbi = _mm_set1_ps(bi);
+    for (; k + 4 <= m; k += 4) {
+      const __m128 tr = _mm_loadu_ps(d_table_re + k);
+      const __m128 ti = _mm_loadu_ps(d_table_im + k);
+      _mm_storeu_ps(out + k, _mm_sub_ps(_mm_mul_ps(vbr, tr), _mm_mul_ps(vbi, ti)));
+    }
+#endif
+    for (; k < m; k++)
+      out[k] = br*d_table_re[k] - bi*d_table_im[k];
+
+    step(m);
+    out += m;
+    n -= m;
+  }
+}
+
+void
+gri_nco_engine::rotate(gr_complex *out, const gr_complex *in, size_t n)
+{
+  if (!d_table_valid || d_table_inc != d_phase_inc)
+    build_table();
+
+  float *o = (float *) out;
+  const float *x = (const float *) in;
+  while (n > 0) {
+    const size_t m = std::min(n, (size_t) BLOCK_SIZE);
+    float br, bi;
+    block_phasor(1.0f, br, bi);
+
+    size_t k = 0;
+#ifdef __SSE2__
+    const __m128 vbr = _mm_set1_ps(br), vbi = _mm_set1_ps(bi);
+    for (; k + 4 <= m; k += 4) {
+      const __m128 tr = _mm_loadu_ps(d_table_re + k);
+      const __m128 ti = _mm_loadu_ps(d_table_im + k);
+      const __m128 pr = _mm_sub_ps(_mm_mul_ps(vbr, tr), _mm_mul_ps(vbi, ti));
+      const __m128 pi = _mm_add_ps(_mm_mul_ps(vbr, ti), _mm_mul_ps(vbi, tr));
+
+      const __m128 x1 = _mm_loadu_ps(x + 2*k);
+      const __m128 x2 = _mm_loadu_ps(x + 2*k + 4);
+      const __m128 xr = _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(2,0,2,0));
+      const __m128 xi = _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(3,1,3,1));
+
+      const __m128 re = _mm_sub_ps(_mm_mul_ps(xr, pr), _mm_mul_ps(xi, pi));
+      const __m128 im = _mm_add_ps(_mm_mul_ps(xr, pi), _mm_mul_ps(xi, pr));
+      _mm_storeu_ps(o + 2*k, _mm_unpacklo_ps(re, im));
+      _mm_storeu_ps(o + 2*k + 4, _mm_unpackhi_ps(re, im));
+    }
+#endif
+    for (; k < m; k++) {
+      const float pr = br*d_table_re[k] - bi*d_table_im[k];
+      const float pi = br*d_table_im[k] + bi*d_table_re[k];
+      const float xr = x[2*k], xi = x[2*k+1];
+      o[2*k] = xr*pr - xi*pi;
+      o[2*k+1] = xr*pi + xi*pr;
+    }
+
+    step(m);
+    o += 2*m;
+    x += 2*m;
+    n -= m;
+  }
+}
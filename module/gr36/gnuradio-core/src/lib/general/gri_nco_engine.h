@@ -0,0 +1,102 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GRI_NCO_ENGINE_H
+#define INCLUDED_GRI_NCO_ENGINE_H
+
+#include <gr_core_api.h>
+#include <gr_complex.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * \brief Block oriented oscillator and rotator
+ * \ingroup misc
+ *
+ * The phase is a 64 bit fixed point accumulator with 2^64 counts per
+ * turn, so stepping is exact and the phase after n samples is always
+ * phase + n * freq modulo one turn; there is no drift however long the
+ * run. Output is produced in blocks of BLOCK_SIZE samples: each block
+ * rotates a table of exp(j*k*freq), k < BLOCK_SIZE, by the phasor of
+ * the accumulator at the start of the block. The block phasor is
+ * recomputed in double precision from the accumulator every block, so
+ * the rounding of the recursion never carries past one block and the
+ * amplitude never needs renormalizing. The error of each output is a
+ * few float ulp.
+ *
+ * The table is rebuilt lazily after the frequency changes; callers that
+ * retune every sample should keep using gr_nco's per sample methods.
+ */
+class GR_CORE_API gri_nco_engine
+{
+ public:
+  enum { BLOCK_SIZE = 64 };
+
+  gri_nco_engine();
+
+  // radians
+  void set_phase(double angle) { d_phase = to_fixed(angle); }
+  void adjust_phase(double delta_phase) { d_phase += to_fixed(delta_phase); }
+
+  // angle_rate is in radians / step
+  void set_freq(double angle_rate);
+  void adjust_freq(double delta_angle_rate);
+
+  // radians in [-pi, pi), radians / step
+  double get_phase() const { return to_radians(d_phase); }
+  double get_freq() const { return to_radians(d_phase_inc); }
+
+  // advance without producing output
+  void step() { d_phase += d_phase_inc; }
+  void step(uint64_t n) { d_phase += d_phase_inc * n; }
+
+  //! out[i] = ampl * exp(j*phase), one step per item
+  void sincos(gr_complex *out, size_t n, float ampl = 1.0f);
+
+  //! out[i] = ampl * sin(phase), one step per item
+  void sin(float *out, size_t n, float ampl = 1.0f);
+
+  //! out[i] = ampl * cos(phase), one step per item
+  void cos(float *out, size_t n, float ampl = 1.0f);
+
+  //! out[i] = in[i] * exp(j*phase), one step per item, in may equal out
+  void rotate(gr_complex *out, const gr_complex *in, size_t n);
+
+  //! accumulator conversions, 2^64 counts per turn
+  static uint64_t to_fixed(double angle);
+  static double to_radians(uint64_t phase);
+
+ private:
+  uint64_t d_phase;
+  uint64_t d_phase_inc;
+  uint64_t d_table_inc;
+  bool d_table_valid;
+
+  // exp(j*k*freq) split into real and imaginary parts
+  float d_table_re[BLOCK_SIZE];
+  float d_table_im[BLOCK_SIZE];
+
+  void build_table();
+  void block_phasor(float ampl, float &re, float &im) const;
+};
+
+#endif /* INCLUDED_GRI_NCO_ENGINE_H */
@@ -0,0 +1,534 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gri_philox_rng.h>
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+enum { UNIFORM, GAUSSIAN, LAPLACIAN, RAYLEIGH, IMPULSE };
+
+// words produced per unit, four Philox blocks
+static const size_t UNIT = 16;
+
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+static const int PHILOX_ROUNDS = 10;
+
+// cephes logf, for arguments in (0, 1]
+static const float LOG_P0 = 7.0376836292E-2f;
+static const float LOG_P1 = -1.1514610310E-1f;
+static const float LOG_P2 = 1.1676998740E-1f;
+static const float LOG_P3 = -1.2420140846E-1f;
+static const float LOG_P4 = 1.4249322787E-1f;
+static const float LOG_P5 = -1.6668057665E-1f;
+static const float LOG_P6 = 2.0000714765E-1f;
+static const float LOG_P7 = -2.4999993993E-1f;
+static const float LOG_P8 = 3.3333331174E-1f;
+static const float LOG_Q1 = -2.12194440E-4f;
+static const float LOG_Q2 = 0.693359375f;
+static const float SQRTHF = 0.707106781186547524f;
+
+// cephes sinf / cosf on [-pi/4, pi/4]
+static const float SIN_P0 = -1.9515295891E-4f;
+static const float SIN_P1 = 8.3321608736E-3f;
+static const float SIN_P2 = -1.6666654611E-1f;
+static const float COS_P0 = 2.443315711809948E-5f;
+static const float COS_P1 = -1.388731625493765E-3f;
+static const float COS_P2 = 4.166664568298827E-2f;
+
+// word conversions, all exact or a single rounding:
+//   uniform:  ((w >> 8) + 1/2) / 2^23 - 1, on (-1, 1) in steps of 2^-23
+//   fine:     ((w >> 1) + 1/2) / 2^31, on (0, 1], full precision near 0
+//   angle:    w >> 8 in quarter turns as quadrant j plus f in [-1/2, 1/2)
+static const float UNIFORM_SCALE = 1.0f / 8388608.0f;
+static const float UNIFORM_OFFSET = 1.0f / 16777216.0f - 1.0f;
+static const float FINE_SCALE = 1.0f / 2147483648.0f;
+static const float FINE_OFFSET = 1.0f / 4294967296.0f;
+static const float ANGLE_SCALE = (float)(M_PI / 2 / 4194304.0);
+
+gri_philox_rng::gri_philox_rng(uint64_t seed, uint64_t stream)
+{
+  reseed(seed, stream);
+}
+
+void
+gri_philox_rng::reseed(uint64_t seed, uint64_t stream)
+{
+  d_key[0] = (uint32_t) seed;
+  d_key[1] = (uint32_t)(seed >> 32);
+  d_stream[0] = (uint32_t) stream;
+  d_stream[1] = (uint32_t)(stream >> 32);
+  d_pos = 0;
+}
+
+void
+gri_philox_rng::philox(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4])
+{
+  uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+  uint32_t k0 = key[0], k1 = key[1];
+
+  for (int r = 0; r < PHILOX_ROUNDS; r++) {
+    const uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+    const uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+    c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+    c1 = (uint32_t) p1;
+    c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+    c3 = (uint32_t) p0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+  out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+/***********************************************************************
+ * Conversions. The SSE2 and the portable versions perform the same
+ * float operations in the same order, so both builds give identical
+ * streams.
+ **********************************************************************/
+
+#ifdef __SSE2__
+
+static inline __m128i
+mulhilo(__m128i a, __m128i m, __m128i &lo)
+{
+  const __m128i lo_mask = _mm_set_epi32(0, -1, 0, -1);
+  const __m128i even = _mm_mul_epu32(a, m);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+  lo = _mm_or_si128(_mm_and_si128(even, lo_mask), _mm_slli_epi64(odd, 32));
+  return _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(lo_mask, odd));
+}
+
+static inline __m128
+log_ps(__m128 x)
+{
+  const __m128i i = _mm_castps_si128(x);
+  __m128i e = _mm_sub_epi32(_mm_srli_epi32(i, 23), _mm_set1_epi32(126));
+  __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(i, _mm_set1_epi32(0x007fffff)),
+                                           _mm_set1_epi32(0x3f000000)));
+
+  // m in [sqrt(1/2), sqrt(2)) around 1, then less 1
+  const __m128 below = _mm_cmplt_ps(m, _mm_set1_ps(SQRTHF));
+  e = _mm_add_epi32(e, _mm_castps_si128(below));
+  m = _mm_add_ps(_mm_sub_ps(m, _mm_set1_ps(1.0f)), _mm_and_ps(m, below));
+  const __m128 ef = _mm_cvtepi32_ps(e);
+
+  const __m128 z = _mm_mul_ps(m, m);
+  __m128 y = _mm_set1_ps(LOG_P0);
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P1));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P2));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P3));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P4));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P5));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P6));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P7));
+  y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(LOG_P8));
+  y = _mm_mul_ps(_mm_mul_ps(y, m), z);
+  y = _mm_add_ps(y, _mm_mul_ps(ef, _mm_set1_ps(LOG_Q1)));
+  y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+  m = _mm_add_ps(m, y);
+  return _mm_add_ps(m, _mm_mul_ps(ef, _mm_set1_ps(LOG_Q2)));
+}
+
+// cos and sin of w >> 8 in units of 2^-24 turns
+static inline void
+sincos_ps(__m128i w, __m128 &c, __m128 &s)
+{
+  const __m128i k = _mm_srli_epi32(w, 8);
+  const __m128i j = _mm_srli_epi32(_mm_add_epi32(k, _mm_set1_epi32(1 << 21)), 22);
+  const __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(k, _mm_slli_epi32(j, 22))),
+                              _mm_set1_ps(ANGLE_SCALE));
+  const __m128 z = _mm_mul_ps(x, x);
+
+  __m128 ys = _mm_set1_ps(SIN_P0);
+  ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(SIN_P1));
+  ys = _mm_add_ps(_mm_mul_ps(ys, z), _mm_set1_ps(SIN_P2));
+  ys = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ys, z), x), x);
+
+  __m128 yc = _mm_set1_ps(COS_P0);
+  yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(COS_P1));
+  yc = _mm_add_ps(_mm_mul_ps(yc, z), _mm_set1_ps(COS_P2));
+  yc = _mm_mul_ps(_mm_mul_ps(yc, z), z);
+  yc = _mm_sub_ps(yc, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+  yc = _mm_add_ps(yc, _mm_set1_ps(1.0f));
+
+  // odd quadrants swap, quadrants 1 and 2 negate cos, 2 and 3 sin
+  const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(1)),
+                                                       _mm_set1_epi32(1)));
+  const __m128 cs = _mm_or_ps(_mm_and_ps(swap, ys), _mm_andnot_ps(swap, yc));
+  const __m128 ss = _mm_or_ps(_mm_and_ps(swap, yc), _mm_andnot_ps(swap, ys));
+  const __m128i two = _mm_set1_epi32(2);
+  const __m128i csign = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), two), 30);
+  const __m128i ssign = _mm_slli_epi32(_mm_and_si128(j, two), 30);
+  c = _mm_xor_ps(cs, _mm_castsi128_ps(csign));
+  s = _mm_xor_ps(ss, _mm_castsi128_ps(ssign));
+}
+
+static inline __m128
+uniform_ps(__m128i w)
+{
+  return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(w, 8)),
+                               _mm_set1_ps(UNIFORM_SCALE)),
+                    _mm_set1_ps(UNIFORM_OFFSET));
+}
+
+static inline __m128
+fine_ps(__m128i w)
+{
+  return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(w, 1)),
+                               _mm_set1_ps(FINE_SCALE)),
+                    _mm_set1_ps(FINE_OFFSET));
+}
+
+// sqrt(-2 ln u), clamped in case the polynomial rounds above 0 near 1
+static inline __m128
+radius_ps(__m128i w)
+{
+  const __m128 l2 = _mm_mul_ps(log_ps(fine_ps(w)), _mm_set1_ps(-2.0f));
+  return _mm_sqrt_ps(_mm_max_ps(l2, _mm_setzero_ps()));
+}
+
+void
+gri_philox_rng::unit(int dist, uint64_t u, float ampl, float param, float out[16]) const
+{
+  // four consecutive blocks, one per lane
+  const uint64_t b = u * 4;
+  __m128i c0 = _mm_add_epi32(_mm_set1_epi32((uint32_t) b), _mm_set_epi32(3, 2, 1, 0));
+  __m128i c1 = _mm_set1_epi32((uint32_t)(b >> 32));  // b is a multiple of 4, no carry
+  __m128i c2 = _mm_set1_epi32(d_stream[0]);
+  __m128i c3 = _mm_set1_epi32(d_stream[1]);
+  const __m128i m0 = _mm_set1_epi32(PHILOX_M0);
+  const __m128i m1 = _mm_set1_epi32(PHILOX_M1);
+  uint32_t k0 = d_key[0], k1 = d_key[1];
+
+  for (int r = 0; r < PHILOX_ROUNDS; r++) {
+    __m128i lo0, lo1;
+    const __m128i hi0 = mulhilo(c0, m0, lo0);
+    const __m128i hi1 = mulhilo(c2, m1, lo1);
+    c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32(k0));
+    c1 = lo1;
+    c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32(k1));
+    c3 = lo0;
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+
+  const __m128i w[4] = { c0, c1, c2, c3 };
+  const __m128 a = _mm_set1_ps(ampl);
+
+  switch (dist) {
+  case UNIFORM:
+    for (int j = 0; j < 4; j++)
+      _mm_storeu_ps(out + 4*j, _mm_mul_ps(uniform_ps(w[j]), a));
+    break;
+
+  case GAUSSIAN:
+    for (int j = 0; j < 4; j += 2) {
+      const __m128 r = _mm_mul_ps(radius_ps(w[j]), a);
+      __m128 c, s;
+      sincos_ps(w[j+1], c, s);
+      c = _mm_mul_ps(r, c);
+      s = _mm_mul_ps(r, s);
+      _mm_storeu_ps(out + 4*j, _mm_unpacklo_ps(c, s));
+      _mm_storeu_ps(out + 4*j + 4, _mm_unpackhi_ps(c, s));
+    }
+    break;
+
+  case LAPLACIAN:
+    for (int j = 0; j < 4; j++) {
+      const __m128 sign = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+      const __m128 v = uniform_ps(w[j]);
+      const __m128 t = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_andnot_ps(sign, v));
+      const __m128 l = _mm_mul_ps(log_ps(t), _mm_set1_ps(-(float) M_SQRT1_2));
+      _mm_storeu_ps(out + 4*j, _mm_mul_ps(_mm_xor_ps(l, _mm_and_ps(sign, v)), a));
+    }
+    break;
+
+  case RAYLEIGH:
+    for (int j = 0; j < 4; j++) {
+      _mm_storeu_ps(out + 4*j, _mm_mul_ps(radius_ps(w[j]), a));
+    }
+    break;
+
+  case IMPULSE:
+    for (int j = 0; j < 4; j++) {
+      const __m128 z = _mm_mul_ps(log_ps(fine_ps(w[j])), _mm_set1_ps(-(float) M_SQRT2));
+      const __m128 keep = _mm_cmpgt_ps(z, _mm_set1_ps(param));
+      _mm_storeu_ps(out + 4*j, _mm_and_ps(_mm_mul_ps(z, a), keep));
+    }
+    break;
+  }
+}
+
+#else /* __SSE2__ */
+
+static inline float
+bits_to_float(uint32_t i)
+{
+  float f;
+  memcpy(&f, &i, sizeof(f));
+  return f;
+}
+
+static inline uint32_t
+float_to_bits(float f)
+{
+  uint32_t i;
+  memcpy(&i, &f, sizeof(i));
+  return i;
+}
+
+static inline float
+log_ps(float x)
+{
+  const uint32_t i = float_to_bits(x);
+  int e = (int)(i >> 23) - 126;
+  float m = bits_to_float((i & 0x007fffff) | 0x3f000000);
+
+  const bool below = m < SQRTHF;
+  e -= below;
+  m = (m - 1.0f) + (below ? m : 0.0f);
+  const float ef = (float) e;
+
+  const float z = m * m;
+  float y = LOG_P0;
+  y = y * m + LOG_P1;
+  y = y * m + LOG_P2;
+  y = y * m + LOG_P3;
+  y = y * m + LOG_P4;
+  y = y * m + LOG_P5;
+  y = y * m + LOG_P6;
+  y = y * m + LOG_P7;
+  y = y * m + LOG_P8;
+  y = (y * m) * z;
+  y = y + ef * LOG_Q1;
+  y = y - z * 0.5f;
+  m = m + y;
+  return m + ef * LOG_Q2;
+}
+
+static inline void
+sincos_ps(uint32_t w, float &c, float &s)
+{
+  const uint32_t k = w >> 8;
+  const uint32_t j = (k + (1 << 21)) >> 22;
+  const float x = (float)(int32_t)(k - (j << 22)) * ANGLE_SCALE;
+  const float z = x * x;
+
+  float ys = SIN_P0;
+  ys = ys * z + SIN_P1;
+  ys = ys * z + SIN_P2;
+  ys = (ys * z) * x + x;
+
+  float yc = COS_P0;
+  yc = yc * z + COS_P1;
+  yc = yc * z + COS_P2;
+  yc = (yc * z) * z;
+  yc = yc - z * 0.5f;
+  yc = yc + 1.0f;
+
+  c = (j & 1) ? ys : yc;
+  s = (j & 1) ? yc : ys;
+  if ((j + 1) & 2)
+    c = -c;
+  if (j & 2)
+    s = -s;
+}
+
+static inline float
+uniform_ps(uint32_t w)
+{
+  return (float)(int32_t)(w >> 8) * UNIFORM_SCALE + UNIFORM_OFFSET;
+}
+
+static inline float
+fine_ps(uint32_t w)
+{
+  return (float)(int32_t)(w >> 1) * FINE_SCALE + FINE_OFFSET;
+}
+
+static inline float
+radius_ps(uint32_t w)
+{
+  const float l2 = log_ps(fine_ps(w)) * -2.0f;
+  return sqrtf(l2 > 0.0f ? l2 : 0.0f);
+}
+
+void
+gri_philox_rng::unit(int dist, uint64_t u, float ampl, float param, float out[16]) const
+{
+  // four consecutive blocks, word j of block i at w[j][i]
+  uint32_t w[4][4];
+  for (int i = 0; i < 4; i++) {
+    const uint64_t b = u * 4 + i;
+    const uint32_t ctr[4] = { (uint32_t) b, (uint32_t)(b >> 32), d_stream[0], d_stream[1] };
+    uint32_t r[4];
+    philox(ctr, d_key, r);
+    for (int j = 0; j < 4; j++)
+      w[j][i] = r[j];
+  }
+
+  switch (dist) {
+  case UNIFORM:
+    for (int j = 0; j < 4; j++)
+      for (int i = 0; i < 4; i++)
+        out[4*j + i] = uniform_ps(w[j][i]) * ampl;
+    break;
+
+  case GAUSSIAN:
+    for (int j = 0; j < 4; j += 2) {
+      for (int i = 0; i < 4; i++) {
+        const float r = radius_ps(w[j][i]) * ampl;
+        float c, s;
+        sincos_ps(w[j+1][i], c, s);
+        out[4*j + 2*i] = r * c;
+        out[4*j + 2*i + 1] = r * s;
+      }
+    }
+    break;
+
+  case LAPLACIAN:
+    for (int j = 0; j < 4; j++) {
+      for (int i = 0; i < 4; i++) {
+        const float v = uniform_ps(w[j][i]);
+        const float l = log_ps(1.0f - fabsf(v)) * -(float) M_SQRT1_2;
+        out[4*j + i] = (v < 0 ? -l : l) * ampl;
+      }
+    }
+    break;
+
+  case RAYLEIGH:
+    for (int j = 0; j < 4; j++)
+      for (int i = 0; i < 4; i++)
+        out[4*j + i] = radius_ps(w[j][i]) * ampl;
+    break;
+
+  case IMPULSE:
+    for (int j = 0; j < 4; j++) {
+      for (int i = 0; i < 4; i++) {
+        const float z = log_ps(fine_ps(w[j][i])) * -(float) M_SQRT2;
+        out[4*j + i] = z > param ? z * ampl : 0.0f;
+      }
+    }
+    break;
+  }
+}
+
+#endif /* __SSE2__ */
+
+/***********************************************************************
+ * Block fills. Whole units go straight to the output, a unit that is
+ * cut by the start or the end of the call goes through a scratch copy.
+ **********************************************************************/
+
+void
+gri_philox_rng::fill(int dist, float *out, size_t n, float ampl, float param)
+{
+  float tmp[UNIT];
+  uint64_t u = d_pos / UNIT;
+  const size_t off = d_pos % UNIT;
+  d_pos += n;
+
+  if (off) {
+    const size_t m = std::min(n, UNIT - off);
+    unit(dist, u++, ampl, param, tmp);
+    std::copy(tmp + off, tmp + off + m, out);
+    out += m;
+    n -= m;
+  }
+
+  for (; n >= UNIT; n -= UNIT, out += UNIT)
+    unit(dist, u++, ampl, param, out);
+
+  if (n) {
+    unit(dist, u, ampl, param, tmp);
+    std::copy(tmp, tmp + n, out);
+  }
+}
+
+void
+gri_philox_rng::uniform(float *out, size_t n, float ampl)
+{
+  fill(UNIFORM, out, n, ampl, 0);
+}
+
+void
+gri_philox_rng::uniform(gr_complex *out, size_t n, float ampl)
+{
+  fill(UNIFORM, (float *) out, 2*n, ampl, 0);
+}
+
+void
+gri_philox_rng::gaussian(float *out, size_t n, float ampl)
+{
+  fill(GAUSSIAN, out, n, ampl, 0);
+}
+
+void
+gri_philox_rng::gaussian(gr_complex *out, size_t n, float ampl)
+{
+  fill(GAUSSIAN, (float *) out, 2*n, ampl, 0);
+}
+
+void
+gri_philox_rng::add_gaussian(gr_complex *out, const gr_complex *in, size_t n, float ampl)
+{
+  gr_complex noise[128];
+  while (n) {
+    const size_t m = std::min(n, sizeof(noise) / sizeof(noise[0]));
+    gaussian(noise, m, ampl);
+    for (size_t i = 0; i < m; i++)
+      out[i] = in[i] + noise[i];
+    out += m;
+    in += m;
+    n -= m;
+  }
+}
+
+void
+gri_philox_rng::laplacian(float *out, size_t n, float ampl)
+{
+  fill(LAPLACIAN, out, n, ampl, 0);
+}
+
+void
+gri_philox_rng::rayleigh(float *out, size_t n, float ampl)
+{
+  fill(RAYLEIGH, out, n, ampl, 0);
+}
+
+void
+gri_philox_rng::impulse(float *out, size_t n, float ampl, float factor)
+{
+  fill(IMPULSE, out, n, ampl, factor);
+}
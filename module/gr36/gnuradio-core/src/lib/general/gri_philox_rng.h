@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_GRI_PHILOX_RNG_H
+#define INCLUDED_GRI_PHILOX_RNG_H
+
+#include <gr_core_api.h>
+#include <gr_complex.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * \brief Counter based random number generator with block fills
+ * \ingroup math_blk
+ *
+ * Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as
+ * 1, 2, 3") keyed by the seed. Word k of the stream is a pure
+ * function of (seed, stream, k), so there is no state besides the
+ * position: filling n1 and then n2 items gives exactly the same
+ * values as filling n1 + n2 at once, and seek() jumps anywhere in
+ * constant time.
+ *
+ * Every output float consumes one word of the stream (a complex
+ * item two), whatever the distribution. Words are produced sixteen
+ * at a time and converted four lanes wide: Gaussian deviates by
+ * Box-Muller, two per pair of words, with polynomial log and sincos
+ * that the SSE2 and the portable code evaluate identically. A
+ * complex Gaussian item is one Box-Muller pair.
+ *
+ * All distributions are scaled by \p ampl; the unscaled Gaussian,
+ * Laplacian and uniform (on (-1, 1)) deviates have zero mean, the
+ * Gaussian and Laplacian unit variance, which matches gr_random.
+ */
+class GR_CORE_API gri_philox_rng
+{
+ public:
+  gri_philox_rng(uint64_t seed = 0, uint64_t stream = 0);
+
+  //! restart at position 0 of another key and stream
+  void reseed(uint64_t seed, uint64_t stream = 0);
+
+  //! words consumed so far
+  uint64_t position() const { return d_pos; }
+  void seek(uint64_t position) { d_pos = position; }
+  void skip(uint64_t nwords) { d_pos += nwords; }
+
+  //! ampl times a deviate uniform on (-1, 1)
+  void uniform(float *out, size_t n, float ampl = 1.0f);
+  void uniform(gr_complex *out, size_t n, float ampl = 1.0f);
+
+  //! ampl times a zero mean, unit variance normal deviate
+  void gaussian(float *out, size_t n, float ampl = 1.0f);
+
+  //! real and imaginary parts independent, each of unit variance
+  void gaussian(gr_complex *out, size_t n, float ampl = 1.0f);
+
+  //! out[i] = in[i] + ampl * complex Gaussian, in may equal out
+  void add_gaussian(gr_complex *out, const gr_complex *in, size_t n, float ampl);
+
+  //! zero mean, unit variance Laplacian
+  void laplacian(float *out, size_t n, float ampl = 1.0f);
+
+  //! sqrt(-2 ln u), the magnitude of a complex Gaussian item
+  void rayleigh(float *out, size_t n, float ampl = 1.0f);
+
+  //! -sqrt(2) ln u where above factor, 0 elsewhere (see gr_random)
+  void impulse(float *out, size_t n, float ampl = 1.0f, float factor = 5.0f);
+
+  //! the raw Philox4x32-10 bijection, for tests
+  static void philox(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]);
+
+ private:
+  uint32_t d_key[2];
+  uint32_t d_stream[2];
+  uint64_t d_pos;
+
+  void fill(int dist, float *out, size_t n, float ampl, float param);
+  void unit(int dist, uint64_t u, float ampl, float param, float out[16]) const;
+};
+
+#endif /* INCLUDED_GRI_PHILOX_RNG_H */
@@ -34,6 +34,10 @@
 #include <qa_gr_fxpt_vco.h>
 #include <qa_gr_math.h>
 #include <qa_gri_lfsr.h>
+#include <qa_gri_nco_engine.h>
+#include <qa_gri_agc_engine.h>
+#include <qa_gri_philox_rng.h>
+#include <qa_gri_access_code_correlator.h>
 
 CppUnit::TestSuite *
 qa_general::suite ()
@@ -48,6 +52,10 @@ qa_general::suite ()
   s->addTest (qa_gr_fxpt_vco::suite ());
   s->addTest (qa_gr_math::suite ());
   s->addTest (qa_gri_lfsr::suite ());
+  s->addTest (qa_gri_nco_engine::suite ());
+  s->addTest (qa_gri_agc_engine::suite ());
+  s->addTest (qa_gri_philox_rng::suite ());
+  s->addTest (qa_gri_access_code_correlator::suite ());
 
   return s;
 }
@@ -0,0 +1,153 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <qa_gri_access_code_correlator.h>
+#include <gri_access_code_correlator.h>
+#include <gr_count_bits.h>
+#include <cppunit/TestAssert.h>
+#include <stdlib.h>
+#include <vector>
+
+static const unsigned int lengths[] = { 1, 7, 32, 63, 64 };
+static const unsigned int thresholds[] = { 0, 1, 3, 12, 64 };
+
+static std::string
+random_code(unsigned int len)
+{
+  std::string code;
+  for (unsigned int i = 0; i < len; i++)
+    code += (random() & 1) ? '1' : '0';
+  return code;
+}
+
+// random bits with copies of the code, some of them damaged
+static std::vector<unsigned char>
+random_stream(const std::string &code, int n)
+{
+  std::vector<unsigned char> bits(n);
+  for (int i = 0; i < n; i++)
+    bits[i] = random() & 0xff;    // only the LSB counts
+  for (int k = 0; k < n / 200; k++) {
+    const int at = random() % n;
+    for (size_t j = 0; j < code.size() && at + j < (size_t) n; j++)
+      bits[at + j] = (code[j] & 1) ^ (random() % 8 == 0);
+  }
+  return bits;
+}
+
+// feed the stream in random chunks
+static std::vector<int>
+run(gri_access_code_correlator &c, const std::vector<unsigned char> &bits)
+{
+  std::vector<int> all, some;
+  int k = 0;
+  const int n = bits.size();
+  while (k < n) {
+    const int m = std::min(n - k, (int)(random() % 300));
+    some.clear();
+    c.search(&bits[k], m, some);
+    for (size_t i = 0; i < some.size(); i++) {
+      CPPUNIT_ASSERT(some[i] >= 0 && some[i] < m);
+      all.push_back(k + some[i]);
+    }
+    k += m;
+  }
+  return all;
+}
+
+void
+qa_gri_access_code_correlator::test_brute_force()
+{
+  srandom(1);
+  const int n = 5000;
+
+  for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+    for (size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); t++) {
+      const unsigned int len = lengths[l];
+      const std::string code = random_code(len);
+      const std::vector<unsigned char> bits = random_stream(code, n);
+
+      // count the wrong bits ending at every offset, zeros before the start
+      std::vector<int> expected;
+      for (int k = 0; k < n; k++) {
+        unsigned int wrong = 0;
+        for (unsigned int j = 0; j < len; j++) {
+          const int at = k - (int) len + (int) j;
+          const int bit = at < 0 ? 0 : bits[at] & 1;
+          wrong += bit != (code[j] & 1);
+        }
+        if (wrong <= thresholds[t])
+          expected.push_back(k);
+      }
+
+      gri_access_code_correlator c(thresholds[t]);
+      CPPUNIT_ASSERT(c.set_access_code(code));
+      CPPUNIT_ASSERT(run(c, bits) == expected);
+    }
+  }
+
+  gri_access_code_correlator c;
+  CPPUNIT_ASSERT(!c.set_access_code(std::string(65, '1')));
+}
+
+void
+qa_gri_access_code_correlator::test_shift_register()
+{
+  // the former per bit loop of gr_correlate_access_code_tag_bb, which
+  // finds the same codes 64 - len bits later
+  srandom(2);
+  const int n = 20000;
+
+  for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+    const unsigned int len = lengths[l];
+    const unsigned int threshold = 3;
+    const std::string code = random_code(len);
+    const std::vector<unsigned char> bits = random_stream(code, n);
+
+    unsigned long long access_code = 0;
+    for (unsigned i = 0; i < 64; i++) {
+      access_code <<= 1;
+      if (i < len)
+        access_code |= code[i] & 1;
+    }
+    const unsigned long long mask = ((~0ULL) >> (64 - len)) << (64 - len);
+
+    unsigned long long reg = 0;
+    std::vector<int> expected;
+    for (int i = 0; i < n; i++) {
+      if (gr_count_bits64((reg ^ access_code) & mask) <= threshold) {
+        const int at = i - 64 + len;
+        if (at >= 0)
+          expected.push_back(at);
+      }
+      reg = (reg << 1) | (bits[i] & 1);
+    }
+
+    gri_access_code_correlator c(threshold);
+    c.set_access_code(code);
+    std::vector<int> found = run(c, bits);
+    while (!found.empty() && found.back() >= n - 64 + (int) len)
+      found.pop_back();
+    CPPUNIT_ASSERT(found == expected);
+  }
+}
@@ -0,0 +1,205 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <qa_gri_agc_engine.h>
+#include <gri_agc_engine.h>
+#include <gri_agc_cc.h>
+#include <gri_agc_ff.h>
+#include <gri_agc2_cc.h>
+#include <gri_agc2_ff.h>
+#include <cppunit/TestAssert.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// scaleN call lengths that land on, just short of and just past sub-blocks
+static const unsigned lengths[] = { 1, 15, 16, 17, 255, 256, 300, 1000 };
+static const int nlengths = sizeof(lengths) / sizeof(lengths[0]);
+
+// a tone whose envelope steps over four decades and wobbles slowly
+static std::vector<gr_complex>
+make_input(int n)
+{
+  static const float steps[] = { 0.1f, 10.0f, 1.0f, 0.01f, 3.0f };
+  std::vector<gr_complex> in(n);
+  for (int i = 0; i < n; i++) {
+    const float ampl = steps[(5*i/n) % 5] * (1.0f + 0.3f*std::sin(0.002f*i));
+    in[i] = std::polar(ampl, 0.05f*i);
+  }
+  return in;
+}
+
+static std::vector<float>
+real_part(const std::vector<gr_complex> &in)
+{
+  std::vector<float> out(in.size());
+  for (size_t i = 0; i < in.size(); i++)
+    out[i] = in[i].real() + 0.5f*in[i].imag();
+  return out;
+}
+
+// run scale() per sample and scaleN in uneven pieces, return the largest
+// output difference relative to the reference level
+template <class agc_t, class T>
+static double
+compare(agc_t ref, agc_t agc, const std::vector<T> &in, bool block_mode)
+{
+  const size_t n = in.size();
+  std::vector<T> expected(n), out(n);
+  for (size_t i = 0; i < n; i++)
+    expected[i] = ref.scale(in[i]);
+
+  agc.set_block_mode(block_mode);
+  for (size_t i = 0, k = 0; i < n; k++) {
+    const size_t m = std::min((size_t) lengths[k % nlengths], n - i);
+    agc.scaleN(&out[i], &in[i], m);
+    i += m;
+  }
+
+  double err = 0;
+  for (size_t i = 0; i < n; i++)
+    err = std::max(err, (double) std::abs(out[i] - expected[i]) / ref.reference());
+  return err;
+}
+
+// block mode against the per sample loop: within each sub-block the
+// output may differ by BLOCK_SIZE*rate*|reference - |out||*|in|
+template <class agc_t, class T>
+static double
+block_error(agc_t ref, agc_t agc, const std::vector<T> &in, double rate)
+{
+  const size_t n = in.size();
+  const size_t K = gri_agc_engine::BLOCK_SIZE;
+  std::vector<T> expected(n), out(n);
+  for (size_t i = 0; i < n; i++)
+    expected[i] = ref.scale(in[i]);
+  agc.set_block_mode(true);
+  agc.scaleN(&out[0], &in[0], n);
+
+  double worst = 0;
+  for (size_t b = 0; b < n; b += K) {
+    double dev = 0, ampl = 0, err = 0;
+    for (size_t i = b; i < b + K; i++) {
+      dev = std::max(dev, (double) std::abs(ref.reference() - std::abs(expected[i])));
+      ampl = std::max(ampl, (double) std::abs(in[i]));
+      err = std::max(err, (double) std::abs(out[i] - expected[i]));
+    }
+    worst = std::max(worst, err / (K*rate*dev*ampl + 1e-5));
+  }
+  return worst;
+}
+
+void
+qa_gri_agc_engine::test_sample_mode()
+{
+  const std::vector<gr_complex> in = make_input(20000);
+  const std::vector<float> in_f = real_part(in);
+
+  // same loop on magnitudes computed up front, a few ulp apart
+  CPPUNIT_ASSERT(compare(gri_agc_cc(1e-3, 1.0, 1.0, 1000),
+			 gri_agc_cc(1e-3, 1.0, 1.0, 1000), in, false) < 1e-5);
+  CPPUNIT_ASSERT(compare(gri_agc_ff(1e-3, 1.0, 1.0, 1000),
+			 gri_agc_ff(1e-3, 1.0, 1.0, 1000), in_f, false) < 1e-5);
+  CPPUNIT_ASSERT(compare(gri_agc2_cc(1e-2, 1e-3, 1.0, 1.0, 1000),
+			 gri_agc2_cc(1e-2, 1e-3, 1.0, 1.0, 1000), in, false) < 1e-5);
+  CPPUNIT_ASSERT(compare(gri_agc2_ff(1e-2, 1e-3, 1.0, 1.0, 1000),
+			 gri_agc2_ff(1e-2, 1e-3, 1.0, 1.0, 1000), in_f, false) < 1e-5);
+}
+
+void
+qa_gri_agc_engine::test_block_mode()
+{
+  // constant envelope: the closed form is the per sample loop, so the
+  // outputs agree at every sub-block start and the loops settle alike
+  const int n = 4096;
+  std::vector<gr_complex> tone(n), expected(n), out(n);
+  for (int i = 0; i < n; i++)
+    tone[i] = std::polar(10.0f, 0.05f*i);
+
+  gri_agc_cc ref(1e-3, 1.0, 1.0, 1000), agc(ref);
+  agc.set_block_mode(true);
+  for (int i = 0; i < n; i++)
+    expected[i] = ref.scale(tone[i]);
+  agc.scaleN(&out[0], &tone[0], n);
+  for (int i = 0; i < n; i += gri_agc_engine::BLOCK_SIZE)
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::abs(expected[i]), std::abs(out[i]),
+				 1e-5*std::abs(expected[i]));
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, std::abs(out[n-1]), 1e-5);
+
+  gri_agc2_cc ref2(1e-2, 1e-3, 1.0, 1.0, 1000), agc2(ref2);
+  agc2.set_block_mode(true);
+  agc2.scaleN(&out[0], &tone[0], n);
+  for (int i = 0; i < n; i++)
+    expected[i] = ref2.scale(tone[i]);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, std::abs(expected[n-1]), 1e-5);
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, std::abs(out[n-1]), 1e-5);
+
+  // stepped and wobbling envelope: within the documented per sub-block
+  // bound, with room for lag carried over from earlier sub-blocks
+  const std::vector<gr_complex> in = make_input(20000);
+  const std::vector<float> in_f = real_part(in);
+  CPPUNIT_ASSERT(block_error(gri_agc_cc(1e-3, 1.0, 1.0, 1000),
+			     gri_agc_cc(1e-3, 1.0, 1.0, 1000), in, 1e-3) < 2.5);
+  CPPUNIT_ASSERT(block_error(gri_agc_ff(1e-3, 1.0, 1.0, 1000),
+			     gri_agc_ff(1e-3, 1.0, 1.0, 1000), in_f, 1e-3) < 2.5);
+  CPPUNIT_ASSERT(block_error(gri_agc2_cc(1e-2, 1e-3, 1.0, 1.0, 1000),
+			     gri_agc2_cc(1e-2, 1e-3, 1.0, 1.0, 1000), in, 1e-2) < 2.5);
+  CPPUNIT_ASSERT(block_error(gri_agc2_ff(1e-2, 1e-3, 1.0, 1.0, 1000),
+			     gri_agc2_ff(1e-2, 1e-3, 1.0, 1.0, 1000), in_f, 1e-2) < 2.5);
+}
+
+// gr_feedforward_agc_cc's original envelope
+static float
+envelope(gr_complex x)
+{
+  float r_abs = std::fabs(x.real());
+  float i_abs = std::fabs(x.imag());
+
+  if (r_abs > i_abs)
+    return r_abs + 0.4 * i_abs;
+  else
+    return i_abs + 0.4 * r_abs;
+}
+
+void
+qa_gri_agc_engine::test_feedforward()
+{
+  static const size_t windows[] = { 1, 2, 15, 16, 100 };
+  const std::vector<gr_complex> in = make_input(2000);
+  std::vector<float> env(in.size()), out(in.size()), scratch(2*in.size());
+
+  gri_agc_engine::envelope(&env[0], &in[0], in.size());
+  for (size_t i = 0; i < in.size(); i++)
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(envelope(in[i]), env[i], 1e-6*env[i]);
+
+  for (int w = 0; w < 5; w++) {
+    for (int l = 0; l < nlengths; l++) {
+      const size_t window = windows[w], n = lengths[l];
+      gri_agc_engine::window_max(&out[0], &env[0], n, window, &scratch[0]);
+      for (size_t i = 0; i < n; i++) {
+	const float expected = *std::max_element(&env[i], &env[i] + window);
+	CPPUNIT_ASSERT_EQUAL(expected, out[i]);
+      }
+    }
+  }
+}
@@ -20,9 +20,11 @@
  */
 
 #include <gri_lfsr.h>
+#include <gri_glfsr.h>
 #include <qa_gri_lfsr.h>
 #include <cppunit/TestAssert.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <vector>
 
@@ -140,3 +142,71 @@ qa_gri_lfsr::test_descrambler()
 
   CPPUNIT_ASSERT(memcmp(expected, &actual[0], len) == 0);
 }
+
+/*
+ * The block methods must match the bit at a time methods exactly,
+ * including the register state left behind for the next call
+ */
+void
+qa_gri_lfsr::test_block_lfsr()
+{
+  // odd lengths exercise the 64 bit blocks and the tails
+  const int sizes[] = {1, 63, 64, 65, 200, 1000};
+  srandom(12345);
+
+  for (int len = 0; len < 32; len++) {
+    for (int trial = 0; trial < 4; trial++) {
+      // include seeds and masks with bits above the register
+      int mask = random() & 0x7fffffff;
+      int seed = random() & ((trial == 0) ? 0x7fffffff : (int)((1ULL << (len+1))-1));
+      if (len < 31 && trial == 1)
+	mask &= (1u << (len+1))-1;
+
+      gri_lfsr gen1(mask, seed, len), gen2(mask, seed, len);
+      gri_lfsr scr1(mask, seed, len), scr2(mask, seed, len);
+      gri_lfsr des1(mask, seed, len), des2(mask, seed, len);
+
+      for (size_t s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++) {
+	const int n = sizes[s];
+	std::vector<unsigned char> in(n), expected(n), actual(n);
+	for (int i = 0; i < n; i++)
+	  in[i] = random() & 0xff;
+
+	for (int i = 0; i < n; i++)
+	  expected[i] = gen1.next_bit();
+	gen2.next_bits(&actual[0], n);
+	CPPUNIT_ASSERT(memcmp(&expected[0], &actual[0], n) == 0);
+
+	for (int i = 0; i < n; i++)
+	  expected[i] = scr1.next_bit_scramble(in[i]);
+	scr2.next_bits_scramble(&actual[0], &in[0], n);
+	CPPUNIT_ASSERT(memcmp(&expected[0], &actual[0], n) == 0);
+
+	for (int i = 0; i < n; i++)
+	  expected[i] = des1.next_bit_descramble(in[i]);
+	des2.next_bits_descramble(&actual[0], &in[0], n);
+	CPPUNIT_ASSERT(memcmp(&expected[0], &actual[0], n) == 0);
+      }
+    }
+  }
+}
+
+void
+qa_gri_lfsr::test_block_glfsr()
+{
+  const int sizes[] = {1, 63, 64, 65, 200, 1000};
+
+  for (int degree = 1; degree <= 32; degree++) {
+    const int mask = gri_glfsr::glfsr_mask(degree);
+    gri_glfsr glfsr1(mask, 1), glfsr2(mask, 1);
+
+    for (size_t s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++) {
+      const int n = sizes[s];
+      std::vector<unsigned char> expected(n), actual(n);
+      for (int i = 0; i < n; i++)
+	expected[i] = glfsr1.next_bit();
+      glfsr2.next_bits(&actual[0], n);
+      CPPUNIT_ASSERT(memcmp(&expected[0], &actual[0], n) == 0);
+    }
+  }
+}
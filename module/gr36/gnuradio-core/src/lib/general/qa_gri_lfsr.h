@@ -31,12 +31,16 @@ class qa_gri_lfsr : public CppUnit::TestCase {
   CPPUNIT_TEST(test_lfsr);
   CPPUNIT_TEST(test_scrambler);
   CPPUNIT_TEST(test_descrambler);
+  CPPUNIT_TEST(test_block_lfsr);
+  CPPUNIT_TEST(test_block_glfsr);
   CPPUNIT_TEST_SUITE_END();
 
  private:
   void test_lfsr();
   void test_scrambler();
   void test_descrambler();
+  void test_block_lfsr();
+  void test_block_glfsr();
 };
 
 #endif /* _QA_GRI_LFSR_H_ */
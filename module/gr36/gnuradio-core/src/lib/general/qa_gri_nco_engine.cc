@@ -0,0 +1,177 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <qa_gri_nco_engine.h>
+#include <gri_nco_engine.h>
+#include <gr_nco.h>
+#include <cppunit/TestAssert.h>
+#include <cmath>
+#include <vector>
+
+static const double freqs[] = { 0.0, 1e-7, 0.001, -0.001, 0.1234567, -2.5, 3.0 };
+static const int nfreqs = sizeof(freqs) / sizeof(freqs[0]);
+
+// lengths that land on, just short of and just past block boundaries
+static const int lengths[] = { 1, 3, 63, 64, 65, 1000, 4099 };
+static const int nlengths = sizeof(lengths) / sizeof(lengths[0]);
+
+// a few float ulp at amplitude 2
+static const double TOLERANCE = 1e-6;
+
+static double
+wrap(double x)
+{
+  return x - 2*M_PI * std::floor(x / (2*M_PI) + 0.5);
+}
+
+void
+qa_gri_nco_engine::test_fixed_point()
+{
+  CPPUNIT_ASSERT_EQUAL(uint64_t(0), gri_nco_engine::to_fixed(0.0));
+  CPPUNIT_ASSERT_EQUAL(uint64_t(1) << 62, gri_nco_engine::to_fixed(M_PI/2));
+  CPPUNIT_ASSERT_EQUAL(uint64_t(3) << 62, gri_nco_engine::to_fixed(-M_PI/2));
+  CPPUNIT_ASSERT_EQUAL(uint64_t(0), gri_nco_engine::to_fixed(4*M_PI));
+
+  for (int i = 0; i < nfreqs; i++) {
+    const double f = gri_nco_engine::to_radians(gri_nco_engine::to_fixed(freqs[i]));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(freqs[i], f, 1e-15);
+  }
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(-M_PI, gri_nco_engine::to_radians(gri_nco_engine::to_fixed(M_PI)), 1e-15);
+}
+
+void
+qa_gri_nco_engine::test_accuracy()
+{
+  for (int i = 0; i < nfreqs; i++) {
+    for (int j = 0; j < nlengths; j++) {
+      const int n = lengths[j];
+      std::vector<gr_complex> sc(n);
+      std::vector<float> s(n), c(n);
+
+      gri_nco_engine e1, e2, e3;
+      e1.set_phase(0.3); e1.set_freq(freqs[i]);
+      e2.set_phase(0.3); e2.set_freq(freqs[i]);
+      e3.set_phase(0.3); e3.set_freq(freqs[i]);
+      e1.sincos(&sc[0], n, 2.0f);
+      e2.sin(&s[0], n, 2.0f);
+      e3.cos(&c[0], n, 2.0f);
+
+      const double f = e1.get_freq();
+      for (int k = 0; k < n; k++) {
+	const double ph = wrap(0.3 + f*k);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2*std::cos(ph), sc[k].real(), TOLERANCE);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2*std::sin(ph), sc[k].imag(), TOLERANCE);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2*std::sin(ph), s[k], TOLERANCE);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2*std::cos(ph), c[k], TOLERANCE);
+      }
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(wrap(0.3 + f*n), e1.get_phase(), 1e-9);
+    }
+  }
+}
+
+void
+qa_gri_nco_engine::test_long_run()
+{
+  // a billion samples in odd sized calls lands exactly where one big
+  // step does, and the output there is as good as at the start
+  const int n = 4093;
+  const int calls = 1 << 18;
+  std::vector<gr_complex> buf(n);
+
+  gri_nco_engine run, jump;
+  run.set_freq(0.1);
+  jump.set_freq(0.1);
+  for (int i = 0; i < calls; i++)
+    run.sincos(&buf[0], n);
+  jump.step(uint64_t(n) * calls);
+  CPPUNIT_ASSERT_EQUAL(jump.get_phase(), run.get_phase());
+
+  const double ph = run.get_phase();
+  run.sincos(&buf[0], n);
+  for (int k = 0; k < n; k++) {
+    const double ref = wrap(ph + run.get_freq()*k);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::cos(ref), buf[k].real(), TOLERANCE);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::sin(ref), buf[k].imag(), TOLERANCE);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, std::abs(buf[k]), TOLERANCE);
+  }
+}
+
+void
+qa_gri_nco_engine::test_rotate()
+{
+  const int n = 1001;
+  std::vector<gr_complex> in(n), out(n), lo(n);
+  for (int k = 0; k < n; k++)
+    in[k] = gr_complex(std::cos(0.01*k), 0.5f - (k % 7) * 0.1f);
+
+  for (int i = 0; i < nfreqs; i++) {
+    gri_nco_engine r, o;
+    r.set_phase(-1.0); r.set_freq(freqs[i]);
+    o.set_phase(-1.0); o.set_freq(freqs[i]);
+
+    // out of place, then in place on a copy
+    r.rotate(&out[0], &in[0], n);
+    o.sincos(&lo[0], n);
+    for (int k = 0; k < n; k++) {
+      const gr_complex ref = in[k] * lo[k];
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(ref.real(), out[k].real(), TOLERANCE);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(ref.imag(), out[k].imag(), TOLERANCE);
+    }
+
+    std::vector<gr_complex> io(in);
+    r.set_phase(-1.0);
+    r.rotate(&io[0], &io[0], n);
+    for (int k = 0; k < n; k++)
+      CPPUNIT_ASSERT(io[k] == out[k]);
+  }
+}
+
+void
+qa_gri_nco_engine::test_gr_nco()
+{
+  // gr_nco's block methods follow its per sample methods and keep
+  // their phase across calls
+  const int n = 777;
+  gr_nco<float,float> block, sample;
+  block.set_freq(0.05);
+  sample.set_freq(0.05);
+
+  std::vector<gr_complex> out(n);
+  for (int call = 0; call < 3; call++) {
+    block.sincos(&out[0], n, 3.0);
+    for (int k = 0; k < n; k++) {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(3*sample.cos(), out[k].real(), 1e-5);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(3*sample.sin(), out[k].imag(), 1e-5);
+      sample.step();
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(sample.get_phase(), block.get_phase(), 1e-9);
+  }
+
+  std::vector<short> s(n);
+  block.adjust_phase(1.0);
+  sample.adjust_phase(1.0);
+  block.sin(&s[0], n, 1000.0);
+  for (int k = 0; k < n; k++) {
+    CPPUNIT_ASSERT(std::abs(s[k] - (short)(sample.sin() * 1000.0)) <= 1);
+    sample.step();
+  }
+}
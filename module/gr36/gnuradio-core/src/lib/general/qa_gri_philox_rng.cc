@@ -0,0 +1,178 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <qa_gri_philox_rng.h>
+#include <gri_philox_rng.h>
+#include <cppunit/TestAssert.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+
+enum { UNIFORM, GAUSSIAN, LAPLACIAN, RAYLEIGH, IMPULSE, COMPLEX_GAUSSIAN, NDISTS };
+
+static void
+fill(gri_philox_rng &rng, int dist, float *out, size_t n)
+{
+  switch (dist) {
+  case UNIFORM: rng.uniform(out, n, 2.0f); break;
+  case GAUSSIAN: rng.gaussian(out, n, 2.0f); break;
+  case LAPLACIAN: rng.laplacian(out, n, 2.0f); break;
+  case RAYLEIGH: rng.rayleigh(out, n, 2.0f); break;
+  case IMPULSE: rng.impulse(out, n, 2.0f, 3.0f); break;
+  case COMPLEX_GAUSSIAN: rng.gaussian((gr_complex *) out, n / 2, 2.0f); break;
+  }
+}
+
+void
+qa_gri_philox_rng::test_known_answers()
+{
+  // Random123 kat_vectors, philox4x32 10 rounds
+  static const uint32_t vectors[][10] = {
+    { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+      0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+    { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+      0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+    { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0,
+      0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 },
+  };
+
+  for (size_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++) {
+    uint32_t out[4];
+    gri_philox_rng::philox(&vectors[v][0], &vectors[v][4], out);
+    for (int i = 0; i < 4; i++)
+      CPPUNIT_ASSERT_EQUAL(vectors[v][6+i], out[i]);
+  }
+}
+
+void
+qa_gri_philox_rng::test_chunking()
+{
+  // chunk sizes that cut units at every offset
+  static const size_t chunks[] = { 1, 3, 16, 5, 31, 17, 2, 64, 7, 100 };
+  const size_t nchunks = sizeof(chunks) / sizeof(chunks[0]);
+  const size_t n = 2000;
+
+  for (int dist = 0; dist < NDISTS; dist++) {
+    std::vector<float> whole(n), pieces(n), tail(n);
+    gri_philox_rng a(12345, 6), b(12345, 6), c(12345, 6);
+    fill(a, dist, &whole[0], n);
+
+    size_t k = 0;
+    for (size_t i = 0; k < n; i++) {
+      size_t m = std::min(chunks[i % nchunks], n - k);
+      if (dist == COMPLEX_GAUSSIAN)
+        m = (m + 1) & ~size_t(1);
+      fill(b, dist, &pieces[k], m);
+      k += m;
+    }
+    CPPUNIT_ASSERT_EQUAL(uint64_t(n), b.position());
+    CPPUNIT_ASSERT(memcmp(&whole[0], &pieces[0], n * sizeof(float)) == 0);
+
+    // jumping ahead gives the same words as getting there
+    c.seek(1234);
+    fill(c, dist, &tail[0], n - 1234);
+    CPPUNIT_ASSERT(memcmp(&whole[1234], &tail[0], (n - 1234) * sizeof(float)) == 0);
+  }
+
+  // add_gaussian is the complex Gaussian fill plus the input
+  std::vector<gr_complex> noise(1000), in(1000), out(1000);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = gr_complex(i, -float(i));
+  gri_philox_rng d(7), e(7);
+  d.gaussian(&noise[0], noise.size(), 0.5f);
+  e.add_gaussian(&out[0], &in[0], in.size(), 0.5f);
+  for (size_t i = 0; i < in.size(); i++) {
+    const gr_complex expected = in[i] + noise[i];
+    CPPUNIT_ASSERT(expected == out[i]);
+  }
+}
+
+void
+qa_gri_philox_rng::test_seeds()
+{
+  const size_t n = 256;
+  std::vector<float> a(n), b(n), c(n), d(n);
+  gri_philox_rng ra(1), rb(1), rc(2), rd(1, 1);
+  ra.uniform(&a[0], n);
+  rb.uniform(&b[0], n);
+  rc.uniform(&c[0], n);
+  rd.uniform(&d[0], n);
+  CPPUNIT_ASSERT(a == b);
+
+  // other seeds and streams are unrelated
+  int csame = 0, dsame = 0;
+  for (size_t i = 0; i < n; i++) {
+    csame += a[i] == c[i];
+    dsame += a[i] == d[i];
+  }
+  CPPUNIT_ASSERT(csame < 4);
+  CPPUNIT_ASSERT(dsame < 4);
+
+  ra.reseed(1);
+  ra.uniform(&c[0], n);
+  CPPUNIT_ASSERT(a == c);
+}
+
+void
+qa_gri_philox_rng::test_moments()
+{
+  const size_t n = 1 << 20;
+  std::vector<float> x(n);
+  gri_philox_rng rng(42);
+
+  // sample mean and variance to within a few standard errors
+  struct { int dist; double mean, var, lo, hi; } cases[] = {
+    { UNIFORM,          0.0,                   4.0 / 3, -2.0, 2.0 },
+    { GAUSSIAN,         0.0,                   4.0,     -15,  15 },
+    { COMPLEX_GAUSSIAN, 0.0,                   4.0,     -15,  15 },
+    { LAPLACIAN,        0.0,                   4.0,     -25,  25 },
+    { RAYLEIGH,         2.0 * sqrt(M_PI / 2),  4.0 * (2 - M_PI / 2), 0, 15 },
+  };
+
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    fill(rng, cases[c].dist, &x[0], n);
+    double sum = 0, sum2 = 0;
+    for (size_t i = 0; i < n; i++) {
+      CPPUNIT_ASSERT(x[i] > cases[c].lo && x[i] < cases[c].hi);
+      sum += x[i];
+      sum2 += x[i] * x[i];
+    }
+    const double mean = sum / n;
+    const double var = sum2 / n - mean * mean;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(cases[c].mean, mean, 5 * sqrt(cases[c].var / n));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(cases[c].var, var, 0.01 * cases[c].var);
+  }
+
+  // the Gaussian tails: P(|x| > 3 sigma) = 0.0027
+  rng.gaussian(&x[0], n);
+  size_t outside = 0;
+  for (size_t i = 0; i < n; i++)
+    outside += std::fabs(x[i]) > 3;
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0027, double(outside) / n, 0.0003);
+
+  // pairs are uncorrelated
+  double sxy = 0;
+  for (size_t i = 0; i < n; i += 2)
+    sxy += x[i] * x[i+1];
+  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, sxy / (n / 2), 5 / sqrt(double(n / 2)));
+}
@@ -53,47 +53,47 @@ void
 @NAME@::generate()
 {
   int noutput_items = d_samples.size();
-  switch (d_type){
 #if @IS_COMPLEX@	// complex?
-
+  switch (d_type){
   case GR_UNIFORM:
-    for (int i = 0; i < noutput_items; i++)
-      d_samples[i] = gr_complex (d_ampl * ((d_rng.ran1 () * 2.0) - 1.0),
-			   d_ampl * ((d_rng.ran1 () * 2.0) - 1.0));
+    d_rng.uniform (&d_samples[0], noutput_items, d_ampl);
     break;
 
   case GR_GAUSSIAN:
-    for (int i = 0; i < noutput_items; i++)
-      d_samples[i] = d_ampl * d_rng.rayleigh_complex ();
+    d_rng.gaussian (&d_samples[0], noutput_items, d_ampl);
     break;
 
+  default:
+    throw std::runtime_error ("invalid type");
+  }
+
 #else			// nope...
 
+  std::vector<float> buf(noutput_items);
+  switch (d_type){
   case GR_UNIFORM:
-    for (int i = 0; i < noutput_items; i++)
-      d_samples[i] = (@TYPE@)(d_ampl * ((d_rng.ran1 () * 2.0) - 1.0));
+    d_rng.uniform (&buf[0], noutput_items, d_ampl);
     break;
 
   case GR_GAUSSIAN:
-    for (int i = 0; i < noutput_items; i++)
-      d_samples[i] = (@TYPE@)(d_ampl * d_rng.gasdev ());
+    d_rng.gaussian (&buf[0], noutput_items, d_ampl);
     break;
 
   case GR_LAPLACIAN:
-    for (int i = 0; i < noutput_items; i++)
-      d_samples[i] = (@TYPE@)(d_ampl * d_rng.laplacian ());
+    d_rng.laplacian (&buf[0], noutput_items, d_ampl);
     break;
 
   case GR_IMPULSE:	// FIXME changeable impulse settings
-    for (int i = 0; i < noutput_items; i++)
-      d_samples[i] = (@TYPE@)(d_ampl * d_rng.impulse (9));
+    d_rng.impulse (&buf[0], noutput_items, d_ampl, 9);
     break;
-#endif
 
   default:
     throw std::runtime_error ("invalid type");
   }
 
+  for (int i = 0; i < noutput_items; i++)
+    d_samples[i] = (@TYPE@) buf[i];
+#endif
 }
 
 int
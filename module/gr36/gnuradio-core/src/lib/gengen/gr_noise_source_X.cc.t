@@ -28,6 +28,7 @@
 #include <@NAME@.h>
 #include <gr_io_signature.h>
 #include <stdexcept>
+#include <vector>
 
 
 @NAME@_sptr
@@ -47,6 +48,34 @@ gr_make_@BASE_NAME@ (gr_noise_type_t type, float ampl, long seed)
 {
 }
 
+#if !@IS_COMPLEX@
+// integer outputs are filled through a float scratch buffer
+static inline float *
+noise_buffer (float *out, std::vector<float> &, int)
+{
+  return out;
+}
+
+template <class T> static float *
+noise_buffer (T *, std::vector<float> &buf, int n)
+{
+  buf.resize (n);
+  return &buf[0];
+}
+
+static inline void
+noise_copy (float *, const float *, int)
+{
+}
+
+template <class T> static void
+noise_copy (T *out, const float *in, int n)
+{
+  for (int i = 0; i < n; i++)
+    out[i] = (T) in[i];
+}
+#endif
+
 int
 @NAME@::work (int noutput_items,
 		   gr_vector_const_void_star &input_items,
@@ -54,46 +83,48 @@ int
 {
   @TYPE@ *out = (@TYPE@ *) output_items[0];
 
-  switch (d_type){
 #if @IS_COMPLEX@	// complex?
 
+  switch (d_type){
   case GR_UNIFORM:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = gr_complex (d_ampl * ((d_rng.ran1 () * 2.0) - 1.0),
-			   d_ampl * ((d_rng.ran1 () * 2.0) - 1.0));
+    d_rng.uniform (out, noutput_items, d_ampl);
     break;
 
   case GR_GAUSSIAN:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = d_ampl * d_rng.rayleigh_complex ();
+    d_rng.gaussian (out, noutput_items, d_ampl);
     break;
 
+  default:
+    throw std::runtime_error ("invalid type");
+  }
+
 #else			// nope...
 
+  float *buf = noise_buffer (out, d_buf, noutput_items);
+
+  switch (d_type){
   case GR_UNIFORM:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = (@TYPE@)(d_ampl * ((d_rng.ran1 () * 2.0) - 1.0));
+    d_rng.uniform (buf, noutput_items, d_ampl);
     break;
 
   case GR_GAUSSIAN:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = (@TYPE@)(d_ampl * d_rng.gasdev ());
+    d_rng.gaussian (buf, noutput_items, d_ampl);
     break;
 
   case GR_LAPLACIAN:
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = (@TYPE@)(d_ampl * d_rng.laplacian ());
+    d_rng.laplacian (buf, noutput_items, d_ampl);
     break;
 
   case GR_IMPULSE:	// FIXME changeable impulse settings
-    for (int i = 0; i < noutput_items; i++)
-      out[i] = (@TYPE@)(d_ampl * d_rng.impulse (9));
+    d_rng.impulse (buf, noutput_items, d_ampl, 9);
     break;
-#endif
 
   default:
     throw std::runtime_error ("invalid type");
   }
 
+  noise_copy (out, buf, noutput_items);
+#endif
+
   return noutput_items;
 }
@@ -28,7 +28,8 @@
 #include <gr_core_api.h>
 #include <gr_sync_block.h>
 #include <gr_noise_type.h>
-#include <gr_random.h>
+#include <gri_philox_rng.h>
+#include <vector>
 
 
 class @NAME@;
@@ -37,8 +38,8 @@ typedef boost::shared_ptr<@NAME@> @NAME@_sptr;
 /*! \brief Make a noise source
  * \param type  the random distribution to use (see gr_noise_type.h)
  * \param ampl  a scaling factor for the output
- * \param seed seed for random generators. Note that for uniform and
- * Gaussian distributions, this should be a negative number.
+ * \param seed seed for random generators. Equal seeds give equal
+ * output, whatever the work sizes.
  */
 GR_CORE_API @NAME@_sptr
 gr_make_@BASE_NAME@ (gr_noise_type_t type, float ampl, long seed = 0);
@@ -53,8 +54,8 @@ gr_make_@BASE_NAME@ (gr_noise_type_t type, float ampl, long seed = 0);
  *
  * \param type  the random distribution to use (see gr_noise_type.h)
  * \param ampl  a scaling factor for the output
- * \param seed seed for random generators. Note that for uniform and
- * Gaussian distributions, this should be a negative number.
+ * \param seed seed for random generators. Equal seeds give equal
+ * output, whatever the work sizes.
  */
 class GR_CORE_API @NAME@ : public gr_sync_block {
   friend GR_CORE_API @NAME@_sptr
@@ -63,7 +64,8 @@ class GR_CORE_API @NAME@ : public gr_sync_block {
 
   gr_noise_type_t	d_type;
   float			d_ampl;
-  gr_random		d_rng;
+  gri_philox_rng	d_rng;
+  std::vector<float>	d_buf;
 
   @NAME@ (gr_noise_type_t type, float ampl, long seed = 0);
 
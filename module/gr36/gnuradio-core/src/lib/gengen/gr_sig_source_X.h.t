@@ -28,7 +28,7 @@
 #include <gr_core_api.h>
 #include <gr_sync_block.h>
 #include <gr_sig_source_waveform.h>
-#include <gr_fxpt_nco.h>
+#include <gr_nco.h>
 
 class @NAME@;
 typedef boost::shared_ptr<@NAME@> @NAME@_sptr;
@@ -48,7 +48,7 @@ class GR_CORE_API @NAME@ : public gr_sync_block {
   double		d_frequency;
   double		d_ampl;
   @TYPE@		d_offset;
-  gr_fxpt_nco		d_nco;
+  gr_nco<float,float>	d_nco;
 
 
   @NAME@ (double sampling_freq, gr_waveform_t waveform,
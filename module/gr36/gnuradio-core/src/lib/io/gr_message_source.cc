@@ -34,6 +34,8 @@
 #include <stdexcept>
 #include <string.h>
 
+// messages taken from an unbounded queue at a time
+static const unsigned int MAX_PENDING = 64;
 
 // public constructor that returns a shared_ptr
 
@@ -54,7 +56,7 @@ gr_message_source::gr_message_source (size_t itemsize, int msgq_limit)
   : gr_sync_block("message_source",
 		  gr_make_io_signature(0, 0, 0),
 		  gr_make_io_signature(1, 1, itemsize)),
-    d_itemsize(itemsize), d_msgq(gr_make_msg_queue(msgq_limit)), d_msg_offset(0), d_eof(false)
+    d_itemsize(itemsize), d_msgq(gr_make_msg_queue(msgq_limit)), d_pending_pos(0), d_msg_offset(0), d_eof(false)
 {
 }
 
@@ -62,7 +64,7 @@ gr_message_source::gr_message_source (size_t itemsize, gr_msg_queue_sptr msgq)
   : gr_sync_block("message_source",
 		  gr_make_io_signature(0, 0, 0),
 		  gr_make_io_signature(1, 1, itemsize)),
-    d_itemsize(itemsize), d_msgq(msgq), d_msg_offset(0), d_eof(false)
+    d_itemsize(itemsize), d_msgq(msgq), d_pending_pos(0), d_msg_offset(0), d_eof(false)
 {
 }
 
@@ -77,6 +79,10 @@ gr_message_source::work(int noutput_items,
 {
   char *out = (char *) output_items[0];
   int nn = 0;
+  // Taking messages out of a bounded queue makes room for the producers,
+  // so a batch would hold up to limit() more messages than the queue
+  // allows. Bounded queues are drained one message at a time.
+  const unsigned int batch = d_msgq->limit() ? 1 : MAX_PENDING;
 
   while (nn < noutput_items){
     if (d_msg){
@@ -101,14 +107,23 @@ gr_message_source::work(int noutput_items,
       //
       // No current message
       //
-      if (d_msgq->empty_p() && nn > 0){    // no more messages in the queue, return what we've got
+      if (d_pending_pos == d_pending.size()){
+	d_pending.clear();
+	d_pending_pos = 0;
+	d_msgq->delete_head_n_nowait(d_pending, batch);
+      }
+
+      if (d_pending.empty() && nn > 0){    // no more messages in the queue, return what we've got
 	break;
       }
 
       if (d_eof)
 	return -1;
 
-      d_msg = d_msgq->delete_head();	   // block, waiting for a message
+      if (d_pending.empty())
+	d_msgq->delete_head_n(d_pending, batch);	   // block, waiting for a message
+
+      d_msg.swap(d_pending[d_pending_pos++]);
       d_msg_offset = 0;
 
       if ((d_msg->length() % d_itemsize) != 0)
@@ -44,6 +44,8 @@ class GR_CORE_API gr_message_source : public gr_sync_block
   size_t	 	d_itemsize;
   gr_msg_queue_sptr	d_msgq;
   gr_message_sptr	d_msg;
+  std::vector<gr_message_sptr> d_pending;	// taken from d_msgq, not yet started
+  size_t		d_pending_pos;
   unsigned		d_msg_offset;
   bool			d_eof;
 
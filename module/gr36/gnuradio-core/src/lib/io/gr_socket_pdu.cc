@@ -46,7 +46,7 @@ gr_make_socket_pdu (std::string type, std::string addr, std::string port, int MT
 }
 
 gr_socket_pdu::gr_socket_pdu (std::string type, std::string addr, std::string port, int MTU)
-    : gr_stream_pdu_base(MTU)
+    : gr_stream_pdu_base(MTU), d_type(type)
 {
 
     if( (type == "TCP_SERVER") || (type == "TCP_CLIENT")){
@@ -82,32 +82,59 @@ gr_socket_pdu::gr_socket_pdu (std::string type, std::string addr, std::string po
         if(error){
             throw boost::system::system_error(error);
         }
-        set_msg_handler(pmt::mp("pdus"), boost::bind(&gr_socket_pdu::tcp_client_send, this, _1));
-        _tcp_socket->async_read_some(
-            boost::asio::buffer(rxbuf),
-            boost::bind(&gr_socket_pdu::handle_tcp_read, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred));
+        // the connected socket is serviced by the pdu reactor
+        d_fd = _tcp_socket->native_handle();
+        d_fd_type = gri_pdu_reactor::STREAM;
+        set_msg_handler(pmt::mp("pdus"), boost::bind(&gr_socket_pdu::send, this, _1));
 
-    } else if(type =="UDP_SERVER"){
+    } else if( (type =="UDP_SERVER") || (type =="UDP_CLIENT") ){
         _udp_socket.reset(new boost::asio::ip::udp::socket(_io_service, _udp_endpoint));
-        _udp_socket->async_receive_from( boost::asio::buffer(rxbuf), _udp_endpoint_other, 
-            boost::bind(&gr_socket_pdu::handle_udp_read, this,
-                boost::asio::placeholders::error,
-                boost::asio::placeholders::bytes_transferred)); 
-        set_msg_handler(pmt::mp("pdus"), boost::bind(&gr_socket_pdu::udp_send, this, _1));
-    } else if(type =="UDP_CLIENT"){
-        _udp_socket.reset(new boost::asio::ip::udp::socket(_io_service, _udp_endpoint));
-        _udp_socket->async_receive_from( boost::asio::buffer(rxbuf), _udp_endpoint_other, 
-            boost::bind(&gr_socket_pdu::handle_udp_read, this,
-                boost::asio::placeholders::error,
-                boost::asio::placeholders::bytes_transferred)); 
-        set_msg_handler(pmt::mp("pdus"), boost::bind(&gr_socket_pdu::udp_send, this, _1));
+        d_fd = _udp_socket->native_handle();
+        d_fd_type = gri_pdu_reactor::DATAGRAM;
+        set_msg_handler(pmt::mp("pdus"), boost::bind(&gr_socket_pdu::send, this, _1));
     } else {
         throw std::runtime_error("unknown socket type!");
     }
     
-    // start thread for io_service
-    d_thread = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&gr_socket_pdu::run_io_service, this)));
-    d_started = true;
+    // only the tcp server is left on asio, start a thread for its io_service
+    if(_acceptor_tcp){
+        d_thread = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&gr_socket_pdu::run_io_service, this)));
+    }
+}
+
+gr_socket_pdu::~gr_socket_pdu()
+{
+    // take the socket off the reactor before it closes with this object
+    stop();
+    _io_service.stop();
+    if(d_thread){
+        d_thread->join();
+    }
+}
+
+bool gr_socket_pdu::start(){
+    gr_stream_pdu_base::start();
+
+    // replies go to the source of the last datagram, like before;
+    // a client starts out sending to the address it was given
+    if(_udp_socket){
+        if(d_type == "UDP_CLIENT"){
+            gri_pdu_reactor::instance().set_peer(d_fd, _udp_endpoint_other.data(), _udp_endpoint_other.size(), true);
+        } else {
+            gri_pdu_reactor::instance().set_peer(d_fd, NULL, 0, true);
+        }
+    }
+    return true;
+}
+
+void gr_socket_pdu::send_packet(const gras::SBuffer &buff){
+    if(not _acceptor_tcp){
+        gr_stream_pdu_base::send_packet(buff);
+        return;
+    }
+    for(size_t i=0; i<d_tcp_connections.size(); i++){
+        d_tcp_connections[i]->send(buff);
+    }
 }
 
 void tcp_connection::handle_read(const boost::system::error_code& error/*error*/, size_t bytes_transferred)
@@ -119,6 +146,14 @@ void tcp_connection::handle_read(const boost::system::error_code& error/*error*/
 
         d_block->message_port_pub( pmt::mp("pdus"), pdu );
 
+        gras::SBufferConfig config;
+        config.length = bytes_transferred;
+        gras::SBuffer buff(config);
+        buff.offset = 0;
+        buff.length = bytes_transferred;
+        memcpy(buff.get(), &buf[0], bytes_transferred);
+        d_block->handle_packets(&buff, 1);
+
         socket_.async_read_some(
             boost::asio::buffer(buf),
             boost::bind(&tcp_connection::handle_read, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred));
@@ -136,22 +171,3 @@ void gr_socket_pdu::tcp_server_send(pmt::pmt_t msg){
         d_tcp_connections[i]->send(vector);
     }
 }
-
-void gr_socket_pdu::tcp_client_send(pmt::pmt_t msg){
-    pmt::pmt_t vector = pmt::pmt_cdr(msg);
-    size_t len = pmt::pmt_length(vector);
-    size_t offset(0);
-    boost::array<char, 10000> txbuf;
-    memcpy(&txbuf[0], pmt::pmt_uniform_vector_elements(vector, offset), len);
-    _tcp_socket->send(boost::asio::buffer(txbuf,len));
-}
-
-void gr_socket_pdu::udp_send(pmt::pmt_t msg){
-    pmt::pmt_t vector = pmt::pmt_cdr(msg);
-    size_t len = pmt::pmt_length(vector);
-    size_t offset(0);
-    boost::array<char, 10000> txbuf;
-    memcpy(&txbuf[0], pmt::pmt_uniform_vector_elements(vector, offset), len);
-    if(_udp_endpoint_other.address().to_string() != "0.0.0.0")
-        _udp_socket->send_to(boost::asio::buffer(txbuf,len), _udp_endpoint_other);
-}
@@ -28,6 +28,7 @@
 #include <gr_message.h>
 #include <gr_msg_queue.h>
 #include <gr_stream_pdu_base.h>
+#include <gras/sbuffer.hpp>
 #include <boost/array.hpp>
 #include <boost/asio.hpp>
 #include <iostream>
@@ -78,6 +79,13 @@ public:
           boost::asio::placeholders::error,
           boost::asio::placeholders::bytes_transferred));
     }
+  void send(const gras::SBuffer &buff){
+    // the handler holds on to the buffer until it is written
+    boost::asio::async_write(socket_, boost::asio::buffer(buff.get(), buff.length),
+        boost::bind(&tcp_connection::handle_packet_write, shared_from_this(), buff,
+          boost::asio::placeholders::error,
+          boost::asio::placeholders::bytes_transferred));
+    }
 
   ~tcp_connection(){
 //    std::cout << "tcp_connection destroyed\n";
@@ -96,6 +104,12 @@ private:
   {
   }
 
+  void handle_packet_write(gras::SBuffer /*buff*/,
+      const boost::system::error_code& /*error*/,
+      size_t /*bytes_transferred*/)
+  {
+  }
+
   boost::asio::ip::tcp::socket socket_;
   std::string message_;
 };
@@ -112,8 +126,8 @@ class GR_CORE_API gr_socket_pdu : public gr_stream_pdu_base
   gr_make_socket_pdu(std::string type, std::string addr, std::string port, int MTU);
 
   boost::asio::io_service _io_service;
- 
-  boost::array<char, 10000> rxbuf;
+  boost::shared_ptr<boost::thread> d_thread;
+  std::string d_type;
 
   // tcp specific
   boost::asio::ip::tcp::endpoint _tcp_endpoint;
@@ -122,8 +136,6 @@ class GR_CORE_API gr_socket_pdu : public gr_stream_pdu_base
   boost::shared_ptr<boost::asio::ip::tcp::acceptor> _acceptor_tcp;
   std::vector<tcp_connection::pointer> d_tcp_connections;
   void tcp_server_send(pmt::pmt_t msg);
-  void tcp_client_send(pmt::pmt_t msg);
-  void udp_send(pmt::pmt_t msg);
 
   // specific to tcp client
   boost::shared_ptr<boost::asio::ip::tcp::socket> _tcp_socket;
@@ -133,9 +145,6 @@ class GR_CORE_API gr_socket_pdu : public gr_stream_pdu_base
   boost::asio::ip::udp::endpoint _udp_endpoint_other;
   boost::shared_ptr<boost::asio::ip::udp::socket> _udp_socket;
 
-  void handle_receive(const boost::system::error_code& error, std::size_t ){
-    }
- 
   void start_tcp_accept(){
     tcp_connection::pointer new_connection =
         tcp_connection::create(_acceptor_tcp->get_io_service());
@@ -160,44 +169,12 @@ class GR_CORE_API gr_socket_pdu : public gr_stream_pdu_base
     _io_service.run();
     } 
 
-  void handle_udp_read(const boost::system::error_code& error/*error*/, size_t bytes_transferred){
-    if(!error){
-        pmt::pmt_t vector = pmt::pmt_init_u8vector(bytes_transferred, (const uint8_t*)&rxbuf[0]);
-        pmt::pmt_t pdu = pmt::pmt_cons( pmt::PMT_NIL, vector);
-        
-        message_port_pub( pmt::mp("pdus"), pdu );
-    
-        _udp_socket->async_receive_from( boost::asio::buffer(rxbuf), _udp_endpoint_other,
-            boost::bind(&gr_socket_pdu::handle_udp_read, this,
-                boost::asio::placeholders::error,
-                boost::asio::placeholders::bytes_transferred));
-    } else {
-        throw boost::system::system_error(error);
-//        std::cout << "error occurred\n";
-    }
-  }
-  void handle_tcp_read(const boost::system::error_code& error/*error*/, size_t bytes_transferred){
-    if(!error)
-    {
-        pmt::pmt_t vector = pmt::pmt_init_u8vector(bytes_transferred, (const uint8_t*)&rxbuf[0]);
-        pmt::pmt_t pdu = pmt::pmt_cons( pmt::PMT_NIL, vector);
-
-        message_port_pub( pmt::mp("pdus"), pdu );
-
-        _tcp_socket->async_read_some(
-            boost::asio::buffer(rxbuf),
-            boost::bind(&gr_socket_pdu::handle_tcp_read, this, boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred));
-
-    } else {
-        //std::cout << "error occurred\n";
-        throw boost::system::system_error(error);
-    }
-  }
-
  protected:
   gr_socket_pdu (std::string type, std::string addr, std::string port, int MTU=10000);
  public:
-  ~gr_socket_pdu () {}
+  ~gr_socket_pdu ();
+  bool start();
+  void send_packet(const gras::SBuffer &buff);
 };
 
-#endif /* INCLUDED_GR_TUNTAP_PDU_H */
+#endif /* INCLUDED_GR_SOCKET_PDU_H */
@@ -35,63 +35,100 @@
 #include <stdexcept>
 #include <string.h>
 #include <iostream>
+#include <unistd.h>
 #include <gr_pdu.h>
-#include <boost/asio.hpp>
+#include <gras/tags.hpp>
 #include <boost/format.hpp>
 
 #ifdef HAVE_IO_H
 #include <io.h>
 #endif
 
-static const long timeout_us = 100*1000; //100ms
-
 gr_stream_pdu_base::gr_stream_pdu_base (int MTU)
   : gr_sync_block("stream_pdu_base",
 		  gr_make_io_signature(0, 0, 0),
 		  gr_make_io_signature(0, 0, 0)),
-    d_finished(false), d_started(false), d_fd(-1)
+    d_fd(-1), d_fd_type(gri_pdu_reactor::PACKET), d_mtu(MTU),
+    d_has_input(false), d_running(false)
 {
-    // reserve space for rx buffer 
-    d_rxbuf.resize(MTU,0);
 }
 
 gr_stream_pdu_base::~gr_stream_pdu_base()
 {
-    stop_rxthread();
+    stop();
 }
 
-void gr_stream_pdu_base::stop_rxthread(){
-    d_finished = true;
-    if(d_started){
-        d_thread->interrupt();
-        d_thread->join();
-        }
+bool gr_stream_pdu_base::start(){
+    if(d_fd >= 0){
+        gri_pdu_reactor::instance().add(d_fd, d_fd_type, d_mtu, this);
+    }
+    gruel::scoped_lock lock(d_rx_mutex);
+    d_running = true;
+    return true;
+}
+
+bool gr_stream_pdu_base::stop(){
+    {
+        gruel::scoped_lock lock(d_rx_mutex);
+        if(not d_running) return true;
+        d_running = false;
+    }
+    if(d_fd >= 0){
+        gri_pdu_reactor::instance().remove(d_fd);
     }
+    return true;
+}
+
+bool gr_stream_pdu_base::check_topology(int ninputs, int noutputs){
+    d_has_input = ninputs > 0;
+    return true;
+}
 
-void gr_stream_pdu_base::start_rxthread(pmt::pmt_t _rxport){
-    rxport = _rxport;
-    d_thread = boost::shared_ptr<boost::thread>(new boost::thread(boost::bind(&gr_stream_pdu_base::run, this)));
-    d_started = true;
+// called from the reactor thread
+void gr_stream_pdu_base::handle_packets(const gras::SBuffer packets[], size_t n){
+    bool kick;
+    {
+        gruel::scoped_lock lock(d_rx_mutex);
+        kick = d_rxq.empty();
+        d_rxq.insert(d_rxq.end(), packets, packets + n);
     }
 
-void gr_stream_pdu_base::run(){
-    while(!d_finished) {
-        if(not wait_ready()){ continue; }   
-        const int result = read( d_fd, &d_rxbuf[0], d_rxbuf.size() );
-        if(result <= 0){ throw std::runtime_error("gr_stream_pdu_base, bad socket read!"); }
-        pmt::pmt_t vector = pmt::pmt_init_u8vector(result, &d_rxbuf[0]);       
-        pmt::pmt_t pdu = pmt::pmt_cons( pmt::PMT_NIL, vector);
-        message_port_pub(rxport, pdu);
-    } 
+    // work sleeps while there is nothing to send or receive;
+    // an empty packet message gets it to pick up the received ones
+    // (without an input connected, the message only wakes the block)
+    if(kick){
+        this->post_input_msg(0, gras::PacketMsg());
+    }
 }
 
 void gr_stream_pdu_base::send(pmt::pmt_t msg){
     pmt::pmt_t vector = pmt::pmt_cdr(msg);
     size_t offset(0);
     size_t itemsize(gr_pdu_itemsize(type_from_pmt(vector)));
-    int len( pmt::pmt_length(vector)*itemsize );
-    
-    const int rv = write(d_fd, pmt::pmt_uniform_vector_elements(vector, offset), len);
+    size_t len( pmt::pmt_length(vector)*itemsize );
+
+    gras::SBufferConfig config;
+    config.length = len;
+    gras::SBuffer buff(config);
+    buff.offset = 0;
+    buff.length = len;
+    memcpy(buff.get(), pmt::pmt_uniform_vector_elements(vector, offset), len);
+    send_packet(buff);
+}
+
+void gr_stream_pdu_base::send_packet(const gras::SBuffer &buff){
+    {
+        gruel::scoped_lock lock(d_rx_mutex);
+        if(d_running){
+            lock.unlock();
+            gri_pdu_reactor::instance().send(d_fd, buff);
+            return;
+        }
+    }
+
+    // not registered with the reactor, write it here
+    const int len = buff.length;
+    const int rv = write(d_fd, buff.get(), len);
     if(rv != len){
         std::cerr << boost::format("WARNING: gr_stream_pdu_base::send(pdu) write failed! (d_fd=%d, len=%d, rv=%d)")
                             % d_fd % len % rv << std::endl;
@@ -107,17 +144,37 @@ gr_stream_pdu_base::work(int noutput_items,
   return 0; 
 }
 
-bool gr_stream_pdu_base::wait_ready(){
-    //setup timeval for timeout
-    timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = timeout_us;
-    
-    //setup rset for timeout
-    fd_set rset;
-    FD_ZERO(&rset);
-    FD_SET(d_fd, &rset);
-
-    //call select with timeout on receive socket
-    return ::select(d_fd+1, &rset, NULL, NULL, &tv) > 0;
+void gr_stream_pdu_base::work(const InputItems &, const OutputItems &output_items){
+    // write out the packets that arrived on the input
+    if(d_has_input){
+        PMCC msg;
+        while((msg = this->pop_input_msg(0))){
+            if(msg.is<gras::PacketMsg>()){
+                const gras::SBuffer &buff = msg.as<gras::PacketMsg>().buff;
+                if(buff) send_packet(buff);
+            }
+            else if(msg.is<gras::SBuffer>()){
+                send_packet(msg.as<gras::SBuffer>());
+            }
+        }
+    }
+
+    std::deque<gras::SBuffer> rx;
+    {
+        gruel::scoped_lock lock(d_rx_mutex);
+        rx.swap(d_rxq);
+    }
+
+    // nothing else wakes a block without inputs, so sleep until
+    // handle_packets posts a message; packets that arrive after the
+    // swap find the queue empty and post one
+    if(not d_has_input and rx.empty()){
+        this->mark_input_fail(0);
+        return;
+    }
+
+    if(output_items.size() == 0) return;
+    for(size_t i = 0; i < rx.size(); i++){
+        this->post_output_msg(0, gras::PacketMsg(rx[i]));
+    }
 }
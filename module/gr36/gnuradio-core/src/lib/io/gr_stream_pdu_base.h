@@ -27,33 +27,46 @@
 #include <gr_sync_block.h>
 #include <gr_message.h>
 #include <gr_msg_queue.h>
+#include <gri_pdu_reactor.h>
+#include <deque>
 
 /*!
- * \brief Gather received items into messages and insert into msgq
+ * \brief Base for blocks moving PDUs through a file descriptor
  * \ingroup sink_blk
+ *
+ * The descriptor is serviced by the shared gri_pdu_reactor while
+ * the block is running. Packets read from it leave on output 0 as
+ * gras::PacketMsg messages, and PacketMsg (or SBuffer) messages
+ * arriving on input 0 are written to it, both without copying the
+ * payload. Work only runs when there is something to do: the
+ * reactor posts a message to input 0 to wake the block up.
  */
-class GR_CORE_API gr_stream_pdu_base : public gr_sync_block
+class GR_CORE_API gr_stream_pdu_base : public gr_sync_block,
+				       public gri_pdu_reactor::handler
 {
  public:
-  boost::shared_ptr<boost::thread> d_thread;
-  bool d_finished;
-  bool d_started;
-  std::vector<uint8_t> d_rxbuf;
-  void run();
   int d_fd;
+  gri_pdu_reactor::fd_type d_fd_type;
+  size_t d_mtu;
   gr_stream_pdu_base (int MTU=10000);
   ~gr_stream_pdu_base ();
   void send(pmt::pmt_t msg);
-  bool wait_ready();
+  virtual void send_packet(const gras::SBuffer &buff);
   int work (int noutput_items,
 	    gr_vector_const_void_star &input_items,
 	    gr_vector_void_star &output_items);
-  void start_rxthread(pmt::pmt_t _rxport);
-  void stop_rxthread();
+  void work(const InputItems &, const OutputItems &);
+  bool check_topology(int ninputs, int noutputs);
+  void handle_packets(const gras::SBuffer packets[], size_t n);
+  bool start();
+  bool stop();
  private:
-  pmt::pmt_t rxport;
+  gruel::mutex d_rx_mutex;
+  std::deque<gras::SBuffer> d_rxq;
+  bool d_has_input;
+  bool d_running;
 };
 
 typedef boost::shared_ptr<gr_stream_pdu_base> gr_stream_pdu_base_sptr;
 
-#endif /* INCLUDED_GR_TUNTAP_PDU_H */
+#endif /* INCLUDED_GR_STREAM_PDU_BASE_H */
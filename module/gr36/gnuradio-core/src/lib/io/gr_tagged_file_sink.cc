@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2010 Free Software Foundation, Inc.
+ * Copyright 2010,2013 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -31,7 +31,8 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stdexcept>
-#include <iostream>
+#include <algorithm>
+#include <sstream>
 
 #ifdef HAVE_IO_H
 #include <io.h>
@@ -51,14 +52,23 @@
 #endif
 
 
+// bursts are written through this much stdio buffer
+static const size_t IOBUF_SIZE = 256 * 1024;
+
 gr_tagged_file_sink::gr_tagged_file_sink (size_t itemsize, double samp_rate)
   : gr_sync_block ("tagged_file_sink",
 		   gr_make_io_signature (1, 1, itemsize),
 		   gr_make_io_signature (0, 0, 0)),
-    d_itemsize (itemsize), d_n(0), d_sample_rate(samp_rate)
+    d_itemsize (itemsize), d_handle(0), d_index(0), d_n(0),
+    d_sample_rate(samp_rate),
+    d_burst_key(pmt::pmt_string_to_symbol("burst")),
+    d_time_key(pmt::pmt_string_to_symbol("time")),
+    d_iobuf(IOBUF_SIZE)
 {
   d_state = NOT_IN_BURST;
-  d_last_N = 0;
+  d_time_N = 0;
+  d_time_secs = 0;
+  d_time_frac = 0;
   d_timeval = 0;
 }
 
@@ -70,6 +80,16 @@ gr_make_tagged_file_sink (size_t itemsize, double samp_rate)
 
 gr_tagged_file_sink::~gr_tagged_file_sink ()
 {
+  if(d_state == IN_BURST)
+    close_burst();
+  if(d_index)
+    fclose(d_index);
+}
+
+static inline bool
+offset_greater(const gr_tag_t &x, const gr_tag_t &y)
+{
+  return x.offset > y.offset;
 }
 
 int
@@ -77,140 +97,130 @@ gr_tagged_file_sink::work (int noutput_items,
 			   gr_vector_const_void_star &input_items,
 			   gr_vector_void_star &output_items)
 {
-  char *inbuf = (char *) input_items[0];
+  const char *inbuf = (const char *) input_items[0];
 
   uint64_t start_N = nitems_read(0);
   uint64_t end_N = start_N + (uint64_t)(noutput_items);
-  pmt::pmt_t bkey = pmt::pmt_string_to_symbol("burst");
-  //pmt::pmt_t tkey = pmt::pmt_string_to_symbol("time"); // use gr_tags::key_time
-
-  std::vector<gr_tag_t> all_tags;
-  get_tags_in_range(all_tags, 0, start_N, end_N);
-
-  std::sort(all_tags.begin(), all_tags.end(), gr_tag_t::offset_compare);
-
-  std::vector<gr_tag_t>::iterator vitr = all_tags.begin();
-
-  int idx = 0, idx_stop = 0;
-  while(idx < noutput_items) {
-    if(d_state == NOT_IN_BURST) {
-      while(vitr != all_tags.end()) {
-	if((pmt::pmt_eqv((*vitr).key, bkey)) &&
-	   pmt::pmt_is_true((*vitr).value)) {
-
-	  uint64_t N = (*vitr).offset;
-	  idx = (int)(N - start_N);
-
-	  //std::cout << std::endl << "Found start of burst: "
-	  //	    << idx << ", " << N << std::endl;
-
-	  // Find time burst occurred by getting latest time tag and extrapolating
-	  // to new time based on sample rate of this block.
-	  std::vector<gr_tag_t> time_tags;
-	  //get_tags_in_range(time_tags, 0, d_last_N, N, gr_tags::key_time);
-	  get_tags_in_range(time_tags, 0, d_last_N, N,
-			    pmt::pmt_string_to_symbol("time"));
-	  if(time_tags.size() > 0) {
-	    const gr_tag_t tag = time_tags[time_tags.size()-1];
-
-	    uint64_t time_nitems = tag.offset;
-
-	    // Get time based on last time tag from USRP
-	    pmt::pmt_t time = tag.value;
-	    int tsecs = pmt::pmt_to_long(pmt::pmt_tuple_ref(time, 0));
-	    double tfrac = pmt::pmt_to_double(pmt::pmt_tuple_ref(time, 1));
-
-	    // Get new time from last time tag + difference in time to when
-	    // burst tag occured based on the sample rate
-	    double delta = (double)(N - time_nitems) / d_sample_rate;
-	    d_timeval = (double)tsecs + tfrac + delta;
-
-	    //std::cout.setf(std::ios::fixed, std::ios::floatfield);
-	    //std::cout.precision(8);
-	    //std::cout << "Time found: " << (double)tsecs + tfrac << std::endl;
-	    //std::cout << "   time: " << d_timeval << std::endl;
-	    //std::cout << "   time at N = " << time_nitems << " burst N = " << N << std::endl;
-	  }
-	  else {
-	    // if no time tag, use last seen tag and update time based on
-	    // sample rate of the block
-	    d_timeval += (double)(N - d_last_N) / d_sample_rate;
-	    //std::cout << "Time not found" << std::endl;
-	    //std::cout << "   time: " << d_timeval << std::endl;
-	  }
-	  d_last_N = N;
-
-	  std::stringstream filename;
-	  filename.setf(std::ios::fixed, std::ios::floatfield);
-	  filename.precision(8);
-	  filename << "file" << unique_id() << "_" << d_n << "_" << d_timeval << ".dat";
-	  d_n++;
-
-	  int fd;
-	  if ((fd = ::open (filename.str().c_str(),
-			    O_WRONLY|O_CREAT|O_TRUNC|OUR_O_LARGEFILE|OUR_O_BINARY,
-			    0664)) < 0){
-	    perror (filename.str().c_str());
-	    return -1;
-	  }
-
-	  // FIXME:
-	  //if ((d_handle = fdopen (fd, d_is_binary ? "wb" : "w")) == NULL){
-	  if ((d_handle = fdopen (fd, "wb")) == NULL){
-	    perror (filename.str().c_str());
-	    ::close(fd);		// don't leak file descriptor if fdopen fails.
-	  }
-
-	  //std::cout << "Created new file: " << filename.str() << std::endl;
-
-	  d_state = IN_BURST;
-	  break;
-	}
-
-	vitr++;
-      }
-      if(d_state == NOT_IN_BURST)
-	return noutput_items;
+
+  get_tags_in_range(d_tags, 0, start_N, end_N);
+
+  // Tags nearly always arrive in order; only sort when they didn't.
+  if(std::adjacent_find(d_tags.begin(), d_tags.end(), offset_greater) != d_tags.end())
+    std::stable_sort(d_tags.begin(), d_tags.end(), gr_tag_t::offset_compare);
+
+  // One pass over the tags: time tags move the time reference along,
+  // burst tags open and close the burst files.
+  int idx = 0;
+  std::vector<gr_tag_t>::const_iterator vitr;
+  for(vitr = d_tags.begin(); vitr != d_tags.end(); vitr++) {
+    if(pmt::pmt_eqv((*vitr).key, d_time_key)) {
+      d_time_N = (*vitr).offset;
+      d_time_secs = pmt::pmt_to_long(pmt::pmt_tuple_ref((*vitr).value, 0));
+      d_time_frac = pmt::pmt_to_double(pmt::pmt_tuple_ref((*vitr).value, 1));
     }
-    else {  // In burst
-      while(vitr != all_tags.end()) {
-	if((pmt::pmt_eqv((*vitr).key, bkey)) &&
-	   pmt::pmt_is_false((*vitr).value)) {
-	  uint64_t N = (*vitr).offset;
-	  idx_stop = (int)N - start_N;
-
-	  //std::cout << "Found end of burst: "
-	  //	    << idx_stop << ", " << N << std::endl;
-
-	  int count = fwrite (&inbuf[d_itemsize*idx], d_itemsize,
-			      idx_stop-idx, d_handle);
-	  if (count == 0) {
-	    if(ferror(d_handle)) {
-	      perror("gr_tagged_file_sink: error writing file");
-	    }
-	  }
-	  idx = idx_stop;
-	  d_state = NOT_IN_BURST;
-	  vitr++;
-	  fclose(d_handle);
-	  break;
-	}
-	else {
-	  vitr++;
-	}
+    else if(pmt::pmt_eqv((*vitr).key, d_burst_key)) {
+      int tidx = (int)((*vitr).offset - start_N);
+
+      if(d_state == NOT_IN_BURST && pmt::pmt_is_true((*vitr).value)) {
+	if(!open_burst((*vitr).offset))
+	  return -1;
+	idx = tidx;
       }
-      if(d_state == IN_BURST) {
-	int count = fwrite (&inbuf[d_itemsize*idx], d_itemsize,
-			    noutput_items-idx, d_handle);
-	if (count == 0) {
-	  if(ferror(d_handle)) {
-	    perror("gr_tagged_file_sink: error writing file");
-	  }
-	}
-	idx = noutput_items;
+      else if(d_state == IN_BURST && pmt::pmt_is_false((*vitr).value)) {
+	write_burst(&inbuf[d_itemsize*idx], tidx - idx);
+	close_burst();
       }
     }
   }
 
+  if(d_state == IN_BURST)
+    write_burst(&inbuf[d_itemsize*idx], noutput_items - idx);
+
   return noutput_items;
 }
+
+bool
+gr_tagged_file_sink::open_burst(uint64_t N)
+{
+  // Get the time of the burst by extrapolating from the reference with
+  // the sample rate of this block. The burst becomes the reference
+  // until the next time tag.
+  double delta = (double)(N - d_time_N) / d_sample_rate;
+  d_timeval = (double)d_time_secs + d_time_frac + delta;
+  d_time_N = N;
+  d_time_secs = 0;
+  d_time_frac = d_timeval;
+
+  std::stringstream filename;
+  filename.setf(std::ios::fixed, std::ios::floatfield);
+  filename.precision(8);
+  filename << "file" << unique_id() << "_" << d_n << "_" << d_timeval << ".dat";
+  d_filename = filename.str();
+
+  int fd;
+  if ((fd = ::open (d_filename.c_str(),
+		    O_WRONLY|O_CREAT|O_TRUNC|OUR_O_LARGEFILE|OUR_O_BINARY,
+		    0664)) < 0){
+    perror (d_filename.c_str());
+    return false;
+  }
+
+  if ((d_handle = fdopen (fd, "wb")) == NULL){
+    perror (d_filename.c_str());
+    ::close(fd);		// don't leak file descriptor if fdopen fails.
+    return false;
+  }
+  setvbuf(d_handle, &d_iobuf[0], _IOFBF, d_iobuf.size());
+
+  d_burst_N = N;
+  d_burst_nitems = 0;
+  d_state = IN_BURST;
+  return true;
+}
+
+void
+gr_tagged_file_sink::write_burst(const char *buf, int nitems)
+{
+  if(nitems <= 0)
+    return;
+
+  int count = fwrite (buf, d_itemsize, nitems, d_handle);
+  if (count == 0) {
+    if(ferror(d_handle)) {
+      perror("gr_tagged_file_sink: error writing file");
+    }
+  }
+  d_burst_nitems += count;
+}
+
+void
+gr_tagged_file_sink::close_burst()
+{
+  if(fclose(d_handle) != 0)
+    perror("gr_tagged_file_sink: error writing file");
+  d_handle = 0;
+  d_state = NOT_IN_BURST;
+
+  if(!d_index) {
+    std::stringstream filename;
+    filename << "file" << unique_id() << ".index";
+    if((d_index = fopen(filename.str().c_str(), "w")) == NULL) {
+      perror(filename.str().c_str());
+    }
+    else {
+      fputs("# burst first_item nitems time file\n", d_index);
+    }
+  }
+
+  if(d_index) {
+    std::stringstream entry;
+    entry.setf(std::ios::fixed, std::ios::floatfield);
+    entry.precision(8);
+    entry << d_n << " " << d_burst_N << " " << d_burst_nitems << " "
+	  << d_timeval << " " << d_filename << "\n";
+    fputs(entry.str().c_str(), d_index);
+    fflush(d_index);    // readable while the flowgraph runs
+  }
+
+  d_n++;
+}
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2010 Free Software Foundation, Inc.
+ * Copyright 2010,2013 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -26,6 +26,8 @@
 #include <gr_core_api.h>
 #include <gr_sync_block.h>
 #include <cstdio>  // for FILE
+#include <string>
+#include <vector>
 
 class gr_tagged_file_sink;
 typedef boost::shared_ptr<gr_tagged_file_sink> gr_tagged_file_sink_sptr;
@@ -34,8 +36,20 @@ GR_CORE_API gr_tagged_file_sink_sptr gr_make_tagged_file_sink (size_t itemsize,
 						   double samp_rate);
 
 /*!
- * \brief Write stream to file descriptor.
+ * \brief Write each burst of a stream to its own file.
  * \ingroup sink_blk
+ *
+ * A "burst" tag with a true value starts a burst, one with a false
+ * value ends it. Each burst goes to file<id>_<n>_<time>.dat, where
+ * the time comes from the latest "time" tag, or from the previous
+ * burst, extrapolated with the sample rate.
+ *
+ * Every finished burst also gets a line in file<id>.index:
+ *
+ *   <n> <first item> <number of items> <time> <file name>
+ *
+ * so bursts can be found by time or item number without opening the
+ * data files. Lines starting with '#' are comments.
  */
 
 class GR_CORE_API gr_tagged_file_sink : public gr_sync_block
@@ -52,10 +66,29 @@ class GR_CORE_API gr_tagged_file_sink : public gr_sync_block
   size_t	d_itemsize;
   int	        d_state;
   FILE         *d_handle;
+  FILE         *d_index;
   int           d_n;
   double        d_sample_rate;
-  uint64_t      d_last_N;
+
+  pmt::pmt_t    d_burst_key;
+  pmt::pmt_t    d_time_key;
+  std::vector<gr_tag_t> d_tags;     // this call's tags, kept for the storage
+  std::vector<char> d_iobuf;        // stdio buffer of the burst file
+
+  // time reference: the latest time tag, or the start of the last burst
+  uint64_t      d_time_N;
+  long          d_time_secs;
+  double        d_time_frac;
+
+  // the burst being written
+  uint64_t      d_burst_N;
+  uint64_t      d_burst_nitems;
   double        d_timeval;
+  std::string   d_filename;
+
+  bool open_burst(uint64_t N);
+  void write_burst(const char *buf, int nitems);
+  void close_burst();
 
  protected:
   gr_tagged_file_sink (size_t itemsize, double samp_rate);
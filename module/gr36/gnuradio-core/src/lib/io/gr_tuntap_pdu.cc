@@ -76,9 +76,11 @@ gr_tuntap_pdu::gr_tuntap_pdu (std::string dev, int MTU)
         "Be sure to use a different address in the same subnet for each machine.\n"
         ) % dev % dev << std::endl;
 
+    // one packet per read, serviced by the pdu reactor once started
+    d_fd_type = gri_pdu_reactor::PACKET;
+
     // set up output message port
     message_port_register_out(pmt::mp("pdus"));
-    start_rxthread(pmt::mp("pdus"));
     
     // set up input message port
     message_port_register_in(pmt::mp("pdus"));
@@ -28,12 +28,9 @@
 #include <gr_io_signature.h>
 #include <gri_wavfile.h>
 #include <stdexcept>
-#include <climits>
 #include <cstring>
-#include <cmath>
 #include <fcntl.h>
 #include <gruel/thread.h>
-#include <boost/math/special_functions/round.hpp>
 
 // win32 (mingw/msvc) specific
 #ifdef HAVE_IO_H
@@ -73,32 +70,16 @@ gr_wavfile_sink::gr_wavfile_sink(const char *filename,
 		   gr_make_io_signature(1, n_channels, sizeof(float)),
 		   gr_make_io_signature(0, 0, 0)),
     d_sample_rate(sample_rate), d_nchans(n_channels),
-    d_fp(0), d_new_fp(0), d_updated(false)
+    d_bits_per_sample(bits_per_sample),
+    d_new_fp(0), d_updated(false)
 {
-  if (bits_per_sample != 8 && bits_per_sample != 16) {
-    throw std::runtime_error("Invalid bits per sample (supports 8 and 16)");
+  if (!gri_wavfile_writer::valid_bits_per_sample(bits_per_sample)) {
+    throw std::runtime_error("Invalid bits per sample (supports 8, 16, 24 and 32)");
   }
-  d_bytes_per_sample = bits_per_sample / 8;
-  d_bytes_per_sample_new = d_bytes_per_sample;
 
   if (!open(filename)) {
     throw std::runtime_error ("can't open file");
   }
-
-  if (bits_per_sample == 8) {
-    d_max_sample_val = 0xFF;
-    d_min_sample_val = 0;
-    d_normalize_fac  = d_max_sample_val/2;
-    d_normalize_shift = 1;
-  } else {
-    d_max_sample_val = 0x7FFF;
-    d_min_sample_val = -0x7FFF;
-    d_normalize_fac  = d_max_sample_val;
-    d_normalize_shift = 0;
-    if (bits_per_sample != 16) {
-      fprintf(stderr, "Invalid bits per sample value requested, using 16");
-    }
-  }
 }
 
 
@@ -126,16 +107,10 @@ gr_wavfile_sink::open(const char* filename)
     ::close(fd);  // don't leak file descriptor if fdopen fails.
     return false;
   }
+  d_new_sample_rate = d_sample_rate;
+  d_new_bits_per_sample = d_bits_per_sample;
   d_updated = true;
 
-  if (!gri_wavheader_write(d_new_fp,
-			   d_sample_rate,
-			   d_nchans,
-			   d_bytes_per_sample_new)) {
-    fprintf(stderr, "[%s] could not write to WAV file\n", __FILE__);
-    exit(-1);
-  }
-
   return true;
 }
 
@@ -145,20 +120,9 @@ gr_wavfile_sink::close()
 {
   gruel::scoped_lock guard(d_mutex);
 
-  if (!d_fp)
-    return;
-
-  close_wav();
-}
-
-void gr_wavfile_sink::close_wav()
-{
-  unsigned int byte_count = d_sample_count * d_bytes_per_sample;
-
-  gri_wavheader_complete(d_fp, byte_count);
-
-  fclose(d_fp);
-  d_fp = NULL;
+  if (!d_writer.close()) {
+    fprintf(stderr, "[%s] could not complete WAV file\n", __FILE__);
+  }
 }
 
 
@@ -177,56 +141,22 @@ gr_wavfile_sink::work (int noutput_items,
 		       gr_vector_const_void_star &input_items,
 		       gr_vector_void_star &output_items)
 {
-  float **in = (float **) &input_items[0];
+  const float *const *in = (const float *const *) &input_items[0];
   int n_in_chans = input_items.size();
 
-  short int sample_buf_s;
-
-  int nwritten;
-
   gruel::scoped_lock guard(d_mutex);     // hold mutex for duration of this block
-  do_update();	// update: d_fp is reqd
-  if (!d_fp)	// drop output on the floor
+  do_update();	// update: d_writer is reqd
+  if (!d_writer.is_open())	// drop output on the floor
     return noutput_items;
 
-  for (nwritten = 0; nwritten < noutput_items; nwritten++) {
-    for (int chan = 0; chan < d_nchans; chan++) {
-      // Write zeros to channels which are in the WAV file
-      // but don't have any inputs here
-      if (chan < n_in_chans) {
-	sample_buf_s =
-	  convert_to_short(in[chan][nwritten]);
-      } else {
-	sample_buf_s = 0;
-      }
-
-      gri_wav_write_sample(d_fp, sample_buf_s, d_bytes_per_sample);
-
-      if (feof(d_fp) || ferror(d_fp)) {
-	fprintf(stderr, "[%s] file i/o error\n", __FILE__);
-	close();
-	exit(-1);
-      }
-      d_sample_count++;
-    }
-  }
-
-  return nwritten;
-}
-
-
-short int
-gr_wavfile_sink::convert_to_short(float sample)
-{
-  sample += d_normalize_shift;
-  sample *= d_normalize_fac;
-  if (sample > d_max_sample_val) {
-    sample = d_max_sample_val;
-  } else if (sample < d_min_sample_val) {
-    sample = d_min_sample_val;
+  // Channels in the WAV file without an input here are written as zeros
+  if (!d_writer.write(in, n_in_chans, noutput_items)) {
+    fprintf(stderr, "[%s] file i/o error\n", __FILE__);
+    d_writer.close();
+    exit(-1);
   }
 
-  return (short int) boost::math::iround(sample);
+  return noutput_items;
 }
 
 
@@ -234,8 +164,8 @@ void
 gr_wavfile_sink::set_bits_per_sample(int bits_per_sample)
 {
   gruel::scoped_lock guard(d_mutex);
-  if (bits_per_sample == 8 || bits_per_sample == 16) {
-    d_bytes_per_sample_new = bits_per_sample / 8;
+  if (gri_wavfile_writer::valid_bits_per_sample(bits_per_sample)) {
+    d_bits_per_sample = bits_per_sample;
   }
 }
 
@@ -255,26 +185,12 @@ gr_wavfile_sink::do_update()
     return;
   }
 
-  if (d_fp) {
-    close_wav();
+  if (!d_writer.close()) {
+    fprintf(stderr, "[%s] could not complete WAV file\n", __FILE__);
   }
 
-  d_fp = d_new_fp;                    // install new file pointer
-  d_new_fp  = 0;
-  d_sample_count = 0;
-  d_bytes_per_sample = d_bytes_per_sample_new;
-
-  if (d_bytes_per_sample == 1) {
-    d_max_sample_val = UCHAR_MAX;
-    d_min_sample_val = 0;
-    d_normalize_fac  = d_max_sample_val/2;
-    d_normalize_shift = 1;
-  } else if (d_bytes_per_sample == 2) {
-    d_max_sample_val = SHRT_MAX;
-    d_min_sample_val = SHRT_MIN;
-    d_normalize_fac  = d_max_sample_val;
-    d_normalize_shift = 0;
-  }
+  d_writer.open(d_new_fp, d_new_sample_rate, d_nchans, d_new_bits_per_sample);
+  d_new_fp = 0;
 
   d_updated = false;
 }
@@ -26,6 +26,7 @@
 #include <gr_core_api.h>
 #include <gr_sync_block.h>
 #include <gr_file_sink_base.h>
+#include <gri_wavfile.h>
 #include <boost/thread.hpp>
 
 class gr_wavfile_sink;
@@ -35,7 +36,8 @@ typedef boost::shared_ptr<gr_wavfile_sink> gr_wavfile_sink_sptr;
  * \p filename The .wav file to be opened
  * \p n_channels Number of channels (2 = stereo or I/Q output)
  * \p sample_rate Sample rate [S/s]
- * \p bits_per_sample 16 or 8 bit, default is 16
+ * \p bits_per_sample 8, 16 or 24 bit PCM, or 32 for float samples;
+ *    default is 16
  */
 GR_CORE_API gr_wavfile_sink_sptr
 gr_make_wavfile_sink (const char *filename,
@@ -46,7 +48,8 @@ gr_make_wavfile_sink (const char *filename,
 /*!
  * \brief Write stream to a Microsoft PCM (.wav) file.
  *
- * Values must be floats within [-1;1].
+ * Values must be floats within [-1;1], unless the file holds float
+ * samples. Files that grow past 4 GiB are written as RF64.
  * Check gr_make_wavfile_sink() for extra info.
  *
  * \ingroup sink_blk
@@ -66,25 +69,15 @@ private:
 
   unsigned d_sample_rate;
   int d_nchans;
-  unsigned d_sample_count;
-  int d_bytes_per_sample;
-  int d_bytes_per_sample_new;
-  int d_max_sample_val;
-  int d_min_sample_val;
-  int d_normalize_shift;
-  int d_normalize_fac;
-
-  FILE *d_fp;
+  int d_bits_per_sample;
+
+  gri_wavfile_writer d_writer;
   FILE *d_new_fp;
+  unsigned d_new_sample_rate;
+  int d_new_bits_per_sample;
   bool d_updated;
   boost::mutex d_mutex;
 
-  /*!
-   * \brief Convert a sample value within [-1;+1] to a corresponding
-   *  short integer value
-   */
-  short convert_to_short(float sample);
-
   /*!
    * \brief If any file changes have occurred, update now. This is called
    * internally by work() and thus doesn't usually need to be called by
@@ -92,19 +85,12 @@ private:
    */
   void do_update();
 
-  /*!
-   * \brief Writes information to the WAV header which is not available
-   * a-priori (chunk size etc.) and closes the file. Not thread-safe and
-   * assumes d_fp is a valid file pointer, should thus only be called by
-   * other methods.
-   */
-  void close_wav();
-
 public:
   ~gr_wavfile_sink ();
 
   /*!
-   * \brief Opens a new file and writes a WAV header. Thread-safe.
+   * \brief Opens a new file. Its header goes out with the first
+   * samples. Thread-safe.
    */
   bool open(const char* filename);
 
@@ -123,8 +109,9 @@ public:
 
   /*!
    * \brief Set bits per sample. This will not affect the WAV file
-   * currently opened (see set_sample_rate()). If the value is neither
-   * 8 nor 16, the call is ignored and the current value is kept.
+   * currently opened (see set_sample_rate()). If the value is not one
+   * of 8, 16, 24 or 32, the call is ignored and the current value is
+   * kept.
    */
   void set_bits_per_sample(int bits_per_sample);
 
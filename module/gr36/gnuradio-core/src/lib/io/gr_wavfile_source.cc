@@ -59,9 +59,7 @@ gr_wavfile_source::gr_wavfile_source (const char *filename, bool repeat)
   : gr_sync_block ("wavfile_source",
 		   gr_make_io_signature (0, 0, 0),
 		   gr_make_io_signature (1, 2, sizeof(float))),
-    d_fp(NULL), d_repeat(repeat),
-    d_sample_rate(1), d_nchans(1), d_bytes_per_sample(2), d_first_sample_pos(0),
-    d_samples_per_chan(0), d_sample_idx(0)
+    d_repeat(repeat)
 {
   // we use "open" to use to the O_LARGEFILE flag
 
@@ -71,41 +69,30 @@ gr_wavfile_source::gr_wavfile_source (const char *filename, bool repeat)
     throw std::runtime_error ("can't open file");
   }
 
-  if ((d_fp = fdopen (fd, "rb")) == NULL) {
+  FILE *fp;
+  if ((fp = fdopen (fd, "rb")) == NULL) {
     perror (filename);
     throw std::runtime_error ("can't open file");
   }
 
   // Scan headers, check file validity
-  if (!gri_wavheader_parse(d_fp,
-			   d_sample_rate,
-			   d_nchans,
-			   d_bytes_per_sample,
-			   d_first_sample_pos,
-			   d_samples_per_chan)) {
+  if (!d_reader.open(fp)) {
     throw std::runtime_error("is not a valid wav file");
   }
 
-  if (d_samples_per_chan == 0) {
+  if (d_reader.samples_per_chan() == 0) {
     throw std::runtime_error("WAV file does not contain any samples");
   }
 
-  if (d_bytes_per_sample == 1) {
-    d_normalize_fac   = 128;
-    d_normalize_shift = 1;
-  } else {
-    d_normalize_fac   = 0x7FFF;
-    d_normalize_shift = 0;
-  }
+  d_out.resize(d_reader.channels());
 
   // Re-set the output signature
-  set_output_signature(gr_make_io_signature(1, d_nchans, sizeof(float)));
+  set_output_signature(gr_make_io_signature(1, d_reader.channels(), sizeof(float)));
 }
 
 
 gr_wavfile_source::~gr_wavfile_source ()
 {
-  fclose(d_fp);
 }
 
 
@@ -117,55 +104,39 @@ gr_wavfile_source::work(int noutput_items,
   float **out = (float **) &output_items[0];
   int n_out_chans = output_items.size();
 
-  int i;
-  short sample;
-
-  for (i = 0; i < noutput_items; i++) {
-    if (d_sample_idx >= d_samples_per_chan) {
+  int i = 0;
+  while (i < noutput_items) {
+    if (d_reader.position() >= d_reader.samples_per_chan()) {
       if (!d_repeat) {
 	// if nothing was read at all, say we're done.
 	return i ? i : -1;
       }
 
-      if (fseek (d_fp, d_first_sample_pos, SEEK_SET) == -1) {
+      if (!d_reader.rewind()) {
 	fprintf(stderr, "[%s] fseek failed\n", __FILE__);
 	exit(-1);
       }
-
-      d_sample_idx = 0;
     }
 
-    for (int chan = 0; chan < d_nchans; chan++) {
-      sample = gri_wav_read_sample(d_fp, d_bytes_per_sample);
-
-      if (chan < n_out_chans) {
-	out[chan][i] = convert_to_float(sample);
-      }
+    for (int chan = 0; chan < n_out_chans; chan++) {
+      d_out[chan] = out[chan] + i;
     }
 
-    d_sample_idx++;
+    int n = d_reader.read(&d_out[0], n_out_chans, noutput_items - i);
 
     // OK, EOF is not necessarily an error. But we're not going to
     // deal with handling corrupt wav files, so if they give us any
     // trouble they won't be processed. Serves them bloody right.
-    if (feof(d_fp) || ferror(d_fp)) {
+    if (n == 0) {
       if (i == 0) {
 	fprintf(stderr, "[%s] WAV file has corrupted header or i/o error\n", __FILE__);
 	return -1;
       }
       return i;
     }
+
+    i += n;
   }
 
   return noutput_items;
 }
-
-
-float
-gr_wavfile_source::convert_to_float(short int sample)
-{
-  float sample_out = (float) sample;
-  sample_out /= d_normalize_fac;
-  sample_out -= d_normalize_shift;
-  return sample_out;
-}
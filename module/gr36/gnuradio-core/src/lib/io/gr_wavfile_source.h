@@ -25,7 +25,8 @@
 
 #include <gr_core_api.h>
 #include <gr_sync_block.h>
-#include <cstdio>  // for FILE
+#include <gri_wavfile.h>
+#include <vector>
 
 class gr_wavfile_source;
 typedef boost::shared_ptr<gr_wavfile_source> gr_wavfile_source_sptr;
@@ -36,6 +37,9 @@ gr_make_wavfile_source (const char *filename, bool repeat = false);
 /*!
  * \brief Read stream from a Microsoft PCM (.wav) file, output floats
  *
+ * Reads 8, 16, 24 and 32 bit PCM and 32 bit float files, RF64 files
+ * included.
+ *
  * Unless otherwise called, values are within [-1;1].
  * Check gr_make_wavfile_source() for extra info.
  *
@@ -49,22 +53,9 @@ private:
 		                                              bool repeat);
   gr_wavfile_source(const char *filename, bool repeat);
 
-  FILE *d_fp;
+  gri_wavfile_reader d_reader;
   bool d_repeat;
-
-  unsigned d_sample_rate;
-  int d_nchans;
-  int d_bytes_per_sample;
-  int d_first_sample_pos;
-  unsigned d_samples_per_chan;
-  unsigned d_sample_idx;
-  int d_normalize_shift;
-  int d_normalize_fac;
-
-  /*!
-   * \brief Convert an integer sample value to a float value within [-1;1]
-   */
-  float convert_to_float(short int sample);
+  std::vector<float *> d_out;
 
 public:
   ~gr_wavfile_source ();
@@ -76,20 +67,21 @@ public:
   /*!
    * \brief Read the sample rate as specified in the wav file header
    */
-  unsigned int sample_rate() const { return d_sample_rate; };
+  unsigned int sample_rate() const { return d_reader.sample_rate(); };
 
   /*!
    * \brief Return the number of bits per sample as specified in the wav
-   * file header. Only 8 or 16 bit are supported here.
+   * file header: 8, 16, 24 or 32. 32 bit files may hold either
+   * integer or float samples.
    */
-  int bits_per_sample() const { return d_bytes_per_sample * 8; };
+  int bits_per_sample() const { return d_reader.bits_per_sample(); };
 
   /*!
    * \brief Return the number of channels in the wav file as specified in
    * the wav file header. This is also the max number of outputs you can
    * have.
    */
-  int channels() const { return d_nchans; };
+  int channels() const { return d_reader.channels(); };
 };
 
 #endif /* INCLUDED_GR_WAVFILE_SOURCE_H */
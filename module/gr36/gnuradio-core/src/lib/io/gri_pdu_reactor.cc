@@ -0,0 +1,616 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gri_pdu_reactor.h>
+#include <boost/bind.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#if (defined(linux) || defined(__linux) || defined(__linux__))
+#define GRI_PDU_REACTOR_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#else
+#include <poll.h>
+#endif
+
+// packets moved per system call, and batches read from one
+// descriptor before the others get a turn
+static const size_t BATCH = 32;
+static const size_t MAX_BATCHES = 8;
+
+struct gri_pdu_reactor::entry
+{
+  int fd;
+  fd_type type;
+  size_t mtu;
+  handler *h;
+  gras::SBuffer spare[BATCH];     // receive buffers, reactor thread only
+  std::deque<gras::SBuffer> txq;
+  bool queued;                    // on d_flush or waiting to be writable
+  bool want_write;
+  bool eof;
+  bool watched;                   // in the epoll set
+  struct sockaddr_storage peer;
+  socklen_t peer_len;
+  bool follow_sender;
+};
+
+static gras::SBuffer
+make_buffer(size_t len)
+{
+  gras::SBufferConfig config;
+  config.memory = NULL;
+  config.length = len;
+  gras::SBuffer buff(config);
+  buff.offset = 0;
+  buff.length = len;
+  return buff;
+}
+
+static void
+warn(const char *what, int fd, int err)
+{
+  std::cerr << boost::format("WARNING: gri_pdu_reactor: %s failed! (fd=%d, %s)")
+    % what % fd % strerror(err) << std::endl;
+}
+
+gri_pdu_reactor &
+gri_pdu_reactor::instance()
+{
+  static gri_pdu_reactor reactor;
+  return reactor;
+}
+
+gri_pdu_reactor::gri_pdu_reactor()
+  : d_busy(NULL), d_woken(false), d_done(false), d_poll_fd(-1)
+{
+#ifdef GRI_PDU_REACTOR_EPOLL
+  d_poll_fd = epoll_create(64);
+  if(d_poll_fd < 0)
+    throw std::runtime_error("gri_pdu_reactor: epoll_create failed");
+  d_wake_fd[0] = d_wake_fd[1] = eventfd(0, EFD_NONBLOCK);
+  if(d_wake_fd[0] < 0)
+    throw std::runtime_error("gri_pdu_reactor: eventfd failed");
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = d_wake_fd[0];
+  epoll_ctl(d_poll_fd, EPOLL_CTL_ADD, d_wake_fd[0], &ev);
+#else
+  if(pipe(d_wake_fd) < 0)
+    throw std::runtime_error("gri_pdu_reactor: pipe failed");
+  fcntl(d_wake_fd[0], F_SETFL, fcntl(d_wake_fd[0], F_GETFL) | O_NONBLOCK);
+  fcntl(d_wake_fd[1], F_SETFL, fcntl(d_wake_fd[1], F_GETFL) | O_NONBLOCK);
+#endif
+
+  d_thread = boost::shared_ptr<gruel::thread>
+    (new gruel::thread(boost::bind(&gri_pdu_reactor::run, this)));
+}
+
+gri_pdu_reactor::~gri_pdu_reactor()
+{
+  {
+    gruel::scoped_lock lock(d_mutex);
+    d_done = true;
+  }
+  wake();
+  d_thread->join();
+
+  for(entry_map::iterator it = d_entries.begin(); it != d_entries.end(); it++)
+    delete it->second;
+
+  close(d_wake_fd[0]);
+  if(d_wake_fd[1] != d_wake_fd[0])
+    close(d_wake_fd[1]);
+  if(d_poll_fd >= 0)
+    close(d_poll_fd);
+}
+
+void
+gri_pdu_reactor::add(int fd, fd_type type, size_t mtu, handler *h)
+{
+  entry *e = new entry();
+  e->fd = fd;
+  e->type = type;
+  e->mtu = mtu;
+  e->h = h;
+  e->queued = false;
+  e->want_write = false;
+  e->eof = false;
+  e->peer_len = 0;
+  e->follow_sender = false;
+  e->watched = false;
+  for(size_t i = 0; i < BATCH; i++)
+    e->spare[i] = make_buffer(mtu);
+
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  {
+    gruel::scoped_lock lock(d_mutex);
+    if(d_entries.count(fd)) {
+      delete e;
+      throw std::invalid_argument("gri_pdu_reactor: descriptor already registered");
+    }
+    d_entries[fd] = e;
+    watch(e);
+  }
+  wake();
+}
+
+void
+gri_pdu_reactor::remove(int fd)
+{
+  entry *e;
+  {
+    gruel::scoped_lock lock(d_mutex);
+    entry_map::iterator it = d_entries.find(fd);
+    if(it == d_entries.end())
+      return;
+    e = it->second;
+    d_entries.erase(it);
+    d_flush.erase(std::remove(d_flush.begin(), d_flush.end(), fd), d_flush.end());
+#ifdef GRI_PDU_REACTOR_EPOLL
+    struct epoll_event ev;
+    if(e->watched)
+      epoll_ctl(d_poll_fd, EPOLL_CTL_DEL, fd, &ev);
+#endif
+    while(d_busy == e)
+      d_idle.wait(lock);
+  }
+  wake();
+  delete e;
+}
+
+void
+gri_pdu_reactor::set_peer(int fd, const struct sockaddr *addr, socklen_t len,
+			  bool follow_sender)
+{
+  gruel::scoped_lock lock(d_mutex);
+  entry_map::iterator it = d_entries.find(fd);
+  if(it == d_entries.end())
+    return;
+  entry *e = it->second;
+  e->peer_len = std::min<socklen_t>(len, sizeof(e->peer));
+  if(e->peer_len)
+    memcpy(&e->peer, addr, e->peer_len);
+  e->follow_sender = follow_sender;
+}
+
+void
+gri_pdu_reactor::send(int fd, const gras::SBuffer &buff)
+{
+  bool need_wake = false;
+  {
+    gruel::scoped_lock lock(d_mutex);
+    entry_map::iterator it = d_entries.find(fd);
+    if(it == d_entries.end())
+      return;
+    entry *e = it->second;
+    e->txq.push_back(buff);
+    if(!e->queued) {
+      e->queued = true;
+      d_flush.push_back(fd);
+      need_wake = !d_woken;
+      d_woken = true;
+    }
+  }
+  if(need_wake)
+    wake();
+}
+
+void
+gri_pdu_reactor::send(int fd, const void *data, size_t len)
+{
+  gras::SBuffer buff = make_buffer(len);
+  memcpy(buff.get(), data, len);
+  send(fd, buff);
+}
+
+void
+gri_pdu_reactor::wake()
+{
+#ifdef GRI_PDU_REACTOR_EPOLL
+  const uint64_t one = 1;
+#else
+  const char one = 1;
+#endif
+  if(write(d_wake_fd[1], &one, sizeof(one)) < 0 && errno != EAGAIN)
+    warn("wakeup", d_wake_fd[1], errno);
+}
+
+void
+gri_pdu_reactor::drain_wake()
+{
+  char buf[64];
+  while(read(d_wake_fd[0], buf, sizeof(buf)) > 0)
+    ;
+}
+
+// update the events waited for, called with d_mutex held
+void
+gri_pdu_reactor::watch(entry *e)
+{
+  entry_map::iterator it = d_entries.find(e->fd);
+  if(it == d_entries.end() || it->second != e)
+    return;  // being removed
+
+#ifdef GRI_PDU_REACTOR_EPOLL
+  // a descriptor with nothing to wait for is taken out of the set,
+  // otherwise a hung up one would keep reporting EPOLLHUP
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  if(!e->eof)
+    ev.events |= EPOLLIN;
+  if(e->want_write)
+    ev.events |= EPOLLOUT;
+  ev.data.fd = e->fd;
+  int op = EPOLL_CTL_MOD;
+  if(ev.events == 0)
+    op = EPOLL_CTL_DEL;
+  else if(!e->watched)
+    op = EPOLL_CTL_ADD;
+  if(ev.events == 0 && !e->watched)
+    return;
+  if(epoll_ctl(d_poll_fd, op, e->fd, &ev) < 0)
+    warn("epoll_ctl", e->fd, errno);
+  e->watched = (ev.events != 0);
+#else
+  // the poll set is rebuilt from the entries on every pass
+  e->watched = !e->eof || e->want_write;
+#endif
+}
+
+void
+gri_pdu_reactor::wait(std::vector<int> &readable, std::vector<int> &writable)
+{
+#ifdef GRI_PDU_REACTOR_EPOLL
+  struct epoll_event events[64];
+  const int n = epoll_wait(d_poll_fd, events, 64, -1);
+  for(int i = 0; i < n; i++) {
+    const uint32_t ev = events[i].events;
+    if(ev & (EPOLLIN | EPOLLERR | EPOLLHUP))
+      readable.push_back(events[i].data.fd);
+    if(ev & (EPOLLOUT | EPOLLERR))
+      writable.push_back(events[i].data.fd);
+  }
+#else
+  std::vector<struct pollfd> fds(1);
+  fds[0].fd = d_wake_fd[0];
+  fds[0].events = POLLIN;
+  {
+    gruel::scoped_lock lock(d_mutex);
+    for(entry_map::iterator it = d_entries.begin(); it != d_entries.end(); it++) {
+      if(!it->second->watched)
+	continue;
+      struct pollfd p;
+      p.fd = it->first;
+      p.events = (it->second->eof ? 0 : POLLIN) | (it->second->want_write ? POLLOUT : 0);
+      p.revents = 0;
+      fds.push_back(p);
+    }
+  }
+  if(poll(&fds[0], fds.size(), -1) <= 0)
+    return;
+  for(size_t i = 0; i < fds.size(); i++) {
+    const short ev = fds[i].revents;
+    if(ev & (POLLIN | POLLERR | POLLHUP))
+      readable.push_back(fds[i].fd);
+    if(i > 0 && (ev & (POLLOUT | POLLERR)))
+      writable.push_back(fds[i].fd);
+  }
+#endif
+}
+
+void
+gri_pdu_reactor::run()
+{
+  std::vector<int> readable, writable, flush;
+  for(;;) {
+    readable.clear();
+    writable.clear();
+    wait(readable, writable);
+
+    flush.clear();
+    std::vector<int>::iterator w = std::find(readable.begin(), readable.end(), d_wake_fd[0]);
+    if(w != readable.end()) {
+      readable.erase(w);
+      drain_wake();
+      gruel::scoped_lock lock(d_mutex);
+      if(d_done)
+	return;
+      d_woken = false;
+      flush.swap(d_flush);
+    }
+
+    for(size_t i = 0; i < readable.size(); i++)
+      service(readable[i], true, false);
+    for(size_t i = 0; i < writable.size(); i++)
+      service(writable[i], false, true);
+    for(size_t i = 0; i < flush.size(); i++)
+      service(flush[i], false, true);
+  }
+}
+
+void
+gri_pdu_reactor::service(int fd, bool readable, bool writable)
+{
+  entry *e;
+  {
+    gruel::scoped_lock lock(d_mutex);
+    entry_map::iterator it = d_entries.find(fd);
+    if(it == d_entries.end())
+      return;
+    e = it->second;
+    d_busy = e;
+  }
+
+  if(readable && !e->eof) {
+    for(size_t i = 0; i < MAX_BATCHES; i++)
+      if(!receive(e))
+	break;
+  }
+  if(writable)
+    flush(e);
+
+  {
+    gruel::scoped_lock lock(d_mutex);
+    d_busy = NULL;
+  }
+  d_idle.notify_all();
+}
+
+// read up to one batch, true when the batch filled up
+bool
+gri_pdu_reactor::receive(entry *e)
+{
+  size_t n = 0;
+  int err = 0;
+
+  if(e->type == DATAGRAM) {
+#ifdef GRI_PDU_REACTOR_EPOLL
+    struct mmsghdr msgs[BATCH];
+    struct iovec iov[BATCH];
+    struct sockaddr_storage from[BATCH];
+    memset(msgs, 0, sizeof(msgs));
+    for(size_t i = 0; i < BATCH; i++) {
+      iov[i].iov_base = e->spare[i].get_actual_memory();
+      iov[i].iov_len = e->mtu;
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      msgs[i].msg_hdr.msg_name = &from[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(from[i]);
+    }
+    const int r = recvmmsg(e->fd, msgs, BATCH, MSG_DONTWAIT, NULL);
+    if(r < 0)
+      err = errno;
+    else {
+      n = r;
+      for(size_t i = 0; i < n; i++)
+	e->spare[i].length = msgs[i].msg_len;
+    }
+    const struct sockaddr_storage *last = n ? &from[n-1] : NULL;
+    const socklen_t last_len = n ? msgs[n-1].msg_hdr.msg_namelen : 0;
+#else
+    struct sockaddr_storage last_from;
+    socklen_t last_len = 0;
+    while(n < BATCH) {
+      socklen_t len = sizeof(last_from);
+      const ssize_t r = recvfrom(e->fd, e->spare[n].get_actual_memory(), e->mtu, 0,
+				 (struct sockaddr *) &last_from, &len);
+      if(r < 0) {
+	err = errno;
+	break;
+      }
+      last_len = len;
+      e->spare[n++].length = r;
+    }
+    const struct sockaddr_storage *last = n ? &last_from : NULL;
+#endif
+    if(last && last_len) {
+      gruel::scoped_lock lock(d_mutex);
+      if(e->follow_sender) {
+	memcpy(&e->peer, last, last_len);
+	e->peer_len = last_len;
+      }
+    }
+    // a refused send on a connected socket is reported here, skip it
+    if(err == ECONNREFUSED)
+      err = EAGAIN;
+  }
+  else {
+    while(n < BATCH) {
+      const ssize_t r = read(e->fd, e->spare[n].get_actual_memory(), e->mtu);
+      if(r < 0) {
+	if(errno == EINTR)
+	  continue;
+	err = errno;
+	break;
+      }
+      if(r == 0) {
+	// the stream was closed, stop reading it
+	gruel::scoped_lock lock(d_mutex);
+	e->eof = true;
+	watch(e);
+	break;
+      }
+      e->spare[n++].length = r;
+    }
+  }
+
+  if(err != 0 && err != EAGAIN && err != EWOULDBLOCK && err != EINTR) {
+    warn("read", e->fd, err);
+    gruel::scoped_lock lock(d_mutex);
+    e->eof = true;
+    watch(e);
+  }
+
+  if(n == 0)
+    return false;
+
+  e->h->handle_packets(e->spare, n);
+  for(size_t i = 0; i < n; i++)
+    e->spare[i] = make_buffer(e->mtu);
+  return n == BATCH && !e->eof;
+}
+
+void
+gri_pdu_reactor::flush(entry *e)
+{
+  gras::SBuffer batch[BATCH];
+  for(;;) {
+    size_t n = 0;
+    {
+      gruel::scoped_lock lock(d_mutex);
+      while(n < BATCH && !e->txq.empty()) {
+	batch[n++] = e->txq.front();
+	e->txq.pop_front();
+      }
+      if(n == 0) {
+	e->queued = false;
+	if(e->want_write) {
+	  e->want_write = false;
+	  watch(e);
+	}
+	return;
+      }
+    }
+
+    const size_t done = write_batch(e, batch, n);
+    if(done < n) {
+      // would block, put the rest back and wait until writable
+      gruel::scoped_lock lock(d_mutex);
+      for(size_t i = n; i > done; i--)
+	e->txq.push_front(batch[i-1]);
+      if(!e->want_write) {
+	e->want_write = true;
+	watch(e);
+      }
+      return;
+    }
+    for(size_t i = 0; i < n; i++)
+      batch[i] = gras::SBuffer();
+  }
+}
+
+// write what the descriptor takes without blocking, the return is
+// the number of buffers finished; a stream leaves a partly written
+// buffer trimmed to the rest
+size_t
+gri_pdu_reactor::write_batch(entry *e, gras::SBuffer bufs[], size_t n)
+{
+  struct iovec iov[BATCH];
+  for(size_t i = 0; i < n; i++) {
+    iov[i].iov_base = bufs[i].get();
+    iov[i].iov_len = bufs[i].length;
+  }
+
+  if(e->type == STREAM) {
+    const ssize_t r = writev(e->fd, iov, n);
+    if(r < 0) {
+      if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+	return 0;
+      warn("writev", e->fd, errno);
+      return n;
+    }
+    size_t left = r, i = 0;
+    while(i < n && left >= bufs[i].length)
+      left -= bufs[i++].length;
+    if(i < n) {
+      bufs[i].offset += left;
+      bufs[i].length -= left;
+    }
+    return i;
+  }
+
+  struct sockaddr_storage peer;
+  socklen_t peer_len = 0;
+  if(e->type == DATAGRAM) {
+    gruel::scoped_lock lock(d_mutex);
+    peer_len = e->peer_len;
+    if(peer_len)
+      memcpy(&peer, &e->peer, peer_len);
+  }
+
+  size_t i = 0;
+#ifdef GRI_PDU_REACTOR_EPOLL
+  if(e->type == DATAGRAM) {
+    struct mmsghdr msgs[BATCH];
+    memset(msgs, 0, sizeof(msgs));
+    for(size_t k = 0; k < n; k++) {
+      msgs[k].msg_hdr.msg_iov = &iov[k];
+      msgs[k].msg_hdr.msg_iovlen = 1;
+      msgs[k].msg_hdr.msg_name = peer_len ? &peer : NULL;
+      msgs[k].msg_hdr.msg_namelen = peer_len;
+    }
+    while(i < n) {
+      const int r = sendmmsg(e->fd, msgs + i, n - i, MSG_DONTWAIT);
+      if(r > 0) {
+	i += r;
+	continue;
+      }
+      if(errno == EAGAIN || errno == EWOULDBLOCK)
+	return i;
+      if(errno != EINTR) {
+	// drop the datagram that failed and carry on with the rest,
+	// quietly when there is nobody to send to yet
+	if(errno != EDESTADDRREQ)
+	  warn("sendmmsg", e->fd, errno);
+	i++;
+      }
+    }
+    return i;
+  }
+#endif
+
+  while(i < n) {
+    ssize_t r;
+    if(e->type == DATAGRAM)
+      r = sendto(e->fd, iov[i].iov_base, iov[i].iov_len, 0,
+		 peer_len ? (struct sockaddr *) &peer : NULL, peer_len);
+    else
+      r = write(e->fd, iov[i].iov_base, iov[i].iov_len);
+    if(r < 0) {
+      if(errno == EAGAIN || errno == EWOULDBLOCK)
+	return i;
+      if(errno == EINTR)
+	continue;
+      if(errno != EDESTADDRREQ)
+	warn("write", e->fd, errno);
+    }
+    i++;
+  }
+  return i;
+}
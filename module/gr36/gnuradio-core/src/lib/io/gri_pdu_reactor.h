@@ -0,0 +1,136 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_GRI_PDU_REACTOR_H
+#define INCLUDED_GRI_PDU_REACTOR_H
+
+#include <gr_core_api.h>
+#include <gras/sbuffer.hpp>
+#include <gruel/thread.h>
+#include <boost/shared_ptr.hpp>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <map>
+#include <vector>
+
+/*!
+ * \brief One I/O thread shared by all PDU blocks.
+ * \ingroup internal
+ *
+ * Blocks register a non-blocking descriptor and a handler instead
+ * of running a thread and a select loop each. The reactor waits on
+ * all of them at once (epoll on Linux, poll elsewhere) and moves
+ * packets in batches: recvmmsg/sendmmsg for datagram sockets,
+ * read/writev for streams, and one read or write per packet for
+ * packet devices like tun/tap, all drained in one wakeup.
+ *
+ * Received packets are read straight into fresh SBuffers that are
+ * handed to the handler, so a block can pass them downstream
+ * without another copy. Sends queue the SBuffer and are written
+ * from the reactor thread; a descriptor that would block is
+ * retried when it becomes writable.
+ */
+class GR_CORE_API gri_pdu_reactor
+{
+public:
+  enum fd_type {
+    DATAGRAM,   //!< socket with message boundaries
+    STREAM,     //!< byte stream, packets are whatever one read returns
+    PACKET      //!< device returning one packet per read (tun/tap)
+  };
+
+  class handler
+  {
+  public:
+    virtual ~handler() {}
+
+    /*!
+     * Called from the reactor thread with the packets read in one
+     * pass. The handler may keep the buffers.
+     */
+    virtual void handle_packets(const gras::SBuffer packets[], size_t n) = 0;
+  };
+
+  //! the process wide reactor, its thread starts on first use
+  static gri_pdu_reactor &instance();
+
+  /*!
+   * Start watching \p fd. Reads allocate \p mtu bytes per packet.
+   * The descriptor is switched to non-blocking mode. It must stay
+   * open until remove() returns.
+   */
+  void add(int fd, fd_type type, size_t mtu, handler *h);
+
+  /*!
+   * Stop watching \p fd and drop its pending sends. Once this
+   * returns the handler is not running and will not be called.
+   */
+  void remove(int fd);
+
+  /*!
+   * Destination for sends on a DATAGRAM descriptor; without one
+   * the socket must be connected. With \p follow_sender the peer
+   * is replaced by the source of each received datagram.
+   */
+  void set_peer(int fd, const struct sockaddr *addr, socklen_t len,
+		bool follow_sender = false);
+
+  //! queue \p buff.get() .. + buff.length for writing to \p fd
+  void send(int fd, const gras::SBuffer &buff);
+
+  //! copy \p len bytes into a buffer and queue it
+  void send(int fd, const void *data, size_t len);
+
+  ~gri_pdu_reactor();
+
+private:
+  struct entry;
+  typedef std::map<int, entry *> entry_map;
+
+  gruel::mutex d_mutex;
+  gruel::condition_variable d_idle;
+  boost::shared_ptr<gruel::thread> d_thread;
+  entry_map d_entries;
+  std::vector<int> d_flush;     // descriptors with new sends queued
+  entry *d_busy;                // entry being serviced, unlocked
+  bool d_woken;
+  bool d_done;
+  int d_poll_fd;                // epoll instance, -1 with poll()
+  int d_wake_fd[2];             // eventfd (twice) or pipe
+
+  gri_pdu_reactor();
+
+  void run();
+  void wait(std::vector<int> &readable, std::vector<int> &writable);
+  void wake();
+  void drain_wake();
+  void watch(entry *e);
+  void service(int fd, bool readable, bool writable);
+  bool receive(entry *e);
+  void flush(entry *e);
+  size_t write_batch(entry *e, gras::SBuffer bufs[], size_t n);
+
+  gri_pdu_reactor(const gri_pdu_reactor &);
+  gri_pdu_reactor &operator=(const gri_pdu_reactor &);
+};
+
+#endif /* INCLUDED_GRI_PDU_REACTOR_H */
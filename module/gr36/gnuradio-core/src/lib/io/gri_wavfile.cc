@@ -25,227 +25,509 @@
 #endif
 
 #include <gri_wavfile.h>
+#include <volk/volk.h>
+#include <algorithm>
 #include <cstring>
-#include <stdint.h>
 #include <boost/detail/endian.hpp> //BOOST_BIG_ENDIAN
 
-# define VALID_COMPRESSION_TYPE 0x0001
+#define WAVE_FORMAT_PCM        0x0001
+#define WAVE_FORMAT_IEEE_FLOAT 0x0003
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
 
-// Basically, this is the opposite of htonx() and ntohx()
-// Define host to/from worknet (little endian) short and long
-#ifdef BOOST_BIG_ENDIAN
+static const size_t BUF_BYTES = 128 * 1024;   // one fwrite/fread
+static const int STAGE_SAMPLES = 8192;        // one conversion
 
-    static inline uint16_t __gri_wav_bs16(uint16_t x)
-    {
-        return (x>>8) | (x<<8);
-    }
+// WAV files are always little-endian; the header is assembled a byte
+// at a time so it comes out the same on any host.
+static inline void put16(unsigned char *p, uint16_t x)
+{
+  p[0] = x; p[1] = x >> 8;
+}
 
-    static inline uint32_t __gri_wav_bs32(uint32_t x)
-    {
-        return (uint32_t(__gri_wav_bs16(uint16_t(x&0xfffful)))<<16) | (__gri_wav_bs16(uint16_t(x>>16)));
-    }
+static inline void put32(unsigned char *p, uint32_t x)
+{
+  put16(p, x); put16(p + 2, x >> 16);
+}
 
-    #define htowl(x) __gri_wav_bs32(x)
-    #define wtohl(x) __gri_wav_bs32(x)
-    #define htows(x) __gri_wav_bs16(x)
-    #define wtohs(x) __gri_wav_bs16(x)
+static inline void put64(unsigned char *p, uint64_t x)
+{
+  put32(p, uint32_t(x)); put32(p + 4, uint32_t(x >> 32));
+}
+
+static inline uint16_t get16(const unsigned char *p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t get32(const unsigned char *p)
+{
+  return get16(p) | (uint32_t(get16(p + 2)) << 16);
+}
 
+static inline uint64_t get64(const unsigned char *p)
+{
+  return get32(p) | (uint64_t(get32(p + 4)) << 32);
+}
+
+// Samples on the other hand are converted in bulk and swapped
+// afterwards on big-endian hosts.
+static inline void swap_samples(void *p, int bytes_per_sample, int n)
+{
+#ifdef BOOST_BIG_ENDIAN
+  if(bytes_per_sample == 2)
+    volk_16u_byteswap_u((uint16_t *) p, n);
+  else if(bytes_per_sample == 4)
+    volk_32u_byteswap_u((uint32_t *) p, n);
 #else
+  (void) p; (void) bytes_per_sample; (void) n;
+#endif
+}
 
-    #define htowl(x) uint32_t(x)
-    #define wtohl(x) uint32_t(x)
-    #define htows(x) uint16_t(x)
-    #define wtohs(x) uint16_t(x)
+/********************************************************************/
 
-#endif // BOOST_BIG_ENDIAN
+gri_wavfile_writer::gri_wavfile_writer()
+  : d_fp(0), d_sample_rate(0), d_nchans(0), d_bytes_per_sample(0),
+    d_block_align(0), d_header_len(0), d_error(false),
+    d_frames(0), d_flushed(0), d_buf(BUF_BYTES), d_fill(0),
+    d_stage_frames(0)
+{
+}
 
-// WAV files are always little-endian, so we need some byte switching macros
-static inline uint32_t host_to_wav(uint32_t x) { return htowl(x); }
-static inline uint16_t host_to_wav(uint16_t x) { return htows(x); }
-static inline int16_t  host_to_wav(int16_t x)  { return htows(x); }
-static inline uint32_t wav_to_host(uint32_t x) { return wtohl(x); }
-static inline uint16_t wav_to_host(uint16_t x) { return wtohs(x); }
-static inline int16_t  wav_to_host(int16_t x)  { return wtohs(x); }
+gri_wavfile_writer::~gri_wavfile_writer()
+{
+  close();
+}
 
 bool
-gri_wavheader_parse(FILE *fp,
-		    unsigned int &sample_rate_o,
-		    int &nchans_o,
-		    int &bytes_per_sample_o,
-		    int &first_sample_pos_o,
-		    unsigned int &samples_per_chan_o)
-{
-  // _o variables take return values
-  char str_buf[8] = {0};
-
-  uint32_t file_size;
-  uint32_t fmt_hdr_skip;
-  uint16_t compression_type;
-  uint16_t nchans;
-  uint32_t sample_rate;
-  uint32_t avg_bytes_per_sec;
-  uint16_t block_align;
-  uint16_t bits_per_sample;
-  uint32_t chunk_size;
-
-  size_t fresult;
-
-  fresult = fread(str_buf, 1, 4, fp);
-  if (fresult != 4 || strncmp(str_buf, "RIFF", 4) || feof(fp)) {
-    return false;
-  }
+gri_wavfile_writer::valid_bits_per_sample(int bits_per_sample)
+{
+  return (bits_per_sample == 8 || bits_per_sample == 16 ||
+	  bits_per_sample == 24 || bits_per_sample == 32);
+}
 
-  fresult = fread(&file_size, 1, 4, fp);
+void
+gri_wavfile_writer::open(FILE *fp, unsigned int sample_rate, int nchans,
+			 int bits_per_sample)
+{
+  close();
+
+  d_fp = fp;
+  d_sample_rate = sample_rate;
+  d_nchans = nchans;
+  d_bytes_per_sample = bits_per_sample / 8;
+  d_block_align = d_bytes_per_sample * nchans;
+  d_header_len = (d_bytes_per_sample == 4) ? 94 : 80;
+  d_error = false;
+  d_frames = 0;
+  d_flushed = 0;
+
+  d_stage_frames = std::max(1, STAGE_SAMPLES / nchans);
+  d_stage.resize(d_stage_frames * nchans);
+  d_pcm.resize(d_stage_frames * nchans);
+
+  // we hand fwrite whole buffers, stdio has nothing to add
+  setvbuf(d_fp, NULL, _IONBF, 0);
+
+  // a placeholder until close(); it goes out with the first buffer
+  make_header(&d_buf[0], 0);
+  d_fill = d_header_len;
+}
 
-  fresult = fread(str_buf, 1, 8, fp);
-  if (fresult != 8 || strncmp(str_buf, "WAVEfmt ", 8) || feof(fp)) {
-    return false;
+void
+gri_wavfile_writer::make_header(unsigned char *hdr, uint64_t data_bytes) const
+{
+  bool is_float = (d_bytes_per_sample == 4);
+  uint64_t riff_bytes = d_header_len - 8 + data_bytes + (data_bytes & 1);
+  bool rf64 = riff_bytes > 0xFFFFFFFFULL;
+
+  memset(hdr, 0, d_header_len);
+
+  memcpy(hdr, rf64 ? "RF64" : "RIFF", 4);
+  put32(hdr + 4, rf64 ? 0xFFFFFFFF : uint32_t(riff_bytes));
+  memcpy(hdr + 8, "WAVE", 4);
+
+  // room for a ds64 chunk, filled in only when it is needed
+  memcpy(hdr + 12, rf64 ? "ds64" : "JUNK", 4);
+  put32(hdr + 16, 28);
+  if(rf64) {
+    put64(hdr + 20, riff_bytes);
+    put64(hdr + 28, data_bytes);
+    put64(hdr + 36, d_frames);
   }
 
-  fresult = fread(&fmt_hdr_skip, 1, 4, fp);
-
-  fresult = fread(&compression_type, 1, 2, fp);
-  if (wav_to_host(compression_type) != VALID_COMPRESSION_TYPE) {
-    return false;
+  unsigned char *fmt = hdr + 48;
+  memcpy(fmt, "fmt ", 4);
+  put32(fmt + 4, is_float ? 18 : 16);
+  put16(fmt + 8, is_float ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+  put16(fmt + 10, d_nchans);
+  put32(fmt + 12, d_sample_rate);
+  put32(fmt + 16, d_sample_rate * d_block_align);
+  put16(fmt + 20, d_block_align);
+  put16(fmt + 22, d_bytes_per_sample * 8);
+
+  unsigned char *data = fmt + 24;
+  if(is_float) {
+    // cbSize is already zero; non-PCM files also carry a fact chunk
+    unsigned char *fact = fmt + 26;
+    memcpy(fact, "fact", 4);
+    put32(fact + 4, 4);
+    put32(fact + 8, rf64 ? 0xFFFFFFFF : uint32_t(d_frames));
+    data = fact + 12;
   }
 
-  fresult = fread(&nchans,            1, 2, fp);
-  fresult = fread(&sample_rate,       1, 4, fp);
-  fresult = fread(&avg_bytes_per_sec, 1, 4, fp);
-  fresult = fread(&block_align,       1, 2, fp);
-  fresult = fread(&bits_per_sample,   1, 2, fp);
+  memcpy(data, "data", 4);
+  put32(data + 4, rf64 ? 0xFFFFFFFF : uint32_t(data_bytes));
+}
 
-  if (ferror(fp)) {
-    return false;
+void
+gri_wavfile_writer::flush()
+{
+  if(d_fill && !d_error) {
+    if(fwrite(&d_buf[0], 1, d_fill, d_fp) != d_fill)
+      d_error = true;
   }
+  d_flushed += d_fill;
+  d_fill = 0;
+}
 
-  fmt_hdr_skip    = wav_to_host(fmt_hdr_skip);
-  nchans          = wav_to_host(nchans);
-  sample_rate     = wav_to_host(sample_rate);
-  bits_per_sample = wav_to_host(bits_per_sample);
+void
+gri_wavfile_writer::append(const unsigned char *p, size_t len)
+{
+  while(len) {
+    size_t n = std::min(len, d_buf.size() - d_fill);
+    memcpy(&d_buf[d_fill], p, n);
+    d_fill += n;
+    p += n;
+    len -= n;
+    if(d_fill == d_buf.size())
+      flush();
+  }
+}
 
-  if (bits_per_sample != 8 && bits_per_sample != 16) {
+bool
+gri_wavfile_writer::write(const float *const in[], int nin_chans, int nframes)
+{
+  if(!d_fp)
     return false;
-  }
 
-  fmt_hdr_skip -= 16;
-  if (fmt_hdr_skip) {
-    fseek(fp, fmt_hdr_skip, SEEK_CUR);
+  nin_chans = std::min(nin_chans, d_nchans);
+  unsigned char *pcm = (unsigned char *) &d_pcm[0];
+
+  for(int done = 0; done < nframes; ) {
+    int n = std::min(nframes - done, d_stage_frames);
+    int nsamples = n * d_nchans;
+
+    const float *src;
+    if(d_nchans == 1 && nin_chans == 1) {
+      src = in[0] + done;
+    }
+    else {
+      float *dst = &d_stage[0];
+      for(int i = 0; i < n; i++) {
+	int c = 0;
+	for(; c < nin_chans; c++)
+	  *dst++ = in[c][done + i];
+	for(; c < d_nchans; c++)
+	  *dst++ = 0;
+      }
+      src = &d_stage[0];
+    }
+
+    switch(d_bytes_per_sample) {
+    case 1:
+      // unsigned, centered on 128
+      for(int i = 0; i < nsamples; i++) {
+	float s = (src[i] + 1) * 127;
+	s = std::min(std::max(s, 0.0f), 255.0f);
+	pcm[i] = (unsigned char) (s + 0.5f);
+      }
+      break;
+
+    case 2:
+      volk_32f_s32f_convert_16i_u((int16_t *) pcm, src, 32767, nsamples);
+      swap_samples(pcm, 2, nsamples);
+      break;
+
+    case 3:
+      // the 32 bit conversion only clips at the int32 range, so clip
+      // to full scale first; then pack the low three bytes of each in
+      // place, sample i is read before bytes 3i..3i+2 are stored
+      for(int i = 0; i < nsamples; i++)
+	d_stage[i] = std::min(std::max(src[i], -1.0f), 1.0f);
+      volk_32f_s32f_convert_32i_u(&d_pcm[0], &d_stage[0], 8388607, nsamples);
+      for(int i = 0; i < nsamples; i++) {
+	int32_t s = d_pcm[i];
+	pcm[3*i]   = s;
+	pcm[3*i+1] = s >> 8;
+	pcm[3*i+2] = s >> 16;
+      }
+      break;
+
+    case 4:
+      memcpy(pcm, src, nsamples * sizeof(float));
+      swap_samples(pcm, 4, nsamples);
+      break;
+    }
+
+    append(pcm, n * d_block_align);
+    d_frames += n;
+    done += n;
   }
 
-  // data chunk
-  fresult = fread(str_buf, 1, 4, fp);
-  if (strncmp(str_buf, "data", 4)) {
-    return false;
+  return !d_error;
+}
+
+bool
+gri_wavfile_writer::close()
+{
+  if(!d_fp)
+    return true;
+
+  uint64_t data_bytes = d_frames * d_block_align;
+  if(data_bytes & 1) {
+    unsigned char pad = 0;
+    append(&pad, 1);
   }
 
-  fresult = fread(&chunk_size, 1, 4, fp);
-  if (ferror(fp)) {
-    return false;
+  if(d_flushed == 0) {
+    // the header never left the buffer, fix it up there
+    make_header(&d_buf[0], data_bytes);
+    flush();
+  }
+  else {
+    std::vector<unsigned char> hdr(d_header_len);
+    make_header(&hdr[0], data_bytes);
+    flush();
+    if(fseek(d_fp, 0, SEEK_SET) != 0 ||
+       fwrite(&hdr[0], 1, hdr.size(), d_fp) != hdr.size())
+      d_error = true;
   }
 
-  // More byte swapping
-  chunk_size = wav_to_host(chunk_size);
+  if(fclose(d_fp) != 0)
+    d_error = true;
+  d_fp = 0;
 
-  // Output values
-  sample_rate_o      = (unsigned) sample_rate;
-  nchans_o           = (int) nchans;
-  bytes_per_sample_o = (int) (bits_per_sample / 8);
-  first_sample_pos_o = (int) ftell(fp);
-  samples_per_chan_o = (unsigned) (chunk_size / (bytes_per_sample_o * nchans));
-  return true;
+  return !d_error;
 }
 
+/********************************************************************/
 
-short int
-gri_wav_read_sample(FILE *fp, int bytes_per_sample)
+gri_wavfile_reader::gri_wavfile_reader()
+  : d_fp(0), d_sample_rate(0), d_nchans(0), d_bytes_per_sample(0),
+    d_block_align(0), d_float(false), d_data_pos(0),
+    d_samples_per_chan(0), d_position(0), d_unread(0),
+    d_buf(BUF_BYTES), d_pos(0), d_len(0), d_stage_frames(0)
 {
-  int16_t buf_16bit;
+}
 
-  if(!fread(&buf_16bit, bytes_per_sample, 1, fp)) {
-    return 0;
-  }
-  if(bytes_per_sample == 1) {
-    return (short) buf_16bit;
-  }
-  return (short)wav_to_host(buf_16bit);
+gri_wavfile_reader::~gri_wavfile_reader()
+{
+  close();
 }
 
+void
+gri_wavfile_reader::close()
+{
+  if(d_fp)
+    fclose(d_fp);
+  d_fp = 0;
+}
 
 bool
-gri_wavheader_write(FILE *fp,
-		    unsigned int sample_rate,
-		    int nchans,
-		    int bytes_per_sample)
-{
-  const int header_len = 44;
-  char wav_hdr[header_len] = "RIFF\0\0\0\0WAVEfmt \0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0data\0\0\0";
-  uint16_t nchans_f        = (uint16_t) nchans;
-  uint32_t sample_rate_f   = (uint32_t) sample_rate;
-  uint16_t block_align     = bytes_per_sample * nchans;
-  uint32_t avg_bytes       = sample_rate * block_align;
-  uint16_t bits_per_sample = bytes_per_sample * 8;
-
-  nchans_f        = host_to_wav(nchans_f);
-  sample_rate_f   = host_to_wav(sample_rate_f);
-  block_align     = host_to_wav(block_align);
-  avg_bytes       = host_to_wav(avg_bytes);
-  bits_per_sample = host_to_wav(bits_per_sample);
-
-  wav_hdr[16] = 0x10; // no extra bytes
-  wav_hdr[20] = 0x01; // no compression
-  memcpy((void *) (wav_hdr + 22), (void *) &nchans_f,        2);
-  memcpy((void *) (wav_hdr + 24), (void *) &sample_rate_f,   4);
-  memcpy((void *) (wav_hdr + 28), (void *) &avg_bytes,       4);
-  memcpy((void *) (wav_hdr + 32), (void *) &block_align,     2);
-  memcpy((void *) (wav_hdr + 34), (void *) &bits_per_sample, 2);
-
-  fwrite(&wav_hdr, 1, header_len, fp);
-  if (ferror(fp)) {
+gri_wavfile_reader::open(FILE *fp)
+{
+  close();
+  d_fp = fp;
+
+  unsigned char riff[12];
+  if(fread(riff, 1, 12, fp) != 12 || memcmp(riff + 8, "WAVE", 4))
     return false;
+
+  bool rf64 = !memcmp(riff, "RF64", 4);
+  if(!rf64 && memcmp(riff, "RIFF", 4))
+    return false;
+
+  uint64_t ds64_data_bytes = 0;
+  uint16_t format = 0;
+  uint16_t nchans = 0;
+  uint16_t bits_per_sample = 0;
+  uint64_t data_bytes = 0;
+
+  for(;;) {
+    unsigned char chunk[40];
+    if(fread(chunk, 1, 8, fp) != 8)
+      return false;
+    uint32_t len = get32(chunk + 4);
+    uint32_t used = 0;
+
+    if(!memcmp(chunk, "ds64", 4)) {
+      if(len < 28 || fread(chunk, 1, 28, fp) != 28)
+	return false;
+      ds64_data_bytes = get64(chunk + 8);
+      used = 28;
+    }
+    else if(!memcmp(chunk, "fmt ", 4)) {
+      used = std::min(len, uint32_t(40));
+      if(len < 16 || fread(chunk, 1, used, fp) != used)
+	return false;
+      format          = get16(chunk);
+      nchans          = get16(chunk + 2);
+      d_sample_rate   = get32(chunk + 4);
+      bits_per_sample = get16(chunk + 14);
+      // the sub-format GUID starts with the old format tag
+      if(format == WAVE_FORMAT_EXTENSIBLE && used >= 26)
+	format = get16(chunk + 24);
+    }
+    else if(!memcmp(chunk, "data", 4)) {
+      data_bytes = (rf64 && len == 0xFFFFFFFF) ? ds64_data_bytes : len;
+      break;
+    }
+
+    long skip = long(len - used) + (len & 1);
+    if(skip && fseek(fp, skip, SEEK_CUR) != 0)
+      return false;
   }
 
+  if(format == WAVE_FORMAT_PCM) {
+    if(bits_per_sample != 8 && bits_per_sample != 16 &&
+       bits_per_sample != 24 && bits_per_sample != 32)
+      return false;
+  }
+  else if(format == WAVE_FORMAT_IEEE_FLOAT) {
+    if(bits_per_sample != 32)
+      return false;
+  }
+  else {
+    return false;
+  }
+  if(nchans == 0)
+    return false;
+
+  d_nchans = nchans;
+  d_bytes_per_sample = bits_per_sample / 8;
+  d_block_align = d_bytes_per_sample * nchans;
+  d_float = (format == WAVE_FORMAT_IEEE_FLOAT);
+  d_samples_per_chan = data_bytes / d_block_align;
+  d_data_pos = ftell(fp);
+
+  d_stage_frames = std::max(1, STAGE_SAMPLES / d_nchans);
+  d_stage.resize(d_stage_frames * d_nchans);
+  d_pcm.resize(d_stage_frames * d_nchans);
+
+  // our own buffer does the batching
+  setvbuf(d_fp, NULL, _IONBF, 0);
+
+  d_position = 0;
+  d_unread = d_samples_per_chan * d_block_align;
+  d_pos = d_len = 0;
   return true;
 }
 
+bool
+gri_wavfile_reader::rewind()
+{
+  if(fseek(d_fp, d_data_pos, SEEK_SET) != 0)
+    return false;
+
+  d_position = 0;
+  d_unread = d_samples_per_chan * d_block_align;
+  d_pos = d_len = 0;
+  return true;
+}
 
-void
-gri_wav_write_sample(FILE *fp, short int sample, int bytes_per_sample)
-{
-  void *data_ptr;
-  unsigned char buf_8bit;
-  int16_t       buf_16bit;
-
-  if (bytes_per_sample == 1) {
-    buf_8bit = (unsigned char) sample;
-    data_ptr = (void *) &buf_8bit;
-  } else {
-    buf_16bit = host_to_wav((int16_t) sample);
-    data_ptr  = (void *) &buf_16bit;
-  }
+bool
+gri_wavfile_reader::fill()
+{
+  // keep the partial frame at the end, if any
+  size_t left = d_len - d_pos;
+  memmove(&d_buf[0], &d_buf[d_pos], left);
+  d_pos = 0;
+  d_len = left;
+
+  size_t want = size_t(std::min(uint64_t(d_buf.size() - d_len), d_unread));
+  if(want == 0)
+    return false;
 
-  fwrite(data_ptr, 1, bytes_per_sample, fp);
+  size_t got = fread(&d_buf[d_len], 1, want, d_fp);
+  d_len += got;
+  d_unread -= got;
+  if(got < want)
+    d_unread = 0;    // file cut short or i/o error: stop here
+
+  return got > 0;
 }
 
+void
+gri_wavfile_reader::unpack(float *out, unsigned char *in, int nsamples)
+{
+  switch(d_bytes_per_sample) {
+  case 1:
+    for(int i = 0; i < nsamples; i++)
+      out[i] = in[i] / 128.0f - 1;
+    break;
+
+  case 2:
+    swap_samples(in, 2, nsamples);
+    volk_16i_s32f_convert_32f_u(out, (const int16_t *) in, 32767, nsamples);
+    break;
+
+  case 3:
+    // top-align into 32 bits for the sign, the scale undoes the shift
+    for(int i = 0; i < nsamples; i++)
+      d_pcm[i] = int32_t((uint32_t(in[3*i]) << 8) |
+			 (uint32_t(in[3*i+1]) << 16) |
+			 (uint32_t(in[3*i+2]) << 24));
+    volk_32i_s32f_convert_32f_u(out, &d_pcm[0], 8388607.0f * 256, nsamples);
+    break;
+
+  case 4:
+    swap_samples(in, 4, nsamples);
+    if(d_float)
+      memcpy(out, in, nsamples * sizeof(float));
+    else
+      volk_32i_s32f_convert_32f_u(out, (const int32_t *) in, 2147483647.0f, nsamples);
+    break;
+  }
+}
 
-bool
-gri_wavheader_complete(FILE *fp, unsigned int byte_count)
+int
+gri_wavfile_reader::read(float *const out[], int nout_chans, int nframes)
 {
-  uint32_t chunk_size = (uint32_t) byte_count;
-  chunk_size = host_to_wav(chunk_size);
+  if(!d_fp)
+    return 0;
 
-  fseek(fp, 40, SEEK_SET);
-  fwrite(&chunk_size, 1, 4, fp);
+  nout_chans = std::min(nout_chans, d_nchans);
+
+  int done = 0;
+  while(done < nframes) {
+    size_t avail = (d_len - d_pos) / d_block_align;
+    if(avail == 0) {
+      if(!fill())
+	break;
+      avail = (d_len - d_pos) / d_block_align;
+      if(avail == 0)
+	continue;
+    }
 
-  chunk_size = (uint32_t) byte_count + 36; // fmt chunk and data header
-  chunk_size = host_to_wav(chunk_size);
-  fseek(fp, 4, SEEK_SET);
+    int n = int(std::min(avail, size_t(std::min(nframes - done, d_stage_frames))));
+    int nsamples = n * d_nchans;
+    unsigned char *in = &d_buf[d_pos];
 
-  fwrite(&chunk_size, 1, 4, fp);
+    if(d_nchans == 1 && nout_chans == 1) {
+      unpack(out[0] + done, in, nsamples);
+    }
+    else {
+      unpack(&d_stage[0], in, nsamples);
+      const float *src = &d_stage[0];
+      for(int i = 0; i < n; i++, src += d_nchans)
+	for(int c = 0; c < nout_chans; c++)
+	  out[c][done + i] = src[c];
+    }
 
-  if (ferror(fp)) {
-    return false;
+    d_pos += n * d_block_align;
+    d_position += n;
+    done += n;
   }
 
-  return true;
+  return done;
 }
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2008 Free Software Foundation, Inc.
+ * Copyright 2008,2013 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -23,74 +23,156 @@
 // This file stores all the RIFF file type knowledge for the gr_wavfile_*
 // blocks.
 
+#ifndef INCLUDED_GRI_WAVFILE_H
+#define INCLUDED_GRI_WAVFILE_H
+
 #include <gr_core_api.h>
 #include <cstdio>
+#include <stdint.h>
+#include <vector>
 
 /*!
- * \brief Read signal information from a given WAV file.
+ * \brief Write interleaved float channels to a WAV file in large
+ * chunks.
+ *
+ * Samples are 8, 16 or 24 bit PCM or 32 bit IEEE float. Each call to
+ * write() interleaves the channels into a scratch buffer and converts
+ * it in one go with the VOLK conversion kernels; the result collects
+ * in an output buffer that only goes to disk when full, so every
+ * fwrite() is one whole buffer at a buffer-aligned file offset.
  *
- * \param[in]  fp          File pointer to an opened, empty file.
- * \param[out] sample_rate Stores the sample rate [S/s]
- * \param[out] nchans      Number of channels
- * \param[out] bytes_per_sample Bytes per sample, can either be 1 or 2 (corresponding o
- *                              8 or 16 bit samples, respectively)
- * \param[out] first_sample_pos Number of the first byte containing a sample. Use this
- *                              with fseek() to jump from the end of the file to the
- *                              first sample when in repeat mode.
- * \param[out] samples_per_chan Number of samples per channel
- * \return True on a successful read, false if the file could not be read or is
- *         not a valid WAV file.
+ * The header is kept in the output buffer until the first flush and
+ * its size fields are filled in once, by close(). It reserves room
+ * for an RF64 ds64 chunk; a file that outgrows the 4 GiB RIFF limit
+ * is turned into RF64 on close(), anything smaller stays a plain
+ * WAV file whose JUNK chunk readers skip.
  */
-bool
-gri_wavheader_parse(FILE *fp,
-		    unsigned int &sample_rate,
-		    int &nchans,
-		    int &bytes_per_sample,
-		    int &first_sample_pos,
-		    unsigned int &samples_per_chan);
+class GR_CORE_API gri_wavfile_writer
+{
+ public:
+  gri_wavfile_writer();
+  ~gri_wavfile_writer();
 
+  //! true if \p bits_per_sample is 8, 16, 24 or 32 (float)
+  static bool valid_bits_per_sample(int bits_per_sample);
 
-/*!
- * \brief Read one sample from an open WAV file at the current position.
- *
- * Takes care of endianness.
- */
-short int
-gri_wav_read_sample(FILE *fp, int bytes_per_sample);
+  /*!
+   * \brief Start a new file on \p fp, which the writer takes over.
+   * Nothing is written yet.
+   */
+  void open(FILE *fp, unsigned int sample_rate, int nchans,
+	    int bits_per_sample);
 
+  /*!
+   * \brief Append \p nframes frames. Channel c comes from \p in[c];
+   * channels at or beyond \p nin_chans are written as zeros.
+   *
+   * \return false on an i/o error
+   */
+  bool write(const float *const in[], int nin_chans, int nframes);
 
-/*!
- * \brief Write a valid RIFF file header
- *
- * Note: Some header values are kept blank because they're usually not known
- * a-priori (file and chunk lengths). Use gri_wavheader_complete() to fill
- * these in.
- */
-bool
-gri_wavheader_write(FILE *fp,
-		 unsigned int sample_rate,
-		 int nchans,
-		 int bytes_per_sample);
+  /*!
+   * \brief Flush, complete the header and close the file.
+   *
+   * \return false if anything failed to reach the file
+   */
+  bool close();
 
-/*!
- * \brief Write one sample to an open WAV file at the current position.
- *
- * Takes care of endianness.
- */
-void
-gri_wav_write_sample(FILE *fp, short int sample, int bytes_per_sample);
+  bool is_open() const { return d_fp != 0; }
+  uint64_t frames() const { return d_frames; }
+
+ private:
+  FILE *d_fp;
+  unsigned int d_sample_rate;
+  int d_nchans;
+  int d_bytes_per_sample;
+  int d_block_align;
+  int d_header_len;
+  bool d_error;
+  uint64_t d_frames;
+  uint64_t d_flushed;                // bytes already in the file
+  std::vector<unsigned char> d_buf;  // header and samples not yet written
+  size_t d_fill;
+  std::vector<float> d_stage;        // interleaved samples
+  std::vector<int32_t> d_pcm;        // converted samples
+  int d_stage_frames;
 
+  void make_header(unsigned char *hdr, uint64_t data_bytes) const;
+  void append(const unsigned char *p, size_t len);
+  void flush();
+
+  gri_wavfile_writer(const gri_wavfile_writer &);
+  gri_wavfile_writer &operator=(const gri_wavfile_writer &);
+};
 
 /*!
- * \brief Complete a WAV header
- *
- * Note: The stream position is changed during this function. If anything
- * needs to be written to the WAV file after calling this function (which
- * shouldn't happen), you  need to fseek() to the end of the file (or
- * whereever).
+ * \brief Read a WAV file into float channels in large chunks.
  *
- * \param[in] fp         File pointer to an open WAV file with a blank header
- * \param[in] byte_count Length of all samples written to the file in bytes.
+ * open() accepts RIFF and RF64 files holding 8, 16, 24 or 32 bit PCM
+ * or 32 bit IEEE float samples, including WAVE_FORMAT_EXTENSIBLE
+ * headers, and skips chunks it does not know. read() pulls the data
+ * chunk in with big freads and converts a whole run of frames with
+ * the VOLK kernels before splitting it into channels.
  */
-bool
-gri_wavheader_complete(FILE *fp, unsigned int byte_count);
+class GR_CORE_API gri_wavfile_reader
+{
+ public:
+  gri_wavfile_reader();
+  ~gri_wavfile_reader();
+
+  /*!
+   * \brief Parse the header of \p fp, which the reader takes over,
+   * and leave it at the first sample.
+   *
+   * \return false if the file is not a WAV file we can read
+   */
+  bool open(FILE *fp);
+  void close();
+
+  unsigned int sample_rate() const { return d_sample_rate; }
+  int channels() const { return d_nchans; }
+  int bits_per_sample() const { return d_bytes_per_sample * 8; }
+  bool is_float() const { return d_float; }
+  uint64_t samples_per_chan() const { return d_samples_per_chan; }
+
+  //! frames read since open() or the last rewind()
+  uint64_t position() const { return d_position; }
+
+  /*!
+   * \brief Read up to \p nframes frames. Channel c goes to \p out[c]
+   * for c < \p nout_chans, the others are dropped.
+   *
+   * \return the number of frames read; less than asked for at the end
+   * of the data, 0 once it is exhausted or the file is cut short.
+   */
+  int read(float *const out[], int nout_chans, int nframes);
+
+  //! go back to the first sample
+  bool rewind();
+
+ private:
+  FILE *d_fp;
+  unsigned int d_sample_rate;
+  int d_nchans;
+  int d_bytes_per_sample;
+  int d_block_align;
+  bool d_float;
+  long d_data_pos;
+  uint64_t d_samples_per_chan;
+  uint64_t d_position;
+  uint64_t d_unread;                 // data chunk bytes not read yet
+  std::vector<unsigned char> d_buf;
+  size_t d_pos;
+  size_t d_len;
+  std::vector<float> d_stage;
+  std::vector<int32_t> d_pcm;
+  int d_stage_frames;
+
+  bool fill();
+  void unpack(float *out, unsigned char *in, int nsamples);
+
+  gri_wavfile_reader(const gri_wavfile_reader &);
+  gri_wavfile_reader &operator=(const gri_wavfile_reader &);
+};
+
+#endif /* INCLUDED_GRI_WAVFILE_H */
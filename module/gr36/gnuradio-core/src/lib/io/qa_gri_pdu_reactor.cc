@@ -0,0 +1,225 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <qa_gri_pdu_reactor.h>
+#include <gri_pdu_reactor.h>
+#include <cppunit/TestAssert.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace {
+
+  // gathers what the reactor thread hands over
+  class collector : public gri_pdu_reactor::handler
+  {
+    gruel::mutex d_mutex;
+    std::vector<std::string> d_packets;
+
+  public:
+    void handle_packets(const gras::SBuffer packets[], size_t n)
+    {
+      gruel::scoped_lock lock(d_mutex);
+      for(size_t i = 0; i < n; i++)
+	d_packets.push_back(std::string((const char *) packets[i].get(), packets[i].length));
+    }
+
+    std::vector<std::string> packets()
+    {
+      gruel::scoped_lock lock(d_mutex);
+      return d_packets;
+    }
+
+    // wait up to 5 seconds for the packets to come in
+    std::vector<std::string> wait_for(size_t n)
+    {
+      for(int i = 0; i < 500 && packets().size() < n; i++)
+	usleep(10000);
+      return packets();
+    }
+  };
+
+  // a packet of len bytes that carries its index
+  std::string make_packet(int i, size_t len)
+  {
+    std::string s(len, 'a' + i % 26);
+    memcpy(&s[0], &i, sizeof(i));
+    return s;
+  }
+
+  // blocking read with a timeout, -1 when nothing arrives
+  ssize_t read_packet(int fd, char *buf, size_t len)
+  {
+    pollfd p = {fd, POLLIN, 0};
+    if(poll(&p, 1, 5000) <= 0)
+      return -1;
+    return read(fd, buf, len);
+  }
+
+  int bind_udp_loopback(sockaddr_in &addr)
+  {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    CPPUNIT_ASSERT(fd >= 0);
+    int rcvbuf = 4 << 20;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    CPPUNIT_ASSERT(bind(fd, (sockaddr *) &addr, sizeof(addr)) == 0);
+    socklen_t len = sizeof(addr);
+    CPPUNIT_ASSERT(getsockname(fd, (sockaddr *) &addr, &len) == 0);
+    return fd;
+  }
+}
+
+void
+qa_gri_pdu_reactor::test_udp_loopback()
+{
+  gri_pdu_reactor &reactor = gri_pdu_reactor::instance();
+  sockaddr_in server_addr, client_addr;
+  const int server = bind_udp_loopback(server_addr);
+  const int client = bind_udp_loopback(client_addr);
+
+  collector c;
+  reactor.add(server, gri_pdu_reactor::DATAGRAM, 2000, &c);
+  reactor.set_peer(server, NULL, 0, true);
+
+  // datagrams arrive whole and in order
+  const int n = 200;
+  for(int i = 0; i < n; i++) {
+    const std::string s = make_packet(i, 100 + i % 900);
+    CPPUNIT_ASSERT(sendto(client, s.data(), s.size(), 0,
+			  (sockaddr *) &server_addr, sizeof(server_addr)) == (ssize_t) s.size());
+  }
+  const std::vector<std::string> rx = c.wait_for(n);
+  CPPUNIT_ASSERT_EQUAL((size_t) n, rx.size());
+  for(int i = 0; i < n; i++)
+    CPPUNIT_ASSERT(rx[i] == make_packet(i, 100 + i % 900));
+
+  // replies follow the sender
+  for(int i = 0; i < n; i++) {
+    const std::string s = make_packet(i, 1400);
+    reactor.send(server, s.data(), s.size());
+  }
+  char buf[2000];
+  for(int i = 0; i < n; i++) {
+    const ssize_t len = read_packet(client, buf, sizeof(buf));
+    CPPUNIT_ASSERT_EQUAL((ssize_t) 1400, len);
+    CPPUNIT_ASSERT(std::string(buf, len) == make_packet(i, 1400));
+  }
+
+  reactor.remove(server);
+  close(server);
+  close(client);
+}
+
+void
+qa_gri_pdu_reactor::test_packet_socketpair()
+{
+  // a seqpacket socket pair stands in for a tun device
+  gri_pdu_reactor &reactor = gri_pdu_reactor::instance();
+  int sp[2];
+  CPPUNIT_ASSERT(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sp) == 0);
+
+  collector c;
+  reactor.add(sp[0], gri_pdu_reactor::PACKET, 1500, &c);
+
+  const int n = 200;
+  for(int i = 0; i < n; i++) {
+    const std::string s = make_packet(i, 60 + i);
+    CPPUNIT_ASSERT(write(sp[1], s.data(), s.size()) == (ssize_t) s.size());
+  }
+  const std::vector<std::string> rx = c.wait_for(n);
+  CPPUNIT_ASSERT_EQUAL((size_t) n, rx.size());
+  for(int i = 0; i < n; i++)
+    CPPUNIT_ASSERT(rx[i] == make_packet(i, 60 + i));
+
+  for(int i = 0; i < n; i++) {
+    const std::string s = make_packet(i, 1000);
+    reactor.send(sp[0], s.data(), s.size());
+  }
+  char buf[2000];
+  for(int i = 0; i < n; i++) {
+    const ssize_t len = read_packet(sp[1], buf, sizeof(buf));
+    CPPUNIT_ASSERT_EQUAL((ssize_t) 1000, len);
+    CPPUNIT_ASSERT(std::string(buf, len) == make_packet(i, 1000));
+  }
+
+  reactor.remove(sp[0]);
+  close(sp[0]);
+  close(sp[1]);
+}
+
+void
+qa_gri_pdu_reactor::test_stream_socketpair()
+{
+  gri_pdu_reactor &reactor = gri_pdu_reactor::instance();
+  int st[2];
+  CPPUNIT_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, st) == 0);
+
+  collector c;
+  reactor.add(st[0], gri_pdu_reactor::STREAM, 4096, &c);
+
+  // queue more than the socket holds, so the reactor has to wait
+  // for the reader and resume the partial writes in order
+  std::string tx;
+  for(int i = 0; i < 1000; i++) {
+    const std::string s = make_packet(i, 4 + (i * 37) % 3000);
+    tx += s;
+    reactor.send(st[0], s.data(), s.size());
+  }
+  std::string rx;
+  char buf[777];
+  while(rx.size() < tx.size()) {
+    const ssize_t len = read_packet(st[1], buf, sizeof(buf));
+    CPPUNIT_ASSERT(len > 0);
+    rx.append(buf, len);
+  }
+  CPPUNIT_ASSERT(rx == tx);
+
+  // received bytes come through in order, however they are split up
+  const size_t nbytes = 10000;
+  for(size_t i = 0; i < nbytes; i += 100)
+    CPPUNIT_ASSERT(write(st[1], tx.data() + i, 100) == 100);
+  std::string received;
+  for(int i = 0; i < 500 && received.size() < nbytes; i++) {
+    usleep(10000);
+    const std::vector<std::string> packets = c.packets();
+    received.clear();
+    for(size_t j = 0; j < packets.size(); j++)
+      received += packets[j];
+  }
+  CPPUNIT_ASSERT(received == tx.substr(0, nbytes));
+
+  reactor.remove(st[0]);
+  close(st[0]);
+  close(st[1]);
+}
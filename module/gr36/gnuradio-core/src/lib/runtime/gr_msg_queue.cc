@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2005,2009 Free Software Foundation, Inc.
+ * Copyright 2005,2009,2013 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -25,6 +25,18 @@
 #endif
 #include <gr_msg_queue.h>
 #include <stdexcept>
+#include <climits>
+#include <cstddef>
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+#define GR_MSG_QUEUE_FUTEX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ring size of an unbounded queue before it spills
+static const size_t UNBOUNDED_RING_SIZE = 512;
 
 gr_msg_queue_sptr
 gr_make_msg_queue(unsigned int limit)
@@ -33,9 +45,20 @@ gr_make_msg_queue(unsigned int limit)
 }
 
 gr_msg_queue::gr_msg_queue(unsigned int limit)
-  : d_not_empty(), d_not_full(),
-    /*d_head(0), d_tail(0),*/ d_count(0), d_limit(limit)
+  : d_enqueue_pos(0), d_dequeue_pos(0), d_count(0), d_limit(limit),
+    d_spill_count(0),
+    d_not_empty_seq(0), d_not_empty_waiters(0),
+    d_not_full_seq(0), d_not_full_waiters(0),
+    d_not_empty(), d_not_full()
 {
+  size_t size = 2;
+  while (size < (limit ? limit : UNBOUNDED_RING_SIZE))
+    size *= 2;
+
+  d_ring.resize(size);
+  for (size_t i = 0; i < size; i++)
+    d_ring[i].seq = i;
+  d_mask = size - 1;
 }
 
 gr_msg_queue::~gr_msg_queue()
@@ -43,76 +66,245 @@ gr_msg_queue::~gr_msg_queue()
   flush ();
 }
 
+/*
+ * Cell i is free for the producer at position pos when its seq is pos,
+ * and holds a message for the consumer at pos when its seq is pos + 1.
+ * Releasing a cell hands it on by moving its seq a step ahead. The
+ * positions are read without a barrier, the CAS catches stale values;
+ * the release is a locked add so it also orders the waiter check after.
+ */
+
+bool
+gr_msg_queue::ring_push(const gr_message_sptr &msg)
+{
+  size_t pos = d_enqueue_pos;
+  cell *c;
+  for (;;){
+    c = &d_ring[pos & d_mask];
+    const ptrdiff_t dif = (ptrdiff_t) gruel::atomic_load_acquire(&c->seq) - (ptrdiff_t) pos;
+    if (dif == 0 && gruel::atomic_cas(&d_enqueue_pos, pos, pos + 1))
+      break;
+    if (dif < 0)
+      return false;		// full
+    pos = d_enqueue_pos;
+  }
+
+  c->msg = msg;
+  gruel::atomic_add(&c->seq, (size_t) 1);
+  return true;
+}
+
+bool
+gr_msg_queue::ring_pop(gr_message_sptr &msg)
+{
+  size_t pos = d_dequeue_pos;
+  cell *c;
+  for (;;){
+    c = &d_ring[pos & d_mask];
+    const ptrdiff_t dif = (ptrdiff_t) gruel::atomic_load_acquire(&c->seq) - (ptrdiff_t) (pos + 1);
+    if (dif == 0 && gruel::atomic_cas(&d_dequeue_pos, pos, pos + 1))
+      break;
+    if (dif < 0)
+      return false;		// empty
+    pos = d_dequeue_pos;
+  }
+
+  msg.swap(c->msg);
+  gruel::atomic_add(&c->seq, d_mask);
+  return true;
+}
+
+bool
+gr_msg_queue::try_insert(const gr_message_sptr &msg)
+{
+  if (d_limit != 0){
+    // reserve our place under the limit, the ring always has room for it
+    unsigned int count;
+    do {
+      count = gruel::atomic_load(&d_count);
+      if (count >= d_limit)
+	return false;
+    } while (!gruel::atomic_cas(&d_count, count, count + 1));
+
+    // a cell can lag its consumer for a moment after the count drops
+    while (!ring_push(msg))
+      boost::this_thread::yield();
+    return true;
+  }
+
+  gruel::atomic_add(&d_count, 1u);
+
+  // once anything has spilled, later messages queue behind it
+  if (d_spill_count == 0 && ring_push(msg))
+    return true;
+
+  gruel::scoped_lock guard(d_spill_mutex);
+  if (d_spill_tail == 0)
+    d_spill_head = msg;
+  else
+    d_spill_tail->d_next = msg;
+  d_spill_tail = msg;
+  gruel::atomic_add(&d_spill_count, 1u);
+  return true;
+}
+
+// move spilled messages back into the ring, oldest first
 void
-gr_msg_queue::insert_tail(gr_message_sptr msg)
+gr_msg_queue::refill()
 {
-  if (msg->d_next)
-    throw std::invalid_argument("gr_msg_queue::insert_tail: msg already in queue");
+  gruel::scoped_lock guard(d_spill_mutex);
+  while (d_spill_head != 0){
+    // unlink first, a consumer may take it the moment it is in the ring
+    gr_message_sptr m = d_spill_head;
+    gr_message_sptr next = m->d_next;
+    m->d_next.reset();
+    if (!ring_push(m)){
+      m->d_next = next;
+      break;
+    }
+    d_spill_head = next;
+    if (d_spill_head == 0)
+      d_spill_tail.reset();
+    gruel::atomic_add(&d_spill_count, -1u);
+  }
+}
+
+bool
+gr_msg_queue::try_delete(gr_message_sptr &msg)
+{
+  while (!ring_pop(msg)){
+    if (d_spill_count == 0)
+      return false;
+    refill();
+    if (ring_pop(msg))
+      break;
+    // nothing moved: a cell is still being released by its consumer
+    boost::this_thread::yield();
+  }
+
+  gruel::atomic_add(&d_count, -1u);
+  return true;
+}
 
+/*
+ * A waiter registers, samples the sequence word, and then retries once
+ * before sleeping; the other side publishes its change before reading
+ * the waiter count. One of the two always sees the other, so a wakeup
+ * can't be lost, and nobody makes a system call when no one sleeps.
+ * Each message (or free slot) wakes one sleeper; one that loses the
+ * race for it goes back to sleep.
+ */
+
+void
+gr_msg_queue::wait(volatile int *seq, volatile int *waiters, int val,
+		   gruel::condition_variable &cond)
+{
+#ifdef GR_MSG_QUEUE_FUTEX
+  syscall(SYS_futex, (int *) seq, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+#else
   gruel::scoped_lock guard(d_mutex);
+  while (gruel::atomic_load(seq) == val)
+    cond.wait(guard);
+#endif
+  gruel::atomic_add(waiters, -1);
+}
+
+void
+gr_msg_queue::wake(volatile int *seq, volatile int *waiters,
+		   gruel::condition_variable &cond, int n)
+{
+  if (*waiters == 0)
+    return;
 
-  while (full_p())
-    d_not_full.wait(guard);
+  gruel::atomic_add(seq, 1);
+#ifdef GR_MSG_QUEUE_FUTEX
+  syscall(SYS_futex, (int *) seq, FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+#else
+  gruel::scoped_lock guard(d_mutex);
+  if (n == 1)
+    cond.notify_one();
+  else
+    cond.notify_all();
+#endif
+}
 
-  if (d_tail == 0){
-    d_tail = d_head = msg;
-    //msg->d_next = 0;
-    msg->d_next.reset();
-  }
-  else {
-    d_tail->d_next = msg;
-    d_tail = msg;
-    //msg->d_next = 0;
-    msg->d_next.reset();
+void
+gr_msg_queue::insert_tail(gr_message_sptr msg)
+{
+  if (msg->d_next)
+    throw std::invalid_argument("gr_msg_queue::insert_tail: msg already in queue");
+
+  while (!try_insert(msg)){
+    gruel::atomic_add(&d_not_full_waiters, 1);
+    const int seq = gruel::atomic_load(&d_not_full_seq);
+    if (try_insert(msg)){
+      gruel::atomic_add(&d_not_full_waiters, -1);
+      break;
+    }
+    wait(&d_not_full_seq, &d_not_full_waiters, seq, d_not_full);
   }
-  d_count++;
-  d_not_empty.notify_one();
+
+  wake(&d_not_empty_seq, &d_not_empty_waiters, d_not_empty, 1);
 }
 
 gr_message_sptr
 gr_msg_queue::delete_head()
 {
-  gruel::scoped_lock guard(d_mutex);
   gr_message_sptr m;
 
-  while ((m = d_head) == 0)
-    d_not_empty.wait(guard);
-
-  d_head = m->d_next;
-  if (d_head == 0){
-    //d_tail = 0;
-    d_tail.reset();
+  while (!try_delete(m)){
+    gruel::atomic_add(&d_not_empty_waiters, 1);
+    const int seq = gruel::atomic_load(&d_not_empty_seq);
+    if (try_delete(m)){
+      gruel::atomic_add(&d_not_empty_waiters, -1);
+      break;
+    }
+    wait(&d_not_empty_seq, &d_not_empty_waiters, seq, d_not_empty);
   }
 
-  d_count--;
-  // m->d_next = 0;
-  m->d_next.reset();
-  d_not_full.notify_one();
+  wake(&d_not_full_seq, &d_not_full_waiters, d_not_full, 1);
   return m;
 }
 
 gr_message_sptr
 gr_msg_queue::delete_head_nowait()
 {
-  gruel::scoped_lock guard(d_mutex);
   gr_message_sptr m;
 
-  if ((m = d_head) == 0){
+  if (!try_delete(m)){
     //return 0;
     return gr_message_sptr();
   }
 
-  d_head = m->d_next;
-  if (d_head == 0){
-    //d_tail = 0;
-    d_tail.reset();
+  wake(&d_not_full_seq, &d_not_full_waiters, d_not_full, 1);
+  return m;
+}
+
+unsigned int
+gr_msg_queue::delete_head_n(std::vector<gr_message_sptr> &msgs, unsigned int max)
+{
+  if (max == 0)
+    return 0;
+
+  msgs.push_back(delete_head());
+  return 1 + delete_head_n_nowait(msgs, max - 1);
+}
+
+unsigned int
+gr_msg_queue::delete_head_n_nowait(std::vector<gr_message_sptr> &msgs, unsigned int max)
+{
+  gr_message_sptr m;
+  unsigned int n = 0;
+
+  while (n < max && try_delete(m)){
+    msgs.push_back(m);
+    m.reset();
+    n++;
   }
 
-  d_count--;
-  //m->d_next = 0;
-  m->d_next.reset();
-  d_not_full.notify_one();
-  return m;
+  if (n > 0)
+    wake(&d_not_full_seq, &d_not_full_waiters, d_not_full, n);
+  return n;
 }
 
 void
@@ -1,6 +1,6 @@
 /* -*- c++ -*- */
 /*
- * Copyright 2005,2009 Free Software Foundation, Inc.
+ * Copyright 2005,2009,2013 Free Software Foundation, Inc.
  *
  * This file is part of GNU Radio
  *
@@ -25,6 +25,8 @@
 #include <gr_core_api.h>
 #include <gr_msg_handler.h>
 #include <gruel/thread.h>
+#include <gruel/atomic.h>
+#include <vector>
 
 class gr_msg_queue;
 typedef boost::shared_ptr<gr_msg_queue> gr_msg_queue_sptr;
@@ -34,16 +36,56 @@ GR_CORE_API gr_msg_queue_sptr gr_make_msg_queue(unsigned int limit=0);
 /*!
  * \brief thread-safe message queue
  * \ingroup misc
+ *
+ * Messages live in a ring of sequence numbered cells; producers and
+ * consumers claim cells with a compare-and-swap on their own counter,
+ * so neither side takes a lock. The ring holds at least \p limit
+ * messages. An unbounded queue (limit 0) that outgrows its ring spills
+ * the excess to a locked list until consumers catch up.
+ *
+ * Only blocked callers sleep: on a futex on Linux, elsewhere on a
+ * condition variable. The non-blocking paths make no system calls.
  */
 class GR_CORE_API gr_msg_queue : public gr_msg_handler {
 
-  gruel::mutex		    d_mutex;
+  struct cell {
+    volatile size_t	    seq;
+    gr_message_sptr	    msg;
+  };
+
+  std::vector<cell>	    d_ring;
+  size_t		    d_mask;
+  volatile size_t	    d_enqueue_pos;
+  char			    d_pad0[64];	// keep producers and consumers
+  volatile size_t	    d_dequeue_pos;	//   off each other's cache line
+  char			    d_pad1[64];
+  volatile unsigned int	    d_count;    // # of messages in queue.
+  unsigned int		    d_limit;    // max # of messages in queue.  0 -> unbounded
+
+  // overflow of an unbounded queue, linked through gr_message::d_next
+  gruel::mutex		    d_spill_mutex;
+  gr_message_sptr	    d_spill_head;
+  gr_message_sptr	    d_spill_tail;
+  volatile unsigned int	    d_spill_count;
+
+  // blocking waits; the sequence words are bumped on every wakeup
+  volatile int		    d_not_empty_seq;
+  volatile int		    d_not_empty_waiters;
+  volatile int		    d_not_full_seq;
+  volatile int		    d_not_full_waiters;
+  gruel::mutex		    d_mutex;	// only for the non-futex fallback
   gruel::condition_variable d_not_empty;
   gruel::condition_variable d_not_full;
-  gr_message_sptr	    d_head;
-  gr_message_sptr	    d_tail;
-  unsigned int		    d_count;    // # of messages in queue.
-  unsigned int		    d_limit;    // max # of messages in queue.  0 -> unbounded
+
+  bool ring_push(const gr_message_sptr &msg);
+  bool ring_pop(gr_message_sptr &msg);
+  bool try_insert(const gr_message_sptr &msg);
+  bool try_delete(gr_message_sptr &msg);
+  void refill();
+  void wait(volatile int *seq, volatile int *waiters, int val,
+	    gruel::condition_variable &cond);
+  void wake(volatile int *seq, volatile int *waiters,
+	    gruel::condition_variable &cond, int n);
 
 public:
   gr_msg_queue(unsigned int limit);
@@ -72,17 +114,30 @@ public:
    */
   gr_message_sptr delete_head_nowait();
 
+  /*!
+   * \brief Delete up to \p max messages from head of queue and append
+   * them to \p msgs, returning how many were taken.
+   * Block until at least one message is available.
+   */
+  unsigned int delete_head_n(std::vector<gr_message_sptr> &msgs, unsigned int max);
+
+  /*!
+   * \brief Delete up to \p max messages from head of queue and append
+   * them to \p msgs, returning how many were taken; 0 if the queue is empty.
+   */
+  unsigned int delete_head_n_nowait(std::vector<gr_message_sptr> &msgs, unsigned int max);
+
   //! Delete all messages from the queue
   void flush();
 
   //! is the queue empty?
-  bool empty_p() const { return d_count == 0; }
+  bool empty_p() const { return gruel::atomic_load(&d_count) == 0; }
 
   //! is the queue full?
-  bool full_p() const { return d_limit != 0 && d_count >= d_limit; }
+  bool full_p() const { return d_limit != 0 && gruel::atomic_load(&d_count) >= d_limit; }
 
   //! return number of messages in queue
-  unsigned int count() const { return d_count; }
+  unsigned int count() const { return gruel::atomic_load(&d_count); }
 
   //! return limit on number of message in queue.  0 -> unbounded
   unsigned int limit() const { return d_limit; }
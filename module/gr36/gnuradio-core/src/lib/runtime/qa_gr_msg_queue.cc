@@ -0,0 +1,172 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <qa_gr_msg_queue.h>
+#include <gr_msg_queue.h>
+#include <cppunit/TestAssert.h>
+#include <gruel/thread_group.h>
+#include <boost/bind.hpp>
+#include <vector>
+
+// fifo through an unbounded queue, well past the ring so it spills
+void
+qa_gr_msg_queue::t0 ()
+{
+  gr_msg_queue_sptr q = gr_make_msg_queue ();
+  const int N = 5000;
+
+  for (int i = 0; i < N; i++)
+    q->insert_tail (gr_make_message (i));
+  CPPUNIT_ASSERT_EQUAL (N, (int) q->count ());
+  CPPUNIT_ASSERT (!q->full_p ());
+
+  for (int i = 0; i < N; i++){
+    if (i % 7 == 0)		// interleave more so spilled and fresh mix
+      q->insert_tail (gr_make_message (N + i));
+    CPPUNIT_ASSERT_EQUAL ((long) i, q->delete_head ()->type ());
+  }
+  for (int i = 0; i < N; i += 7)
+    CPPUNIT_ASSERT_EQUAL ((long) (N + i), q->delete_head_nowait ()->type ());
+
+  CPPUNIT_ASSERT (q->empty_p ());
+  CPPUNIT_ASSERT (q->delete_head_nowait () == 0);
+}
+
+// bounded queue reports full at exactly its limit
+void
+qa_gr_msg_queue::t1 ()
+{
+  gr_msg_queue_sptr q = gr_make_msg_queue (3);
+
+  for (int i = 0; i < 3; i++){
+    CPPUNIT_ASSERT (!q->full_p ());
+    q->insert_tail (gr_make_message (i));
+  }
+  CPPUNIT_ASSERT (q->full_p ());
+  CPPUNIT_ASSERT_EQUAL (3U, q->count ());
+
+  q->delete_head ();
+  CPPUNIT_ASSERT (!q->full_p ());
+  q->flush ();
+  CPPUNIT_ASSERT (q->empty_p ());
+}
+
+// batches take up to max, oldest first, and append
+void
+qa_gr_msg_queue::t2 ()
+{
+  gr_msg_queue_sptr q = gr_make_msg_queue ();
+  std::vector<gr_message_sptr> msgs;
+
+  CPPUNIT_ASSERT_EQUAL (0U, q->delete_head_n_nowait (msgs, 10));
+  for (int i = 0; i < 5; i++)
+    q->insert_tail (gr_make_message (i));
+
+  CPPUNIT_ASSERT_EQUAL (3U, q->delete_head_n (msgs, 3));
+  CPPUNIT_ASSERT_EQUAL (2U, q->delete_head_n_nowait (msgs, 10));
+  CPPUNIT_ASSERT_EQUAL ((size_t) 5, msgs.size ());
+  for (int i = 0; i < 5; i++)
+    CPPUNIT_ASSERT_EQUAL ((long) i, msgs[i]->type ());
+  CPPUNIT_ASSERT (q->empty_p ());
+}
+
+void
+qa_gr_msg_queue::t3 ()
+{
+  gr_msg_queue_sptr q = gr_make_msg_queue ();
+  gr_message_sptr msg = gr_make_message (0);
+
+  // the spill list links through the message
+  for (int i = 0; i < 1000; i++)
+    q->insert_tail (gr_make_message (i));
+  q->insert_tail (msg);
+  q->insert_tail (gr_make_message (0));
+  q->insert_tail (msg);		// throws std::invalid_argument
+}
+
+static void
+producer (gr_msg_queue_sptr q, int id, int n)
+{
+  for (int i = 0; i < n; i++)
+    q->insert_tail (gr_make_message (id, i));
+}
+
+static void
+consumer (gr_msg_queue_sptr q, int nproducers, std::vector<long> *seen, bool *in_order)
+{
+  std::vector<gr_message_sptr> msgs;
+  std::vector<long> last (nproducers, -1);
+
+  for (;;){
+    msgs.clear ();
+    q->delete_head_n (msgs, 8);
+    for (size_t k = 0; k < msgs.size (); k++){
+      const long id = msgs[k]->type ();
+      if (id < 0){		// pass the rest of any shutdown batch on
+	for (size_t j = k + 1; j < msgs.size (); j++)
+	  q->insert_tail (gr_make_message (-1));
+	return;
+      }
+      const long i = (long) msgs[k]->arg1 ();
+      if (i <= last[id])
+	*in_order = false;
+      last[id] = i;
+      (*seen)[id]++;
+    }
+  }
+}
+
+// several producers and consumers through a small bounded queue: every
+// message arrives once and each producer's messages stay in order
+void
+qa_gr_msg_queue::t4 ()
+{
+  const int NP = 3, NC = 3, N = 20000;
+  gr_msg_queue_sptr q = gr_make_msg_queue (16);
+  std::vector<std::vector<long> > seen (NC, std::vector<long> (NP, 0));
+  bool in_order[NC];
+
+  gruel::thread_group consumers, producers;
+  for (int c = 0; c < NC; c++){
+    in_order[c] = true;
+    consumers.create_thread (boost::bind (consumer, q, NP, &seen[c], &in_order[c]));
+  }
+  for (int p = 0; p < NP; p++)
+    producers.create_thread (boost::bind (producer, q, p, N));
+  producers.join_all ();
+  for (int c = 0; c < NC; c++)
+    q->insert_tail (gr_make_message (-1));
+  consumers.join_all ();
+
+  for (int p = 0; p < NP; p++){
+    long total = 0;
+    for (int c = 0; c < NC; c++)
+      total += seen[c][p];
+    CPPUNIT_ASSERT_EQUAL ((long) N, total);
+  }
+  for (int c = 0; c < NC; c++)
+    CPPUNIT_ASSERT (in_order[c]);
+  CPPUNIT_ASSERT (q->empty_p ());
+}
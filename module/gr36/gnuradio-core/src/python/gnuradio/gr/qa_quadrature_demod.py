@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+#
+# Copyright 2013 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+from gnuradio import gr, gr_unittest
+import cmath
+import math
+
+class test_quadrature_demod (gr_unittest.TestCase):
+
+    def setUp (self):
+        self.tb = gr.top_block ()
+
+    def tearDown (self):
+        self.tb = None
+
+    def test_quad_demod_001 (self):
+        # a tone of varying amplitude, long enough to cross several
+        # work calls; each output is the phase step times the gain and
+        # the first, against the zero history, is 0
+        gain = 2.5
+        freqs = [0.3 * math.sin(0.01*i) for i in range(10000)]
+        phase = 0
+        src_data = []
+        for i, f in enumerate(freqs):
+            phase += f
+            src_data.append((1 + 0.5*math.cos(0.003*i)) * cmath.exp(1j*phase))
+        expected_result = [0.0] + [gain * f for f in freqs[1:]]
+
+        src = gr.vector_source_c (src_data)
+        op = gr.quadrature_demod_cf (gain)
+        dst = gr.vector_sink_f ()
+        self.tb.connect (src, op)
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        result_data = dst.data ()
+        self.assertFloatTuplesAlmostEqual (expected_result, result_data, 5)
+
+
+if __name__ == '__main__':
+    gr_unittest.run(test_quadrature_demod, "test_quadrature_demod.xml")
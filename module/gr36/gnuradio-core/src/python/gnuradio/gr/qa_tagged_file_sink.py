@@ -0,0 +1,65 @@
+#!/usr/bin/env python
+#
+# Copyright 2013 Free Software Foundation, Inc.
+#
+# This file is part of GNU Radio
+#
+# GNU Radio is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3, or (at your option)
+# any later version.
+#
+# GNU Radio is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Radio; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+from gnuradio import gr, gr_unittest
+import array
+import os
+
+class test_tagged_file_sink(gr_unittest.TestCase):
+
+    def setUp(self):
+        self.tb = gr.top_block()
+
+    def tearDown(self):
+        self.tb = None
+
+    def test_001(self):
+        src_data = range(1000)
+        trigger = 100*[0,] + 200*[1,] + 300*[0,] + 100*[1,] + 300*[0,]
+
+        src = gr.vector_source_s(src_data)
+        trg = gr.vector_source_s(trigger)
+        tagger = gr.burst_tagger(gr.sizeof_short)
+        snk = gr.tagged_file_sink(gr.sizeof_short, 1000)
+        self.tb.connect(src, (tagger, 0))
+        self.tb.connect(trg, (tagger, 1))
+        self.tb.connect(tagger, snk)
+        self.tb.run()
+
+        index = "file%d.index" % snk.unique_id()
+        entries = [l.split() for l in open(index) if not l.startswith('#')]
+        os.remove(index)
+
+        # Without time tags the burst times come from the sample rate
+        self.assertEqual(len(entries), 2)
+        for (n, first, nitems, t, fname), (start, length) in \
+                zip(entries, ((100, 200), (600, 100))):
+            self.assertEqual(int(first), start)
+            self.assertEqual(int(nitems), length)
+            self.assertAlmostEqual(float(t), start / 1000.0)
+
+            data = array.array('h', open(fname, 'rb').read())
+            os.remove(fname)
+            self.assertEqual(list(data), src_data[start:start+length])
+
+if __name__ == '__main__':
+    gr_unittest.run(test_tagged_file_sink, "test_tagged_file_sink.xml")
@@ -52,7 +52,10 @@ class test_wavefile(gr_unittest.TestCase):
 	self.tb.run()
 	wf_out.close()
 
-	self.assertEqual(getsize(infile), getsize(outfile))
+	# The sink reserves a 36 byte JUNK chunk ahead of the format
+	# chunk, so the file can be turned into RF64 if it grows past
+	# 4 GiB; the samples have to come through unchanged.
+	self.assertEqual(getsize(infile) + 36, getsize(outfile))
 
 	in_f  = file(infile,  'rb')
 	out_f = file(outfile, 'rb')
@@ -60,9 +63,61 @@ class test_wavefile(gr_unittest.TestCase):
 	in_data  = in_f.read()
 	out_data = out_f.read()
         out_f.close()
+
+	wf_check = gr.wavfile_source(outfile)
+	self.assertEqual(wf_check.channels(), wf_in.channels())
+	self.assertEqual(wf_check.sample_rate(), wf_in.sample_rate())
+	self.assertEqual(wf_check.bits_per_sample(), wf_in.bits_per_sample())
+	wf_check = None
+	os.remove(outfile)
+
+	self.assertEqual(in_data[44:], out_data[80:])
+
+    def test_003_wide_formats (self):
+	src_data = (0.5, -0.25, 0.125, 0.0, -1.0, 0.75, 0.3, -0.6)
+	for bits in (24, 32):
+	    outfile = "test_out_%d.wav" % bits
+
+	    tb = gr.top_block()
+	    src = gr.vector_source_f(src_data)
+	    wf_out = gr.wavfile_sink(outfile, 1, 48000, bits)
+	    tb.connect(src, wf_out)
+	    tb.run()
+	    wf_out.close()
+
+	    tb = gr.top_block()
+	    wf_in = gr.wavfile_source(outfile)
+	    dst = gr.vector_sink_f()
+	    tb.connect(wf_in, dst)
+	    tb.run()
+	    self.assertEqual(wf_in.bits_per_sample(), bits)
+	    wf_in = None
+	    os.remove(outfile)
+
+	    self.assertFloatTuplesAlmostEqual(src_data, dst.data(), 6)
+
+    def test_004_clip_24bit (self):
+	# samples out of range clip to full scale instead of wrapping
+	src_data = (2.0, -3.0, 1000.0, -1000.0, 0.5)
+	expected = (1.0, -1.0, 1.0, -1.0, 0.5)
+	outfile = "test_out_clip.wav"
+
+	tb = gr.top_block()
+	src = gr.vector_source_f(src_data)
+	wf_out = gr.wavfile_sink(outfile, 1, 48000, 24)
+	tb.connect(src, wf_out)
+	tb.run()
+	wf_out.close()
+
+	tb = gr.top_block()
+	wf_in = gr.wavfile_source(outfile)
+	dst = gr.vector_sink_f()
+	tb.connect(wf_in, dst)
+	tb.run()
+	wf_in = None
 	os.remove(outfile)
 
-	self.assertEqual(in_data, out_data)
+	self.assertFloatTuplesAlmostEqual(expected, dst.data(), 6)
 
 
 if __name__ == '__main__':
@@ -0,0 +1,168 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#include <time.h>
+#include <unistd.h>
+#include <gri_lfsr.h>
+#include <gri_glfsr.h>
+#include <string.h>
+
+#define ITERATIONS	(64 * 1000 * 1000)
+#define BLOCK_SIZE	(64 * 1000)	// fits in cache
+
+static unsigned char input[BLOCK_SIZE];
+static unsigned char output[BLOCK_SIZE];
+
+static double
+timeval_to_double (const struct timeval *tv)
+{
+  return (double) tv->tv_sec + (double) tv->tv_usec * 1e-6;
+}
+
+static double
+cpu_time ()
+{
+#ifdef HAVE_SYS_RESOURCE_H
+  struct rusage	rusage;
+  if (getrusage (RUSAGE_SELF, &rusage) < 0){
+    perror ("getrusage");
+    exit (1);
+  }
+  return timeval_to_double (&rusage.ru_utime)
+    + timeval_to_double (&rusage.ru_stime);
+#else
+  return (double) clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+static void
+benchmark (void test (unsigned char *out, const unsigned char *in),
+	   const char *implementation_name)
+{
+  // touch memory
+  memset (output, 0, sizeof (output));
+
+  double start = cpu_time ();
+  test (output, input);
+  double total = cpu_time () - start;
+
+  printf ("%22s:  cpu: %6.3f  Mbits/sec: %8.1f\n",
+	  implementation_name, total, ITERATIONS / total / 1e6);
+}
+
+// ----------------------------------------------------------------
+// One bit at a time against the block versions; both produce the
+// same bits.
+
+void lfsr_bitwise (unsigned char *out, const unsigned char *in)
+{
+  gri_lfsr lfsr (0x8A, 0x7F, 7);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++)
+    for (int j = 0; j < BLOCK_SIZE; j++)
+      out[j] = lfsr.next_bit ();
+}
+
+void lfsr_block (unsigned char *out, const unsigned char *in)
+{
+  gri_lfsr lfsr (0x8A, 0x7F, 7);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++)
+    lfsr.next_bits (out, BLOCK_SIZE);
+}
+
+void glfsr_bitwise (unsigned char *out, const unsigned char *in)
+{
+  gri_glfsr glfsr (gri_glfsr::glfsr_mask (16), 1);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++)
+    for (int j = 0; j < BLOCK_SIZE; j++)
+      out[j] = glfsr.next_bit ();
+}
+
+void glfsr_block (unsigned char *out, const unsigned char *in)
+{
+  gri_glfsr glfsr (gri_glfsr::glfsr_mask (16), 1);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++)
+    glfsr.next_bits (out, BLOCK_SIZE);
+}
+
+// ----------------------------------------------------------------
+
+void scramble_bitwise (unsigned char *out, const unsigned char *in)
+{
+  gri_lfsr lfsr (0x8A, 0x7F, 7);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++)
+    for (int j = 0; j < BLOCK_SIZE; j++)
+      out[j] = lfsr.next_bit_scramble (in[j]);
+}
+
+void scramble_block (unsigned char *out, const unsigned char *in)
+{
+  gri_lfsr lfsr (0x8A, 0x7F, 7);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++)
+    lfsr.next_bits_scramble (out, in, BLOCK_SIZE);
+}
+
+void descramble_bitwise (unsigned char *out, const unsigned char *in)
+{
+  gri_lfsr lfsr (0x8A, 0x7F, 7);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++)
+    for (int j = 0; j < BLOCK_SIZE; j++)
+      out[j] = lfsr.next_bit_descramble (in[j]);
+}
+
+void descramble_block (unsigned char *out, const unsigned char *in)
+{
+  gri_lfsr lfsr (0x8A, 0x7F, 7);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++)
+    lfsr.next_bits_descramble (out, in, BLOCK_SIZE);
+}
+
+int
+main (int argc, char **argv)
+{
+  for (int i = 0; i < BLOCK_SIZE; i++)
+    input[i] = random () & 1;
+
+  benchmark (lfsr_bitwise, "lfsr bitwise");
+  benchmark (lfsr_block, "lfsr block");
+  benchmark (glfsr_bitwise, "glfsr bitwise");
+  benchmark (glfsr_block, "glfsr block");
+  benchmark (scramble_bitwise, "scramble bitwise");
+  benchmark (scramble_block, "scramble block");
+  benchmark (descramble_bitwise, "descramble bitwise");
+  benchmark (descramble_block, "descramble block");
+}
@@ -30,6 +30,7 @@
 #include <unistd.h>
 #include <gr_nco.h>
 #include <gr_fxpt_nco.h>
+#include <gri_nco_engine.h>
 #include <string.h>
 
 #define ITERATIONS	20000000
@@ -141,6 +142,28 @@ void fxpt_sincos_vec (float *x, float *y)
   }
 }
 
+void engine_sincos_vec (float *x, float *y)
+{
+  gri_nco_engine	nco;
+
+  nco.set_freq (2 * M_PI / FREQ);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++){
+    nco.sincos ((gr_complex*)x, BLOCK_SIZE);
+  }
+}
+
+void engine_rotate_vec (float *x, float *y)
+{
+  gri_nco_engine	nco;
+
+  nco.set_freq (2 * M_PI / FREQ);
+
+  for (int i = 0; i < ITERATIONS/BLOCK_SIZE; i++){
+    nco.rotate ((gr_complex*)x, (gr_complex*)x, BLOCK_SIZE);
+  }
+}
+
 // ----------------------------------------------------------------
 
 void native_sincos (float *x, float *y)
@@ -217,4 +240,6 @@ main (int argc, char **argv)
   benchmark (basic_sincos_vec, "basic sin/cos vec");
   benchmark (native_sincos_vec, "native sin/cos vec");
   benchmark (fxpt_sincos_vec, "fxpt sin/cos vec");
+  benchmark (engine_sincos_vec, "engine sin/cos vec");
+  benchmark (engine_rotate_vec, "engine rotate vec");
 }
@@ -26,6 +26,7 @@
 #include <gr_unittests.h>
 #include <qa_runtime.h>
 #include <qa_general.h>
+#include <qa_io.h>
 #include <qa_filter.h>
 // #include <qa_atsc.h>
 
@@ -40,6 +41,7 @@ main (int argc, char **argv)
 
   runner.addTest (qa_runtime::suite ());
   runner.addTest (qa_general::suite ());
+  runner.addTest (qa_io::suite ());
   runner.addTest (qa_filter::suite ());
   // runner.addTest (qa_atsc::suite ());
   runner.setOutputter(xmlout);
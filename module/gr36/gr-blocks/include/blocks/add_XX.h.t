@@ -45,6 +45,18 @@ namespace gr {
       typedef boost::shared_ptr<@NAME@> sptr;
 
       static sptr make(size_t vlen=1);
+
+      /*!
+       * \brief Return true if integer results saturate
+       */
+      virtual bool saturate() const = 0;
+
+      /*!
+       * \brief Clamp integer results to the range of the stream type
+       * instead of wrapping around. Has no effect on float and complex
+       * streams.
+       */
+      virtual void set_saturate(bool saturate) = 0;
     };
 
   } /* namespace blocks */
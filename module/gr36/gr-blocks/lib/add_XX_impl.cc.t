@@ -41,8 +41,12 @@ namespace gr {
       : gr_sync_block ("@NAME@",
 		       gr_make_io_signature (1, -1, sizeof (@I_TYPE@)*vlen),
 		       gr_make_io_signature (1,  1, sizeof (@O_TYPE@)*vlen)),
-      d_vlen(vlen)
+      d_vlen(vlen),
+      d_saturate(false)
     {
+      // the output may reuse the buffer of input 0,
+      // work reads every tile of it before writing the tile
+      input_config(0).inline_buffer = true;
     }
 
     int
@@ -51,16 +55,14 @@ namespace gr {
 		      gr_vector_void_star &output_items)
     {
       @O_TYPE@ *optr = (@O_TYPE@ *) output_items[0];
-      
-      int ninputs = input_items.size ();
-      
-      for (size_t i = 0; i < noutput_items*d_vlen; i++){
-	@I_TYPE@ acc = ((@I_TYPE@ *) input_items[0])[i];
-	for (int j = 1; j < ninputs; j++)
-	  acc += ((@I_TYPE@ *) input_items[j])[i];
-	
-	*optr++ = (@O_TYPE@) acc;
-      }
+      const @I_TYPE@ *const *in = (const @I_TYPE@ *const *) &input_items[0];
+      size_t ninputs = input_items.size();
+      size_t n = noutput_items*d_vlen;
+
+      if(d_saturate && arith_saturate<@I_TYPE@>::run(optr, in, ninputs, n, +1))
+	return noutput_items;
+
+      d_combiner.tree<arith_add<@I_TYPE@> >(optr, in, ninputs, n);
 
       return noutput_items;
     }
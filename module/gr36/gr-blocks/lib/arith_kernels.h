@@ -0,0 +1,302 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_BLOCKS_ARITH_KERNELS_H
+#define INCLUDED_BLOCKS_ARITH_KERNELS_H
+
+#include <gr_complex.h>
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+ * Element-wise kernels for the multi-input math blocks (add_XX,
+ * sub_XX, multiply_XX, divide_XX, and_XX, or_XX, xor_XX).
+ *
+ * Each op provides a scalar apply() and a block() over two arrays;
+ * block() has SSE2 specializations for the integer and float types.
+ * arith_combiner runs an op across all inputs of a work call, one
+ * cache sized tile at a time, so the output tile stays in L1 while
+ * the inputs stream through once.
+ */
+
+namespace gr {
+  namespace blocks {
+
+#define BLOCKS_ARITH_OP(name, expr)                                     \
+    template <typename T> struct name                                   \
+    {                                                                   \
+      static T apply(const T a, const T b) { return expr; }             \
+      static void block(T *out, const T *a, const T *b, const size_t n) \
+      {                                                                 \
+        for(size_t i = 0; i < n; i++)                                   \
+          out[i] = apply(a[i], b[i]);                                   \
+      }                                                                 \
+    };
+
+    BLOCKS_ARITH_OP(arith_add, a + b)
+    BLOCKS_ARITH_OP(arith_sub, a - b)
+    BLOCKS_ARITH_OP(arith_mul, a * b)
+    BLOCKS_ARITH_OP(arith_div, a / b)
+    BLOCKS_ARITH_OP(arith_and, a & b)
+    BLOCKS_ARITH_OP(arith_or,  a | b)
+    BLOCKS_ARITH_OP(arith_xor, a ^ b)
+
+#undef BLOCKS_ARITH_OP
+
+#ifdef __SSE2__
+    static inline __m128i arith_load(const void *p) { return _mm_loadu_si128((const __m128i *)p); }
+    static inline void arith_store(void *p, const __m128i v) { _mm_storeu_si128((__m128i *)p, v); }
+
+#define BLOCKS_ARITH_SSE2(name, T, vop)                                 \
+    template <> inline void                                             \
+    name<T>::block(T *out, const T *a, const T *b, const size_t n)      \
+    {                                                                   \
+      const size_t lanes = 16/sizeof(T);                                \
+      size_t i = 0;                                                     \
+      for(; i + lanes <= n; i += lanes)                                 \
+        arith_store(out + i, vop(arith_load(a + i), arith_load(b + i))); \
+      for(; i < n; i++)                                                 \
+        out[i] = apply(a[i], b[i]);                                     \
+    }
+
+    BLOCKS_ARITH_SSE2(arith_add, short, _mm_add_epi16)
+    BLOCKS_ARITH_SSE2(arith_sub, short, _mm_sub_epi16)
+    BLOCKS_ARITH_SSE2(arith_mul, short, _mm_mullo_epi16)
+    BLOCKS_ARITH_SSE2(arith_and, short, _mm_and_si128)
+    BLOCKS_ARITH_SSE2(arith_or,  short, _mm_or_si128)
+    BLOCKS_ARITH_SSE2(arith_xor, short, _mm_xor_si128)
+    BLOCKS_ARITH_SSE2(arith_add, int, _mm_add_epi32)
+    BLOCKS_ARITH_SSE2(arith_sub, int, _mm_sub_epi32)
+    BLOCKS_ARITH_SSE2(arith_and, int, _mm_and_si128)
+    BLOCKS_ARITH_SSE2(arith_or,  int, _mm_or_si128)
+    BLOCKS_ARITH_SSE2(arith_xor, int, _mm_xor_si128)
+    BLOCKS_ARITH_SSE2(arith_and, unsigned char, _mm_and_si128)
+    BLOCKS_ARITH_SSE2(arith_or,  unsigned char, _mm_or_si128)
+    BLOCKS_ARITH_SSE2(arith_xor, unsigned char, _mm_xor_si128)
+
+#undef BLOCKS_ARITH_SSE2
+
+#define BLOCKS_ARITH_SSE2_PS(name, vop)                                 \
+    template <> inline void                                             \
+    name<float>::block(float *out, const float *a, const float *b, const size_t n) \
+    {                                                                   \
+      size_t i = 0;                                                     \
+      for(; i + 4 <= n; i += 4)                                         \
+        _mm_storeu_ps(out + i, vop(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i))); \
+      for(; i < n; i++)                                                 \
+        out[i] = apply(a[i], b[i]);                                     \
+    }                                                                   \
+    template <> inline void                                             \
+    name<gr_complex>::block(gr_complex *out, const gr_complex *a, const gr_complex *b, const size_t n) \
+    {                                                                   \
+      name<float>::block((float *)out, (const float *)a, (const float *)b, 2*n); \
+    }
+
+    BLOCKS_ARITH_SSE2_PS(arith_add, _mm_add_ps)
+    BLOCKS_ARITH_SSE2_PS(arith_sub, _mm_sub_ps)
+
+#undef BLOCKS_ARITH_SSE2_PS
+
+    template <> inline void
+    arith_div<float>::block(float *out, const float *a, const float *b, const size_t n)
+    {
+      size_t i = 0;
+      for(; i + 4 <= n; i += 4)
+        _mm_storeu_ps(out + i, _mm_div_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+      for(; i < n; i++)
+        out[i] = apply(a[i], b[i]);
+    }
+#endif /* __SSE2__ */
+
+    //! Integer type wide enough to sum any number of inputs without overflow
+    template <typename T> struct arith_wide { typedef long long type; };
+    template <> struct arith_wide<short> { typedef int type; };
+    template <> struct arith_wide<unsigned char> { typedef int type; };
+
+    /*!
+     * Combine the inputs of a multi-input math block.
+     *
+     * Associative ops are reduced as a pairwise tree over the inputs,
+     * which shortens the dependency chain and, for floats, keeps the
+     * rounding error growing with log2(ninputs) instead of ninputs.
+     * The output may alias input 0 (inline buffers): every tile of
+     * input 0 is read before the same tile of the output is written.
+     */
+    template <typename T>
+    class arith_combiner
+    {
+    public:
+      enum { TILE_ITEMS = (4096 / sizeof(T)) > 0 ? (4096 / sizeof(T)) : 1 };
+
+      //! out = in[0] op in[1] op ... as a pairwise tree
+      template <typename Op>
+      void tree(T *out, const T *const *in, const size_t ninputs, const size_t n)
+      {
+        scratch_for(ninputs);
+        for(size_t off = 0; off < n; off += TILE_ITEMS) {
+          const size_t len = std::min<size_t>(TILE_ITEMS, n - off);
+          reduce<Op>(out + off, in, 0, ninputs, off, len, &d_scratch[0]);
+        }
+      }
+
+      //! out = in[0] op (in[1] reduce_op in[2] reduce_op ...), ie a - (b + c)
+      template <typename Op, typename ReduceOp>
+      void head_tree(T *out, const T *const *in, const size_t ninputs, const size_t n)
+      {
+        if(ninputs < 2) return tree<Op>(out, in, ninputs, n);
+        scratch_for(ninputs);
+        for(size_t off = 0; off < n; off += TILE_ITEMS) {
+          const size_t len = std::min<size_t>(TILE_ITEMS, n - off);
+          T *rest = &d_scratch[0];
+          reduce<ReduceOp>(rest, in, 1, ninputs, off, len, rest + TILE_ITEMS);
+          Op::block(out + off, in[0] + off, rest, len);
+        }
+      }
+
+      //! out = ((in[0] op in[1]) op in[2]) op ..., for ops that do not associate
+      template <typename Op>
+      void chain(T *out, const T *const *in, const size_t ninputs, const size_t n)
+      {
+        for(size_t off = 0; off < n; off += TILE_ITEMS) {
+          const size_t len = std::min<size_t>(TILE_ITEMS, n - off);
+          T *dst = out + off;
+          if(ninputs == 1) copy(dst, in[0] + off, len);
+          else Op::block(dst, in[0] + off, in[1] + off, len);
+          for(size_t j = 2; j < ninputs; j++)
+            Op::block(dst, dst, in[j] + off, len);
+        }
+      }
+
+    private:
+      std::vector<T> d_scratch;
+
+      void scratch_for(const size_t ninputs)
+      {
+        //one tile per tree level, plus one for head_tree
+        size_t levels = 2;
+        while((size_t(1) << levels) < ninputs) levels++;
+        if(d_scratch.size() < levels*TILE_ITEMS)
+          d_scratch.resize(levels*TILE_ITEMS);
+      }
+
+      static void copy(T *dst, const T *src, const size_t len)
+      {
+        if(dst != src) memcpy(dst, src, len*sizeof(T));
+      }
+
+      //! reduce inputs [lo, hi) over one tile into dst, scratch holds the deeper levels
+      template <typename Op>
+      static void reduce(T *dst, const T *const *in, const size_t lo, const size_t hi,
+                         const size_t off, const size_t len, T *scratch)
+      {
+        const size_t count = hi - lo;
+        if(count == 1) return copy(dst, in[lo] + off, len);
+        if(count == 2) return Op::block(dst, in[lo] + off, in[lo+1] + off, len);
+        const size_t mid = lo + count/2;
+        reduce<Op>(dst, in, lo, mid, off, len, scratch);
+        reduce<Op>(scratch, in, mid, hi, off, len, scratch + TILE_ITEMS);
+        Op::block(dst, dst, scratch, len);
+      }
+    };
+
+    //! SIMD part of arith_saturate, returns the number of items done
+    template <typename T> inline size_t
+    arith_saturate_simd(T *, const T *const *, size_t, size_t, int)
+    {
+      return 0;
+    }
+
+#ifdef __SSE2__
+    //! 16 bit lanes are widened to 32 bits and packed back with saturation
+    inline size_t
+    arith_saturate_simd(short *out, const short *const *in,
+                        const size_t ninputs, const size_t n, const int sign)
+    {
+      size_t i = 0;
+      for(; i + 8 <= n; i += 8) {
+        __m128i rest_lo = _mm_setzero_si128();
+        __m128i rest_hi = _mm_setzero_si128();
+        for(size_t j = 1; j < ninputs; j++) {
+          const __m128i x = arith_load(in[j] + i);
+          rest_lo = _mm_add_epi32(rest_lo, _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+          rest_hi = _mm_add_epi32(rest_hi, _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+        }
+        const __m128i x = arith_load(in[0] + i);
+        __m128i acc_lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        __m128i acc_hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        if(sign < 0) {
+          acc_lo = _mm_sub_epi32(acc_lo, rest_lo);
+          acc_hi = _mm_sub_epi32(acc_hi, rest_hi);
+        }
+        else {
+          acc_lo = _mm_add_epi32(acc_lo, rest_lo);
+          acc_hi = _mm_add_epi32(acc_hi, rest_hi);
+        }
+        arith_store(out + i, _mm_packs_epi32(acc_lo, acc_hi));
+      }
+      return i;
+    }
+#endif /* __SSE2__ */
+
+    /*!
+     * Saturating add/subtract for integer types:
+     * out = clamp(in[0] + sign*(in[1] + in[2] + ...)),
+     * computed exactly in a wider type and clamped once at the end.
+     * run() returns false for float and complex types, which do not
+     * saturate, so the caller falls back to the plain kernel.
+     */
+    template <typename T, bool is_integer = std::numeric_limits<T>::is_integer>
+    struct arith_saturate
+    {
+      static bool run(T *, const T *const *, size_t, size_t, int) { return false; }
+    };
+
+    template <typename T>
+    struct arith_saturate<T, true>
+    {
+      static bool run(T *out, const T *const *in, const size_t ninputs,
+                      const size_t n, const int sign)
+      {
+        typedef typename arith_wide<T>::type W;
+        const W lo = W(std::numeric_limits<T>::min());
+        const W hi = W(std::numeric_limits<T>::max());
+        for(size_t i = arith_saturate_simd(out, in, ninputs, n, sign); i < n; i++) {
+          W rest = 0;
+          for(size_t j = 1; j < ninputs; j++)
+            rest += W(in[j][i]);
+          const W acc = W(in[0][i]) + (sign < 0 ? -rest : rest);
+          out[i] = T(acc < lo ? lo : (acc > hi ? hi : acc));
+        }
+        return true;
+      }
+    };
+
+  } /* namespace blocks */
+} /* namespace gr */
+
+#endif /* INCLUDED_BLOCKS_ARITH_KERNELS_H */
@@ -26,6 +26,7 @@
 
 #include "deinterleave_impl.h"
 #include <gr_io_signature.h>
+#include <transpose_kernels.h>
 
 namespace gr {
   namespace blocks {
@@ -57,18 +58,11 @@ namespace gr {
 			    gr_vector_void_star &output_items)
     {
       size_t nchan = output_items.size();
-      size_t itemsize = d_itemsize;
       const char *in = (const char *)input_items[0];
       char **out = (char **)&output_items[0];
-      
-      for (int i = 0; i < noutput_items; i++){
-	for (unsigned int n = 0; n < nchan; n++){
-	  memcpy(out[n], in, itemsize);
-	  out[n] += itemsize;
-	  in += itemsize;
-	}
-      }
-      
+
+      deinterleave_items(out, in, d_itemsize, nchan, noutput_items);
+
       return noutput_items;
     }
 
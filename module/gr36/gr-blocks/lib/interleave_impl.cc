@@ -26,6 +26,7 @@
 
 #include "interleave_impl.h"
 #include <gr_io_signature.h>
+#include <transpose_kernels.h>
 
 namespace gr {
   namespace blocks {
@@ -57,17 +58,10 @@ namespace gr {
 			  gr_vector_void_star &output_items)
     {
       size_t nchan = input_items.size();
-      size_t itemsize = d_itemsize;
       const char **in = (const char **)&input_items[0];
       char *out = (char *)output_items[0];
-      
-      for (int i = 0; i < noutput_items; i += nchan) {
-	for (unsigned int n = 0; n < nchan; n++) {
-	  memcpy (out, in[n], itemsize);
-	  out += itemsize;
-	  in[n] += itemsize;
-	}
-      }
+
+      interleave_items(out, in, d_itemsize, nchan, noutput_items / nchan);
 
       return noutput_items;
     }
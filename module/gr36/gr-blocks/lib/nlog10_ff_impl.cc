@@ -26,6 +26,8 @@
 
 #include "nlog10_ff_impl.h"
 #include <gr_io_signature.h>
+#include <volk/volk.h>
+#include <algorithm>
 
 namespace gr {
   namespace blocks {
@@ -41,6 +43,9 @@ namespace gr {
 		      gr_make_io_signature (1, 1, sizeof(float)*vlen)),
 	d_n(n), d_vlen(vlen), d_k(k)
     {
+      const int alignment_multiple =
+	volk_get_alignment() / sizeof(float);
+      set_alignment(std::max(1,alignment_multiple));
     }
 
     int
@@ -54,8 +59,19 @@ namespace gr {
       float n = d_n;
       float k = d_k;
 
+      // Clamp first so the log kernel never sees zero or negatives
       for (int i = 0; i < noi; i++)
-	out[i] = n * log10(std::max(in[i], (float) 1e-18)) + k;
+	out[i] = std::max(in[i], (float) 1e-18);
+
+      if(is_unaligned()) {
+	volk_32f_log10_32f_u(out, out, noi);
+      }
+      else {
+	volk_32f_log10_32f_a(out, out, noi);
+      }
+
+      for (int i = 0; i < noi; i++)
+	out[i] = n * out[i] + k;
 
       return noutput_items;
     }
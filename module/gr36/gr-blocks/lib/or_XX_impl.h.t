@@ -26,6 +26,7 @@
 #define @GUARD_NAME_IMPL@
 
 #include <blocks/@NAME@.h>
+#include <arith_kernels.h>
 
 namespace gr {
   namespace blocks {
@@ -33,6 +34,7 @@ namespace gr {
     class BLOCKS_API @NAME_IMPL@ : public @NAME@
     {
       size_t d_vlen;
+      arith_combiner<@I_TYPE@> d_combiner;
 
     public:
       @NAME_IMPL@(size_t vlen);
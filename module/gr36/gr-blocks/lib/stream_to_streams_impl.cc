@@ -26,6 +26,7 @@
 
 #include "stream_to_streams_impl.h"
 #include <gr_io_signature.h>
+#include <transpose_kernels.h>
 #include <string.h>
 
 namespace gr {
@@ -54,15 +55,9 @@ namespace gr {
       const char *in = (const char *)input_items[0];
       char **outv = (char **)&output_items[0];
       int nstreams = output_items.size();
-      
-      for (int i = 0; i < noutput_items; i++) {
-	for (int j = 0; j < nstreams; j++) {
-	  memcpy(outv[j], in, item_size);
-	  outv[j] += item_size;
-	  in += item_size;
-	}
-      }
-      
+
+      deinterleave_items(outv, in, item_size, nstreams, noutput_items);
+
       return noutput_items;
     }
 
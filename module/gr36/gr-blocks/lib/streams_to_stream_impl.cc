@@ -26,6 +26,7 @@
 
 #include "streams_to_stream_impl.h"
 #include <gr_io_signature.h>
+#include <transpose_kernels.h>
 
 namespace gr {
   namespace blocks {
@@ -56,15 +57,9 @@ namespace gr {
       
       assert (noutput_items % nstreams == 0);
       int ni = noutput_items / nstreams;
-      
-      for (int i = 0; i < ni; i++){
-	for (int j = 0; j < nstreams; j++){
-	  memcpy(out, inv[j], itemsize);
-	  out += itemsize;
-	  inv[j] += itemsize;
-	}
-      }
-      
+
+      interleave_items(out, inv, itemsize, nstreams, ni);
+
       return noutput_items;
     }
 
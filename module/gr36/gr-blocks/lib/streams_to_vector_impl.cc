@@ -26,6 +26,7 @@
 
 #include "streams_to_vector_impl.h"
 #include <gr_io_signature.h>
+#include <transpose_kernels.h>
 
 namespace gr {
   namespace blocks {
@@ -53,13 +54,7 @@ namespace gr {
       const char **inv = (const char **) &input_items[0];
       char *out = (char *) output_items[0];
       
-      for (int i = 0; i < noutput_items; i++){
-	for (int j = 0; j < nstreams; j++){
-	  memcpy(out, inv[j], itemsize);
-	  inv[j] += itemsize;
-	  out += itemsize;
-	}
-      }
+      interleave_items(out, inv, itemsize, nstreams, noutput_items);
 
       return noutput_items;
     }
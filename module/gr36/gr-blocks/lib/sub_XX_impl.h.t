@@ -26,6 +26,7 @@
 #define @GUARD_NAME_IMPL@
 
 #include <blocks/@NAME@.h>
+#include <arith_kernels.h>
 
 namespace gr {
   namespace blocks {
@@ -33,10 +34,15 @@ namespace gr {
     class BLOCKS_API @NAME_IMPL@ : public @NAME@
     {
       size_t d_vlen;
+      bool d_saturate;
+      arith_combiner<@I_TYPE@> d_combiner;
 
     public:
       @NAME_IMPL@(size_t vlen);
 
+      bool saturate() const { return d_saturate; }
+      void set_saturate(bool saturate) { d_saturate = saturate; }
+
       int work(int noutput_items,
 	       gr_vector_const_void_star &input_items,
 	       gr_vector_void_star &output_items);
@@ -27,7 +27,6 @@
 #include "throttle_impl.h"
 #include <gr_io_signature.h>
 #include <cstring>
-#include <boost/thread/thread.hpp>
 
 namespace gr {
   namespace blocks {
@@ -56,17 +55,16 @@ namespace gr {
     void
     throttle_impl::set_sample_rate(double rate)
     {
-      //changing the sample rate performs a reset of state params
-      d_start = boost::get_system_time();
-      d_total_samples = 0;
-      d_samps_per_tick = rate/boost::posix_time::time_duration::ticks_per_second();
-      d_samps_per_us = rate/1e6;
+      //the scheduler holds off work and re-kicks the block on a timer,
+      //so no scheduler thread sleeps; a new rate restarts the schedule
+      this->global_config().maximum_items_per_sec = rate;
+      this->commit_config();
     }
 
     double
     throttle_impl::sample_rate() const
     {
-      return d_samps_per_us * 1e6;
+      return this->global_config().maximum_items_per_sec;
     }
 
     int
@@ -74,22 +72,10 @@ namespace gr {
                         gr_vector_const_void_star &input_items,
                         gr_vector_void_star &output_items)
     {
-      //calculate the expected number of samples to have passed through
-      boost::system_time now = boost::get_system_time();
-      boost::int64_t ticks = (now - d_start).ticks();
-      uint64_t expected_samps = uint64_t(d_samps_per_tick*ticks);
-
-      //if the expected samples was less, we need to throttle back
-      if(d_total_samples > expected_samps) {
-        boost::this_thread::sleep(boost::posix_time::microseconds
-                                  (long((d_total_samples - expected_samps)/d_samps_per_us)));
-      }
-
       //copy all samples output[i] <= input[i]
       const char *in = (const char *)input_items[0];
       char *out = (char *)output_items[0];
       std::memcpy(out, in, noutput_items * d_itemsize);
-      d_total_samples += noutput_items;
       return noutput_items;
     }
 
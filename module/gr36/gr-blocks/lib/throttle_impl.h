@@ -24,7 +24,6 @@
 #define INCLUDED_GR_THROTTLE_IMPL_H
 
 #include <blocks/throttle.h>
-#include <boost/thread/thread.hpp> //d_start
 
 namespace gr {
   namespace blocks {
@@ -32,10 +31,7 @@ namespace gr {
     class throttle_impl : public throttle
     {
     private:
-      boost::system_time d_start;
       size_t d_itemsize;
-      uint64_t d_total_samples;
-      double d_samps_per_tick, d_samps_per_us;
 
     public:
       throttle_impl(size_t itemsize, double samples_per_sec);
@@ -22,10 +22,12 @@
 
 #include "transcendental_impl.h"
 #include <gr_io_signature.h>
+#include <volk/volk.h>
 #include <stdexcept>
 #include <complex> //complex math
 #include <cmath> //real math
 #include <map>
+#include <algorithm>
 
 namespace gr {
   namespace blocks {
@@ -78,6 +80,21 @@ namespace gr {
     }                                                                   \
     transcendental_registrant __key__ ## _registrant(#__key__, &__key__ ## _work, sizeof(__type__));
 
+    //macro to create a work function that hands the whole buffer to a
+    //volk kernel and register it, the dispatcher checks alignment per call
+#define REGISTER_VOLK_FUNCTION(__kernel__, __type__, __key__)           \
+    static int __key__ ## _work(                                        \
+        int noutput_items,                                              \
+        gr_vector_const_void_star &input_items,                         \
+        gr_vector_void_star &output_items)                              \
+    {                                                                   \
+      const __type__ *in = (const __type__ *) input_items[0];           \
+      __type__ *out = (__type__ *) output_items[0];                     \
+      __kernel__(out, in, noutput_items);                               \
+      return noutput_items;                                             \
+    }                                                                   \
+    transcendental_registrant __key__ ## _registrant(#__key__, &__key__ ## _work, sizeof(__type__));
+
     //register work functions for real types
 #define REGISTER_REAL_FUNCTIONS(__fcn__)                        \
     REGISTER_FUNCTION(__fcn__, float, __fcn__ ## _float)        \
@@ -93,19 +110,51 @@ namespace gr {
     REGISTER_REAL_FUNCTIONS(__fcn__)            \
     REGISTER_COMPLEX_FUNCTIONS(__fcn__)
 
-    //create and register transcendental work functions
-    REGISTER_FUNCTIONS(cos)
-    REGISTER_FUNCTIONS(sin)
+    //register real types with the float work done by volk
+#define REGISTER_VOLK_REAL_FUNCTIONS(__fcn__)                           \
+    REGISTER_VOLK_FUNCTION(volk_32f_ ## __fcn__ ## _32f, float, __fcn__ ## _float) \
+    REGISTER_FUNCTION(__fcn__, double, __fcn__ ## _double)
+
+    //register complex types with the complex float work done by volk
+#define REGISTER_VOLK_COMPLEX_FUNCTIONS(__fcn__)                        \
+    REGISTER_VOLK_FUNCTION(volk_32fc_ ## __fcn__ ## _32fc, std::complex<float>, __fcn__ ## _complex_float) \
+    REGISTER_FUNCTION(__fcn__, std::complex<double>, __fcn__ ## _complex_double)
+
+    //complex log10 is the volk complex log scaled by log10(e)
+    static int log10_complex_float_work(
+        int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+    {
+      const std::complex<float> *in = (const std::complex<float> *) input_items[0];
+      std::complex<float> *out = (std::complex<float> *) output_items[0];
+      volk_32fc_log_32fc(out, in, noutput_items);
+      volk_32f_s32f_multiply_32f((float *) out, (const float *) out,
+                                 0.434294481903251828f, 2*noutput_items);
+      return noutput_items;
+    }
+    transcendental_registrant log10_complex_float_registrant
+      ("log10_complex_float", &log10_complex_float_work, sizeof(std::complex<float>));
+
+    //create and register transcendental work functions,
+    //the functions with polynomial volk kernels use them for float
+    REGISTER_VOLK_REAL_FUNCTIONS(cos)
+    REGISTER_COMPLEX_FUNCTIONS(cos)
+    REGISTER_VOLK_REAL_FUNCTIONS(sin)
+    REGISTER_COMPLEX_FUNCTIONS(sin)
     REGISTER_FUNCTIONS(tan)
     REGISTER_REAL_FUNCTIONS(acos)
     REGISTER_REAL_FUNCTIONS(asin)
-    REGISTER_REAL_FUNCTIONS(atan)
+    REGISTER_VOLK_REAL_FUNCTIONS(atan)
     REGISTER_FUNCTIONS(cosh)
     REGISTER_FUNCTIONS(sinh)
     REGISTER_FUNCTIONS(tanh)
-    REGISTER_FUNCTIONS(exp)
-    REGISTER_FUNCTIONS(log)
-    REGISTER_FUNCTIONS(log10)
+    REGISTER_VOLK_REAL_FUNCTIONS(exp)
+    REGISTER_VOLK_COMPLEX_FUNCTIONS(exp)
+    REGISTER_VOLK_REAL_FUNCTIONS(log)
+    REGISTER_VOLK_COMPLEX_FUNCTIONS(log)
+    REGISTER_VOLK_REAL_FUNCTIONS(log10)
+    REGISTER_FUNCTION(log10, std::complex<double>, log10_complex_double)
     REGISTER_FUNCTIONS(sqrt)
 
 
@@ -131,7 +180,9 @@ namespace gr {
                       gr_make_io_signature(1, 1, io_size)),
         _work_fcn(work_fcn)
     {
-      // NOP
+      const int alignment_multiple =
+        volk_get_alignment() / io_size;
+      set_alignment(std::max(1, alignment_multiple));
     }
 
     transcendental_impl::~transcendental_impl()
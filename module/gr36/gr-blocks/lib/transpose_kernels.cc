@@ -0,0 +1,325 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <transpose_kernels.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace gr {
+  namespace blocks {
+
+    struct item16_t { uint64_t w[2]; };
+
+    /***********************************************************************
+     * Generic kernels: typed item copies, channel count fixed when N != 0
+     **********************************************************************/
+    template <typename T, size_t N>
+    static void
+    deinterleave_generic(char *const *out, const char *in,
+                         size_t nchan, size_t first, size_t nitems)
+    {
+      const size_t nc = N? N : nchan;
+      const T *ip = (const T *)in + first*nc;
+      for(size_t i = first; i < nitems; i++) {
+        for(size_t n = 0; n < nc; n++)
+          ((T *)out[n])[i] = ip[n];
+        ip += nc;
+      }
+    }
+
+    template <typename T, size_t N>
+    static void
+    interleave_generic(char *out, const char *const *in,
+                       size_t nchan, size_t first, size_t nitems)
+    {
+      const size_t nc = N? N : nchan;
+      T *op = (T *)out + first*nc;
+      for(size_t i = first; i < nitems; i++) {
+        for(size_t n = 0; n < nc; n++)
+          op[n] = ((const T *)in[n])[i];
+        op += nc;
+      }
+    }
+
+#define TRANSPOSE_NCHAN_CASES(fcn, T, args) \
+    switch(nchan) { \
+    case 1: fcn<T, 1> args; return; \
+    case 2: fcn<T, 2> args; return; \
+    case 3: fcn<T, 3> args; return; \
+    case 4: fcn<T, 4> args; return; \
+    case 5: fcn<T, 5> args; return; \
+    case 6: fcn<T, 6> args; return; \
+    case 7: fcn<T, 7> args; return; \
+    case 8: fcn<T, 8> args; return; \
+    case 9: fcn<T, 9> args; return; \
+    case 10: fcn<T, 10> args; return; \
+    case 11: fcn<T, 11> args; return; \
+    case 12: fcn<T, 12> args; return; \
+    case 13: fcn<T, 13> args; return; \
+    case 14: fcn<T, 14> args; return; \
+    case 15: fcn<T, 15> args; return; \
+    case 16: fcn<T, 16> args; return; \
+    default: fcn<T, 0> args; return; \
+    }
+
+    template <typename T>
+    static void
+    deinterleave_typed(char *const *out, const char *in,
+                       size_t nchan, size_t first, size_t nitems)
+    {
+      TRANSPOSE_NCHAN_CASES(deinterleave_generic, T, (out, in, nchan, first, nitems))
+    }
+
+    template <typename T>
+    static void
+    interleave_typed(char *out, const char *const *in,
+                     size_t nchan, size_t first, size_t nitems)
+    {
+      TRANSPOSE_NCHAN_CASES(interleave_generic, T, (out, in, nchan, first, nitems))
+    }
+
+    static void
+    deinterleave_memcpy(char *const *out, const char *in,
+                        size_t itemsize, size_t nchan, size_t nitems)
+    {
+      for(size_t i = 0; i < nitems; i++) {
+        const size_t offset = i*itemsize;
+        for(size_t n = 0; n < nchan; n++) {
+          memcpy(out[n] + offset, in, itemsize);
+          in += itemsize;
+        }
+      }
+    }
+
+    static void
+    interleave_memcpy(char *out, const char *const *in,
+                      size_t itemsize, size_t nchan, size_t nitems)
+    {
+      for(size_t i = 0; i < nitems; i++) {
+        const size_t offset = i*itemsize;
+        for(size_t n = 0; n < nchan; n++) {
+          memcpy(out, in[n] + offset, itemsize);
+          out += itemsize;
+        }
+      }
+    }
+
+#ifdef __SSE2__
+    /***********************************************************************
+     * SSE2 kernels: 4x4 transposes of 32 bit items and 2x2 transposes of
+     * 64 bit items, the remainder of the items goes to the generic kernel
+     **********************************************************************/
+    static inline void
+    transpose_4x4_32(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3)
+    {
+      const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+      const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+      const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+      const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+      r0 = _mm_unpacklo_epi64(t0, t1);
+      r1 = _mm_unpackhi_epi64(t0, t1);
+      r2 = _mm_unpacklo_epi64(t2, t3);
+      r3 = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    static void
+    deinterleave_32_x2_sse2(char *const *out, const char *in, size_t nitems)
+    {
+      const size_t nblocks = nitems/4;
+      const __m128 *ip = (const __m128 *)in;
+      float *o0 = (float *)out[0];
+      float *o1 = (float *)out[1];
+      for(size_t b = 0; b < nblocks; b++) {
+        const __m128 x = _mm_loadu_ps((const float *)(ip++));
+        const __m128 y = _mm_loadu_ps((const float *)(ip++));
+        _mm_storeu_ps(o0 + 4*b, _mm_shuffle_ps(x, y, _MM_SHUFFLE(2,0,2,0)));
+        _mm_storeu_ps(o1 + 4*b, _mm_shuffle_ps(x, y, _MM_SHUFFLE(3,1,3,1)));
+      }
+      deinterleave_generic<uint32_t, 2>(out, in, 2, 4*nblocks, nitems);
+    }
+
+    static void
+    interleave_32_x2_sse2(char *out, const char *const *in, size_t nitems)
+    {
+      const size_t nblocks = nitems/4;
+      const float *i0 = (const float *)in[0];
+      const float *i1 = (const float *)in[1];
+      float *op = (float *)out;
+      for(size_t b = 0; b < nblocks; b++) {
+        const __m128 x = _mm_loadu_ps(i0 + 4*b);
+        const __m128 y = _mm_loadu_ps(i1 + 4*b);
+        _mm_storeu_ps(op + 8*b + 0, _mm_unpacklo_ps(x, y));
+        _mm_storeu_ps(op + 8*b + 4, _mm_unpackhi_ps(x, y));
+      }
+      interleave_generic<uint32_t, 2>(out, in, 2, 4*nblocks, nitems);
+    }
+
+    //! nchan is a multiple of 4
+    static void
+    deinterleave_32_x4n_sse2(char *const *out, const char *in,
+                             size_t nchan, size_t nitems)
+    {
+      const size_t nblocks = nitems/4;
+      const uint32_t *ip = (const uint32_t *)in;
+      for(size_t b = 0; b < nblocks; b++) {
+        for(size_t c = 0; c < nchan; c += 4) {
+          __m128i r0 = _mm_loadu_si128((const __m128i *)(ip + 0*nchan + c));
+          __m128i r1 = _mm_loadu_si128((const __m128i *)(ip + 1*nchan + c));
+          __m128i r2 = _mm_loadu_si128((const __m128i *)(ip + 2*nchan + c));
+          __m128i r3 = _mm_loadu_si128((const __m128i *)(ip + 3*nchan + c));
+          transpose_4x4_32(r0, r1, r2, r3);
+          _mm_storeu_si128((__m128i *)((uint32_t *)out[c+0] + 4*b), r0);
+          _mm_storeu_si128((__m128i *)((uint32_t *)out[c+1] + 4*b), r1);
+          _mm_storeu_si128((__m128i *)((uint32_t *)out[c+2] + 4*b), r2);
+          _mm_storeu_si128((__m128i *)((uint32_t *)out[c+3] + 4*b), r3);
+        }
+        ip += 4*nchan;
+      }
+      deinterleave_typed<uint32_t>(out, in, nchan, 4*nblocks, nitems);
+    }
+
+    //! nchan is a multiple of 4
+    static void
+    interleave_32_x4n_sse2(char *out, const char *const *in,
+                           size_t nchan, size_t nitems)
+    {
+      const size_t nblocks = nitems/4;
+      uint32_t *op = (uint32_t *)out;
+      for(size_t b = 0; b < nblocks; b++) {
+        for(size_t c = 0; c < nchan; c += 4) {
+          __m128i r0 = _mm_loadu_si128((const __m128i *)((const uint32_t *)in[c+0] + 4*b));
+          __m128i r1 = _mm_loadu_si128((const __m128i *)((const uint32_t *)in[c+1] + 4*b));
+          __m128i r2 = _mm_loadu_si128((const __m128i *)((const uint32_t *)in[c+2] + 4*b));
+          __m128i r3 = _mm_loadu_si128((const __m128i *)((const uint32_t *)in[c+3] + 4*b));
+          transpose_4x4_32(r0, r1, r2, r3);
+          _mm_storeu_si128((__m128i *)(op + 0*nchan + c), r0);
+          _mm_storeu_si128((__m128i *)(op + 1*nchan + c), r1);
+          _mm_storeu_si128((__m128i *)(op + 2*nchan + c), r2);
+          _mm_storeu_si128((__m128i *)(op + 3*nchan + c), r3);
+        }
+        op += 4*nchan;
+      }
+      interleave_typed<uint32_t>(out, in, nchan, 4*nblocks, nitems);
+    }
+
+    //! nchan is a multiple of 2
+    static void
+    deinterleave_64_x2n_sse2(char *const *out, const char *in,
+                             size_t nchan, size_t nitems)
+    {
+      const size_t nblocks = nitems/2;
+      const uint64_t *ip = (const uint64_t *)in;
+      for(size_t b = 0; b < nblocks; b++) {
+        for(size_t c = 0; c < nchan; c += 2) {
+          const __m128i r0 = _mm_loadu_si128((const __m128i *)(ip + 0*nchan + c));
+          const __m128i r1 = _mm_loadu_si128((const __m128i *)(ip + 1*nchan + c));
+          _mm_storeu_si128((__m128i *)((uint64_t *)out[c+0] + 2*b), _mm_unpacklo_epi64(r0, r1));
+          _mm_storeu_si128((__m128i *)((uint64_t *)out[c+1] + 2*b), _mm_unpackhi_epi64(r0, r1));
+        }
+        ip += 2*nchan;
+      }
+      deinterleave_typed<uint64_t>(out, in, nchan, 2*nblocks, nitems);
+    }
+
+    //! nchan is a multiple of 2
+    static void
+    interleave_64_x2n_sse2(char *out, const char *const *in,
+                           size_t nchan, size_t nitems)
+    {
+      const size_t nblocks = nitems/2;
+      uint64_t *op = (uint64_t *)out;
+      for(size_t b = 0; b < nblocks; b++) {
+        for(size_t c = 0; c < nchan; c += 2) {
+          const __m128i r0 = _mm_loadu_si128((const __m128i *)((const uint64_t *)in[c+0] + 2*b));
+          const __m128i r1 = _mm_loadu_si128((const __m128i *)((const uint64_t *)in[c+1] + 2*b));
+          _mm_storeu_si128((__m128i *)(op + 0*nchan + c), _mm_unpacklo_epi64(r0, r1));
+          _mm_storeu_si128((__m128i *)(op + 1*nchan + c), _mm_unpackhi_epi64(r0, r1));
+        }
+        op += 2*nchan;
+      }
+      interleave_typed<uint64_t>(out, in, nchan, 2*nblocks, nitems);
+    }
+#endif /* __SSE2__ */
+
+    /***********************************************************************
+     * Dispatch on item size and channel count
+     **********************************************************************/
+    void
+    deinterleave_items(char *const *out, const char *in,
+                       size_t itemsize, size_t nchan, size_t nitems)
+    {
+      switch(itemsize) {
+      case 1: deinterleave_typed<uint8_t>(out, in, nchan, 0, nitems); return;
+      case 2: deinterleave_typed<uint16_t>(out, in, nchan, 0, nitems); return;
+      case 4:
+#ifdef __SSE2__
+        if(nchan == 2) return deinterleave_32_x2_sse2(out, in, nitems);
+        if(nchan % 4 == 0) return deinterleave_32_x4n_sse2(out, in, nchan, nitems);
+#endif
+        deinterleave_typed<uint32_t>(out, in, nchan, 0, nitems);
+        return;
+      case 8:
+#ifdef __SSE2__
+        if(nchan % 2 == 0) return deinterleave_64_x2n_sse2(out, in, nchan, nitems);
+#endif
+        deinterleave_typed<uint64_t>(out, in, nchan, 0, nitems);
+        return;
+      case 16: deinterleave_typed<item16_t>(out, in, nchan, 0, nitems); return;
+      default: deinterleave_memcpy(out, in, itemsize, nchan, nitems); return;
+      }
+    }
+
+    void
+    interleave_items(char *out, const char *const *in,
+                     size_t itemsize, size_t nchan, size_t nitems)
+    {
+      switch(itemsize) {
+      case 1: interleave_typed<uint8_t>(out, in, nchan, 0, nitems); return;
+      case 2: interleave_typed<uint16_t>(out, in, nchan, 0, nitems); return;
+      case 4:
+#ifdef __SSE2__
+        if(nchan == 2) return interleave_32_x2_sse2(out, in, nitems);
+        if(nchan % 4 == 0) return interleave_32_x4n_sse2(out, in, nchan, nitems);
+#endif
+        interleave_typed<uint32_t>(out, in, nchan, 0, nitems);
+        return;
+      case 8:
+#ifdef __SSE2__
+        if(nchan % 2 == 0) return interleave_64_x2n_sse2(out, in, nchan, nitems);
+#endif
+        interleave_typed<uint64_t>(out, in, nchan, 0, nitems);
+        return;
+      case 16: interleave_typed<item16_t>(out, in, nchan, 0, nitems); return;
+      default: interleave_memcpy(out, in, itemsize, nchan, nitems); return;
+      }
+    }
+
+  } /* namespace blocks */
+} /* namespace gr */
@@ -0,0 +1,56 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_BLOCKS_TRANSPOSE_KERNELS_H
+#define INCLUDED_BLOCKS_TRANSPOSE_KERNELS_H
+
+#include <blocks/api.h>
+#include <cstddef>
+
+namespace gr {
+  namespace blocks {
+
+    /*!
+     * Split an interleaved stream into nchan streams:
+     * out[n][i] = in[i*nchan + n] for i in [0, nitems).
+     *
+     * Items of 1, 2, 4, 8 and 16 bytes are moved as typed words with
+     * the channel count fixed at compile time for up to 16 channels;
+     * 4 and 8 byte items use SSE2 register transposes where possible.
+     * Other item sizes fall back to one memcpy per item.
+     */
+    BLOCKS_API void deinterleave_items(char *const *out, const char *in,
+                                       size_t itemsize, size_t nchan,
+                                       size_t nitems);
+
+    /*!
+     * Merge nchan streams into an interleaved stream:
+     * out[i*nchan + n] = in[n][i] for i in [0, nitems).
+     */
+    BLOCKS_API void interleave_items(char *out, const char *const *in,
+                                     size_t itemsize, size_t nchan,
+                                     size_t nitems);
+
+  } /* namespace blocks */
+} /* namespace gr */
+
+#endif /* INCLUDED_BLOCKS_TRANSPOSE_KERNELS_H */
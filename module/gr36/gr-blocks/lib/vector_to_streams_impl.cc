@@ -26,6 +26,7 @@
 
 #include "vector_to_streams_impl.h"
 #include <gr_io_signature.h>
+#include <transpose_kernels.h>
 
 namespace gr {
   namespace blocks {
@@ -54,13 +55,7 @@ namespace gr {
       const char *in = (const char *) input_items[0];
       char **outv = (char **) &output_items[0];
       
-      for (int i = 0; i < noutput_items; i++){
-	for (int j = 0; j < nstreams; j++){
-	  memcpy(outv[j], in, itemsize);
-	  outv[j] += itemsize;
-	  in += itemsize;
-	}
-      }
+      deinterleave_items(outv, in, itemsize, nstreams, noutput_items);
 
       return noutput_items;
     }
@@ -103,6 +103,43 @@ class test_add_mult_div_sub(gr_unittest.TestCase):
 
     # add_const_XX
 
+    def test_add_ss_many(self):
+        # more inputs than one level of the pairwise tree
+        src_data = [tuple(range(j, j+100)) for j in range(7)]
+        expected_result = tuple([sum(x) for x in zip(*src_data)])
+        op = blocks_swig.add_ss()
+        self.help_ss(src_data, expected_result, op)
+
+    def test_add_cc_many(self):
+        src_data = [tuple([complex(i, -j) for i in range(50)]) for j in range(5)]
+        expected_result = tuple([sum(x) for x in zip(*src_data)])
+        op = blocks_swig.add_cc()
+        self.help_cc(src_data, expected_result, op)
+
+    def test_add_ss_saturate(self):
+        src1_data = (32000,  32000, -32000, 1, 30000)
+        src2_data = (  767,    768,   -769, 2, 30000)
+        src3_data = (    0,      0,      0, 3, -30000)
+        expected_result = (32767, 32767, -32768, 6, 30000)
+        op = blocks_swig.add_ss()
+        op.set_saturate(True)
+        self.assertTrue(op.saturate())
+        self.help_ss((src1_data, src2_data, src3_data), expected_result, op)
+
+    def test_add_ss_saturate_long(self):
+        # several vector blocks plus an unaligned tail, clipping both ways
+        n = 37
+        src1_data = tuple([(32000, -32000, 20000, -5)[i % 4] for i in range(n)])
+        src2_data = tuple([(i*997) % 4000 - 2000 for i in range(n)])
+        src3_data = tuple([(30000, -30000, -20000, 7)[i % 3] for i in range(n)])
+        expected_result = tuple([max(-32768, min(32767, sum(x)))
+                                 for x in zip(src1_data, src2_data, src3_data)])
+        self.assertTrue(32767 in expected_result)
+        self.assertTrue(-32768 in expected_result)
+        op = blocks_swig.add_ss()
+        op.set_saturate(True)
+        self.help_ss((src1_data, src2_data, src3_data), expected_result, op)
+
     def test_add_const_ss(self):
         src_data = (1, 2, 3, 4, 5)
         expected_result = (6, 7, 8, 9, 10)
@@ -201,6 +238,41 @@ class test_add_mult_div_sub(gr_unittest.TestCase):
         self.help_ii((src1_data, src2_data),
                       expected_result, op)
 
+    def test_sub_ii_many(self):
+        src_data = [tuple(range(j, j+100)) for j in range(6)]
+        expected_result = tuple([x[0] - sum(x[1:]) for x in zip(*src_data)])
+        op = blocks_swig.sub_ii()
+        self.help_ii(src_data, expected_result, op)
+
+    def test_sub_ss_saturate(self):
+        src1_data = (-32000, 32000, 5)
+        src2_data = (  1000, -1000, 7)
+        expected_result = (-32768, 32767, -2)
+        op = blocks_swig.sub_ss()
+        op.set_saturate(True)
+        self.help_ss((src1_data, src2_data), expected_result, op)
+
+    def test_sub_ss_saturate_long(self):
+        n = 21
+        src1_data = tuple([(-32000, 32000, 100)[i % 3] for i in range(n)])
+        src2_data = tuple([(i*611) % 3000 - 1500 for i in range(n)])
+        src3_data = tuple([(1000, -1000)[i % 2] for i in range(n)])
+        expected_result = tuple([max(-32768, min(32767, x[0] - x[1] - x[2]))
+                                 for x in zip(src1_data, src2_data, src3_data)])
+        self.assertTrue(32767 in expected_result)
+        self.assertTrue(-32768 in expected_result)
+        op = blocks_swig.sub_ss()
+        op.set_saturate(True)
+        self.help_ss((src1_data, src2_data, src3_data), expected_result, op)
+
+    def test_div_ii_many(self):
+        src1_data       = (1000, -1000, 7)
+        src2_data       = (   5,     3, 2)
+        src3_data       = (   3,     4, 1)
+        expected_result = (  66,   -83, 3)
+        op = blocks_swig.divide_ii()
+        self.help_ii((src1_data, src2_data, src3_data), expected_result, op)
+
     def test_div_ff(self):
         src1_data       = ( 5,  9, -15, 1024)
         src2_data       = (10,  3,  -5,   64)
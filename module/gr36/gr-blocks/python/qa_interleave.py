@@ -77,6 +77,56 @@ class test_interleave (gr_unittest.TestCase):
         self.assertFloatTuplesAlmostEqual (expected_result2, dst2.data ())
         self.assertFloatTuplesAlmostEqual (expected_result3, dst3.data ())
 
+    def help_deint (self, nchan, itemsize, src_data, make_src, make_dst):
+        src = make_src (src_data)
+        op = blocks_swig.deinterleave (itemsize)
+        dsts = [make_dst () for n in range (nchan)]
+        self.tb.connect (src, op)
+        for n in range (nchan):
+            self.tb.connect ((op, n), dsts[n])
+        self.tb.run ()
+        for n in range (nchan):
+            self.assertEqual (tuple (src_data[n::nchan]), dsts[n].data ())
+
+    def help_int (self, nchan, itemsize, src_data, make_src, make_dst):
+        op = blocks_swig.interleave (itemsize)
+        dst = make_dst ()
+        for n in range (nchan):
+            self.tb.connect (make_src (src_data[n::nchan]), (op, n))
+        self.tb.connect (op, dst)
+        self.tb.run ()
+        self.assertEqual (tuple (src_data), dst.data ())
+
+    def test_deint_002 (self):
+        # channel counts that take the transpose kernels and the generic ones,
+        # lengths that leave a tail after the last full transpose block
+        for nchan in (2, 3, 5, 8, 12, 16):
+            self.tb = gr.top_block ()
+            src_data = [float (x) for x in range (nchan * 37)]
+            self.help_deint (nchan, gr.sizeof_float, src_data,
+                             gr.vector_source_f, gr.vector_sink_f)
+
+    def test_int_002 (self):
+        for nchan in (2, 3, 5, 8, 12, 16):
+            self.tb = gr.top_block ()
+            src_data = [float (x) for x in range (nchan * 37)]
+            self.help_int (nchan, gr.sizeof_float, src_data,
+                           gr.vector_source_f, gr.vector_sink_f)
+
+    def test_deint_003 (self):
+        for nchan in (2, 3, 16):
+            self.tb = gr.top_block ()
+            src_data = [complex (x, -x) for x in range (nchan * 37)]
+            self.help_deint (nchan, gr.sizeof_gr_complex, src_data,
+                             gr.vector_source_c, gr.vector_sink_c)
+
+    def test_int_003 (self):
+        for nchan in (2, 3, 16):
+            self.tb = gr.top_block ()
+            src_data = [complex (x, -x) for x in range (nchan * 37)]
+            self.help_int (nchan, gr.sizeof_gr_complex, src_data,
+                           gr.vector_source_c, gr.vector_sink_c)
+
 if __name__ == '__main__':
     gr_unittest.run(test_interleave, "test_interleave.xml")
 
@@ -23,6 +23,7 @@
 from gnuradio import gr, gr_unittest
 import blocks_swig as blocks
 import math
+import cmath
 
 class test_transcendental(gr_unittest.TestCase):
 
@@ -86,5 +87,38 @@ class test_transcendental(gr_unittest.TestCase):
 
         self.assertFloatTuplesAlmostEqual(expected_result, dst_data, 5)
 
+    def test_04(self):
+        # float functions with volk kernels, odd length for the scalar tail
+        data = [0.05*x - 3.0 for x in range(123)]
+        pos = [0.05*x + 0.01 for x in range(123)]
+        for name, fcn, src_data in (("sin", math.sin, data),
+                                    ("cos", math.cos, data),
+                                    ("atan", math.atan, data),
+                                    ("exp", math.exp, data),
+                                    ("log", math.log, pos),
+                                    ("log10", math.log10, pos)):
+            self.tb = gr.top_block()
+            src = gr.vector_source_f(src_data, False)
+            op = blocks.transcendental(name, "float")
+            dst = gr.vector_sink_f()
+            self.tb.connect(src, op, dst)
+            self.tb.run()
+            expected_result = [fcn(x) for x in src_data]
+            self.assertFloatTuplesAlmostEqual(expected_result, dst.data(), 5)
+
+    def test_05(self):
+        data = [complex(0.05*x - 3.0, 0.07*x - 4.0) for x in range(123)]
+        for name, fcn in (("exp", cmath.exp),
+                          ("log", cmath.log),
+                          ("log10", cmath.log10)):
+            self.tb = gr.top_block()
+            src = gr.vector_source_c(data, False)
+            op = blocks.transcendental(name, "complex_float")
+            dst = gr.vector_sink_c()
+            self.tb.connect(src, op, dst)
+            self.tb.run()
+            expected_result = [fcn(x) for x in data]
+            self.assertComplexTuplesAlmostEqual(expected_result, dst.data(), 4)
+
 if __name__ == '__main__':
     gr_unittest.run(test_transcendental, "test_transcendental.xml")
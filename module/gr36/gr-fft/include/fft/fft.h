@@ -67,10 +67,13 @@ namespace gr {
     class FFT_API fft_complex {
       int	      d_fft_size;
       int         d_nthreads;
+      bool        d_forward;
       gr_complex *d_inbuf;
       gr_complex *d_outbuf;
       void	     *d_plan;
 
+      void make_plan();
+
     public:
       fft_complex(int fft_size, bool forward = true, int nthreads=1);
       virtual ~fft_complex();
@@ -88,6 +91,7 @@ namespace gr {
       
       /*!
        *  Set the number of threads to use for caclulation.
+       *  The transform is planned again when the count changes.
        */
       void set_nthreads(int n);
       
@@ -114,6 +118,8 @@ namespace gr {
       gr_complex *d_outbuf;
       void	 *d_plan;
 
+      void make_plan();
+
     public:
       fft_real_fwd (int fft_size, int nthreads=1);
       virtual ~fft_real_fwd ();
@@ -131,6 +137,7 @@ namespace gr {
       
       /*!
        *  Set the number of threads to use for caclulation.
+       *  The transform is planned again when the count changes.
        */
       void set_nthreads(int n);
       
@@ -156,6 +163,8 @@ namespace gr {
       gr_complex *d_inbuf;
       float	     *d_outbuf;
       void	     *d_plan;
+
+      void make_plan();
       
     public:
       fft_real_rev(int fft_size, int nthreads=1);
@@ -174,6 +183,7 @@ namespace gr {
       
       /*!
        *  Set the number of threads to use for caclulation.
+       *  The transform is planned again when the count changes.
        */
       void set_nthreads(int n);
       
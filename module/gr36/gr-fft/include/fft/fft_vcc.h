@@ -44,8 +44,14 @@ namespace gr {
 			       const std::vector<float> &window,
 			       bool shift=false, int nthreads=1);
       
+      /*!
+       * Request \p n threads for the transforms. While the block runs
+       * they are granted from gras::ThreadBudget, as many as are free;
+       * the query stats report the grant as threads_granted.
+       */
       virtual void set_nthreads(int n) = 0;
 
+      //! the number of threads requested
       virtual int nthreads() const = 0;
 
       virtual bool set_window(const std::vector<float> &window) = 0;
@@ -43,6 +43,8 @@ static int my_fftw_read_char(void *f) { return fgetc((FILE *) f); }
 #include <cassert>
 #include <stdexcept>
 
+#include <gras/thread_budget.hpp>
+#include <boost/bind.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 namespace fs = boost::filesystem;
@@ -98,6 +100,33 @@ namespace gr {
       }
     }
 
+#ifdef HAVE_FFTWF_THREADS_SET_CALLBACK
+    struct fftw_jobs {
+      void *(*work)(char *);
+      char *jobdata;
+      size_t elsize;
+    };
+
+    static void
+    run_fftw_job(const fftw_jobs &jobs, const size_t i)
+    {
+      jobs.work(jobs.jobdata + jobs.elsize * i);
+    }
+
+    /*
+     * FFTW runs the jobs of a threaded plan through this instead of
+     * its own threads. A plan never has more jobs than the threads
+     * it was made with, which the blocks take from a ThreadGrant.
+     */
+    static void
+    parallel_loop(void *(*work)(char *), char *jobdata, size_t elsize,
+		  int njobs, void *)
+    {
+      const fftw_jobs jobs = {work, jobdata, elsize};
+      gras::ThreadBudget::parallel_for(njobs, boost::bind(&run_fftw_job, jobs, _1));
+    }
+#endif
+
     static void
     config_threading(int nthreads)
     {
@@ -108,6 +137,9 @@ namespace gr {
 	{
 	  fftw_threads_inited = 1;
 	  fftwf_init_threads();
+#ifdef HAVE_FFTWF_THREADS_SET_CALLBACK
+	  fftwf_threads_set_callback(&parallel_loop, NULL);
+#endif
 	}
 
       fftwf_plan_with_nthreads(nthreads);
@@ -153,13 +185,20 @@ namespace gr {
       }
       
       d_nthreads = nthreads;
-      config_threading(nthreads);
+      d_forward = forward;
+      make_plan();
+    }
+
+    void
+    fft_complex::make_plan()
+    {
+      config_threading(d_nthreads);
       import_wisdom();	// load prior wisdom from disk
       
-      d_plan = fftwf_plan_dft_1d (fft_size,
+      d_plan = fftwf_plan_dft_1d (d_fft_size,
 				  reinterpret_cast<fftwf_complex *>(d_inbuf),
 				  reinterpret_cast<fftwf_complex *>(d_outbuf),
-				  forward ? FFTW_FORWARD : FFTW_BACKWARD,
+				  d_forward ? FFTW_FORWARD : FFTW_BACKWARD,
 				  FFTW_MEASURE);
 
       if (d_plan == NULL) {
@@ -184,10 +223,17 @@ namespace gr {
     {
       if (n <= 0)
 	throw std::out_of_range ("gr::fft: invalid number of threads");
-      d_nthreads = n;
+      if (n == d_nthreads)
+	return;
 
+      // Hold global mutex during plan construction and destruction.
+      planner::scoped_lock lock(planner::mutex());
+
+      d_nthreads = n;
 #ifdef FFTW3F_THREADS
-      fftwf_plan_with_nthreads(d_nthreads);
+      // the thread count is part of the plan, so make a new one
+      fftwf_destroy_plan ((fftwf_plan) d_plan);
+      make_plan();
 #endif
     }
 
@@ -221,10 +267,16 @@ namespace gr {
       }
 
       d_nthreads = nthreads;
-      config_threading(nthreads);
+      make_plan();
+    }
+
+    void
+    fft_real_fwd::make_plan()
+    {
+      config_threading(d_nthreads);
       import_wisdom();	// load prior wisdom from disk
 
-      d_plan = fftwf_plan_dft_r2c_1d (fft_size,
+      d_plan = fftwf_plan_dft_r2c_1d (d_fft_size,
 				      d_inbuf,
 				      reinterpret_cast<fftwf_complex *>(d_outbuf),
 				      FFTW_MEASURE);
@@ -251,10 +303,17 @@ namespace gr {
     {
       if (n <= 0)
 	throw std::out_of_range ("gr::fft::fft_real_fwd::set_nthreads: invalid number of threads");
-      d_nthreads = n;
+      if (n == d_nthreads)
+	return;
 
+      // Hold global mutex during plan construction and destruction.
+      planner::scoped_lock lock(planner::mutex());
+
+      d_nthreads = n;
 #ifdef FFTW3F_THREADS
-      fftwf_plan_with_nthreads(d_nthreads);
+      // the thread count is part of the plan, so make a new one
+      fftwf_destroy_plan ((fftwf_plan) d_plan);
+      make_plan();
 #endif
     }
 
@@ -288,13 +347,19 @@ namespace gr {
       }
 
       d_nthreads = nthreads;
-      config_threading(nthreads);
+      make_plan();
+    }
+
+    void
+    fft_real_rev::make_plan()
+    {
+      config_threading(d_nthreads);
       import_wisdom();	// load prior wisdom from disk
 
       // FIXME If there's ever a chance that the planning functions
       // will be called in multiple threads, we've got to ensure single
       // threaded access.  They are not thread-safe.
-      d_plan = fftwf_plan_dft_c2r_1d (fft_size,
+      d_plan = fftwf_plan_dft_c2r_1d (d_fft_size,
 				      reinterpret_cast<fftwf_complex *>(d_inbuf),
 				      d_outbuf,
 				      FFTW_MEASURE);
@@ -321,10 +386,17 @@ namespace gr {
     {
       if (n <= 0)
 	throw std::out_of_range ("gr::fft::fft_real_rev::set_nthreads: invalid number of threads");
+      if (n == d_nthreads)
+	return;
+
+      // Hold global mutex during plan construction and destruction.
+      planner::scoped_lock lock(planner::mutex());
+
       d_nthreads = n;
-      
 #ifdef FFTW3F_THREADS
-      fftwf_plan_with_nthreads(d_nthreads);
+      // the thread count is part of the plan, so make a new one
+      fftwf_destroy_plan ((fftwf_plan) d_plan);
+      make_plan();
 #endif
     }
 
@@ -26,8 +26,11 @@
 
 #include "fft_vcc_fftw.h"
 #include <gr_io_signature.h>
+#include <boost/bind.hpp>
 #include <math.h>
 #include <string.h>
+#include <stdexcept>
+#include <algorithm>
 
 namespace gr {
   namespace fft {
@@ -41,32 +44,81 @@ namespace gr {
 					 shift, nthreads));
     }
 
+    /*
+     * Transforms at least this long run on FFTW's threads, shorter
+     * ones split the vectors of each work call across the threads.
+     */
+    static const unsigned int fftw_threads_min_size = 16384;
+
     fft_vcc_fftw::fft_vcc_fftw(int fft_size, bool forward,
 			       const std::vector<float> &window,
 			       bool shift, int nthreads)
       : gr_sync_block("fft_vcc_fftw",
 		      gr_make_io_signature(1, 1, fft_size * sizeof(gr_complex)),
 		      gr_make_io_signature(1, 1, fft_size * sizeof(gr_complex))),
-	d_fft_size(fft_size), d_forward(forward), d_shift(shift)
+	d_fft_size(fft_size), d_forward(forward), d_shift(shift),
+	d_nthreads(1), d_regrant(false)
     {
-      d_fft = new fft_complex(d_fft_size, forward, nthreads);
+      d_ffts.push_back(new fft_complex(d_fft_size, forward, 1));
+      set_nthreads(nthreads);
     }
 
     fft_vcc_fftw::~fft_vcc_fftw()
     {
-      delete d_fft;
+      for(size_t i = 0; i < d_ffts.size(); i++)
+	delete d_ffts[i];
+    }
+
+    bool
+    fft_vcc_fftw::start()
+    {
+      apply_grant();
+      return gr_sync_block::start();
+    }
+
+    bool
+    fft_vcc_fftw::stop()
+    {
+      d_grant = gras::ThreadGrant();
+      return gr_sync_block::stop();
+    }
+
+    void
+    fft_vcc_fftw::apply_grant()
+    {
+      d_regrant = false;
+      d_grant = gras::ThreadGrant();	// return the old threads first
+      d_grant = gras::ThreadGrant(get_uid(), d_nthreads);
+      const int granted = d_grant.size();
+
+#ifdef FFTW3F_THREADS
+      const bool fftw_threads = d_fft_size >= fftw_threads_min_size;
+#else
+      const bool fftw_threads = false;
+#endif
+      const size_t nffts = fftw_threads ? 1 : granted;
+      while(d_ffts.size() > nffts) {
+	delete d_ffts.back();
+	d_ffts.pop_back();
+      }
+      while(d_ffts.size() < nffts)
+	d_ffts.push_back(new fft_complex(d_fft_size, d_forward, 1));
+      d_ffts[0]->set_nthreads(fftw_threads ? granted : 1);
     }
 
     void
     fft_vcc_fftw::set_nthreads(int n)
     {
-      d_fft->set_nthreads(n);
+      if (n <= 0)
+	throw std::out_of_range ("fft_vcc_fftw: invalid number of threads");
+      d_nthreads = n;
+      d_regrant = true;		// taken from the budget at the next work
     }
 
     int
     fft_vcc_fftw::nthreads() const
     {
-      return d_fft->nthreads();
+      return d_nthreads;
     }
 
     bool
@@ -80,66 +132,81 @@ namespace gr {
 	return false;
     }
 
-    int
-    fft_vcc_fftw::work(int noutput_items,
-		       gr_vector_const_void_star &input_items,
-		       gr_vector_void_star &output_items)
+    void
+    fft_vcc_fftw::transform(fft_complex *fft, const gr_complex *in, gr_complex *out)
     {
-      const gr_complex *in = (const gr_complex *) input_items[0];
-      gr_complex *out = (gr_complex *) output_items[0];
-      
-      unsigned int input_data_size = input_signature()->sizeof_stream_item (0);
-      unsigned int output_data_size = output_signature()->sizeof_stream_item (0);
-      
-      int count = 0;
-      
-      while(count++ < noutput_items) {
-	
-	// copy input into optimally aligned buffer
-	if(d_window.size()) {
-	  gr_complex *dst = d_fft->get_inbuf();
-	  if(!d_forward && d_shift) {
-	    unsigned int offset = (!d_forward && d_shift)?(d_fft_size/2):0;
-	    int fft_m_offset = d_fft_size - offset;
-	    for(unsigned int i = 0; i < offset; i++)		// apply window
-	      dst[i+fft_m_offset] = in[i] * d_window[i];
-	    for(unsigned int i = offset; i < d_fft_size; i++)	// apply window
-	      dst[i-offset] = in[i] * d_window[i];
-	  } 
-	  else {
-	    for(unsigned int i = 0; i < d_fft_size; i++)		// apply window
-	      dst[i] = in[i] * d_window[i];
-	  }
-	}
+      // copy input into optimally aligned buffer
+      if(d_window.size()) {
+	gr_complex *dst = fft->get_inbuf();
+	if(!d_forward && d_shift) {
+	  unsigned int offset = (!d_forward && d_shift)?(d_fft_size/2):0;
+	  int fft_m_offset = d_fft_size - offset;
+	  for(unsigned int i = 0; i < offset; i++)		// apply window
+	    dst[i+fft_m_offset] = in[i] * d_window[i];
+	  for(unsigned int i = offset; i < d_fft_size; i++)	// apply window
+	    dst[i-offset] = in[i] * d_window[i];
+	} 
 	else {
-	  if(!d_forward && d_shift) {  // apply an ifft shift on the data
-	    gr_complex *dst = d_fft->get_inbuf();
-	    unsigned int len = (unsigned int)(floor(d_fft_size/2.0)); // half length of complex array
-	    memcpy(&dst[0], &in[len], sizeof(gr_complex)*(d_fft_size - len));
-	    memcpy(&dst[d_fft_size - len], &in[0], sizeof(gr_complex)*len);
-	  }
-	  else {
-	    memcpy(d_fft->get_inbuf(), in, input_data_size);
-	  }
+	  for(unsigned int i = 0; i < d_fft_size; i++)		// apply window
+	    dst[i] = in[i] * d_window[i];
 	}
-	
-	// compute the fft
-	d_fft->execute();
-	
-	// copy result to our output
-	if(d_forward && d_shift) {  // apply a fft shift on the data
-	  unsigned int len = (unsigned int)(ceil(d_fft_size/2.0));
-	  memcpy(&out[0], &d_fft->get_outbuf()[len], sizeof(gr_complex)*(d_fft_size - len));
-	  memcpy(&out[d_fft_size - len], &d_fft->get_outbuf()[0], sizeof(gr_complex)*len);
+      }
+      else {
+	if(!d_forward && d_shift) {  // apply an ifft shift on the data
+	  gr_complex *dst = fft->get_inbuf();
+	  unsigned int len = (unsigned int)(floor(d_fft_size/2.0)); // half length of complex array
+	  memcpy(&dst[0], &in[len], sizeof(gr_complex)*(d_fft_size - len));
+	  memcpy(&dst[d_fft_size - len], &in[0], sizeof(gr_complex)*len);
 	}
 	else {
-	  memcpy (out, d_fft->get_outbuf (), output_data_size);
+	  memcpy(fft->get_inbuf(), in, sizeof(gr_complex)*d_fft_size);
 	}
-	
-	in  += d_fft_size;
-	out += d_fft_size;
       }
       
+      // compute the fft
+      fft->execute();
+      
+      // copy result to our output
+      if(d_forward && d_shift) {  // apply a fft shift on the data
+	unsigned int len = (unsigned int)(ceil(d_fft_size/2.0));
+	memcpy(&out[0], &fft->get_outbuf()[len], sizeof(gr_complex)*(d_fft_size - len));
+	memcpy(&out[d_fft_size - len], &fft->get_outbuf()[0], sizeof(gr_complex)*len);
+      }
+      else {
+	memcpy (out, fft->get_outbuf (), sizeof(gr_complex)*d_fft_size);
+      }
+    }
+
+    void
+    fft_vcc_fftw::transform_items(const gr_complex *in, gr_complex *out,
+				  int nitems, int nparts, int part)
+    {
+      // each part runs on its own fft object
+      const int first = (nitems * part) / nparts;
+      const int last = (nitems * (part + 1)) / nparts;
+      for(int i = first; i < last; i++)
+	transform(d_ffts[part], in + i*d_fft_size, out + i*d_fft_size);
+    }
+
+    int
+    fft_vcc_fftw::work(int noutput_items,
+		       gr_vector_const_void_star &input_items,
+		       gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *) input_items[0];
+      gr_complex *out = (gr_complex *) output_items[0];
+
+      if(d_regrant)
+	apply_grant();
+
+      const int nparts = std::min(int(d_ffts.size()), noutput_items);
+      if(nparts <= 1)
+	transform_items(in, out, noutput_items, 1, 0);
+      else
+	d_grant.parallel_for(nparts,
+			     boost::bind(&fft_vcc_fftw::transform_items, this,
+					 in, out, noutput_items, nparts, _1));
+      
       return noutput_items;
     }
 
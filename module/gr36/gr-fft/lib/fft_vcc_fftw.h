@@ -25,6 +25,7 @@
 
 #include <fft/fft_vcc.h>
 #include <fft/fft.h>
+#include <gras/thread_budget.hpp>
 
 namespace gr {
   namespace fft {
@@ -32,11 +33,19 @@ namespace gr {
     class FFT_API fft_vcc_fftw : public fft_vcc
     {
     private:
-      fft_complex          *d_fft;
+      std::vector<fft_complex *> d_ffts;  // one per thread when splitting items
       unsigned int          d_fft_size;
       std::vector<float>    d_window;
       bool                  d_forward;
       bool                  d_shift;
+      int                   d_nthreads;   // requested, see d_grant for granted
+      bool                  d_regrant;
+      gras::ThreadGrant     d_grant;
+
+      void apply_grant();
+      void transform(fft_complex *fft, const gr_complex *in, gr_complex *out);
+      void transform_items(const gr_complex *in, gr_complex *out,
+			   int nitems, int nparts, int part);
 
     public:
       fft_vcc_fftw(int fft_size, bool forward,
@@ -44,6 +53,9 @@ namespace gr {
 		   bool shift, int nthreads=1);
       
       ~fft_vcc_fftw();
+
+      bool start();
+      bool stop();
       
       void set_nthreads(int n);
       int nthreads() const;
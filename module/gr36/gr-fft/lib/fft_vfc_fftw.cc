@@ -26,8 +26,11 @@
 
 #include "fft_vfc_fftw.h"
 #include <gr_io_signature.h>
+#include <boost/bind.hpp>
 #include <math.h>
 #include <string.h>
+#include <stdexcept>
+#include <algorithm>
 
 namespace gr {
   namespace fft {
@@ -41,32 +44,81 @@ namespace gr {
 					 nthreads));
     }
     
+    /*
+     * Transforms at least this long run on FFTW's threads, shorter
+     * ones split the vectors of each work call across the threads.
+     */
+    static const unsigned int fftw_threads_min_size = 16384;
+    
     fft_vfc_fftw::fft_vfc_fftw(int fft_size, bool forward,
 			       const std::vector<float> &window,
 			       int nthreads)
       : gr_sync_block("fft_vfc_fftw",
 		      gr_make_io_signature(1, 1, fft_size * sizeof(float)),
 		      gr_make_io_signature(1, 1, fft_size * sizeof(gr_complex))),
-	d_fft_size(fft_size), d_forward(forward)
+	d_fft_size(fft_size), d_forward(forward),
+	d_nthreads(1), d_regrant(false)
     {
-      d_fft = new fft_complex(d_fft_size, forward, nthreads);
+      d_ffts.push_back(new fft_complex(d_fft_size, forward, 1));
+      set_nthreads(nthreads);
     }
 
     fft_vfc_fftw::~fft_vfc_fftw()
     {
-      delete d_fft;
+      for(size_t i = 0; i < d_ffts.size(); i++)
+	delete d_ffts[i];
+    }
+
+    bool
+    fft_vfc_fftw::start()
+    {
+      apply_grant();
+      return gr_sync_block::start();
+    }
+
+    bool
+    fft_vfc_fftw::stop()
+    {
+      d_grant = gras::ThreadGrant();
+      return gr_sync_block::stop();
+    }
+
+    void
+    fft_vfc_fftw::apply_grant()
+    {
+      d_regrant = false;
+      d_grant = gras::ThreadGrant();	// return the old threads first
+      d_grant = gras::ThreadGrant(get_uid(), d_nthreads);
+      const int granted = d_grant.size();
+
+#ifdef FFTW3F_THREADS
+      const bool fftw_threads = d_fft_size >= fftw_threads_min_size;
+#else
+      const bool fftw_threads = false;
+#endif
+      const size_t nffts = fftw_threads ? 1 : granted;
+      while(d_ffts.size() > nffts) {
+	delete d_ffts.back();
+	d_ffts.pop_back();
+      }
+      while(d_ffts.size() < nffts)
+	d_ffts.push_back(new fft_complex(d_fft_size, d_forward, 1));
+      d_ffts[0]->set_nthreads(fftw_threads ? granted : 1);
     }
 
     void
     fft_vfc_fftw::set_nthreads(int n)
     {
-      d_fft->set_nthreads(n);
+      if (n <= 0)
+	throw std::out_of_range ("fft_vfc_fftw: invalid number of threads");
+      d_nthreads = n;
+      d_regrant = true;		// taken from the budget at the next work
     }
 
     int
     fft_vfc_fftw::nthreads() const
     {
-      return d_fft->nthreads();
+      return d_nthreads;
     }
     
     bool
@@ -79,6 +131,39 @@ namespace gr {
       else
 	return false;
     }
+
+    void
+    fft_vfc_fftw::transform(fft_complex *fft, const float *in, gr_complex *out)
+    {
+      // copy input into optimally aligned buffer
+      if(d_window.size()) {
+	gr_complex *dst = fft->get_inbuf();
+	for(unsigned int i = 0; i < d_fft_size; i++)    // apply window
+	  dst[i] = in[i] * d_window[i];
+      }
+      else {
+	gr_complex *dst = fft->get_inbuf();
+	for(unsigned int i = 0; i < d_fft_size; i++)    // float to complex conversion
+	  dst[i] = in[i];
+      }
+      
+      // compute the fft
+      fft->execute();
+      
+      // copy result to output stream
+      memcpy(out, fft->get_outbuf(), sizeof(gr_complex)*d_fft_size);
+    }
+
+    void
+    fft_vfc_fftw::transform_items(const float *in, gr_complex *out,
+				  int nitems, int nparts, int part)
+    {
+      // each part runs on its own fft object
+      const int first = (nitems * part) / nparts;
+      const int last = (nitems * (part + 1)) / nparts;
+      for(int i = first; i < last; i++)
+	transform(d_ffts[part], in + i*d_fft_size, out + i*d_fft_size);
+    }
     
     int
     fft_vfc_fftw::work(int noutput_items,
@@ -87,34 +172,17 @@ namespace gr {
     {
       const float *in = (const float *)input_items[0];
       gr_complex *out = (gr_complex *)output_items[0];
-      
-      unsigned int output_data_size = output_signature()->sizeof_stream_item (0);
-      
-      int count = 0;
-      
-      while(count++ < noutput_items) {
-	
-	// copy input into optimally aligned buffer
-	if(d_window.size()) {
-	  gr_complex *dst = d_fft->get_inbuf();
-	  for(unsigned int i = 0; i < d_fft_size; i++)    // apply window
-	    dst[i] = in[i] * d_window[i];
-	}
-	else {
-	  gr_complex *dst = d_fft->get_inbuf();
-	  for(unsigned int i = 0; i < d_fft_size; i++)    // float to complex conversion
-	    dst[i] = in[i];
-	}
-	
-	// compute the fft
-	d_fft->execute();
-	
-	// copy result to output stream
-	memcpy(out, d_fft->get_outbuf(), output_data_size);
-	
-	in  += d_fft_size;
-	out += d_fft_size;
-      }
+
+      if(d_regrant)
+	apply_grant();
+
+      const int nparts = std::min(int(d_ffts.size()), noutput_items);
+      if(nparts <= 1)
+	transform_items(in, out, noutput_items, 1, 0);
+      else
+	d_grant.parallel_for(nparts,
+			     boost::bind(&fft_vfc_fftw::transform_items, this,
+					 in, out, noutput_items, nparts, _1));
       
       return noutput_items;
     }
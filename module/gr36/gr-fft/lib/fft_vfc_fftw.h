@@ -25,6 +25,7 @@
 
 #include <fft/fft_vfc.h>
 #include <fft/fft.h>
+#include <gras/thread_budget.hpp>
 
 namespace gr {
   namespace fft {
@@ -32,10 +33,18 @@ namespace gr {
     class FFT_API fft_vfc_fftw : public fft_vfc
     {
     private:
-      fft_complex          *d_fft;
+      std::vector<fft_complex *> d_ffts;  // one per thread when splitting items
       unsigned int          d_fft_size;
       std::vector<float>    d_window;
       bool                  d_forward;
+      int                   d_nthreads;   // requested, see d_grant for granted
+      bool                  d_regrant;
+      gras::ThreadGrant     d_grant;
+
+      void apply_grant();
+      void transform(fft_complex *fft, const float *in, gr_complex *out);
+      void transform_items(const float *in, gr_complex *out,
+			   int nitems, int nparts, int part);
       
     public:
       fft_vfc_fftw(int fft_size, bool forward,
@@ -43,6 +52,9 @@ namespace gr {
 		   int nthreads=1);
       
       ~fft_vfc_fftw();
+
+      bool start();
+      bool stop();
       
       void set_nthreads(int n);
       int nthreads() const;
@@ -208,6 +208,31 @@ class test_fft(gr_unittest.TestCase):
         result_data = dst.data()
         self.assert_fft_ok2(expected_result, result_data)
 
+    def test_004(self):
+        # Many vectors split across the threads give the same result as one thread
+        fft_size = 64
+        nvectors = 37
+        random.seed(0)
+        src_data = tuple([complex(random.uniform(-1, 1), random.uniform(-1, 1))
+                          for i in range(fft_size*nvectors)])
+        window = [0.5 + 0.01*i for i in range(fft_size)]
+
+        results = []
+        for nthreads in (1, 4):
+            tb = gr.top_block()
+            src = gr.vector_source_c(src_data)
+            s2v = gr.stream_to_vector(gr.sizeof_gr_complex, fft_size)
+            op  = fft.fft_vcc(fft_size, True, window, True, nthreads)
+            v2s = gr.vector_to_stream(gr.sizeof_gr_complex, fft_size)
+            dst = gr.vector_sink_c()
+            tb.connect(src, s2v, op, v2s, dst)
+            tb.run()
+            self.assertEqual(nthreads, op.nthreads())
+            results.append(dst.data())
+
+        self.assertEqual(fft_size*nvectors, len(results[1]))
+        self.assertComplexTuplesAlmostEqual(results[0], results[1], 5)
+
 if __name__ == '__main__':
     gr_unittest.run(test_fft, "test_fft.xml")
 
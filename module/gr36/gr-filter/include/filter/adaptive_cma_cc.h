@@ -0,0 +1,74 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_FILTER_ADAPTIVE_CMA_CC_H
+#define	INCLUDED_FILTER_ADAPTIVE_CMA_CC_H
+
+#include <filter/api.h>
+#include <gr_sync_decimator.h>
+
+namespace gr {
+  namespace filter {
+
+    /*!
+     * \brief Constant modulus (CMA) blind equalizer with complex taps.
+     * \ingroup filter_blk
+     *
+     * Adapts the taps to drive |out|^2 towards \p modulus: the taps
+     * move by mu * out * (modulus - |out|^2) * conj(input), with the
+     * error clipped to [-1, 1] per component. The updates of \p
+     * block_size outputs are summed and applied together. The filter
+     * takes \p sps samples per output symbol (fractionally spaced
+     * with sps > 1). The taps start as a unit impulse in the middle.
+     *
+     * See kernel::adaptive_engine.
+     */
+    class FILTER_API adaptive_cma_cc : virtual public gr_sync_decimator
+    {
+    public:
+      // gr::filter::adaptive_cma_cc::sptr
+      typedef boost::shared_ptr<adaptive_cma_cc> sptr;
+
+      /*!
+       * \param ntaps (int) number of taps
+       * \param modulus (float) target |out|^2
+       * \param mu (float) step size
+       * \param sps (int) input samples per output
+       * \param block_size (int) outputs per tap update
+       */
+      static sptr make(unsigned int ntaps, float modulus, float mu,
+		       unsigned int sps=1, unsigned int block_size=1);
+
+      virtual void set_taps(const std::vector<gr_complex> &taps) = 0;
+      virtual std::vector<gr_complex> taps() const = 0;
+
+      virtual void set_mu(float mu) = 0;
+      virtual float mu() const = 0;
+
+      virtual void set_modulus(float modulus) = 0;
+      virtual float modulus() const = 0;
+    };
+
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_ADAPTIVE_CMA_CC_H */
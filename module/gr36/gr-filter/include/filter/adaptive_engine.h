@@ -0,0 +1,235 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_FILTER_ADAPTIVE_ENGINE_H
+#define	INCLUDED_FILTER_ADAPTIVE_ENGINE_H
+
+#include <filter/api.h>
+#include <gr_complex.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace gr {
+  namespace filter {
+    namespace kernel {
+
+      /*
+       * Vector primitives of the adaptive engine, SSE2 where
+       * available. Taps are in input order: taps[k] multiplies x[k].
+       */
+
+      //! sum of taps[k] * x[k]
+      FILTER_API gr_complex adaptive_dot(const gr_complex taps[], const gr_complex x[],
+					 unsigned int n);
+      FILTER_API gr_complex adaptive_dot(const float taps[], const gr_complex x[],
+					 unsigned int n);
+
+      //! taps[k] += a * conj(x[k]), the real part for real taps
+      FILTER_API void adaptive_axpy(gr_complex taps[], gr_complex a, const gr_complex x[],
+				    unsigned int n);
+      FILTER_API void adaptive_axpy(float taps[], gr_complex a, const gr_complex x[],
+				    unsigned int n);
+
+      //! sum of |x[k]|^2
+      FILTER_API float adaptive_energy(const gr_complex x[], unsigned int n);
+
+      /*!
+       * \brief LMS error: the reference minus the output.
+       * \ingroup filter_primitive
+       */
+      struct lms_error
+      {
+	static const bool blind = false;
+	float scale(const gr_complex [], unsigned int) const { return 1.0f; }
+	gr_complex operator()(const gr_complex &out, const gr_complex &desired) const
+	{
+	  return desired - out;
+	}
+      };
+
+      /*!
+       * \brief NLMS error: as LMS, the step is divided by the energy
+       * of the input window plus \p delta.
+       * \ingroup filter_primitive
+       */
+      struct nlms_error
+      {
+	static const bool blind = false;
+	float delta;
+	nlms_error(float delta_ = 1e-6f) : delta(delta_) {}
+	float scale(const gr_complex x[], unsigned int n) const
+	{
+	  return 1.0f / (delta + adaptive_energy(x, n));
+	}
+	gr_complex operator()(const gr_complex &out, const gr_complex &desired) const
+	{
+	  return desired - out;
+	}
+      };
+
+      /*!
+       * \brief Constant modulus error out * (modulus - |out|^2), no
+       * reference; each component is clipped to [-1, 1].
+       * \ingroup filter_primitive
+       */
+      struct cma_error
+      {
+	static const bool blind = true;
+	float modulus;
+	cma_error(float modulus_ = 1.0f) : modulus(modulus_) {}
+	float scale(const gr_complex [], unsigned int) const { return 1.0f; }
+	gr_complex operator()(const gr_complex &out, const gr_complex &) const
+	{
+	  const gr_complex e = out * (modulus - std::norm(out));
+	  return gr_complex(std::max(-1.0f, std::min(1.0f, e.real())),
+			    std::max(-1.0f, std::min(1.0f, e.imag())));
+	}
+      };
+
+      /*!
+       * \class adaptive_engine
+       *
+       * \brief Adaptive FIR filter for complex samples, with the error
+       * function as a compile time policy.
+       *
+       * \ingroup filter_primitive
+       *
+       * Each output is y = sum(taps[ntaps-1-k] * x[k]) over its input
+       * window, the fir_filter convention. The policy turns y (and the
+       * reference for non-blind policies) into an error e, and the
+       * taps move by mu * scale * e * conj(x), where the policy's
+       * scale is 1 or, for NLMS, the inverse window energy. The dot product and the tap update
+       * are each one vector pass over the window instead of a call
+       * per tap.
+       *
+       * With a block size K > 1 the updates of K outputs are summed
+       * and applied together (block LMS): the taps stay fixed within
+       * a block, which is what lets a block be filtered as a batch.
+       *
+       * \p tap_type is gr_complex or float; with float taps the
+       * update keeps the real part. For error functions that need
+       * per-tap control, adaptive_fir_ccc and adaptive_fir_ccf keep
+       * the virtual error()/update_tap() hooks.
+       */
+      template <class tap_type, class error_type>
+      class adaptive_engine
+      {
+      public:
+	adaptive_engine(const std::vector<tap_type> &taps, float mu,
+			unsigned int block_size = 1,
+			const error_type &error = error_type())
+	  : d_mu(mu), d_block_size(1), d_count(0), d_error(error)
+	{
+	  set_taps(taps);
+	  set_block_size(block_size);
+	}
+
+	//! taps in fir_filter order; drops a partial block update
+	void set_taps(const std::vector<tap_type> &taps)
+	{
+	  if(taps.empty())
+	    throw std::invalid_argument("adaptive_engine: need at least one tap");
+	  d_taps.assign(taps.rbegin(), taps.rend());
+	  d_grad.assign(taps.size(), tap_type(0));
+	  d_count = 0;
+	}
+
+	std::vector<tap_type> taps() const
+	{
+	  return std::vector<tap_type>(d_taps.rbegin(), d_taps.rend());
+	}
+
+	unsigned int ntaps() const { return d_taps.size(); }
+
+	void set_mu(float mu) { d_mu = mu; }
+	float mu() const { return d_mu; }
+
+	//! outputs per tap update; applies a partial block update
+	void set_block_size(unsigned int block_size)
+	{
+	  if(block_size == 0)
+	    throw std::invalid_argument("adaptive_engine: block size must be > 0");
+	  apply();
+	  d_block_size = block_size;
+	}
+
+	unsigned int block_size() const { return d_block_size; }
+
+	error_type &error() { return d_error; }
+	const error_type &error() const { return d_error; }
+
+	/*!
+	 * Compute \p n outputs, adapting as they go. Output i reads
+	 * input[i*decimation .. i*decimation + ntaps()-1] and is
+	 * compared against desired[i]; blind policies ignore
+	 * \p desired, it may be NULL.
+	 */
+	void filter_n(gr_complex output[], const gr_complex input[],
+		      const gr_complex desired[], int n,
+		      unsigned int decimation = 1)
+	{
+	  const unsigned int nt = d_taps.size();
+	  for(int i = 0; i < n; i++) {
+	    const gr_complex *x = input + i * decimation;
+	    const gr_complex y = adaptive_dot(&d_taps[0], x, nt);
+	    output[i] = y;
+
+	    const gr_complex step = d_mu * d_error.scale(x, nt) *
+	      d_error(y, error_type::blind ? gr_complex(0) : desired[i]);
+
+	    if(d_block_size == 1)
+	      adaptive_axpy(&d_taps[0], step, x, nt);
+	    else {
+	      adaptive_axpy(&d_grad[0], step, x, nt);
+	      if(++d_count == d_block_size)
+		apply();
+	    }
+	  }
+	}
+
+      private:
+	std::vector<tap_type> d_taps;   // reversed, taps[k] multiplies x[k]
+	std::vector<tap_type> d_grad;   // summed updates of the current block
+	float d_mu;
+	unsigned int d_block_size;
+	unsigned int d_count;
+	error_type d_error;
+
+	void apply()
+	{
+	  if(d_count == 0)
+	    return;
+	  for(size_t k = 0; k < d_taps.size(); k++) {
+	    d_taps[k] += d_grad[k];
+	    d_grad[k] = tap_type(0);
+	  }
+	  d_count = 0;
+	}
+      };
+
+    } /* namespace kernel */
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_ADAPTIVE_ENGINE_H */
@@ -0,0 +1,71 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_FILTER_ADAPTIVE_LMS_CC_H
+#define	INCLUDED_FILTER_ADAPTIVE_LMS_CC_H
+
+#include <filter/api.h>
+#include <gr_sync_block.h>
+
+namespace gr {
+  namespace filter {
+
+    /*!
+     * \brief LMS or NLMS adaptive FIR filter with complex taps,
+     * trained against a reference signal.
+     * \ingroup filter_blk
+     *
+     * Input 0 is filtered; input 1 is the desired output, aligned
+     * with the newest input sample in the filter window. The taps
+     * move by mu * (desired - out) * conj(input) after every \p
+     * block_size outputs, with the updates of a block summed (block
+     * LMS). With \p normalized the step is divided by the energy of
+     * the input window (NLMS). The taps start at zero.
+     *
+     * See kernel::adaptive_engine.
+     */
+    class FILTER_API adaptive_lms_cc : virtual public gr_sync_block
+    {
+    public:
+      // gr::filter::adaptive_lms_cc::sptr
+      typedef boost::shared_ptr<adaptive_lms_cc> sptr;
+
+      /*!
+       * \param ntaps (int) number of taps
+       * \param mu (float) step size
+       * \param normalized (bool) NLMS instead of LMS
+       * \param block_size (int) outputs per tap update
+       */
+      static sptr make(unsigned int ntaps, float mu, bool normalized=false,
+		       unsigned int block_size=1);
+
+      virtual void set_taps(const std::vector<gr_complex> &taps) = 0;
+      virtual std::vector<gr_complex> taps() const = 0;
+
+      virtual void set_mu(float mu) = 0;
+      virtual float mu() const = 0;
+    };
+
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_ADAPTIVE_LMS_CC_H */
@@ -0,0 +1,127 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_FILTER_BIQUAD_CASCADE_H
+#define	INCLUDED_FILTER_BIQUAD_CASCADE_H
+
+#include <filter/api.h>
+#include <filter/iir_filter.h>
+#include <vector>
+
+namespace gr {
+  namespace filter {
+    namespace kernel {
+
+      /*!
+       * \class biquad_cascade
+       *
+       * \brief IIR filter run as a cascade of second-order sections,
+       * float samples and double taps.
+       *
+       * \ingroup filter_primitive
+       *
+       * set_taps() takes the direct form taps of iir_filter and
+       * factors both polynomials. Each pole pair gets the zeros
+       * nearest to it and the sections are ordered so the poles
+       * closest to the unit circle come last. If the sections do not
+       * multiply back to the taps given, the direct form is kept.
+       *
+       * Each section is a transposed direct form II biquad in double
+       * precision. With one channel a section runs four samples per
+       * step: the outputs are the 4x4 impulse response times the
+       * inputs plus the response to the state, and the state
+       * advances by A^4. The feedback dependency is then one step per
+       * four samples and the rest are independent multiply-adds.
+       *
+       * With several channels an item holds one sample of each, and
+       * every section updates all channels together.
+       */
+      class FILTER_API biquad_cascade
+      {
+      public:
+	biquad_cascade(unsigned int nchannels = 1);
+	~biquad_cascade();
+
+	/*!
+	 * Install direct form taps, iir_filter convention: fbtaps[0]
+	 * is ignored and y[n] = sum b_k x[n-k] + sum a_k y[n-k].
+	 * Clears the state.
+	 */
+	void set_taps(const std::vector<double> &fftaps,
+		      const std::vector<double> &fbtaps);
+
+	/*!
+	 * Install sections directly, each {b0, b1, b2, a1, a2} with
+	 * the feedback taps in the convention above. Clears the state.
+	 */
+	void set_sections(const std::vector< std::vector<double> > &sections);
+
+	//! the sections in use, empty when running the direct form
+	const std::vector< std::vector<double> > &sections() const { return d_sections; }
+
+	unsigned int nchannels() const { return d_nchannels; }
+
+	//! zero the filter state
+	void reset();
+
+	/*!
+	 * Filter \p n items. An item is one sample of every channel,
+	 * channels interleaved.
+	 */
+	void filter_n(float output[], const float input[], long n);
+
+	/*!
+	 * Factor direct form taps into sections.
+	 * \return false if the factored sections do not reproduce the taps
+	 */
+	static bool factor(const std::vector<double> &fftaps,
+			   const std::vector<double> &fbtaps,
+			   std::vector< std::vector<double> > &sections);
+
+      private:
+	typedef iir_filter<float,float,double> direct_filter;
+
+	unsigned int d_nchannels;
+	std::vector< std::vector<double> > d_sections;
+	std::vector<double> d_coeffs;   // block constants, per section
+	std::vector<double> d_s1;       // state, per section and channel
+	std::vector<double> d_s2;
+	std::vector<double> d_work;
+	std::vector<direct_filter *> d_direct;
+	std::vector<double> d_fftaps;   // kept for the direct form
+	std::vector<double> d_fbtaps;
+	bool d_zero;
+
+	void clear_direct();
+	void run_block(const double *k, double &s1, double &s2, double x[], long n);
+	void run_channels(const double *k, double s1[], double s2[], double x[], long n);
+
+	biquad_cascade(const biquad_cascade &);
+	biquad_cascade &operator=(const biquad_cascade &);
+      };
+
+    } /* namespace kernel */
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_BIQUAD_CASCADE_H */
@@ -24,7 +24,7 @@
 #define INCLUDED_FILTER_CHANNEL_MODEL_H
 
 #include <filter/api.h>
-#include <gr_hier_block2.h>
+#include <gr_block.h>
 #include <gr_types.h>
 
 namespace gr {
@@ -43,8 +43,13 @@ namespace gr {
      *
      * Multipath can be approximated in this model by using a FIR
      * filter representation of a multipath delay profile..
+     *
+     * The stages run in one block, in order: timing offset (MMSE
+     * interpolation), multipath, frequency offset and AWGN. The noise
+     * depends only on the seed and the sample index, so a run is
+     * reproducible whatever the scheduler's work sizes.
      */
-    class FILTER_API channel_model : virtual public gr_hier_block2
+    class FILTER_API channel_model : virtual public gr_block
     {
     public:
       // gr::filter::channel_model::sptr
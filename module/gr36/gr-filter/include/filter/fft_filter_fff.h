@@ -71,11 +71,14 @@ namespace gr {
 
       /*!
        * \brief Set number of threads to use.
+       *
+       * This is a request: while the block runs the threads are
+       * granted from gras::ThreadBudget, as many as are free.
        */
       virtual void set_nthreads(int n) = 0;
 
       /*!
-       * \brief Get number of threads being used.
+       * \brief Get number of threads requested.
        */
       virtual int nthreads() const = 0;
     };
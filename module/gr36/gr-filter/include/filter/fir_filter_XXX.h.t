@@ -27,6 +27,8 @@
 
 #include <filter/api.h>
 #include <gr_sync_decimator.h>
+#include <string>
+#include <vector>
 
 namespace gr {
   namespace filter {
@@ -74,6 +76,25 @@ namespace gr {
 
       virtual void set_taps(const std::vector<@TAP_TYPE@> &taps) = 0;
       virtual std::vector<@TAP_TYPE@> taps() const = 0;
+
+      /*!
+       * \brief Design new taps with pm_remez and set them when ready.
+       *
+       * The design runs on the tap_designer thread and this call
+       * returns right away, so retuning never waits on a long
+       * design. A design still queued for this block is replaced by
+       * the newer one. The arguments are those of pm_remez; a design
+       * that fails leaves the taps unchanged.
+       */
+      virtual void set_taps_remez(int order,
+				  const std::vector<double> &bands,
+				  const std::vector<double> &ampl,
+				  const std::vector<double> &error_weight,
+				  const std::string filter_type="bandpass",
+				  int grid_density=16) = 0;
+
+      //! block until the design asked for with set_taps_remez is done
+      virtual void wait_for_taps() = 0;
     };
 
   } /* namespace filter */
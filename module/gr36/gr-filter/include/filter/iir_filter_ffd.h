@@ -62,6 +62,13 @@ namespace gr {
      * Note that some texts define the system function with a + in the
      * denominator. If you're using that convention, you'll need to
      * negate the feedback taps.
+     *
+     * The taps are factored into second-order sections, see
+     * kernel::biquad_cascade. Taps that do not factor accurately,
+     * typically high order narrow band designs, run in the direct
+     * form; give those as sections with set_sections() instead. With
+     * \p vlen greater than one each item is a vector of \p vlen
+     * independent signals filtered with the same taps.
      */
     class FILTER_API iir_filter_ffd : virtual public gr_sync_block
     {
@@ -70,10 +77,18 @@ namespace gr {
       typedef boost::shared_ptr<iir_filter_ffd> sptr;
 
       static sptr make(const std::vector<double> &fftaps,
-				  const std::vector<double> &fbtaps);
+		       const std::vector<double> &fbtaps,
+		       unsigned int vlen=1);
 
       virtual void set_taps(const std::vector<double> &fftaps,
 			    const std::vector<double> &fbtaps) = 0;
+
+      /*!
+       * Filter with second-order sections in place of the taps, each
+       * {b0, b1, b2, a1, a2} with the feedback taps in the convention
+       * above. The sections run in the order given.
+       */
+      virtual void set_sections(const std::vector< std::vector<double> > &sections) = 0;
     };
 
   } /* namespace filter */
@@ -23,7 +23,7 @@
 #define _GRI_MMSE_FIR_INTERPOLATOR_CC_H_
 
 #include <filter/api.h>
-#include <filter/fir_filter.h>
+#include <filter/polyphase_engine.h>
 #include <gr_complex.h>
 #include <vector>
 
@@ -70,7 +70,7 @@ namespace gr {
       gr_complex interpolate(const gr_complex input[], float mu) const;
 
     protected:
-      std::vector<kernel::fir_filter_ccf *> filters;
+      kernel::polyphase_engine_ccf d_engine;  // one phase per step of mu
     };
 
   }  /* namespace filter */
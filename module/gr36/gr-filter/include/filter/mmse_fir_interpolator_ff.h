@@ -24,7 +24,7 @@
 #define _MMSE_FIR_INTERPOLATOR_FF_H_
 
 #include <filter/api.h>
-#include <filter/fir_filter.h>
+#include <filter/polyphase_engine.h>
 #include <vector>
 
 namespace gr {
@@ -67,7 +67,7 @@ namespace gr {
       float interpolate(const float input[], float mu) const;
 
     protected:
-      std::vector<kernel::fir_filter_fff*> filters;
+      kernel::polyphase_engine_fff d_engine;  // one phase per step of mu
     };
 
   }  /* namespace filter */
@@ -51,6 +51,9 @@ namespace gr {
      * Frequency is in the range [0, 1], with 1 being the Nyquist
      * frequency (Fs/2)
      *
+     * Designs are looked up in tap_cache first and stored there
+     * once computed, so asking again for the same design is cheap.
+     *
      * \returns vector of computed taps
      *
      * \throws std::runtime_error if args are invalid or calculation
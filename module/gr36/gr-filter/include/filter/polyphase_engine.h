@@ -0,0 +1,242 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_FILTER_POLYPHASE_ENGINE_H
+#define	INCLUDED_FILTER_POLYPHASE_ENGINE_H
+
+#include <filter/api.h>
+#include <filter/fir_filter.h>
+#include <vector>
+
+namespace gr {
+  namespace filter {
+    namespace kernel {
+
+      /*!
+       * \class polyphase_engine_ccf
+       *
+       * \brief Bank of real tap filters for complex samples, one per
+       * phase, with an optional derivative bank for interpolating
+       * between phases.
+       *
+       * \ingroup filter_primitive
+       *
+       * All phases live in one aligned table, so picking a phase is
+       * an offset instead of a separate filter object with its own
+       * alignment fixup. The taps of a phase use the fir_filter
+       * convention: output = sum(input[k] * taps[ntaps-1-k]).
+       *
+       * filter(phase, mu, input) computes the phase and derivative
+       * dot products in the same pass over the input. resample()
+       * runs the arbitrary resampler stepping two outputs per pass,
+       * so each input vector loaded feeds four independent dot
+       * products; when both outputs share a window (interpolating)
+       * the second read of it comes straight from L1.
+       */
+      class FILTER_API polyphase_engine_ccf
+      {
+      public:
+	polyphase_engine_ccf();
+	~polyphase_engine_ccf();
+
+	/*!
+	 * Load the bank. All phases must have the same number of
+	 * taps; \p diff_taps is either empty or the same shape as
+	 * \p taps.
+	 */
+	void set_taps(const std::vector< std::vector<float> > &taps,
+		      const std::vector< std::vector<float> > &diff_taps
+		      = std::vector< std::vector<float> >());
+
+	unsigned int nphases() const { return d_nphases; }
+	unsigned int ntaps() const { return d_ntaps; }
+
+	//! output of one phase, reads input[0 .. ntaps()-1]
+	gr_complex filter(unsigned int phase, const gr_complex input[]) const;
+
+	//! phase output plus \p mu times the derivative output
+	gr_complex filter(unsigned int phase, float mu, const gr_complex input[]) const;
+
+	/*!
+	 * Arbitrary resampler stepping: each output advances the
+	 * phase by \p dec_rate plus the carry of \p acc += \p
+	 * flt_rate; a phase past nphases() moves \p count along the
+	 * input. Stops after \p noutput_items outputs or once \p count
+	 * reaches \p max_input. \p count, \p phase and \p acc carry
+	 * the state between calls.
+	 *
+	 * \return the number of outputs produced
+	 */
+	int resample(gr_complex output[], int noutput_items,
+		     const gr_complex input[], int max_input,
+		     unsigned int dec_rate, float flt_rate,
+		     int &count, unsigned int &phase, float &acc) const;
+
+      private:
+	unsigned int d_nphases;
+	unsigned int d_ntaps;
+	unsigned int d_stride;     // floats per phase in the tables
+	float       *d_taps;       // reversed, each tap twice (re, im)
+	float       *d_diff_taps;  // NULL without a derivative bank
+
+	void filter2(unsigned int p0, float mu0, const gr_complex in0[],
+		     unsigned int p1, float mu1, const gr_complex in1[],
+		     gr_complex &o0, gr_complex &o1) const;
+
+	polyphase_engine_ccf(const polyphase_engine_ccf &);
+	polyphase_engine_ccf &operator=(const polyphase_engine_ccf &);
+      };
+
+      /**************************************************************/
+
+      /*!
+       * \class polyphase_engine_fff
+       *
+       * \brief Bank of real tap filters for real samples, one per
+       * phase, with an optional derivative bank for interpolating
+       * between phases.
+       *
+       * \ingroup filter_primitive
+       *
+       * See polyphase_engine_ccf.
+       */
+      class FILTER_API polyphase_engine_fff
+      {
+      public:
+	polyphase_engine_fff();
+	~polyphase_engine_fff();
+
+	void set_taps(const std::vector< std::vector<float> > &taps,
+		      const std::vector< std::vector<float> > &diff_taps
+		      = std::vector< std::vector<float> >());
+
+	unsigned int nphases() const { return d_nphases; }
+	unsigned int ntaps() const { return d_ntaps; }
+
+	float filter(unsigned int phase, const float input[]) const;
+	float filter(unsigned int phase, float mu, const float input[]) const;
+
+	int resample(float output[], int noutput_items,
+		     const float input[], int max_input,
+		     unsigned int dec_rate, float flt_rate,
+		     int &count, unsigned int &phase, float &acc) const;
+
+      private:
+	unsigned int d_nphases;
+	unsigned int d_ntaps;
+	unsigned int d_stride;
+	float       *d_taps;       // reversed
+	float       *d_diff_taps;
+
+	void filter2(unsigned int p0, float mu0, const float in0[],
+		     unsigned int p1, float mu1, const float in1[],
+		     float &o0, float &o1) const;
+
+	polyphase_engine_fff(const polyphase_engine_fff &);
+	polyphase_engine_fff &operator=(const polyphase_engine_fff &);
+      };
+
+      /**************************************************************/
+
+      /*!
+       * \brief A bank of filters indexed by phase, for the blocks
+       * that are generated for many tap and sample types.
+       *
+       * Real tap banks for complex or real samples run on the
+       * polyphase engines; the other types keep one fir_filter per
+       * phase.
+       */
+      template <class FIR_TYPE, class I_TYPE, class O_TYPE, class TAP_TYPE>
+      class polyphase_bank
+      {
+      public:
+	polyphase_bank() {}
+	~polyphase_bank() { clear(); }
+
+	void set_taps(const std::vector< std::vector<TAP_TYPE> > &taps)
+	{
+	  clear();
+	  for(size_t i = 0; i < taps.size(); i++)
+	    d_firs.push_back(new FIR_TYPE(1, taps[i]));
+	}
+
+	O_TYPE filter(unsigned int phase, const I_TYPE input[]) const
+	{
+	  return d_firs[phase]->filter(input);
+	}
+
+      private:
+	std::vector<FIR_TYPE *> d_firs;
+
+	void clear()
+	{
+	  for(size_t i = 0; i < d_firs.size(); i++)
+	    delete d_firs[i];
+	  d_firs.clear();
+	}
+
+	polyphase_bank(const polyphase_bank &);
+	polyphase_bank &operator=(const polyphase_bank &);
+      };
+
+      template <>
+      class polyphase_bank<fir_filter_ccf, gr_complex, gr_complex, float>
+      {
+      public:
+	void set_taps(const std::vector< std::vector<float> > &taps)
+	{
+	  d_engine.set_taps(taps);
+	}
+
+	gr_complex filter(unsigned int phase, const gr_complex input[]) const
+	{
+	  return d_engine.filter(phase, input);
+	}
+
+      private:
+	polyphase_engine_ccf d_engine;
+      };
+
+      template <>
+      class polyphase_bank<fir_filter_fff, float, float, float>
+      {
+      public:
+	void set_taps(const std::vector< std::vector<float> > &taps)
+	{
+	  d_engine.set_taps(taps);
+	}
+
+	float filter(unsigned int phase, const float input[]) const
+	{
+	  return d_engine.filter(phase, input);
+	}
+
+      private:
+	polyphase_engine_fff d_engine;
+      };
+
+    } /* namespace kernel */
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_POLYPHASE_ENGINE_H */
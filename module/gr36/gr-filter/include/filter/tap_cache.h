@@ -0,0 +1,93 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_FILTER_TAP_CACHE_H
+#define INCLUDED_FILTER_TAP_CACHE_H
+
+#include <filter/api.h>
+#include <string>
+#include <vector>
+
+namespace gr {
+  namespace filter {
+
+    /*!
+     * \brief Taps of finished filter designs, keyed by the design
+     * parameters.
+     *
+     * \ingroup filter_design
+     *
+     * Designs that take long to compute, like pm_remez, look here
+     * first. Recent designs are kept in memory. When persistence is
+     * turned on every design is also written to its own file in the
+     * cache directory (~/.gr_filter_taps by default), so the next run
+     * of a flowgraph finds it there. Files are written to a temporary
+     * name and renamed, so processes sharing the directory never read
+     * half a file. The directory holds at most max_files designs; the
+     * least recently used are removed first.
+     */
+    class FILTER_API tap_cache
+    {
+    public:
+      /*!
+       * Make the key for a design: its name and every parameter,
+       * printed with enough digits to round trip.
+       */
+      static std::string make_key(const std::string &design,
+				  const std::vector<double> &params);
+
+      /*!
+       * Find the taps stored for \p key, in memory first and then
+       * on disk.
+       * \return false if the design is not cached
+       */
+      static bool lookup(const std::string &key, std::vector<double> &taps);
+
+      //! keep \p taps for \p key
+      static void store(const std::string &key, const std::vector<double> &taps);
+
+      //! the most design files kept in the cache directory
+      static const size_t max_files = 256;
+
+      //! turn the on disk copy on or off, it is off by default
+      static void set_persistent(bool persistent);
+      static bool persistent();
+
+      //! store the files in \p dir, an empty string means the default
+      static void set_directory(const std::string &dir);
+      static std::string directory();
+
+      //! the design file for \p key in the cache directory
+      static std::string filename(const std::string &key);
+
+      //! forget the designs held in memory, the files are kept
+      static void clear();
+
+      //! the number of designs held in memory
+      static size_t size();
+    };
+
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_TAP_CACHE_H */
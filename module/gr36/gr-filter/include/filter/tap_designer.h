@@ -0,0 +1,132 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef INCLUDED_FILTER_TAP_DESIGNER_H
+#define INCLUDED_FILTER_TAP_DESIGNER_H
+
+#include <filter/api.h>
+#include <gruel/thread.h>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <deque>
+#include <vector>
+
+namespace gr {
+  namespace filter {
+
+    /*!
+     * \brief One worker thread that computes filter designs away
+     * from the flowgraph and the GUI.
+     *
+     * \ingroup filter_design
+     *
+     * A design is submitted for a target, usually the filter block
+     * that will use the taps. The worker computes the taps and hands
+     * them to the deliver function, typically the block's set_taps,
+     * which swaps them in under the block's lock between two calls
+     * to work. Retuning from a slider submits faster than long
+     * designs finish; a design still queued for the same target is
+     * replaced, so only the newest one is computed.
+     *
+     * \code
+     *   tap_designer::instance().submit<float, double>(fir.get(),
+     *     boost::bind(&pm_remez, order, bands, ampl, weight, "bandpass", 16),
+     *     boost::bind(&fir_filter_fff::set_taps, fir, _1));
+     * \endcode
+     *
+     * A design that throws is reported on stderr and not delivered.
+     * The fir_filter_XXX blocks use it for set_taps_remez, which is
+     * also the way to reach it from Python.
+     */
+    class FILTER_API tap_designer
+    {
+    public:
+      typedef boost::function<void(void)> job;
+
+      //! the process wide designer, its thread starts on first use
+      static tap_designer &instance();
+
+      /*!
+       * Queue a design for \p target. \p design runs on the worker
+       * and returns the taps; \p deliver receives them converted to
+       * \p tap_type.
+       */
+      template <typename tap_type, typename design_type>
+      void submit(const void *target,
+		  const boost::function<std::vector<design_type>(void)> &design,
+		  const boost::function<void(const std::vector<tap_type> &)> &deliver)
+      {
+	post(target, boost::bind(&run_design<tap_type, design_type>,
+				 design, deliver));
+      }
+
+      //! queue \p j for \p target, replacing a job still queued for it
+      void post(const void *target, const job &j);
+
+      /*!
+       * Drop the job queued for \p target and wait for its running
+       * one, if any. Call before destroying the target.
+       */
+      void cancel(const void *target);
+
+      //! wait until every queued job has run
+      void wait();
+
+      //! wait until the job queued or running for \p target has run
+      void wait(const void *target);
+
+      ~tap_designer();
+
+    private:
+      typedef std::pair<const void *, job> entry;
+
+      gruel::mutex d_mutex;
+      gruel::condition_variable d_cond;
+      boost::shared_ptr<gruel::thread> d_thread;
+      std::deque<entry> d_queue;
+      const void *d_running;
+      bool d_done;
+
+      tap_designer();
+
+      bool pending(const void *target) const;
+
+      void run();
+
+      template <typename tap_type, typename design_type>
+      static void run_design(const boost::function<std::vector<design_type>(void)> &design,
+			     const boost::function<void(const std::vector<tap_type> &)> &deliver)
+      {
+	const std::vector<design_type> taps = design();
+	deliver(std::vector<tap_type>(taps.begin(), taps.end()));
+      }
+
+      tap_designer(const tap_designer &);
+      tap_designer &operator=(const tap_designer &);
+    };
+
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_TAP_DESIGNER_H */
@@ -0,0 +1,119 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "adaptive_cma_cc_impl.h"
+#include <gr_io_signature.h>
+
+namespace gr {
+  namespace filter {
+
+    adaptive_cma_cc::sptr
+    adaptive_cma_cc::make(unsigned int ntaps, float modulus, float mu,
+			  unsigned int sps, unsigned int block_size)
+    {
+      return gnuradio::get_initial_sptr
+	(new adaptive_cma_cc_impl(ntaps, modulus, mu, sps, block_size));
+    }
+
+    static std::vector<gr_complex>
+    center_impulse(unsigned int ntaps)
+    {
+      std::vector<gr_complex> taps(ntaps, gr_complex(0, 0));
+      if(ntaps > 0)
+	taps[ntaps / 2] = 1;
+      return taps;
+    }
+
+    adaptive_cma_cc_impl::adaptive_cma_cc_impl(unsigned int ntaps, float modulus,
+					       float mu, unsigned int sps,
+					       unsigned int block_size)
+      : gr_sync_decimator("adaptive_cma_cc",
+			  gr_make_io_signature(1, 1, sizeof(gr_complex)),
+			  gr_make_io_signature(1, 1, sizeof(gr_complex)),
+			  sps),
+	d_cma(center_impulse(ntaps), mu, block_size, kernel::cma_error(modulus)),
+	d_updated(false)
+    {
+      set_history(ntaps);
+    }
+
+    void
+    adaptive_cma_cc_impl::set_taps(const std::vector<gr_complex> &taps)
+    {
+      d_new_taps = taps;
+      d_updated = true;
+    }
+
+    std::vector<gr_complex>
+    adaptive_cma_cc_impl::taps() const
+    {
+      return d_cma.taps();
+    }
+
+    void
+    adaptive_cma_cc_impl::set_mu(float mu)
+    {
+      d_cma.set_mu(mu);
+    }
+
+    float
+    adaptive_cma_cc_impl::mu() const
+    {
+      return d_cma.mu();
+    }
+
+    void
+    adaptive_cma_cc_impl::set_modulus(float modulus)
+    {
+      d_cma.error().modulus = modulus;
+    }
+
+    float
+    adaptive_cma_cc_impl::modulus() const
+    {
+      return d_cma.error().modulus;
+    }
+
+    int
+    adaptive_cma_cc_impl::work(int noutput_items,
+			       gr_vector_const_void_star &input_items,
+			       gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *)input_items[0];
+      gr_complex *out = (gr_complex *)output_items[0];
+
+      if(d_updated) {
+	d_cma.set_taps(d_new_taps);
+	set_history(d_new_taps.size());
+	d_updated = false;
+	return 0;		     // history requirements may have changed.
+      }
+
+      d_cma.filter_n(out, in, NULL, noutput_items, decimation());
+      return noutput_items;
+    }
+
+  } /* namespace filter */
+} /* namespace gr */
@@ -0,0 +1,60 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_FILTER_ADAPTIVE_CMA_CC_IMPL_H
+#define	INCLUDED_FILTER_ADAPTIVE_CMA_CC_IMPL_H
+
+#include <filter/adaptive_cma_cc.h>
+#include <filter/adaptive_engine.h>
+
+namespace gr {
+  namespace filter {
+
+    class FILTER_API adaptive_cma_cc_impl : public adaptive_cma_cc
+    {
+    private:
+      kernel::adaptive_engine<gr_complex, kernel::cma_error> d_cma;
+      std::vector<gr_complex> d_new_taps;
+      bool d_updated;
+
+    public:
+      adaptive_cma_cc_impl(unsigned int ntaps, float modulus, float mu,
+			   unsigned int sps, unsigned int block_size);
+
+      void set_taps(const std::vector<gr_complex> &taps);
+      std::vector<gr_complex> taps() const;
+
+      void set_mu(float mu);
+      float mu() const;
+
+      void set_modulus(float modulus);
+      float modulus() const;
+
+      int work(int noutput_items,
+	       gr_vector_const_void_star &input_items,
+	       gr_vector_void_star &output_items);
+    };
+
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_ADAPTIVE_CMA_CC_IMPL_H */
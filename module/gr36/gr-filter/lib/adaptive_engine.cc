@@ -0,0 +1,165 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <filter/adaptive_engine.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace gr {
+  namespace filter {
+    namespace kernel {
+
+#ifdef __SSE2__
+      // (even lanes, odd lanes) summed
+      static inline gr_complex
+      hsum_pairs(__m128 v)
+      {
+	v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	return gr_complex(_mm_cvtss_f32(v), _mm_cvtss_f32(_mm_shuffle_ps(v, v, 1)));
+      }
+
+      // swap re and im of both complex values
+      static inline __m128
+      swap_pairs(__m128 v)
+      {
+	return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+      }
+#endif
+
+      gr_complex
+      adaptive_dot(const gr_complex taps[], const gr_complex x[], unsigned int n)
+      {
+	unsigned int k = 0;
+	gr_complex sum = 0;
+#ifdef __SSE2__
+	const float *t = (const float *) taps;
+	const float *xf = (const float *) x;
+	// a: tr*xr, ti*xi  b: tr*xi, ti*xr
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	__m128 b0 = _mm_setzero_ps(), b1 = _mm_setzero_ps();
+	for(; k + 4 <= n; k += 4) {
+	  const __m128 t0 = _mm_loadu_ps(t + 2*k), t1 = _mm_loadu_ps(t + 2*k + 4);
+	  const __m128 x0 = _mm_loadu_ps(xf + 2*k), x1 = _mm_loadu_ps(xf + 2*k + 4);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(t0, x0));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(t1, x1));
+	  b0 = _mm_add_ps(b0, _mm_mul_ps(t0, swap_pairs(x0)));
+	  b1 = _mm_add_ps(b1, _mm_mul_ps(t1, swap_pairs(x1)));
+	}
+	const gr_complex a = hsum_pairs(_mm_add_ps(a0, a1));
+	const gr_complex b = hsum_pairs(_mm_add_ps(b0, b1));
+	sum = gr_complex(a.real() - a.imag(), b.real() + b.imag());
+#endif
+	for(; k < n; k++)
+	  sum += taps[k] * x[k];
+	return sum;
+      }
+
+      gr_complex
+      adaptive_dot(const float taps[], const gr_complex x[], unsigned int n)
+      {
+	unsigned int k = 0;
+	gr_complex sum = 0;
+#ifdef __SSE2__
+	const float *xf = (const float *) x;
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	for(; k + 4 <= n; k += 4) {
+	  const __m128 t = _mm_loadu_ps(taps + k);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_unpacklo_ps(t, t), _mm_loadu_ps(xf + 2*k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_unpackhi_ps(t, t), _mm_loadu_ps(xf + 2*k + 4)));
+	}
+	sum = hsum_pairs(_mm_add_ps(a0, a1));
+#endif
+	for(; k < n; k++)
+	  sum += taps[k] * x[k];
+	return sum;
+      }
+
+      void
+      adaptive_axpy(gr_complex taps[], gr_complex a, const gr_complex x[], unsigned int n)
+      {
+	unsigned int k = 0;
+#ifdef __SSE2__
+	// a * conj(x) = (ar, -ar) * (xr, xi) + (ai, ai) * (xi, xr)
+	float *t = (float *) taps;
+	const float *xf = (const float *) x;
+	const __m128 p = _mm_setr_ps(a.real(), -a.real(), a.real(), -a.real());
+	const __m128 q = _mm_set1_ps(a.imag());
+	for(; k + 2 <= n; k += 2) {
+	  const __m128 xv = _mm_loadu_ps(xf + 2*k);
+	  const __m128 u = _mm_add_ps(_mm_mul_ps(p, xv), _mm_mul_ps(q, swap_pairs(xv)));
+	  _mm_storeu_ps(t + 2*k, _mm_add_ps(_mm_loadu_ps(t + 2*k), u));
+	}
+#endif
+	for(; k < n; k++)
+	  taps[k] += a * std::conj(x[k]);
+      }
+
+      void
+      adaptive_axpy(float taps[], gr_complex a, const gr_complex x[], unsigned int n)
+      {
+	unsigned int k = 0;
+#ifdef __SSE2__
+	// real(a * conj(x)) = ar*xr + ai*xi, summed over lane pairs
+	const float *xf = (const float *) x;
+	const __m128 av = _mm_setr_ps(a.real(), a.imag(), a.real(), a.imag());
+	for(; k + 4 <= n; k += 4) {
+	  const __m128 m0 = _mm_mul_ps(av, _mm_loadu_ps(xf + 2*k));
+	  const __m128 m1 = _mm_mul_ps(av, _mm_loadu_ps(xf + 2*k + 4));
+	  const __m128 u = _mm_add_ps(_mm_shuffle_ps(m0, m1, _MM_SHUFFLE(2, 0, 2, 0)),
+				      _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(3, 1, 3, 1)));
+	  _mm_storeu_ps(taps + k, _mm_add_ps(_mm_loadu_ps(taps + k), u));
+	}
+#endif
+	for(; k < n; k++)
+	  taps[k] += a.real() * x[k].real() + a.imag() * x[k].imag();
+      }
+
+      float
+      adaptive_energy(const gr_complex x[], unsigned int n)
+      {
+	unsigned int k = 0;
+	float sum = 0;
+#ifdef __SSE2__
+	const float *xf = (const float *) x;
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	for(; k + 4 <= n; k += 4) {
+	  const __m128 x0 = _mm_loadu_ps(xf + 2*k), x1 = _mm_loadu_ps(xf + 2*k + 4);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(x0, x0));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(x1, x1));
+	}
+	const gr_complex s = hsum_pairs(_mm_add_ps(a0, a1));
+	sum = s.real() + s.imag();
+#endif
+	for(; k < n; k++)
+	  sum += std::norm(x[k]);
+	return sum;
+      }
+
+    } /* namespace kernel */
+  } /* namespace filter */
+} /* namespace gr */
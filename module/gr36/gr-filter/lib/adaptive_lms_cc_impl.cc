@@ -0,0 +1,122 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "adaptive_lms_cc_impl.h"
+#include <gr_io_signature.h>
+
+namespace gr {
+  namespace filter {
+
+    adaptive_lms_cc::sptr
+    adaptive_lms_cc::make(unsigned int ntaps, float mu, bool normalized,
+			  unsigned int block_size)
+    {
+      return gnuradio::get_initial_sptr
+	(new adaptive_lms_cc_impl(ntaps, mu, normalized, block_size));
+    }
+
+    adaptive_lms_cc_impl::adaptive_lms_cc_impl(unsigned int ntaps, float mu,
+					       bool normalized,
+					       unsigned int block_size)
+      : gr_sync_block("adaptive_lms_cc",
+		      gr_make_io_signature(2, 2, sizeof(gr_complex)),
+		      gr_make_io_signature(1, 1, sizeof(gr_complex))),
+	d_lms(NULL), d_nlms(NULL), d_updated(false)
+    {
+      const std::vector<gr_complex> taps(ntaps, gr_complex(0, 0));
+      if(normalized)
+	d_nlms = new kernel::adaptive_engine<gr_complex, kernel::nlms_error>
+	  (taps, mu, block_size);
+      else
+	d_lms = new kernel::adaptive_engine<gr_complex, kernel::lms_error>
+	  (taps, mu, block_size);
+      set_history(ntaps);
+    }
+
+    adaptive_lms_cc_impl::~adaptive_lms_cc_impl()
+    {
+      delete d_lms;
+      delete d_nlms;
+    }
+
+    void
+    adaptive_lms_cc_impl::set_taps(const std::vector<gr_complex> &taps)
+    {
+      d_new_taps = taps;
+      d_updated = true;
+    }
+
+    std::vector<gr_complex>
+    adaptive_lms_cc_impl::taps() const
+    {
+      return d_lms ? d_lms->taps() : d_nlms->taps();
+    }
+
+    void
+    adaptive_lms_cc_impl::set_mu(float mu)
+    {
+      if(d_lms)
+	d_lms->set_mu(mu);
+      else
+	d_nlms->set_mu(mu);
+    }
+
+    float
+    adaptive_lms_cc_impl::mu() const
+    {
+      return d_lms ? d_lms->mu() : d_nlms->mu();
+    }
+
+    int
+    adaptive_lms_cc_impl::work(int noutput_items,
+			       gr_vector_const_void_star &input_items,
+			       gr_vector_void_star &output_items)
+    {
+      const gr_complex *in = (const gr_complex *)input_items[0];
+      const gr_complex *desired = (const gr_complex *)input_items[1];
+      gr_complex *out = (gr_complex *)output_items[0];
+
+      if(d_updated) {
+	if(d_lms)
+	  d_lms->set_taps(d_new_taps);
+	else
+	  d_nlms->set_taps(d_new_taps);
+	set_history(d_new_taps.size());
+	d_updated = false;
+	return 0;		     // history requirements may have changed.
+      }
+
+      // the reference lines up with the newest sample of the window
+      desired += history() - 1;
+      if(d_lms)
+	d_lms->filter_n(out, in, desired, noutput_items);
+      else
+	d_nlms->filter_n(out, in, desired, noutput_items);
+
+      return noutput_items;
+    }
+
+  } /* namespace filter */
+} /* namespace gr */
@@ -0,0 +1,60 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_FILTER_ADAPTIVE_LMS_CC_IMPL_H
+#define	INCLUDED_FILTER_ADAPTIVE_LMS_CC_IMPL_H
+
+#include <filter/adaptive_lms_cc.h>
+#include <filter/adaptive_engine.h>
+
+namespace gr {
+  namespace filter {
+
+    class FILTER_API adaptive_lms_cc_impl : public adaptive_lms_cc
+    {
+    private:
+      // one of the two is in use
+      kernel::adaptive_engine<gr_complex, kernel::lms_error> *d_lms;
+      kernel::adaptive_engine<gr_complex, kernel::nlms_error> *d_nlms;
+      std::vector<gr_complex> d_new_taps;
+      bool d_updated;
+
+    public:
+      adaptive_lms_cc_impl(unsigned int ntaps, float mu, bool normalized,
+			   unsigned int block_size);
+      ~adaptive_lms_cc_impl();
+
+      void set_taps(const std::vector<gr_complex> &taps);
+      std::vector<gr_complex> taps() const;
+
+      void set_mu(float mu);
+      float mu() const;
+
+      int work(int noutput_items,
+	       gr_vector_const_void_star &input_items,
+	       gr_vector_void_star &output_items);
+    };
+
+  } /* namespace filter */
+} /* namespace gr */
+
+#endif /* INCLUDED_FILTER_ADAPTIVE_LMS_CC_IMPL_H */
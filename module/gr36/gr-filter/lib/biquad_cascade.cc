@@ -0,0 +1,685 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <filter/biquad_cascade.h>
+#include <stdexcept>
+#include <algorithm>
+#include <complex>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace gr {
+  namespace filter {
+    namespace kernel {
+
+      typedef std::complex<double> cplx;
+
+      // doubles of block constants per section:
+      //   0  4x4 impulse response, one column of outputs per input
+      //  16  response of the four outputs to s1, then to s2
+      //  24  A^4 as columns (s1, s2)
+      //  28  state contribution of each of the four inputs
+      //  36  b0 b1 b2 a1 a2
+      static const unsigned int STRIDE = 48;
+      static const long CHUNK = 512;
+
+      /******************************************************************
+       * Factoring
+       ******************************************************************/
+
+      // roots of c[0] z^n + c[1] z^(n-1) + ... + c[n], c[0] != 0
+      static std::vector<cplx>
+      poly_roots(const std::vector<double> &c)
+      {
+	const size_t n = c.size() - 1;
+	std::vector<cplx> r(n);
+	if(n == 0)
+	  return r;
+
+	// Aberth-Ehrlich iteration, starting on a circle with the
+	// geometric mean radius of the roots; filter roots tend to
+	// cluster and this converges well where Durand-Kerner stalls
+	std::vector<double> m(n + 1), dm(n);
+	for(size_t i = 0; i <= n; i++)
+	  m[i] = c[i] / c[0];
+	for(size_t i = 0; i < n; i++)
+	  dm[i] = m[i] * (n - i);
+	const double radius = std::max(std::pow(std::abs(m[n]), 1.0 / n), 1e-3);
+	for(size_t k = 0; k < n; k++)
+	  r[k] = std::polar(radius, 2 * M_PI * k / n + 0.4);
+
+	for(int iter = 0; iter < 500; iter++) {
+	  double moved = 0;
+	  for(size_t k = 0; k < n; k++) {
+	    cplx p = m[0], dp = dm[0];
+	    for(size_t i = 1; i <= n; i++)
+	      p = p * r[k] + m[i];
+	    for(size_t i = 1; i < n; i++)
+	      dp = dp * r[k] + dm[i];
+	    if(std::abs(p) == 0)
+	      continue;
+	    cplx sum = 0;
+	    for(size_t j = 0; j < n; j++) {
+	      if(j != k)
+		sum += 1.0 / (r[k] - r[j]);
+	    }
+	    const cplx ratio = p / dp;
+	    const cplx step = ratio / (1.0 - ratio * sum);
+	    if(!std::isfinite(step.real()) || !std::isfinite(step.imag()))
+	      continue;
+	    r[k] -= step;
+	    moved = std::max(moved, std::abs(step) / std::max(1.0, std::abs(r[k])));
+	  }
+	  if(moved < 1e-15)
+	    break;
+	}
+	return r;
+      }
+
+      // roots of a real polynomial grouped in twos, conjugates
+      // together; false if they do not come in conjugate pairs
+      struct root_group
+      {
+	cplx r[2];
+	int nroots;      // finite roots
+	int ninf;        // zeros at infinity (pure delays)
+	double radius() const
+	{
+	  double m = 0;
+	  for(int i = 0; i < nroots; i++)
+	    m = std::max(m, std::abs(r[i]));
+	  return m;
+	}
+      };
+
+      static bool
+      by_magnitude(const cplx &a, const cplx &b)
+      {
+	return std::abs(a) > std::abs(b);
+      }
+
+      static bool
+      group_roots(std::vector<cplx> roots, int ninf, std::vector<root_group> &groups)
+      {
+	std::vector<cplx> upper, lower, real;
+	for(size_t i = 0; i < roots.size(); i++) {
+	  const double tol = 1e-7 * std::max(1.0, std::abs(roots[i]));
+	  if(roots[i].imag() > tol)
+	    upper.push_back(roots[i]);
+	  else if(roots[i].imag() < -tol)
+	    lower.push_back(roots[i]);
+	  else
+	    real.push_back(roots[i].real());
+	}
+	if(upper.size() != lower.size())
+	  return false;
+
+	for(size_t i = 0; i < upper.size(); i++) {
+	  size_t best = 0;
+	  for(size_t j = 1; j < lower.size(); j++) {
+	    if(std::abs(lower[j] - std::conj(upper[i])) <
+	       std::abs(lower[best] - std::conj(upper[i])))
+	      best = j;
+	  }
+	  const cplx p = 0.5 * (upper[i] + std::conj(lower[best]));
+	  lower.erase(lower.begin() + best);
+	  root_group g;
+	  g.r[0] = p;
+	  g.r[1] = std::conj(p);
+	  g.nroots = 2;
+	  g.ninf = 0;
+	  groups.push_back(g);
+	}
+
+	// real roots pair with their neighbours by magnitude, a
+	// leftover one shares its section with a delay if there is one
+	std::sort(real.begin(), real.end(), by_magnitude);
+	for(size_t i = 0; i < real.size(); i += 2) {
+	  root_group g;
+	  g.r[0] = real[i];
+	  g.nroots = 1;
+	  g.ninf = 0;
+	  if(i + 1 < real.size()) {
+	    g.r[1] = real[i+1];
+	    g.nroots = 2;
+	  }
+	  else if(ninf > 0) {
+	    g.ninf = 1;
+	    ninf--;
+	  }
+	  groups.push_back(g);
+	}
+	while(ninf > 0) {
+	  root_group g;
+	  g.nroots = 0;
+	  g.ninf = std::min(ninf, 2);
+	  ninf -= g.ninf;
+	  groups.push_back(g);
+	}
+	return true;
+      }
+
+      // coefficients in z^-1 of the product of (1 - r z^-1) over the
+      // finite roots and z^-1 per delay
+      static std::vector<double>
+      group_poly(const root_group *g)
+      {
+	std::vector<cplx> p(1, 1.0);
+	if(g != NULL) {
+	  for(int i = 0; i < g->nroots; i++) {
+	    p.push_back(0);
+	    for(size_t k = p.size() - 1; k > 0; k--)
+	      p[k] -= g->r[i] * p[k-1];
+	  }
+	  for(int i = 0; i < g->ninf; i++)
+	    p.insert(p.begin(), 0.0);
+	}
+	std::vector<double> out(3, 0.0);
+	for(size_t k = 0; k < p.size() && k < 3; k++)
+	  out[k] = p[k].real();
+	return out;
+      }
+
+      static std::vector<double>
+      poly_mul(const std::vector<double> &a, const std::vector<double> &b)
+      {
+	std::vector<double> c(a.size() + b.size() - 1, 0.0);
+	for(size_t i = 0; i < a.size(); i++)
+	  for(size_t j = 0; j < b.size(); j++)
+	    c[i+j] += a[i] * b[j];
+	return c;
+      }
+
+      // true if \p p (padded with zeros) matches \p ref
+      static bool
+      poly_match(const std::vector<double> &p, const std::vector<double> &ref)
+      {
+	double scale = 1.0;
+	for(size_t i = 0; i < ref.size(); i++)
+	  scale = std::max(scale, std::abs(ref[i]));
+	for(size_t i = 0; i < std::max(p.size(), ref.size()); i++) {
+	  const double a = i < p.size() ? p[i] : 0.0;
+	  const double b = i < ref.size() ? ref[i] : 0.0;
+	  if(std::abs(a - b) > 1e-9 * scale)
+	    return false;
+	}
+	return true;
+      }
+
+      // value and derivative at z of the (d)th derivative of the
+      // polynomial c[0] z^n + ... + c[n]
+      static void
+      poly_eval(const std::vector<double> &c, size_t d, cplx z, cplx &p, cplx &dp)
+      {
+	const size_t n = c.size() - 1;
+	p = 0;
+	dp = 0;
+	for(size_t i = 0; i + d <= n; i++) {
+	  // coefficient of z^(n-d-i) after differentiating d times
+	  double k = c[i];
+	  for(size_t j = 0; j < d; j++)
+	    k *= n - i - j;
+	  dp = dp * z + p;
+	  p = p * z + k;
+	}
+      }
+
+      // a root of multiplicity k comes out of the root finder as a
+      // cluster of k; it is a simple root of the (k-1)th derivative,
+      // so replace the cluster by its mean polished there
+      static std::vector<cplx>
+      merge_roots(const std::vector<double> &c, const std::vector<cplx> &roots, double tol)
+      {
+	std::vector<cplx> out(roots);
+	std::vector<bool> done(roots.size(), false);
+	for(size_t i = 0; i < roots.size(); i++) {
+	  if(done[i])
+	    continue;
+	  const double dist = tol * std::max(1.0, std::abs(roots[i]));
+	  std::vector<size_t> cluster;
+	  cplx z = 0;
+	  for(size_t j = i; j < roots.size(); j++) {
+	    if(!done[j] && std::abs(roots[j] - roots[i]) <= dist) {
+	      cluster.push_back(j);
+	      z += roots[j];
+	    }
+	  }
+	  z /= (double) cluster.size();
+	  for(int iter = 0; cluster.size() > 1 && iter < 20; iter++) {
+	    cplx p, dp;
+	    poly_eval(c, cluster.size() - 1, z, p, dp);
+	    if(std::abs(dp) == 0)
+	      break;
+	    const cplx step = p / dp;
+	    z -= step;
+	    if(std::abs(step) <= 1e-16 * std::max(1.0, std::abs(z)))
+	      break;
+	  }
+	  for(size_t j = 0; j < cluster.size(); j++) {
+	    out[cluster[j]] = z;
+	    done[cluster[j]] = true;
+	  }
+	}
+	return out;
+      }
+
+      // pair up pole and zero groups into sections, false if the
+      // sections do not multiply back to \p b over \p a
+      static bool
+      make_sections(const std::vector<root_group> &zeros,
+		    const std::vector<root_group> &poles, double gain,
+		    const std::vector<double> &b, const std::vector<double> &a,
+		    std::vector< std::vector<double> > &sections)
+      {
+	sections.clear();
+
+	// poles nearest the unit circle pick their zeros first
+	std::vector<std::pair<const root_group *, const root_group *> > pairs;
+	std::vector<bool> taken(zeros.size(), false);
+	std::vector<size_t> order(poles.size());
+	for(size_t i = 0; i < poles.size(); i++)
+	  order[i] = i;
+	for(size_t i = 0; i < order.size(); i++) {
+	  for(size_t j = i + 1; j < order.size(); j++) {
+	    if(poles[order[j]].radius() > poles[order[i]].radius())
+	      std::swap(order[i], order[j]);
+	  }
+	}
+	for(size_t i = 0; i < order.size(); i++) {
+	  const root_group &p = poles[order[i]];
+	  int best = -1;
+	  double best_dist = 0;
+	  for(size_t j = 0; j < zeros.size(); j++) {
+	    if(taken[j])
+	      continue;
+	    const double dist = zeros[j].nroots == 0 ? 1e300 :
+	      std::abs(zeros[j].r[0] - p.r[0]);
+	    if(best < 0 || dist < best_dist) {
+	      best = j;
+	      best_dist = dist;
+	    }
+	  }
+	  const root_group *z = NULL;
+	  if(best >= 0) {
+	    taken[best] = true;
+	    z = &zeros[best];
+	  }
+	  pairs.push_back(std::make_pair(z, &p));
+	}
+	for(size_t j = 0; j < zeros.size(); j++) {
+	  if(!taken[j])
+	    pairs.push_back(std::make_pair(&zeros[j], (const root_group *) NULL));
+	}
+	if(pairs.empty())
+	  pairs.push_back(std::make_pair((const root_group *) NULL,
+					 (const root_group *) NULL));
+
+	// the sections nearest instability run last, the gain first
+	std::reverse(pairs.begin(), pairs.end());
+	std::vector<double> num(1, 1.0), den(1, 1.0);
+	for(size_t i = 0; i < pairs.size(); i++) {
+	  std::vector<double> bz = group_poly(pairs[i].first);
+	  const std::vector<double> ap = group_poly(pairs[i].second);
+	  if(i == 0) {
+	    for(int k = 0; k < 3; k++)
+	      bz[k] *= gain;
+	  }
+	  num = poly_mul(num, bz);
+	  den = poly_mul(den, ap);
+
+	  std::vector<double> s(5);
+	  s[0] = bz[0];
+	  s[1] = bz[1];
+	  s[2] = bz[2];
+	  s[3] = -ap[1];
+	  s[4] = -ap[2];
+	  sections.push_back(s);
+	}
+
+	// compare the numerator with its gain divided out; narrow band
+	// designs have tiny gains that would hide misplaced zeros
+	std::vector<double> bn(b);
+	for(size_t k = 0; k < num.size(); k++)
+	  num[k] /= gain;
+	for(size_t k = 0; k < bn.size(); k++)
+	  bn[k] /= gain;
+	return poly_match(num, bn) && poly_match(den, a);
+      }
+
+      bool
+      biquad_cascade::factor(const std::vector<double> &fftaps,
+			     const std::vector<double> &fbtaps,
+			     std::vector< std::vector<double> > &sections)
+      {
+	sections.clear();
+
+	// numerator b0 + b1 z^-1 + ..., leading zeros are delays
+	std::vector<double> b(fftaps);
+	while(!b.empty() && b.back() == 0)
+	  b.pop_back();
+	if(b.empty())
+	  return false;
+	size_t delay = 0;
+	while(b[delay] == 0)
+	  delay++;
+	const std::vector<double> zpoly(b.begin() + delay, b.end());
+	const double gain = zpoly[0];
+
+	// denominator 1 - a1 z^-1 - a2 z^-2 ...
+	std::vector<double> a(1, 1.0);
+	for(size_t i = 1; i < fbtaps.size(); i++)
+	  a.push_back(-fbtaps[i]);
+	while(a.size() > 1 && a.back() == 0)
+	  a.pop_back();
+
+	// try merging ever wider clusters until the sections check out
+	const std::vector<cplx> zroots = poly_roots(zpoly);
+	const std::vector<cplx> proots = poly_roots(a);
+	static const double merge[] = { 0, 1e-6, 1e-4, 1e-3, 1e-2, 3e-2, 1e-1 };
+	for(size_t i = 0; i < sizeof(merge) / sizeof(merge[0]); i++) {
+	  std::vector<root_group> zeros, poles;
+	  if(group_roots(merge_roots(zpoly, zroots, merge[i]), delay, zeros) &&
+	     group_roots(merge_roots(a, proots, merge[i]), 0, poles) &&
+	     make_sections(zeros, poles, gain, b, a, sections))
+	    return true;
+	}
+	sections.clear();
+	return false;
+      }
+
+
+      /******************************************************************
+       * Filtering
+       ******************************************************************/
+
+      biquad_cascade::biquad_cascade(unsigned int nchannels)
+	: d_nchannels(nchannels), d_zero(true)
+      {
+	if(nchannels == 0)
+	  throw std::invalid_argument("biquad_cascade: need at least one channel");
+      }
+
+      biquad_cascade::~biquad_cascade()
+      {
+	clear_direct();
+      }
+
+      void
+      biquad_cascade::clear_direct()
+      {
+	for(size_t i = 0; i < d_direct.size(); i++)
+	  delete d_direct[i];
+	d_direct.clear();
+      }
+
+      void
+      biquad_cascade::set_taps(const std::vector<double> &fftaps,
+			       const std::vector<double> &fbtaps)
+      {
+	std::vector< std::vector<double> > sections;
+	bool zero = true;
+	for(size_t i = 0; i < fftaps.size(); i++)
+	  zero &= fftaps[i] == 0;
+
+	if(zero || factor(fftaps, fbtaps, sections)) {
+	  set_sections(sections);
+	  d_zero = zero;
+	  return;
+	}
+
+	// keep the direct form
+	d_sections.clear();
+	d_coeffs.clear();
+	clear_direct();
+	d_fftaps = fftaps;
+	d_fbtaps = fbtaps;
+	for(unsigned int c = 0; c < d_nchannels; c++)
+	  d_direct.push_back(new direct_filter(fftaps, fbtaps));
+	d_zero = false;
+      }
+
+      void
+      biquad_cascade::set_sections(const std::vector< std::vector<double> > &sections)
+      {
+	for(size_t i = 0; i < sections.size(); i++) {
+	  if(sections[i].size() != 5)
+	    throw std::invalid_argument("biquad_cascade: a section is {b0, b1, b2, a1, a2}");
+	}
+
+	clear_direct();
+	d_sections = sections;
+	d_zero = false;
+	d_coeffs.assign(STRIDE * sections.size(), 0.0);
+
+	for(size_t i = 0; i < sections.size(); i++) {
+	  const std::vector<double> &s = sections[i];
+	  double *k = &d_coeffs[STRIDE * i];
+	  const double b0 = s[0], a1 = s[3], a2 = s[4];
+
+	  // state space of the section: s' = A s + B x, y = s1 + b0 x
+	  const double B[2] = { s[1] + a1 * b0, s[2] + a2 * b0 };
+	  double P[5][2][2];   // A^0 .. A^4
+	  P[0][0][0] = 1; P[0][0][1] = 0; P[0][1][0] = 0; P[0][1][1] = 1;
+	  for(int m = 1; m <= 4; m++) {
+	    P[m][0][0] = a1 * P[m-1][0][0] + P[m-1][1][0];
+	    P[m][0][1] = a1 * P[m-1][0][1] + P[m-1][1][1];
+	    P[m][1][0] = a2 * P[m-1][0][0];
+	    P[m][1][1] = a2 * P[m-1][0][1];
+	  }
+
+	  double h[4];
+	  h[0] = b0;
+	  for(int m = 1; m < 4; m++)
+	    h[m] = P[m-1][0][0] * B[0] + P[m-1][0][1] * B[1];
+
+	  for(int j = 0; j < 4; j++) {
+	    for(int o = 0; o < 4; o++)
+	      k[4*j + o] = o >= j ? h[o-j] : 0.0;
+	  }
+	  for(int o = 0; o < 4; o++) {
+	    k[16 + o] = P[o][0][0];
+	    k[20 + o] = P[o][0][1];
+	  }
+	  k[24] = P[4][0][0];
+	  k[25] = P[4][1][0];
+	  k[26] = P[4][0][1];
+	  k[27] = P[4][1][1];
+	  for(int j = 0; j < 4; j++) {
+	    k[28 + 2*j] = P[3-j][0][0] * B[0] + P[3-j][0][1] * B[1];
+	    k[29 + 2*j] = P[3-j][1][0] * B[0] + P[3-j][1][1] * B[1];
+	  }
+	  for(int j = 0; j < 5; j++)
+	    k[36 + j] = s[j];
+	}
+	reset();
+      }
+
+      void
+      biquad_cascade::reset()
+      {
+	d_s1.assign(d_sections.size() * d_nchannels, 0.0);
+	d_s2.assign(d_sections.size() * d_nchannels, 0.0);
+	for(size_t i = 0; i < d_direct.size(); i++)
+	  d_direct[i]->set_taps(d_fftaps, d_fbtaps);
+      }
+
+      // one section over one channel, in place
+      void
+      biquad_cascade::run_block(const double *k, double &s1, double &s2,
+				double x[], long n)
+      {
+	long i = 0;
+#ifdef __SSE2__
+	__m128d sv = _mm_set_pd(s2, s1);
+	for(; i + 4 <= n; i += 4) {
+	  const __m128d x0 = _mm_set1_pd(x[i]), x1 = _mm_set1_pd(x[i+1]);
+	  const __m128d x2 = _mm_set1_pd(x[i+2]), x3 = _mm_set1_pd(x[i+3]);
+	  const __m128d s1b = _mm_unpacklo_pd(sv, sv);
+	  const __m128d s2b = _mm_unpackhi_pd(sv, sv);
+
+	  __m128d lo = _mm_add_pd(_mm_mul_pd(s1b, _mm_loadu_pd(k + 16)),
+				  _mm_mul_pd(s2b, _mm_loadu_pd(k + 20)));
+	  lo = _mm_add_pd(lo, _mm_add_pd(_mm_mul_pd(x0, _mm_loadu_pd(k + 0)),
+					 _mm_mul_pd(x1, _mm_loadu_pd(k + 4))));
+	  __m128d hi = _mm_add_pd(_mm_mul_pd(s1b, _mm_loadu_pd(k + 18)),
+				  _mm_mul_pd(s2b, _mm_loadu_pd(k + 22)));
+	  hi = _mm_add_pd(hi, _mm_add_pd(_mm_mul_pd(x0, _mm_loadu_pd(k + 2)),
+					 _mm_mul_pd(x1, _mm_loadu_pd(k + 6))));
+	  hi = _mm_add_pd(hi, _mm_add_pd(_mm_mul_pd(x2, _mm_loadu_pd(k + 10)),
+					 _mm_mul_pd(x3, _mm_loadu_pd(k + 14))));
+
+	  __m128d st = _mm_add_pd(_mm_mul_pd(x0, _mm_loadu_pd(k + 28)),
+				  _mm_mul_pd(x1, _mm_loadu_pd(k + 30)));
+	  st = _mm_add_pd(st, _mm_add_pd(_mm_mul_pd(x2, _mm_loadu_pd(k + 32)),
+					 _mm_mul_pd(x3, _mm_loadu_pd(k + 34))));
+	  sv = _mm_add_pd(st, _mm_add_pd(_mm_mul_pd(s1b, _mm_loadu_pd(k + 24)),
+					 _mm_mul_pd(s2b, _mm_loadu_pd(k + 26))));
+
+	  _mm_storeu_pd(x + i, lo);
+	  _mm_storeu_pd(x + i + 2, hi);
+	}
+	s1 = _mm_cvtsd_f64(sv);
+	s2 = _mm_cvtsd_f64(_mm_unpackhi_pd(sv, sv));
+#else
+	for(; i + 4 <= n; i += 4) {
+	  const double xv[4] = { x[i], x[i+1], x[i+2], x[i+3] };
+	  double y[4], t1 = 0, t2 = 0;
+	  for(int o = 0; o < 4; o++) {
+	    y[o] = k[16 + o] * s1 + k[20 + o] * s2;
+	    for(int j = 0; j <= o; j++)
+	      y[o] += k[4*j + o] * xv[j];
+	  }
+	  for(int j = 0; j < 4; j++) {
+	    t1 += k[28 + 2*j] * xv[j];
+	    t2 += k[29 + 2*j] * xv[j];
+	  }
+	  const double n1 = k[24] * s1 + k[26] * s2 + t1;
+	  const double n2 = k[25] * s1 + k[27] * s2 + t2;
+	  s1 = n1;
+	  s2 = n2;
+	  for(int o = 0; o < 4; o++)
+	    x[i + o] = y[o];
+	}
+#endif
+	const double b0 = k[36], b1 = k[37], b2 = k[38], a1 = k[39], a2 = k[40];
+	for(; i < n; i++) {
+	  const double y = b0 * x[i] + s1;
+	  s1 = b1 * x[i] + a1 * y + s2;
+	  s2 = b2 * x[i] + a2 * y;
+	  x[i] = y;
+	}
+      }
+
+      // one section over n items of all channels, in place
+      void
+      biquad_cascade::run_channels(const double *k, double s1[], double s2[],
+				   double x[], long n)
+      {
+	const unsigned int nch = d_nchannels;
+	const double b0 = k[36], b1 = k[37], b2 = k[38], a1 = k[39], a2 = k[40];
+#ifdef __SSE2__
+	const __m128d vb0 = _mm_set1_pd(b0), vb1 = _mm_set1_pd(b1);
+	const __m128d vb2 = _mm_set1_pd(b2), va1 = _mm_set1_pd(a1);
+	const __m128d va2 = _mm_set1_pd(a2);
+#endif
+	for(long t = 0; t < n; t++) {
+	  double *row = x + t * nch;
+	  unsigned int c = 0;
+#ifdef __SSE2__
+	  for(; c + 2 <= nch; c += 2) {
+	    const __m128d xv = _mm_loadu_pd(row + c);
+	    const __m128d y = _mm_add_pd(_mm_mul_pd(vb0, xv), _mm_loadu_pd(s1 + c));
+	    const __m128d n1 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(vb1, xv), _mm_mul_pd(va1, y)),
+					  _mm_loadu_pd(s2 + c));
+	    const __m128d n2 = _mm_add_pd(_mm_mul_pd(vb2, xv), _mm_mul_pd(va2, y));
+	    _mm_storeu_pd(s1 + c, n1);
+	    _mm_storeu_pd(s2 + c, n2);
+	    _mm_storeu_pd(row + c, y);
+	  }
+#endif
+	  for(; c < nch; c++) {
+	    const double y = b0 * row[c] + s1[c];
+	    s1[c] = b1 * row[c] + a1 * y + s2[c];
+	    s2[c] = b2 * row[c] + a2 * y;
+	    row[c] = y;
+	  }
+	}
+      }
+
+      void
+      biquad_cascade::filter_n(float output[], const float input[], long n)
+      {
+	const unsigned int nch = d_nchannels;
+
+	if(d_zero) {
+	  std::fill(output, output + n * nch, 0.0f);
+	  return;
+	}
+
+	if(!d_direct.empty()) {
+	  if(nch == 1) {
+	    d_direct[0]->filter_n(output, input, n);
+	    return;
+	  }
+	  for(long t = 0; t < n; t++) {
+	    for(unsigned int c = 0; c < nch; c++)
+	      output[t*nch + c] = d_direct[c]->filter(input[t*nch + c]);
+	  }
+	  return;
+	}
+
+	d_work.resize(CHUNK * nch);
+	double *w = &d_work[0];
+	const size_t nsections = d_sections.size();
+
+	for(long done = 0; done < n; ) {
+	  const long m = std::min(CHUNK, n - done);
+	  const float *in = input + done * nch;
+	  float *out = output + done * nch;
+
+	  for(long i = 0; i < m * nch; i++)
+	    w[i] = in[i];
+
+	  for(size_t s = 0; s < nsections; s++) {
+	    const double *k = &d_coeffs[STRIDE * s];
+	    if(nch == 1)
+	      run_block(k, d_s1[s], d_s2[s], w, m);
+	    else
+	      run_channels(k, &d_s1[s * nch], &d_s2[s * nch], w, m);
+	  }
+
+	  for(long i = 0; i < m * nch; i++)
+	    out[i] = w[i];
+	  done += m;
+	}
+      }
+
+    } /* namespace kernel */
+  } /* namespace filter */
+} /* namespace gr */
@@ -22,7 +22,9 @@
 
 #include "channel_model_impl.h"
 #include <gr_io_signature.h>
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 namespace gr {
   namespace filter {
@@ -42,81 +44,145 @@ namespace gr {
 				noise_seed));
     }
 
-    // Hierarchical block constructor
     channel_model_impl::channel_model_impl(double noise_voltage,
 					   double frequency_offset,
 					   double epsilon,
 					   const std::vector<gr_complex> &taps,
 					   double noise_seed)
-      : gr_hier_block2("gr_channel_model",
-		       gr_make_io_signature(1, 1, sizeof(gr_complex)),
-		       gr_make_io_signature(1, 1, sizeof(gr_complex)))
+      : gr_block("channel_model",
+		 gr_make_io_signature(1, 1, sizeof(gr_complex)),
+		 gr_make_io_signature(1, 1, sizeof(gr_complex))),
+	d_mu(0), d_mu_inc(epsilon),
+	d_rng((long)noise_seed),
+	d_noise_voltage(noise_voltage)
     {
+      if(epsilon <= 0)
+	throw std::out_of_range("timing offset must be > 0");
+      set_relative_rate(1.0 / epsilon);
+
       d_taps = taps;
       while(d_taps.size() < 2) {
 	d_taps.push_back(0);
       }
+      d_multipath = new kernel::fir_filter_ccc(1, d_taps);
+      d_buf.assign(d_multipath->ntaps() - 1, 0);
 
-      d_timing_offset = fractional_interpolator_cc::make(0, epsilon);
-
-      d_multipath = fir_filter_ccc::make(1, d_taps);
+      set_frequency_offset(frequency_offset);
+    }
 
-      d_noise_adder = gr_make_add_cc();
-      d_noise = gr_make_noise_source_c(GR_GAUSSIAN, noise_voltage, noise_seed);
-      d_freq_offset = gr_make_sig_source_c(1, GR_SIN_WAVE, frequency_offset, 1.0, 0.0);
-      d_mixer_offset = gr_make_multiply_cc();
+    channel_model_impl::~channel_model_impl()
+    {
+      delete d_multipath;
+    }
 
-      connect(self(), 0, d_timing_offset, 0);
-      connect(d_timing_offset, 0, d_multipath, 0);
-      connect(d_multipath, 0, d_mixer_offset, 0);
-      connect(d_freq_offset, 0, d_mixer_offset, 1);
-      connect(d_mixer_offset, 0, d_noise_adder, 1);
-      connect(d_noise, 0, d_noise_adder, 0);
-      connect(d_noise_adder, 0, self(), 0);
+    void
+    channel_model_impl::forecast(int noutput_items,
+				 gr_vector_int &ninput_items_required)
+    {
+      unsigned ninputs = ninput_items_required.size();
+      for(unsigned i=0; i < ninputs; i++) {
+	ninput_items_required[i] =
+	  (int)ceil((noutput_items * d_mu_inc) + d_interp.ntaps());
+      }
     }
 
-    channel_model_impl::~channel_model_impl()
+    int
+    channel_model_impl::general_work(int noutput_items,
+				     gr_vector_int &ninput_items,
+				     gr_vector_const_void_star &input_items,
+				     gr_vector_void_star &output_items)
     {
+      gruel::scoped_lock l(d_setlock);
+
+      const gr_complex *in = (const gr_complex*)input_items[0];
+      gr_complex *out = (gr_complex*)output_items[0];
+
+      const unsigned int hist = d_multipath->ntaps() - 1;
+      d_buf.resize(hist + noutput_items);
+
+      // timing offset, into the buffer after the multipath history
+      int ii = 0;
+      for(int oo = 0; oo < noutput_items; oo++) {
+	d_buf[hist + oo] = d_interp.interpolate(&in[ii], d_mu);
+
+	double s = d_mu + d_mu_inc;
+	double f = floor(s);
+	ii += (int)f;
+	d_mu = s - f;
+      }
+
+      // multipath, then keep its history for the next call
+      d_multipath->filterN(out, &d_buf[0], noutput_items);
+      std::copy(d_buf.begin() + noutput_items,
+		d_buf.begin() + noutput_items + hist, d_buf.begin());
+
+      d_nco.rotate(out, out, noutput_items);
+
+      // silent noise still moves along the stream, so raising the
+      // voltage later gives the same noise as if it had always been on
+      if(d_noise_voltage != 0)
+	d_rng.add_gaussian(out, out, noutput_items, d_noise_voltage);
+      else
+	d_rng.skip(2 * (uint64_t)noutput_items);
+
+      consume_each(ii);
+      return noutput_items;
     }
 
     void
     channel_model_impl::set_noise_voltage(double noise_voltage)
     {
-      d_noise->set_amplitude(noise_voltage);
+      gruel::scoped_lock l(d_setlock);
+      d_noise_voltage = noise_voltage;
     }
 
     void
     channel_model_impl::set_frequency_offset(double frequency_offset)
     {
-      d_freq_offset->set_frequency(frequency_offset);
+      gruel::scoped_lock l(d_setlock);
+      d_frequency_offset = frequency_offset;
+      d_nco.set_freq(2 * M_PI * frequency_offset);
     }
 
     void
     channel_model_impl::set_taps(const std::vector<gr_complex> &taps)
     {
+      gruel::scoped_lock l(d_setlock);
+
+      const unsigned int old_hist = d_multipath->ntaps() - 1;
       d_taps = taps;
       while(d_taps.size() < 2) {
 	d_taps.push_back(0);
       }
       d_multipath->set_taps(d_taps);
+
+      // keep the newest samples of the history
+      const unsigned int hist = d_multipath->ntaps() - 1;
+      const unsigned int keep = std::min(hist, old_hist);
+      std::vector<gr_complex> line(hist, 0);
+      std::copy(d_buf.begin() + old_hist - keep, d_buf.begin() + old_hist,
+		line.end() - keep);
+      d_buf.swap(line);
     }
 
     void
     channel_model_impl::set_timing_offset(double epsilon)
     {
-      d_timing_offset->set_interp_ratio(epsilon);
+      gruel::scoped_lock l(d_setlock);
+      d_mu_inc = epsilon;
+      set_relative_rate(1.0 / epsilon);
     }
 
     double
     channel_model_impl::noise_voltage() const
     {
-      return d_noise->amplitude();
+      return d_noise_voltage;
     }
 
     double
     channel_model_impl::frequency_offset() const
     {
-      return d_freq_offset->frequency();
+      return d_frequency_offset;
     }
 
     std::vector<gr_complex>
@@ -128,7 +194,7 @@ namespace gr {
     double
     channel_model_impl::timing_offset() const
     {
-      return d_timing_offset->interp_ratio();
+      return d_mu_inc;
     }
 
   } /* namespace filter */
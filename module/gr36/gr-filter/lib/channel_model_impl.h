@@ -23,14 +23,11 @@
 #ifndef INCLUDED_FILTER_CHANNEL_MODEL_IMPL_H
 #define INCLUDED_FILTER_CHANNEL_MODEL_IMPL_H
 
-#include <gr_top_block.h>
-#include <gr_sig_source_c.h>
-#include <gr_add_cc.h>
-#include <gr_multiply_cc.h>
-#include <gr_noise_source_c.h>
 #include <filter/channel_model.h>
-#include <filter/fractional_interpolator_cc.h>
-#include <filter/fir_filter_ccc.h>
+#include <filter/fir_filter.h>
+#include <filter/mmse_fir_interpolator_cc.h>
+#include <gri_nco_engine.h>
+#include <gri_philox_rng.h>
 
 namespace gr {
   namespace filter {
@@ -38,15 +35,19 @@ namespace gr {
     class FILTER_API channel_model_impl : public channel_model
     {
     private:
-      gr_sig_source_c_sptr d_freq_offset;
-      gr_add_cc_sptr d_noise_adder;
-      gr_noise_source_c_sptr d_noise;
-      gr_multiply_cc_sptr d_mixer_offset;
-
-      fractional_interpolator_cc::sptr d_timing_offset;
-      fir_filter_ccc::sptr d_multipath;
+      mmse_fir_interpolator_cc d_interp;
+      float d_mu;
+      float d_mu_inc;
 
+      kernel::fir_filter_ccc *d_multipath;
       std::vector<gr_complex> d_taps;
+      std::vector<gr_complex> d_buf;   // multipath history, then this call's samples
+
+      gri_nco_engine d_nco;
+      double d_frequency_offset;
+
+      gri_philox_rng d_rng;
+      float d_noise_voltage;
 
     public:
       channel_model_impl(double noise_voltage,
@@ -57,6 +58,13 @@ namespace gr {
       
       ~channel_model_impl();
 
+      void forecast(int noutput_items,
+		    gr_vector_int &ninput_items_required);
+      int general_work(int noutput_items,
+		       gr_vector_int &ninput_items,
+		       gr_vector_const_void_star &input_items,
+		       gr_vector_void_star &output_items);
+
       void set_noise_voltage(double noise_voltage);
       void set_frequency_offset(double frequency_offset);
       void set_taps(const std::vector<gr_complex> &taps);
@@ -50,11 +50,12 @@ namespace gr {
 			  gr_make_io_signature (1, 1, sizeof(float)),
 			  gr_make_io_signature (1, 1, sizeof(float)),
 			  decimation),
-	d_updated(false)
+	d_updated(false), d_nthreads(nthreads), d_regrant(false)
     {
       set_history(1);
       
-      d_filter = new kernel::fft_filter_fff(decimation, taps, nthreads);
+      // planned for the granted threads in start()
+      d_filter = new kernel::fft_filter_fff(decimation, taps, 1);
 
       d_new_taps = taps;
       d_nsamples = d_filter->set_taps(taps);
@@ -79,20 +80,33 @@ namespace gr {
       return d_new_taps;
     }
     
+    bool
+    fft_filter_fff_impl::start()
+    {
+      d_regrant = true;
+      return gr_sync_decimator::start();
+    }
+
+    bool
+    fft_filter_fff_impl::stop()
+    {
+      d_grant = gras::ThreadGrant();
+      return gr_sync_decimator::stop();
+    }
+
     void
     fft_filter_fff_impl::set_nthreads(int n)
     {
-      if(d_filter)
-	d_filter->set_nthreads(n);
+      if(n <= 0)
+	throw std::out_of_range("fft_filter_fff: invalid number of threads");
+      d_nthreads = n;
+      d_regrant = true;
     }
     
     int
     fft_filter_fff_impl::nthreads() const
     {
-      if(d_filter)
-	return d_filter->nthreads();
-      else
-	return 0;
+      return d_nthreads;
     }
 
     int
@@ -103,6 +117,14 @@ namespace gr {
       const float *in = (const float *)input_items[0];
       float *out = (float *)output_items[0];
       
+      if (d_regrant){
+	// return the old threads before asking again
+	d_grant = gras::ThreadGrant();
+	d_grant = gras::ThreadGrant(get_uid(), d_nthreads);
+	d_filter->set_nthreads(d_grant.size());
+	d_regrant = false;
+      }
+
       if (d_updated){
 	d_nsamples = d_filter->set_taps(d_new_taps);
 	d_updated = false;
@@ -25,6 +25,7 @@
 #include <filter/api.h>
 #include <filter/fft_filter.h>
 #include <filter/fft_filter_fff.h>
+#include <gras/thread_budget.hpp>
 
 namespace gr {
   namespace filter {
@@ -34,6 +35,9 @@ namespace gr {
     private:
       int d_nsamples;
       bool d_updated;
+      int d_nthreads;		// requested, see d_grant for granted
+      bool d_regrant;
+      gras::ThreadGrant d_grant;
       kernel::fft_filter_fff *d_filter;
       std::vector<float> d_new_taps;
 
@@ -47,6 +51,9 @@ namespace gr {
       void set_taps(const std::vector<float> &taps);
       std::vector<float> taps() const;
 
+      bool start();
+      bool stop();
+
       void set_nthreads(int n);
       int nthreads() const;
       
@@ -27,6 +27,8 @@
 #endif
 
 #include "@IMPL_NAME@.h"
+#include <filter/pm_remez.h>
+#include <filter/tap_designer.h>
 #include <gr_io_signature.h>
 #include <volk/volk.h>
 
@@ -58,6 +60,8 @@ namespace gr {
 
     @IMPL_NAME@::~@IMPL_NAME@()
     {
+      // a design still queued or running would deliver to a dead block
+      tap_designer::instance().cancel(this);
       delete d_fir;
     }
 
@@ -75,6 +79,27 @@ namespace gr {
       return d_fir->taps();
     }
 
+    void
+    @IMPL_NAME@::set_taps_remez(int order,
+				const std::vector<double> &bands,
+				const std::vector<double> &ampl,
+				const std::vector<double> &error_weight,
+				const std::string filter_type,
+				int grid_density)
+    {
+      tap_designer::instance().submit<@TAP_TYPE@, double>
+	(this,
+	 boost::bind(&pm_remez, order, bands, ampl, error_weight,
+		     filter_type, grid_density),
+	 boost::bind(&@IMPL_NAME@::set_taps, this, _1));
+    }
+
+    void
+    @IMPL_NAME@::wait_for_taps()
+    {
+      tap_designer::instance().wait(this);
+    }
+
     int
     @IMPL_NAME@::work(int noutput_items,
 		      gr_vector_const_void_star &input_items,
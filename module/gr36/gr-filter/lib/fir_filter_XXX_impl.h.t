@@ -44,6 +44,14 @@ namespace gr {
 
       void set_taps(const std::vector<@TAP_TYPE@> &taps);
       std::vector<@TAP_TYPE@> taps() const;
+
+      void set_taps_remez(int order,
+			  const std::vector<double> &bands,
+			  const std::vector<double> &ampl,
+			  const std::vector<double> &error_weight,
+			  const std::string filter_type,
+			  int grid_density);
+      void wait_for_taps();
       
       int work(int noutput_items,
 	       gr_vector_const_void_star &input_items,
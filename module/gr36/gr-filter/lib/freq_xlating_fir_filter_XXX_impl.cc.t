@@ -84,7 +84,7 @@ namespace gr {
 
       std::reverse(ctaps.begin(), ctaps.end());
       d_composite_fir->set_taps(ctaps);
-      d_r.set_phase_incr(exp(gr_complex(0, fwT0 * decimation())));
+      d_r.set_freq(-2 * M_PI * d_center_freq / d_sampling_freq * decimation());
     }
 
     void
@@ -131,9 +131,10 @@ namespace gr {
 
       unsigned j = 0;
       for (int i = 0; i < noutput_items; i++){
-	out[i] = d_r.rotate(d_composite_fir->filter(&in[j]));
+	out[i] = d_composite_fir->filter(&in[j]);
 	j += decimation();
       }
+      d_r.rotate(out, out, noutput_items);
 
       return noutput_items;
     }
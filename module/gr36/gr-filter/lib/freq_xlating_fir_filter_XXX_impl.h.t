@@ -31,6 +31,7 @@
 #include <filter/api.h>
 #include <filter/fir_filter.h>
 #include <filter/@BASE_NAME@.h>
+#include <gri_nco_engine.h>
 
 namespace gr {
   namespace filter {
@@ -40,7 +41,7 @@ namespace gr {
     protected:
       std::vector<@TAP_TYPE@>	d_proto_taps;
       kernel::@CFIR_TYPE@      *d_composite_fir;
-      gr_rotator		d_r;
+      gri_nco_engine	d_r;
       double			d_center_freq;
       double			d_sampling_freq;
       bool			d_updated;
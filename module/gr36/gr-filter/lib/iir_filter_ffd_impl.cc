@@ -26,27 +26,30 @@
 
 #include "iir_filter_ffd_impl.h"
 #include <gr_io_signature.h>
+#include <stdexcept>
 
 namespace gr {
   namespace filter {
     
     iir_filter_ffd::sptr
     iir_filter_ffd::make(const std::vector<double> &fftaps,
-			 const std::vector<double> &fbtaps)
+			 const std::vector<double> &fbtaps,
+			 unsigned int vlen)
     {
-      return gnuradio::get_initial_sptr(new iir_filter_ffd_impl(fftaps, fbtaps));
+      return gnuradio::get_initial_sptr(new iir_filter_ffd_impl(fftaps, fbtaps, vlen));
     }
 
     iir_filter_ffd_impl::iir_filter_ffd_impl(const std::vector<double> &fftaps,
-					     const std::vector<double> &fbtaps)
+					     const std::vector<double> &fbtaps,
+					     unsigned int vlen)
 
       : gr_sync_block("iir_filter_ffd",
-		      gr_make_io_signature(1, 1, sizeof (float)),
-		      gr_make_io_signature(1, 1, sizeof (float))),
-	d_updated(false)
+		      gr_make_io_signature(1, 1, sizeof (float)*vlen),
+		      gr_make_io_signature(1, 1, sizeof (float)*vlen)),
+	d_updated(false), d_new_is_sections(false)
     {
-      d_iir = new kernel::iir_filter<float,float,double>(fftaps, fbtaps);
-      //d_iir = new gri_iir<float,float,double>(fftaps, fbtaps);
+      d_iir = new kernel::biquad_cascade(vlen);
+      d_iir->set_taps(fftaps, fbtaps);
     }
 
     iir_filter_ffd_impl::~iir_filter_ffd_impl()
@@ -58,8 +61,25 @@ namespace gr {
     iir_filter_ffd_impl::set_taps(const std::vector<double> &fftaps,
 				  const std::vector<double> &fbtaps)
     {
+      gruel::scoped_lock l(d_setlock);
       d_new_fftaps = fftaps;
       d_new_fbtaps = fbtaps;
+      d_new_is_sections = false;
+      d_updated = true;
+    }
+
+    void
+    iir_filter_ffd_impl::set_sections(const std::vector< std::vector<double> > &sections)
+    {
+      // check here, the sections are installed later in work
+      for(size_t i = 0; i < sections.size(); i++) {
+	if(sections[i].size() != 5)
+	  throw std::invalid_argument("iir_filter_ffd: a section is {b0, b1, b2, a1, a2}");
+      }
+
+      gruel::scoped_lock l(d_setlock);
+      d_new_sections = sections;
+      d_new_is_sections = true;
       d_updated = true;
     }
 
@@ -71,8 +91,12 @@ namespace gr {
       const float *in = (const float*)input_items[0];
       float *out = (float*)output_items[0];
 
+      gruel::scoped_lock l(d_setlock);
       if(d_updated) {
-	d_iir->set_taps(d_new_fftaps, d_new_fbtaps);
+	if(d_new_is_sections)
+	  d_iir->set_sections(d_new_sections);
+	else
+	  d_iir->set_taps(d_new_fftaps, d_new_fbtaps);
 	d_updated = false;
       }
 
@@ -23,7 +23,7 @@
 #ifndef INCLUDED_IIR_FILTER_FFD_IMPL_H
 #define	INCLUDED_IIR_FILTER_FFD_IMPL_H
 
-#include <filter/iir_filter.h>
+#include <filter/biquad_cascade.h>
 #include <filter/iir_filter_ffd.h>
 
 namespace gr {
@@ -33,17 +33,21 @@ namespace gr {
     {
     private:
       bool d_updated;
-      kernel::iir_filter<float,float,double> *d_iir;
+      kernel::biquad_cascade *d_iir;
       std::vector<double> d_new_fftaps;
       std::vector<double> d_new_fbtaps;
+      std::vector< std::vector<double> > d_new_sections;
+      bool d_new_is_sections;
 
     public:
       iir_filter_ffd_impl(const std::vector<double> &fftaps,
-			  const std::vector<double> &fbtaps);
+			  const std::vector<double> &fbtaps,
+			  unsigned int vlen);
       ~iir_filter_ffd_impl();
 
       void set_taps(const std::vector<double> &fftaps,
 		    const std::vector<double> &fbtaps);
+      void set_sections(const std::vector< std::vector<double> > &sections);
 
       int work(int noutput_items,
 	       gr_vector_const_void_star &input_items,
@@ -33,18 +33,14 @@ namespace gr {
     
     mmse_fir_interpolator_cc::mmse_fir_interpolator_cc()
     {
-      filters.resize (NSTEPS + 1);
-
-      for(int i = 0; i < NSTEPS + 1; i++) {
-	std::vector<float> t (&taps[i][0], &taps[i][NTAPS]);
-	filters[i] = new kernel::fir_filter_ccf(1, t);
-      }
+      std::vector< std::vector<float> > t(NSTEPS + 1);
+      for(int i = 0; i < NSTEPS + 1; i++)
+	t[i].assign(&taps[i][0], &taps[i][NTAPS]);
+      d_engine.set_taps(t);
     }
 
     mmse_fir_interpolator_cc::~mmse_fir_interpolator_cc()
     {
-      for(int i = 0; i < NSTEPS + 1; i++)
-	delete filters[i];
     }
 
     unsigned
@@ -69,8 +65,7 @@ namespace gr {
 	throw std::runtime_error("mmse_fir_interpolator_cc: imu out of bounds.\n");
       }
 
-      gr_complex r = filters[imu]->filter(input);
-      return r;
+      return d_engine.filter(imu, input);
     }
 
   }  /* namespace filter */
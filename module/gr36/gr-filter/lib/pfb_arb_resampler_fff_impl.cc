@@ -67,35 +67,18 @@ namespace gr {
 
       d_start_index = 0;
 
-      d_filters = std::vector<kernel::fir_filter_fff*>(d_int_rate);
-      d_diff_filters = std::vector<kernel::fir_filter_fff*>(d_int_rate);
-
-      // Create an FIR filter for each channel and zero out the taps
-      std::vector<float> vtaps(0, d_int_rate);
-      for(unsigned int i = 0; i < d_int_rate; i++) {
-	d_filters[i] = new kernel::fir_filter_fff(1, vtaps);
-	d_diff_filters[i] = new kernel::fir_filter_fff(1, vtaps);
-      }
-
       // Now, actually set the filters' taps
-      std::vector<float> dtaps;
-      create_diff_taps(taps, dtaps);
-      create_taps(taps, d_taps, d_filters);
-      create_taps(dtaps, d_dtaps, d_diff_filters);
+      set_taps(taps);
+      d_updated = false;
     }
 
     pfb_arb_resampler_fff_impl::~pfb_arb_resampler_fff_impl()
     {
-      for(unsigned int i = 0; i < d_int_rate; i++) {
-	delete d_filters[i];
-	delete d_diff_filters[i];
-      }
     }
 
     void
     pfb_arb_resampler_fff_impl::create_taps(const std::vector<float> &newtaps,
-					    std::vector< std::vector<float> > &ourtaps,
-					    std::vector<kernel::fir_filter_fff*> &ourfilter)
+					    std::vector< std::vector<float> > &ourtaps)
     {
       unsigned int ntaps = newtaps.size();
       d_taps_per_filter = (unsigned int)ceil((double)ntaps/(double)d_int_rate);
@@ -118,15 +101,7 @@ namespace gr {
 	for(unsigned int j = 0; j < d_taps_per_filter; j++) {
 	  ourtaps[d_int_rate - 1 - i][j] = tmp_taps[i + j*d_int_rate];
 	}
-
-	// Build a filter for each channel and add it's taps to it
-	ourfilter[i]->set_taps(ourtaps[d_int_rate-1-i]);
       }
-
-      // Set the history to ensure enough input items for each filter
-      set_history(d_taps_per_filter + 1);
-
-      d_updated = true;
     }
 
     void
@@ -144,10 +119,31 @@ namespace gr {
       difftaps.push_back(tap);
     }
 
+    void
+    pfb_arb_resampler_fff_impl::install_taps()
+    {
+      std::vector< std::vector<float> > taps(d_int_rate), dtaps(d_int_rate);
+      for(unsigned int i = 0; i < d_int_rate; i++) {
+	taps[i] = d_taps[d_int_rate-1-i];
+	dtaps[i] = d_dtaps[d_int_rate-1-i];
+      }
+      d_engine.set_taps(taps, dtaps);
+    }
+
     void
     pfb_arb_resampler_fff_impl::set_taps(const std::vector<float> &taps)
     {
       gruel::scoped_lock guard(d_mutex);
+
+      std::vector<float> dtaps;
+      create_diff_taps(taps, dtaps);
+      create_taps(taps, d_taps);
+      create_taps(dtaps, d_dtaps);
+      install_taps();
+
+      // Set the history to ensure enough input items for each filter
+      set_history(d_taps_per_filter + 1);
+      d_updated = true;
     }
  
     std::vector<std::vector<float> >
@@ -187,14 +183,14 @@ namespace gr {
 	throw std::runtime_error("pfb_arb_resampler_ccf: set_phase value out of bounds [0, 2pi).\n");
       }
       
-      float ph_diff = 2.0*M_PI / (float)d_filters.size();
+      float ph_diff = 2.0*M_PI / (float)d_int_rate;
       d_last_filter = static_cast<int>(ph / ph_diff);
     }
 
     float
     pfb_arb_resampler_fff_impl::phase() const
     {
-      float ph_diff = 2.0*M_PI / static_cast<float>(d_filters.size());
+      float ph_diff = 2.0*M_PI / static_cast<float>(d_int_rate);
       return d_last_filter * ph_diff;
     }
 
@@ -214,36 +210,15 @@ namespace gr {
 	return 0;		     // history requirements may have changed.
       }
 
-      int i = 0, count = d_start_index;
-      unsigned int j;
-      float o0, o1;
+      int count = d_start_index;
 
       // Restore the last filter position
-      j = d_last_filter;
+      unsigned int j = d_last_filter;
 
       // produce output as long as we can and there are enough input samples
       int max_input = ninput_items[0] - (int)d_taps_per_filter;
-      while((i < noutput_items) && (count < max_input)) {
-	// start j by wrapping around mod the number of channels
-	while((j < d_int_rate) && (i < noutput_items)) {
-	  // Take the current filter and derivative filter output
-	  o0 = d_filters[j]->filter(&in[count]);
-	  o1 = d_diff_filters[j]->filter(&in[count]);
-
-	  out[i] = o0 + o1*d_acc;     // linearly interpolate between samples
-	  i++;
-
-	  // Adjust accumulator and index into filterbank
-	  d_acc += d_flt_rate;
-	  j += d_dec_rate + (int)floor(d_acc);
-	  d_acc = fmodf(d_acc, 1.0);
-	}
-	if(i < noutput_items) {              // keep state for next entry
-	  float ss = (int)(j / d_int_rate);  // number of items to skip ahead by
-	  count += ss;                       // we have fully consumed another input
-	  j = j % d_int_rate;                // roll filter around
-	}
-      }
+      int i = d_engine.resample(out, noutput_items, in, max_input,
+				d_dec_rate, d_flt_rate, count, j, d_acc);
 
       // Store the current filter position and start of next sample
       d_last_filter = j;
@@ -25,7 +25,7 @@
 #define	INCLUDED_PFB_ARB_RESAMPLER_FFF_IMPL_H
 
 #include <filter/pfb_arb_resampler_fff.h>
-#include <filter/fir_filter.h>
+#include <filter/polyphase_engine.h>
 #include <gruel/thread.h>
 
 namespace gr {
@@ -34,8 +34,7 @@ namespace gr {
     class FILTER_API pfb_arb_resampler_fff_impl : public pfb_arb_resampler_fff
     {
     private:
-      std::vector<kernel::fir_filter_fff*> d_filters;
-      std::vector<kernel::fir_filter_fff*> d_diff_filters;
+      kernel::polyphase_engine_fff d_engine;
       std::vector< std::vector<float> > d_taps;
       std::vector< std::vector<float> > d_dtaps;
       unsigned int d_int_rate;          // the number of filters (interpolation rate)
@@ -52,15 +51,19 @@ namespace gr {
 			    std::vector<float> &difftaps);
 
       /*!
-       * Resets the filterbank's filter taps with the new prototype filter
+       * Partitions the prototype filter into the filterbank
        * \param newtaps    (vector of floats) The prototype filter to populate the filterbank.
        *                   The taps should be generated at the interpolated sampling rate.
        * \param ourtaps    (vector of floats) Reference to our internal member of holding the taps.
-       * \param ourfilter  (vector of filters) Reference to our internal filter to set the taps for.
        */
       void create_taps(const std::vector<float> &newtaps,
-		       std::vector< std::vector<float> > &ourtaps,
-		       std::vector<kernel::fir_filter_fff*> &ourfilter);
+		       std::vector< std::vector<float> > &ourtaps);
+
+      /*!
+       * Loads d_taps and d_dtaps into the engine, phase i of the
+       * engine being filter i of the filterbank.
+       */
+      void install_taps();
     public:
       pfb_arb_resampler_fff_impl(float rate,
 				 const std::vector<float> &taps,
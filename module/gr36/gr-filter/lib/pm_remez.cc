@@ -42,6 +42,7 @@
 #endif
 
 #include <filter/pm_remez.h>
+#include <filter/tap_cache.h>
 #include <cmath>
 #include <assert.h>
 #include <iostream>
@@ -752,14 +753,13 @@ namespace gr {
       throw std::runtime_error(msg);
     }
 
-    std::vector<double>
-    pm_remez(int order,
-	     const std::vector<double> &arg_bands,
-	     const std::vector<double> &arg_response,
-	     const std::vector<double> &arg_weight,
-	     const std::string filter_type,
-	     int grid_density
-	     ) throw (std::runtime_error)
+    static std::vector<double>
+    design(int order,
+	   const std::vector<double> &arg_bands,
+	   const std::vector<double> &arg_response,
+	   const std::vector<double> &arg_weight,
+	   const std::string filter_type,
+	   int grid_density)
     {
       int numtaps = order + 1;
       if(numtaps < 4)
@@ -830,5 +830,35 @@ namespace gr {
       return std::vector<double>(&coeff[0], &coeff[numtaps]);
     }
 
+    std::vector<double>
+    pm_remez(int order,
+	     const std::vector<double> &arg_bands,
+	     const std::vector<double> &arg_response,
+	     const std::vector<double> &arg_weight,
+	     const std::string filter_type,
+	     int grid_density
+	     ) throw (std::runtime_error)
+    {
+      std::vector<double> params;
+      params.push_back(order);
+      params.push_back(grid_density);
+      params.push_back(arg_bands.size());
+      params.insert(params.end(), arg_bands.begin(), arg_bands.end());
+      params.push_back(arg_response.size());
+      params.insert(params.end(), arg_response.begin(), arg_response.end());
+      params.push_back(arg_weight.size());
+      params.insert(params.end(), arg_weight.begin(), arg_weight.end());
+      const std::string key = tap_cache::make_key("pm_remez " + filter_type, params);
+
+      std::vector<double> taps;
+      if(tap_cache::lookup(key, taps))
+	return taps;
+
+      taps = design(order, arg_bands, arg_response, arg_weight,
+		    filter_type, grid_density);
+      tap_cache::store(key, taps);
+      return taps;
+    }
+
   } /* namespace filter */
 } /* namespace gr */
@@ -0,0 +1,512 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <filter/polyphase_engine.h>
+#include <fft/fft.h>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace gr {
+  namespace filter {
+    namespace kernel {
+
+      /*
+       * Checks the shape of a bank and returns its number of taps.
+       */
+      static unsigned int
+      bank_ntaps(const std::vector< std::vector<float> > &taps,
+		 const std::vector< std::vector<float> > &diff_taps)
+      {
+	const unsigned int ntaps = taps.empty() ? 0 : taps[0].size();
+	for(size_t i = 0; i < taps.size(); i++) {
+	  if(taps[i].size() != ntaps)
+	    throw std::invalid_argument("polyphase_engine: all phases must have the same number of taps");
+	}
+	if(!diff_taps.empty()) {
+	  if(diff_taps.size() != taps.size())
+	    throw std::invalid_argument("polyphase_engine: derivative bank must match the filter bank");
+	  for(size_t i = 0; i < diff_taps.size(); i++) {
+	    if(diff_taps[i].size() != ntaps)
+	      throw std::invalid_argument("polyphase_engine: derivative bank must match the filter bank");
+	  }
+	}
+	return ntaps;
+      }
+
+      /*
+       * Lays out one bank with each phase reversed, every tap
+       * repeated dup times and each phase padded to stride floats.
+       */
+      static float *
+      make_table(const std::vector< std::vector<float> > &taps,
+		 unsigned int ntaps, unsigned int stride, unsigned int dup)
+      {
+	const size_t len = std::max((size_t)1, taps.size()*stride);
+	float *table = fft::malloc_float(len);
+	memset(table, 0, len*sizeof(float));
+	for(size_t p = 0; p < taps.size(); p++) {
+	  for(unsigned int k = 0; k < ntaps; k++) {
+	    for(unsigned int d = 0; d < dup; d++)
+	      table[p*stride + k*dup + d] = taps[p][ntaps-1-k];
+	  }
+	}
+	return table;
+      }
+
+#ifdef __SSE2__
+      static inline float
+      hsum_ps(__m128 v)
+      {
+	v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+	return _mm_cvtss_f32(v);
+      }
+
+      // lanes (re, im, re, im) summed to one complex value
+      static inline gr_complex
+      hsum_pc(__m128 v)
+      {
+	v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	return gr_complex(_mm_cvtss_f32(v), _mm_cvtss_f32(_mm_shuffle_ps(v, v, 1)));
+      }
+#endif
+
+      polyphase_engine_ccf::polyphase_engine_ccf()
+	: d_nphases(0), d_ntaps(0), d_stride(0),
+	  d_taps(NULL), d_diff_taps(NULL)
+      {
+      }
+
+      polyphase_engine_ccf::~polyphase_engine_ccf()
+      {
+	if(d_taps != NULL)
+	  fft::free(d_taps);
+	if(d_diff_taps != NULL)
+	  fft::free(d_diff_taps);
+      }
+
+      void
+      polyphase_engine_ccf::set_taps(const std::vector< std::vector<float> > &taps,
+				     const std::vector< std::vector<float> > &diff_taps)
+      {
+	const unsigned int ntaps = bank_ntaps(taps, diff_taps);
+
+	if(d_taps != NULL)
+	  fft::free(d_taps);
+	if(d_diff_taps != NULL)
+	  fft::free(d_diff_taps);
+	d_diff_taps = NULL;
+
+	d_nphases = taps.size();
+	d_ntaps = ntaps;
+	d_stride = (2*ntaps + 3) & ~3u;
+	d_taps = make_table(taps, ntaps, d_stride, 2);
+	if(!diff_taps.empty())
+	  d_diff_taps = make_table(diff_taps, ntaps, d_stride, 2);
+      }
+
+      gr_complex
+      polyphase_engine_ccf::filter(unsigned int phase, const gr_complex input[]) const
+      {
+	const float *t = d_taps + phase*d_stride;
+	unsigned int k = 0;
+	gr_complex sum(0, 0);
+
+#ifdef __SSE2__
+	const float *x = (const float *)input;
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	for(; k + 4 <= d_ntaps; k += 4) {
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(x + 2*k), _mm_load_ps(t + 2*k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(x + 2*k + 4), _mm_load_ps(t + 2*k + 4)));
+	}
+	for(; k + 2 <= d_ntaps; k += 2)
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(x + 2*k), _mm_load_ps(t + 2*k)));
+	sum = hsum_pc(_mm_add_ps(a0, a1));
+#endif
+
+	for(; k < d_ntaps; k++)
+	  sum += input[k] * t[2*k];
+	return sum;
+      }
+
+      gr_complex
+      polyphase_engine_ccf::filter(unsigned int phase, float mu, const gr_complex input[]) const
+      {
+	if(d_diff_taps == NULL)
+	  return filter(phase, input);
+
+	const float *t = d_taps + phase*d_stride;
+	const float *dt = d_diff_taps + phase*d_stride;
+	unsigned int k = 0;
+	gr_complex s0(0, 0), s1(0, 0);
+
+#ifdef __SSE2__
+	const float *x = (const float *)input;
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	__m128 b0 = _mm_setzero_ps(), b1 = _mm_setzero_ps();
+	for(; k + 4 <= d_ntaps; k += 4) {
+	  const __m128 xv0 = _mm_loadu_ps(x + 2*k);
+	  const __m128 xv1 = _mm_loadu_ps(x + 2*k + 4);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(xv0, _mm_load_ps(t + 2*k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(xv0, _mm_load_ps(dt + 2*k)));
+	  b0 = _mm_add_ps(b0, _mm_mul_ps(xv1, _mm_load_ps(t + 2*k + 4)));
+	  b1 = _mm_add_ps(b1, _mm_mul_ps(xv1, _mm_load_ps(dt + 2*k + 4)));
+	}
+	for(; k + 2 <= d_ntaps; k += 2) {
+	  const __m128 xv = _mm_loadu_ps(x + 2*k);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(xv, _mm_load_ps(t + 2*k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(xv, _mm_load_ps(dt + 2*k)));
+	}
+	s0 = hsum_pc(_mm_add_ps(a0, b0));
+	s1 = hsum_pc(_mm_add_ps(a1, b1));
+#endif
+
+	for(; k < d_ntaps; k++) {
+	  s0 += input[k] * t[2*k];
+	  s1 += input[k] * dt[2*k];
+	}
+	return s0 + s1*mu;
+      }
+
+      void
+      polyphase_engine_ccf::filter2(unsigned int p0, float mu0, const gr_complex in0[],
+				    unsigned int p1, float mu1, const gr_complex in1[],
+				    gr_complex &o0, gr_complex &o1) const
+      {
+	if(d_diff_taps == NULL) {
+	  o0 = filter(p0, in0);
+	  o1 = filter(p1, in1);
+	  return;
+	}
+
+	const float *t0 = d_taps + p0*d_stride;
+	const float *d0 = d_diff_taps + p0*d_stride;
+	const float *t1 = d_taps + p1*d_stride;
+	const float *d1 = d_diff_taps + p1*d_stride;
+	unsigned int k = 0;
+	gr_complex s0(0, 0), s1(0, 0), s2(0, 0), s3(0, 0);
+
+#ifdef __SSE2__
+	const float *x0 = (const float *)in0;
+	const float *x1 = (const float *)in1;
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	__m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+	for(; k + 2 <= d_ntaps; k += 2) {
+	  const __m128 xv0 = _mm_loadu_ps(x0 + 2*k);
+	  const __m128 xv1 = _mm_loadu_ps(x1 + 2*k);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(xv0, _mm_load_ps(t0 + 2*k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(xv0, _mm_load_ps(d0 + 2*k)));
+	  a2 = _mm_add_ps(a2, _mm_mul_ps(xv1, _mm_load_ps(t1 + 2*k)));
+	  a3 = _mm_add_ps(a3, _mm_mul_ps(xv1, _mm_load_ps(d1 + 2*k)));
+	}
+	s0 = hsum_pc(a0);
+	s1 = hsum_pc(a1);
+	s2 = hsum_pc(a2);
+	s3 = hsum_pc(a3);
+#endif
+
+	for(; k < d_ntaps; k++) {
+	  s0 += in0[k] * t0[2*k];
+	  s1 += in0[k] * d0[2*k];
+	  s2 += in1[k] * t1[2*k];
+	  s3 += in1[k] * d1[2*k];
+	}
+	o0 = s0 + s1*mu0;
+	o1 = s2 + s3*mu1;
+      }
+
+      int
+      polyphase_engine_ccf::resample(gr_complex output[], int noutput_items,
+				     const gr_complex input[], int max_input,
+				     unsigned int dec_rate, float flt_rate,
+				     int &count, unsigned int &phase, float &acc) const
+      {
+	int i = 0, c = count;
+	unsigned int j = phase;
+	float a = acc;
+
+	while((i < noutput_items) && (c < max_input)) {
+	  if(j >= d_nphases) {
+	    c += j / d_nphases;  // we have fully consumed another input
+	    j = j % d_nphases;   // roll filter around
+	    continue;
+	  }
+
+	  // the state after one more step, acc stays in [0, 1)
+	  int c1 = c;
+	  unsigned int j1 = j + dec_rate;
+	  float a1 = a + flt_rate;
+	  if(a1 >= 1.0f) {
+	    a1 -= 1.0f;
+	    j1++;
+	  }
+
+	  if(i + 1 == noutput_items) {
+	    output[i++] = filter(j, a, &input[c]);
+	    j = j1;
+	    a = a1;
+	    break;
+	  }
+
+	  c1 += j1 / d_nphases;
+	  j1 = j1 % d_nphases;
+	  if(c1 >= max_input) {
+	    output[i++] = filter(j, a, &input[c]);
+	    c = c1;
+	    j = j1;
+	    a = a1;
+	    break;
+	  }
+
+	  // two outputs per pass, c1 == c while interpolating
+	  filter2(j, a, &input[c], j1, a1, &input[c1], output[i], output[i+1]);
+	  i += 2;
+	  c = c1;
+	  j = j1 + dec_rate;
+	  a = a1 + flt_rate;
+	  if(a >= 1.0f) {
+	    a -= 1.0f;
+	    j++;
+	  }
+	}
+
+	count = c;
+	phase = j;
+	acc = a;
+	return i;
+      }
+
+      /**************************************************************/
+
+      polyphase_engine_fff::polyphase_engine_fff()
+	: d_nphases(0), d_ntaps(0), d_stride(0),
+	  d_taps(NULL), d_diff_taps(NULL)
+      {
+      }
+
+      polyphase_engine_fff::~polyphase_engine_fff()
+      {
+	if(d_taps != NULL)
+	  fft::free(d_taps);
+	if(d_diff_taps != NULL)
+	  fft::free(d_diff_taps);
+      }
+
+      void
+      polyphase_engine_fff::set_taps(const std::vector< std::vector<float> > &taps,
+				     const std::vector< std::vector<float> > &diff_taps)
+      {
+	const unsigned int ntaps = bank_ntaps(taps, diff_taps);
+
+	if(d_taps != NULL)
+	  fft::free(d_taps);
+	if(d_diff_taps != NULL)
+	  fft::free(d_diff_taps);
+	d_diff_taps = NULL;
+
+	d_nphases = taps.size();
+	d_ntaps = ntaps;
+	d_stride = (ntaps + 3) & ~3u;
+	d_taps = make_table(taps, ntaps, d_stride, 1);
+	if(!diff_taps.empty())
+	  d_diff_taps = make_table(diff_taps, ntaps, d_stride, 1);
+      }
+
+      float
+      polyphase_engine_fff::filter(unsigned int phase, const float input[]) const
+      {
+	const float *t = d_taps + phase*d_stride;
+	unsigned int k = 0;
+	float sum = 0;
+
+#ifdef __SSE2__
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	for(; k + 8 <= d_ntaps; k += 8) {
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(input + k), _mm_load_ps(t + k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_loadu_ps(input + k + 4), _mm_load_ps(t + k + 4)));
+	}
+	for(; k + 4 <= d_ntaps; k += 4)
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_loadu_ps(input + k), _mm_load_ps(t + k)));
+	sum = hsum_ps(_mm_add_ps(a0, a1));
+#endif
+
+	for(; k < d_ntaps; k++)
+	  sum += input[k] * t[k];
+	return sum;
+      }
+
+      float
+      polyphase_engine_fff::filter(unsigned int phase, float mu, const float input[]) const
+      {
+	if(d_diff_taps == NULL)
+	  return filter(phase, input);
+
+	const float *t = d_taps + phase*d_stride;
+	const float *dt = d_diff_taps + phase*d_stride;
+	unsigned int k = 0;
+	float s0 = 0, s1 = 0;
+
+#ifdef __SSE2__
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	__m128 b0 = _mm_setzero_ps(), b1 = _mm_setzero_ps();
+	for(; k + 8 <= d_ntaps; k += 8) {
+	  const __m128 xv0 = _mm_loadu_ps(input + k);
+	  const __m128 xv1 = _mm_loadu_ps(input + k + 4);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(xv0, _mm_load_ps(t + k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(xv0, _mm_load_ps(dt + k)));
+	  b0 = _mm_add_ps(b0, _mm_mul_ps(xv1, _mm_load_ps(t + k + 4)));
+	  b1 = _mm_add_ps(b1, _mm_mul_ps(xv1, _mm_load_ps(dt + k + 4)));
+	}
+	for(; k + 4 <= d_ntaps; k += 4) {
+	  const __m128 xv = _mm_loadu_ps(input + k);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(xv, _mm_load_ps(t + k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(xv, _mm_load_ps(dt + k)));
+	}
+	s0 = hsum_ps(_mm_add_ps(a0, b0));
+	s1 = hsum_ps(_mm_add_ps(a1, b1));
+#endif
+
+	for(; k < d_ntaps; k++) {
+	  s0 += input[k] * t[k];
+	  s1 += input[k] * dt[k];
+	}
+	return s0 + s1*mu;
+      }
+
+      void
+      polyphase_engine_fff::filter2(unsigned int p0, float mu0, const float in0[],
+				    unsigned int p1, float mu1, const float in1[],
+				    float &o0, float &o1) const
+      {
+	if(d_diff_taps == NULL) {
+	  o0 = filter(p0, in0);
+	  o1 = filter(p1, in1);
+	  return;
+	}
+
+	const float *t0 = d_taps + p0*d_stride;
+	const float *d0 = d_diff_taps + p0*d_stride;
+	const float *t1 = d_taps + p1*d_stride;
+	const float *d1 = d_diff_taps + p1*d_stride;
+	unsigned int k = 0;
+	float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+#ifdef __SSE2__
+	__m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+	__m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+	for(; k + 4 <= d_ntaps; k += 4) {
+	  const __m128 xv0 = _mm_loadu_ps(in0 + k);
+	  const __m128 xv1 = _mm_loadu_ps(in1 + k);
+	  a0 = _mm_add_ps(a0, _mm_mul_ps(xv0, _mm_load_ps(t0 + k)));
+	  a1 = _mm_add_ps(a1, _mm_mul_ps(xv0, _mm_load_ps(d0 + k)));
+	  a2 = _mm_add_ps(a2, _mm_mul_ps(xv1, _mm_load_ps(t1 + k)));
+	  a3 = _mm_add_ps(a3, _mm_mul_ps(xv1, _mm_load_ps(d1 + k)));
+	}
+	s0 = hsum_ps(a0);
+	s1 = hsum_ps(a1);
+	s2 = hsum_ps(a2);
+	s3 = hsum_ps(a3);
+#endif
+
+	for(; k < d_ntaps; k++) {
+	  s0 += in0[k] * t0[k];
+	  s1 += in0[k] * d0[k];
+	  s2 += in1[k] * t1[k];
+	  s3 += in1[k] * d1[k];
+	}
+	o0 = s0 + s1*mu0;
+	o1 = s2 + s3*mu1;
+      }
+
+      int
+      polyphase_engine_fff::resample(float output[], int noutput_items,
+				     const float input[], int max_input,
+				     unsigned int dec_rate, float flt_rate,
+				     int &count, unsigned int &phase, float &acc) const
+      {
+	int i = 0, c = count;
+	unsigned int j = phase;
+	float a = acc;
+
+	while((i < noutput_items) && (c < max_input)) {
+	  if(j >= d_nphases) {
+	    c += j / d_nphases;  // we have fully consumed another input
+	    j = j % d_nphases;   // roll filter around
+	    continue;
+	  }
+
+	  // the state after one more step, acc stays in [0, 1)
+	  int c1 = c;
+	  unsigned int j1 = j + dec_rate;
+	  float a1 = a + flt_rate;
+	  if(a1 >= 1.0f) {
+	    a1 -= 1.0f;
+	    j1++;
+	  }
+
+	  if(i + 1 == noutput_items) {
+	    output[i++] = filter(j, a, &input[c]);
+	    j = j1;
+	    a = a1;
+	    break;
+	  }
+
+	  c1 += j1 / d_nphases;
+	  j1 = j1 % d_nphases;
+	  if(c1 >= max_input) {
+	    output[i++] = filter(j, a, &input[c]);
+	    c = c1;
+	    j = j1;
+	    a = a1;
+	    break;
+	  }
+
+	  // two outputs per pass, c1 == c while interpolating
+	  filter2(j, a, &input[c], j1, a1, &input[c1], output[i], output[i+1]);
+	  i += 2;
+	  c = c1;
+	  j = j1 + dec_rate;
+	  a = a1 + flt_rate;
+	  if(a >= 1.0f) {
+	    a -= 1.0f;
+	    j++;
+	  }
+	}
+
+	count = c;
+	phase = j;
+	acc = a;
+	return i;
+      }
+
+    } /* namespace kernel */
+  } /* namespace filter */
+} /* namespace gr */
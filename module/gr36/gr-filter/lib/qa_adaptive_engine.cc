@@ -0,0 +1,281 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cppunit/TestAssert.h>
+#include <qa_adaptive_engine.h>
+#include <filter/adaptive_engine.h>
+#include <gr_complex.h>
+#include <random.h>
+#include <stdexcept>
+#include <cmath>
+
+namespace gr {
+  namespace filter {
+
+    using namespace kernel;
+
+    static float
+    uniform()
+    {
+      return 2.0 * ((float)random() / RANDOM_MAX - 0.5);  // uniformly (-1, 1)
+    }
+
+    static gr_complex
+    random_complex()
+    {
+      return gr_complex(uniform(), uniform());
+    }
+
+    static std::vector<gr_complex>
+    random_vector(size_t n)
+    {
+      std::vector<gr_complex> v(n);
+      for(size_t i = 0; i < n; i++)
+	v[i] = random_complex();
+      return v;
+    }
+
+    static void add_update(gr_complex &tap, gr_complex g) { tap += g; }
+    static void add_update(float &tap, gr_complex g) { tap += g.real(); }
+
+    // the per tap loop of gr_adaptive_fir_ccc, taps in fir_filter order
+    template <class T, class E>
+    static void
+    ref_adapt(std::vector<T> &taps, const E &error, float mu, unsigned int block_size,
+	      gr_complex out[], const gr_complex in[], const gr_complex desired[],
+	      int n, unsigned int decimation)
+    {
+      const unsigned int l = taps.size();
+      std::vector<gr_complex> grad(l, 0);
+      unsigned int count = 0;
+      for(int i = 0; i < n; i++) {
+	const gr_complex *x = &in[i * decimation];
+	gr_complex acc = 0;
+	for(unsigned int k = 0; k < l; k++)
+	  acc += taps[l-k-1] * x[k];
+	out[i] = acc;
+
+	const gr_complex e = mu * error.scale(x, l) *
+	  error(acc, E::blind ? gr_complex(0) : desired[i]);
+	for(unsigned int k = 0; k < l; k++)
+	  grad[l-k-1] += e * std::conj(x[k]);
+	if(++count == block_size) {
+	  for(unsigned int k = 0; k < l; k++) {
+	    add_update(taps[k], grad[k]);
+	    grad[k] = 0;
+	  }
+	  count = 0;
+	}
+      }
+    }
+
+    template <class T>
+    static double
+    max_diff(const std::vector<T> &a, const std::vector<T> &b)
+    {
+      double d = 0;
+      for(size_t i = 0; i < a.size(); i++)
+	d = std::max(d, (double) std::abs(a[i] - b[i]));
+      return d;
+    }
+
+    /*
+     * The vector primitives against scalar loops, every length
+     * around the vector widths.
+     */
+    void
+    qa_adaptive_engine::t1()
+    {
+      for(unsigned int n = 0; n < 14; n++) {
+	const std::vector<gr_complex> x = random_vector(n + 1);
+	std::vector<gr_complex> ct = random_vector(n + 1), ct2(ct);
+	std::vector<float> ft(n + 1), ft2;
+	for(unsigned int k = 0; k <= n; k++)
+	  ft[k] = uniform();
+	ft2 = ft;
+	const gr_complex a = random_complex();
+
+	gr_complex cdot = 0, fdot = 0;
+	float energy = 0;
+	for(unsigned int k = 0; k < n; k++) {
+	  cdot += ct[k] * x[k];
+	  fdot += ft[k] * x[k];
+	  energy += std::norm(x[k]);
+	  ct2[k] += a * std::conj(x[k]);
+	  ft2[k] += (a * std::conj(x[k])).real();
+	}
+	CPPUNIT_ASSERT(std::abs(cdot - adaptive_dot(&ct[0], &x[0], n)) < 1e-5);
+	CPPUNIT_ASSERT(std::abs(fdot - adaptive_dot(&ft[0], &x[0], n)) < 1e-5);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(energy, adaptive_energy(&x[0], n), 1e-5);
+
+	adaptive_axpy(&ct[0], a, &x[0], n);
+	adaptive_axpy(&ft[0], a, &x[0], n);
+	// element n is past the end and must not move
+	CPPUNIT_ASSERT(max_diff(ct, ct2) < 1e-6);
+	CPPUNIT_ASSERT(max_diff(ft, ft2) < 1e-6);
+      }
+    }
+
+    /*
+     * LMS and NLMS, complex and real taps, with and without
+     * decimation, against the per tap loop.
+     */
+    void
+    qa_adaptive_engine::t2()
+    {
+      const int N = 300;
+      const unsigned int ntaps = 11;
+      const std::vector<gr_complex> in = random_vector(2 * N + ntaps);
+      const std::vector<gr_complex> desired = random_vector(N);
+      std::vector<gr_complex> expect(N), actual(N);
+
+      for(unsigned int dec = 1; dec <= 2; dec++) {
+	std::vector<gr_complex> ctaps = random_vector(ntaps);
+	adaptive_engine<gr_complex, lms_error> lms(ctaps, 0.01f);
+	ref_adapt(ctaps, lms_error(), 0.01f, 1, &expect[0], &in[0], &desired[0], N, dec);
+	// uneven calls, state carries
+	lms.filter_n(&actual[0], &in[0], &desired[0], 7, dec);
+	lms.filter_n(&actual[7], &in[7 * dec], &desired[7], N - 7, dec);
+	CPPUNIT_ASSERT(max_diff(expect, actual) < 1e-4);
+	CPPUNIT_ASSERT(max_diff(ctaps, lms.taps()) < 1e-4);
+
+	std::vector<float> ftaps(ntaps, 0.0f);
+	ftaps[ntaps / 2] = 1;
+	adaptive_engine<float, nlms_error> nlms(ftaps, 0.1f);
+	ref_adapt(ftaps, nlms_error(), 0.1f, 1, &expect[0], &in[0], &desired[0], N, dec);
+	nlms.filter_n(&actual[0], &in[0], &desired[0], N, dec);
+	CPPUNIT_ASSERT(max_diff(expect, actual) < 1e-4);
+	CPPUNIT_ASSERT(max_diff(ftaps, nlms.taps()) < 1e-4);
+      }
+    }
+
+    /*
+     * Block updates: the taps change only every block_size outputs.
+     */
+    void
+    qa_adaptive_engine::t3()
+    {
+      const int N = 203;
+      const unsigned int ntaps = 8, K = 4;
+      const std::vector<gr_complex> in = random_vector(N + ntaps);
+      std::vector<gr_complex> expect(N), actual(N);
+
+      std::vector<gr_complex> taps(ntaps, gr_complex(0, 0));
+      taps[3] = 1;
+      adaptive_engine<gr_complex, cma_error> cma(taps, 0.005f, K, cma_error(2.0f));
+      CPPUNIT_ASSERT_EQUAL(K, cma.block_size());
+      ref_adapt(taps, cma_error(2.0f), 0.005f, K, &expect[0], &in[0],
+		(const gr_complex *) NULL, N, 1);
+      for(int i = 0; i < N; i += 5)
+	cma.filter_n(&actual[i], &in[i], NULL, std::min(5, N - i));
+      CPPUNIT_ASSERT(max_diff(expect, actual) < 1e-4);
+
+      // the first block runs on the initial taps
+      adaptive_engine<gr_complex, lms_error> lms(std::vector<gr_complex>(ntaps, 1), 0.1f, K);
+      const std::vector<gr_complex> desired = random_vector(N);
+      lms.filter_n(&actual[0], &in[0], &desired[0], K - 1);
+      CPPUNIT_ASSERT(max_diff(std::vector<gr_complex>(ntaps, 1), lms.taps()) == 0);
+      lms.filter_n(&actual[0], &in[K - 1], &desired[K - 1], 1);
+      CPPUNIT_ASSERT(max_diff(std::vector<gr_complex>(ntaps, 1), lms.taps()) > 0);
+
+      // a partial block is applied when the block size changes
+      lms.filter_n(&actual[0], &in[K], &desired[K], 1);
+      const std::vector<gr_complex> before = lms.taps();
+      lms.set_block_size(1);
+      CPPUNIT_ASSERT(max_diff(before, lms.taps()) > 0);
+    }
+
+    /*
+     * Convergence: LMS and NLMS identify an unknown channel, CMA
+     * brings a distorted constant modulus signal back to the circle.
+     */
+    void
+    qa_adaptive_engine::t4()
+    {
+      const int N = 4000;
+      const unsigned int ntaps = 5;
+      std::vector<gr_complex> h(ntaps);
+      h[0] = gr_complex(0.1, -0.2);
+      h[1] = gr_complex(1.0, 0.3);
+      h[2] = gr_complex(-0.4, 0.1);
+      h[3] = gr_complex(0.2, 0.0);
+      h[4] = gr_complex(0.0, 0.05);
+
+      // desired[i] = sum h[j] * x[n-j] with n the newest sample of window i
+      const std::vector<gr_complex> in = random_vector(N + ntaps);
+      std::vector<gr_complex> desired(N), out(N);
+      for(int i = 0; i < N; i++) {
+	desired[i] = 0;
+	for(unsigned int j = 0; j < ntaps; j++)
+	  desired[i] += h[j] * in[i + ntaps - 1 - j];
+      }
+
+      adaptive_engine<gr_complex, lms_error> lms(std::vector<gr_complex>(ntaps, 0), 0.05f);
+      lms.filter_n(&out[0], &in[0], &desired[0], N);
+      CPPUNIT_ASSERT(max_diff(h, lms.taps()) < 1e-3);
+
+      adaptive_engine<gr_complex, nlms_error> nlms(std::vector<gr_complex>(ntaps, 0), 0.5f, 2);
+      nlms.filter_n(&out[0], &in[0], &desired[0], N);
+      CPPUNIT_ASSERT(max_diff(h, nlms.taps()) < 1e-3);
+
+      // QPSK through a mild two tap channel
+      const unsigned int neq = 7;
+      std::vector<gr_complex> sym(N + neq + 1), rx(N + neq);
+      for(size_t i = 0; i < sym.size(); i++)
+	sym[i] = gr_complex(random() & 1 ? 0.7071f : -0.7071f,
+			    random() & 1 ? 0.7071f : -0.7071f);
+      for(size_t i = 0; i < rx.size(); i++)
+	rx[i] = sym[i + 1] + gr_complex(0.3f, 0.2f) * sym[i];
+
+      std::vector<gr_complex> taps(neq, 0);
+      taps[neq / 2] = 1;
+      adaptive_engine<gr_complex, cma_error> cma(taps, 0.005f);
+      cma.filter_n(&out[0], &rx[0], NULL, N);
+
+      double before = 0, after = 0;
+      for(int i = 0; i < 500; i++) {
+	before += std::abs(std::norm(rx[i + neq / 2]) - 1);
+	after += std::abs(std::norm(out[N - 500 + i]) - 1);
+      }
+      CPPUNIT_ASSERT(after < 0.2 * before);
+    }
+
+    /*
+     * Bad arguments throw.
+     */
+    void
+    qa_adaptive_engine::t5()
+    {
+      typedef adaptive_engine<gr_complex, lms_error> engine;
+      CPPUNIT_ASSERT_THROW(engine(std::vector<gr_complex>(), 0.1f), std::invalid_argument);
+      CPPUNIT_ASSERT_THROW(engine(std::vector<gr_complex>(3), 0.1f, 0), std::invalid_argument);
+      engine e(std::vector<gr_complex>(3), 0.1f);
+      CPPUNIT_ASSERT_THROW(e.set_taps(std::vector<gr_complex>()), std::invalid_argument);
+      CPPUNIT_ASSERT_EQUAL(3u, e.ntaps());
+    }
+
+  } /* namespace filter */
+} /* namespace gr */
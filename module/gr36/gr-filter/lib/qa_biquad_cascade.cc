@@ -0,0 +1,355 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cppunit/TestAssert.h>
+#include <qa_biquad_cascade.h>
+#include <filter/biquad_cascade.h>
+#include <filter/iir_filter.h>
+#include <random.h>
+#include <stdexcept>
+#include <algorithm>
+#include <complex>
+#include <cmath>
+
+namespace gr {
+  namespace filter {
+
+    typedef kernel::iir_filter<float,float,double> direct_filter;
+
+    static float
+    uniform()
+    {
+      return 2.0 * ((float)random() / RANDOM_MAX - 0.5);  // uniformly (-1, 1)
+    }
+
+    static std::vector<double>
+    poly_mul(const std::vector<double> &a, const std::vector<double> &b)
+    {
+      std::vector<double> c(a.size() + b.size() - 1, 0.0);
+      for(size_t i = 0; i < a.size(); i++)
+	for(size_t j = 0; j < b.size(); j++)
+	  c[i+j] += a[i] * b[j];
+      return c;
+    }
+
+    // sections with conjugate poles at radius r, angles spread over
+    // [w0, w1], and conjugate zeros on the unit circle further out;
+    // with lowpass all the zeros are at -1, as in a butterworth design
+    static std::vector< std::vector<double> >
+    make_sections(int nsections, double r, double w0, double w1,
+		  bool lowpass = false)
+    {
+      std::vector< std::vector<double> > sections;
+      for(int i = 0; i < nsections; i++) {
+	const double w = w0 + (w1 - w0) * i / std::max(1, nsections - 1);
+	const double wz = w1 + 0.3 + 0.2 * i;
+	std::vector<double> s(5);
+	s[0] = 0.1;
+	s[1] = lowpass ? 0.2 : -0.2 * std::cos(wz);
+	s[2] = 0.1;
+	s[3] = 2 * r * std::cos(w);
+	s[4] = -r * r;
+	sections.push_back(s);
+      }
+      return sections;
+    }
+
+    // direct form taps (iir_filter convention) of a cascade
+    static void
+    expand(const std::vector< std::vector<double> > &sections,
+	   std::vector<double> &fftaps, std::vector<double> &fbtaps)
+    {
+      std::vector<double> b(1, 1.0), a(1, 1.0);
+      for(size_t i = 0; i < sections.size(); i++) {
+	const std::vector<double> &s = sections[i];
+	b = poly_mul(b, std::vector<double>(s.begin(), s.begin() + 3));
+	std::vector<double> d(3);
+	d[0] = 1;
+	d[1] = -s[3];
+	d[2] = -s[4];
+	a = poly_mul(a, d);
+      }
+      fftaps = b;
+      fbtaps = a;
+      for(size_t i = 1; i < fbtaps.size(); i++)
+	fbtaps[i] = -fbtaps[i];
+    }
+
+    // the cascade in long double, one sample at a time
+    static std::vector<double>
+    ref_cascade(const std::vector< std::vector<double> > &sections,
+		const std::vector<float> &in)
+    {
+      std::vector<double> out(in.size());
+      std::vector<long double> s1(sections.size(), 0), s2(sections.size(), 0);
+      for(size_t n = 0; n < in.size(); n++) {
+	long double x = in[n];
+	for(size_t i = 0; i < sections.size(); i++) {
+	  const std::vector<double> &s = sections[i];
+	  const long double y = s[0] * x + s1[i];
+	  s1[i] = s[1] * x + s[3] * y + s2[i];
+	  s2[i] = s[2] * x + s[4] * y;
+	  x = y;
+	}
+	out[n] = x;
+      }
+      return out;
+    }
+
+    static double
+    max_abs(const std::vector<double> &v)
+    {
+      double m = 0;
+      for(size_t i = 0; i < v.size(); i++)
+	m = std::max(m, std::abs(v[i]));
+      return m;
+    }
+
+    /*
+     * Factoring gives back the sections a filter was built from, up to
+     * order, and the filter output matches the direct form.
+     */
+    void
+    qa_biquad_cascade::t1()
+    {
+      for(int lowpass = 0; lowpass < 2; lowpass++) {
+	std::vector< std::vector<double> > sections =
+	  make_sections(lowpass ? 4 : 3, 0.9, 0.3, 1.2, lowpass);
+	std::vector<double> fftaps, fbtaps;
+	expand(sections, fftaps, fbtaps);
+
+	std::vector< std::vector<double> > factored;
+	CPPUNIT_ASSERT(kernel::biquad_cascade::factor(fftaps, fbtaps, factored));
+	CPPUNIT_ASSERT_EQUAL(sections.size(), factored.size());
+	for(size_t i = 0; i < sections.size(); i++) {
+	  bool found = false;
+	  for(size_t j = 0; j < factored.size(); j++) {
+	    found |= std::abs(factored[j][3] - sections[i][3]) < 1e-9 &&
+	      std::abs(factored[j][4] - sections[i][4]) < 1e-9;
+	  }
+	  CPPUNIT_ASSERT(found);
+	}
+
+	const size_t N = 2000;
+	std::vector<float> in(N), expect(N), actual(N);
+	for(size_t i = 0; i < N; i++)
+	  in[i] = uniform();
+
+	direct_filter direct(fftaps, fbtaps);
+	kernel::biquad_cascade cascade;
+	cascade.set_taps(fftaps, fbtaps);
+	CPPUNIT_ASSERT_EQUAL(sections.size(), cascade.sections().size());
+
+	direct.filter_n(&expect[0], &in[0], N);
+	// odd lengths, so state carries across block and tail paths
+	for(size_t off = 0; off < N; ) {
+	  const size_t n = std::min(N - off, (size_t) 1 + off % 37);
+	  cascade.filter_n(&actual[off], &in[off], n);
+	  off += n;
+	}
+	for(size_t i = 0; i < N; i++)
+	  CPPUNIT_ASSERT_DOUBLES_EQUAL(expect[i], actual[i], 1e-4);
+      }
+    }
+
+    /*
+     * A high order narrow band filter. Its direct form taps in double
+     * no longer describe the filter: iir_filter drifts away from the
+     * exact response and the taps cannot be factored back, so
+     * set_taps() keeps the direct form. Given the sections, the
+     * cascade stays with the exact response.
+     */
+    void
+    qa_biquad_cascade::t2()
+    {
+      std::vector< std::vector<double> > sections = make_sections(8, 0.995, 0.02, 0.05);
+      std::vector<double> fftaps, fbtaps;
+      expand(sections, fftaps, fbtaps);
+
+      const size_t N = 8192;
+      std::vector<float> in(N), direct_out(N), cascade_out(N), fallback_out(N);
+      for(size_t i = 0; i < N; i++)
+	in[i] = uniform();
+
+      const std::vector<double> exact = ref_cascade(sections, in);
+      const double scale = max_abs(exact);
+
+      kernel::biquad_cascade cascade;
+      cascade.set_sections(sections);
+      cascade.filter_n(&cascade_out[0], &in[0], N);
+
+      direct_filter direct(fftaps, fbtaps);
+      direct.filter_n(&direct_out[0], &in[0], N);
+
+      double cascade_err = 0, direct_err = 0;
+      for(size_t i = 0; i < N; i++) {
+	cascade_err = std::max(cascade_err, (double) std::abs(cascade_out[i] - exact[i]));
+	const double e = std::abs(direct_out[i] - exact[i]);
+	direct_err = e == e ? std::max(direct_err, e) : HUGE_VAL;
+      }
+      CPPUNIT_ASSERT(cascade_err < 1e-5 * scale);
+      CPPUNIT_ASSERT(direct_err > 100 * cascade_err);
+
+      kernel::biquad_cascade fallback;
+      fallback.set_taps(fftaps, fbtaps);
+      CPPUNIT_ASSERT(fallback.sections().empty());
+      fallback.filter_n(&fallback_out[0], &in[0], N);
+      for(size_t i = 0; i < N; i++) {
+	if(direct_out[i] == direct_out[i])
+	  CPPUNIT_ASSERT_EQUAL(direct_out[i], fallback_out[i]);
+      }
+    }
+
+    /*
+     * Low order filters with delays, unstable poles and only one side
+     * of the taps, against the direct form.
+     */
+    void
+    qa_biquad_cascade::t3()
+    {
+      static const double cases[][2][5] = {
+	{ { 2, 11, 0, 0, 0 },    { 0, -1, 3, 0, 0 } },
+	{ { 0, 0, 2, 0, 0 },     { 0, 0, -1, 3, 0 } },
+	{ { 2, 0, 1, 0, 0 },     { 0, -1, 0, 0, 0 } },
+	{ { 0.5, 0, 0, 0, 0 },   { 0, 1.5, -0.56, 0, 0 } },
+	{ { 1, -3, 3, -1, 0 },   { 0, 0, 0, 0, 0.2 } },
+	{ { 0, 1, 0.5, 0.25, 0 },{ 0, 0, 0, 0, 0 } },
+      };
+      const size_t N = 16;
+      std::vector<float> in(N), expect(N), actual(N);
+      for(size_t i = 0; i < N; i++)
+	in[i] = i + 1;
+
+      for(size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+	std::vector<double> fftaps(cases[c][0], cases[c][0] + 5);
+	std::vector<double> fbtaps(cases[c][1], cases[c][1] + 5);
+	direct_filter direct(fftaps, fbtaps);
+	kernel::biquad_cascade cascade;
+	cascade.set_taps(fftaps, fbtaps);
+	CPPUNIT_ASSERT(!cascade.sections().empty());
+
+	direct.filter_n(&expect[0], &in[0], N);
+	cascade.filter_n(&actual[0], &in[0], N);
+	for(size_t i = 0; i < N; i++)
+	  CPPUNIT_ASSERT_DOUBLES_EQUAL(expect[i], actual[i],
+				       1e-6 * std::max(1.0f, std::abs(expect[i])));
+      }
+    }
+
+    /*
+     * Channels are filtered independently and match one channel runs.
+     */
+    void
+    qa_biquad_cascade::t4()
+    {
+      std::vector< std::vector<double> > sections = make_sections(4, 0.95, 0.2, 0.6);
+      std::vector<double> fftaps, fbtaps;
+      expand(sections, fftaps, fbtaps);
+
+      const unsigned int nch = 5;
+      const size_t N = 1000;
+      std::vector<float> in(N * nch), actual(N * nch);
+      for(size_t i = 0; i < N * nch; i++)
+	in[i] = uniform();
+
+      kernel::biquad_cascade multi(nch);
+      CPPUNIT_ASSERT_EQUAL(nch, multi.nchannels());
+      multi.set_taps(fftaps, fbtaps);
+      multi.filter_n(&actual[0], &in[0], N / 2);
+      multi.filter_n(&actual[N / 2 * nch], &in[N / 2 * nch], N - N / 2);
+
+      for(unsigned int c = 0; c < nch; c++) {
+	std::vector<float> x(N), y(N);
+	for(size_t i = 0; i < N; i++)
+	  x[i] = in[i * nch + c];
+	kernel::biquad_cascade single;
+	single.set_taps(fftaps, fbtaps);
+	single.filter_n(&y[0], &x[0], N);
+	for(size_t i = 0; i < N; i++)
+	  CPPUNIT_ASSERT_DOUBLES_EQUAL(y[i], actual[i * nch + c], 1e-5);
+      }
+
+      // reset() starts every channel over
+      std::vector<float> again(N * nch);
+      multi.reset();
+      multi.filter_n(&again[0], &in[0], N);
+      kernel::biquad_cascade fresh(nch);
+      fresh.set_taps(fftaps, fbtaps);
+      fresh.filter_n(&actual[0], &in[0], N);
+      for(size_t i = 0; i < N * nch; i++)
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(actual[i], again[i], 1e-6);
+    }
+
+    /*
+     * Empty taps give zeros, bad arguments throw.
+     */
+    void
+    qa_biquad_cascade::t5()
+    {
+      const size_t N = 10;
+      std::vector<float> in(N * 2, 1.0f), out(N * 2, 1.0f);
+
+      kernel::biquad_cascade cascade(2);
+      cascade.set_taps(std::vector<double>(), std::vector<double>(2, 0.5));
+      cascade.filter_n(&out[0], &in[0], N);
+      for(size_t i = 0; i < N * 2; i++)
+	CPPUNIT_ASSERT_EQUAL(0.0f, out[i]);
+
+      CPPUNIT_ASSERT_THROW(kernel::biquad_cascade(0), std::invalid_argument);
+      CPPUNIT_ASSERT_THROW(cascade.set_sections(std::vector< std::vector<double> >
+						(1, std::vector<double>(3))),
+			   std::invalid_argument);
+    }
+
+    /*
+     * Narrow band designs have tiny numerator gains. The factored
+     * zeros are checked with the gain divided out, so they still
+     * have to multiply back to the taps.
+     */
+    void
+    qa_biquad_cascade::t6()
+    {
+      std::vector< std::vector<double> > sections = make_sections(3, 0.9, 0.3, 1.2);
+      std::vector<double> fftaps, fbtaps;
+      expand(sections, fftaps, fbtaps);
+      const double gain = 1e-12 / fftaps[0];
+      for(size_t i = 0; i < fftaps.size(); i++)
+	fftaps[i] *= gain;
+
+      std::vector< std::vector<double> > factored;
+      CPPUNIT_ASSERT(kernel::biquad_cascade::factor(fftaps, fbtaps, factored));
+      std::vector<double> b(1, 1.0);
+      for(size_t i = 0; i < factored.size(); i++)
+	b = poly_mul(b, std::vector<double>(factored[i].begin(), factored[i].begin() + 3));
+      CPPUNIT_ASSERT(b.size() >= fftaps.size());
+      for(size_t i = 0; i < b.size(); i++) {
+	const double want = i < fftaps.size() ? fftaps[i] : 0.0;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(want / fftaps[0], b[i] / fftaps[0], 1e-9);
+      }
+    }
+
+  } /* namespace filter */
+} /* namespace gr */
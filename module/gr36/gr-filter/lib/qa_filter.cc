@@ -30,6 +30,10 @@
 #include <qa_fir_filter_with_buffer.h>
 #include <qa_mmse_fir_interpolator_cc.h>
 #include <qa_mmse_fir_interpolator_ff.h>
+#include <qa_polyphase_engine.h>
+#include <qa_biquad_cascade.h>
+#include <qa_adaptive_engine.h>
+#include <qa_tap_cache.h>
 
 CppUnit::TestSuite *
 qa_gr_filter::suite ()
@@ -42,6 +46,10 @@ qa_gr_filter::suite ()
   s->addTest(gr::filter::ccf::qa_fir_filter_with_buffer_ccf::suite());
   s->addTest(gr::filter::qa_mmse_fir_interpolator_cc::suite());
   s->addTest(gr::filter::qa_mmse_fir_interpolator_ff::suite());
+  s->addTest(gr::filter::qa_polyphase_engine::suite());
+  s->addTest(gr::filter::qa_biquad_cascade::suite());
+  s->addTest(gr::filter::qa_adaptive_engine::suite());
+  s->addTest(gr::filter::qa_tap_cache::suite());
 
   return s;
 }
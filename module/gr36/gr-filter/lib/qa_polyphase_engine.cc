@@ -0,0 +1,258 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cppunit/TestAssert.h>
+#include <qa_polyphase_engine.h>
+#include <filter/polyphase_engine.h>
+#include <gr_complex.h>
+#include <random.h>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+namespace gr {
+  namespace filter {
+
+    static float
+    uniform()
+    {
+      return 2.0 * ((float)random() / RANDOM_MAX - 0.5);  // uniformly (-1, 1)
+    }
+
+    static std::vector< std::vector<float> >
+    random_bank(unsigned int nphases, unsigned int ntaps)
+    {
+      std::vector< std::vector<float> > bank(nphases);
+      for(unsigned int p = 0; p < nphases; p++) {
+	for(unsigned int k = 0; k < ntaps; k++)
+	  bank[p].push_back(uniform());
+      }
+      return bank;
+    }
+
+    // fir_filter convention, the taps run backwards over the input
+    template <class T>
+    static T
+    ref_dot(const std::vector<float> &taps, const T input[])
+    {
+      T sum = 0;
+      for(size_t k = 0; k < taps.size(); k++)
+	sum += input[k] * taps[taps.size()-1-k];
+      return sum;
+    }
+
+    // the loop the arbitrary resamplers ran before the engine
+    template <class T>
+    static int
+    ref_resample(const std::vector< std::vector<float> > &taps,
+		 const std::vector< std::vector<float> > &dtaps,
+		 T out[], int noutput_items, const T in[], int max_input,
+		 unsigned int dec_rate, float flt_rate,
+		 int &count, unsigned int &j, float &acc)
+    {
+      const unsigned int int_rate = taps.size();
+      int i = 0;
+      while((i < noutput_items) && (count < max_input)) {
+	while((j < int_rate) && (i < noutput_items)) {
+	  T o0 = ref_dot(taps[j], &in[count]);
+	  T o1 = ref_dot(dtaps[j], &in[count]);
+	  out[i++] = o0 + o1*acc;
+	  acc += flt_rate;
+	  j += dec_rate + (int)floor(acc);
+	  acc = fmodf(acc, 1.0);
+	}
+	if(i < noutput_items) {
+	  count += j / int_rate;
+	  j = j % int_rate;
+	}
+      }
+      return i;
+    }
+
+    /*
+     * Single phase and interpolated outputs against the reference
+     * dot products, for tap counts around the vector widths and
+     * every input alignment.
+     */
+    void
+    qa_polyphase_engine::t1()
+    {
+      for(unsigned int ntaps = 1; ntaps <= 13; ntaps++) {
+	const std::vector< std::vector<float> > taps = random_bank(5, ntaps);
+	const std::vector< std::vector<float> > dtaps = random_bank(5, ntaps);
+	kernel::polyphase_engine_ccf ccf;
+	kernel::polyphase_engine_fff fff;
+	ccf.set_taps(taps, dtaps);
+	fff.set_taps(taps, dtaps);
+	CPPUNIT_ASSERT_EQUAL(5u, ccf.nphases());
+	CPPUNIT_ASSERT_EQUAL(ntaps, fff.ntaps());
+
+	std::vector<gr_complex> cin(ntaps + 4);
+	std::vector<float> fin(ntaps + 4);
+	for(size_t k = 0; k < cin.size(); k++) {
+	  cin[k] = gr_complex(uniform(), uniform());
+	  fin[k] = uniform();
+	}
+
+	for(unsigned int off = 0; off < 4; off++) {
+	  for(unsigned int p = 0; p < 5; p++) {
+	    const float mu = 0.25 * off;
+	    const gr_complex c0 = ref_dot(taps[p], &cin[off]);
+	    const gr_complex c1 = ref_dot(dtaps[p], &cin[off]);
+	    const float f0 = ref_dot(taps[p], &fin[off]);
+	    const float f1 = ref_dot(dtaps[p], &fin[off]);
+
+	    const gr_complex cexp = c0 + c1*mu;
+	    const gr_complex cact0 = ccf.filter(p, &cin[off]);
+	    const gr_complex cact1 = ccf.filter(p, mu, &cin[off]);
+
+	    CPPUNIT_ASSERT_COMPLEXES_EQUAL(c0, cact0, 1e-5);
+	    CPPUNIT_ASSERT_COMPLEXES_EQUAL(cexp, cact1, 1e-5);
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(f0, fff.filter(p, &fin[off]), 1e-5);
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(f0 + f1*mu, fff.filter(p, mu, &fin[off]), 1e-5);
+	  }
+	}
+      }
+    }
+
+    /*
+     * Complex resampling against the reference loop, decimating and
+     * interpolating, with the output split over several calls.
+     */
+    void
+    qa_polyphase_engine::t2()
+    {
+      const unsigned int int_rate = 32, ntaps = 7;
+      const std::vector< std::vector<float> > taps = random_bank(int_rate, ntaps);
+      const std::vector< std::vector<float> > dtaps = random_bank(int_rate, ntaps);
+      kernel::polyphase_engine_ccf engine;
+      engine.set_taps(taps, dtaps);
+
+      const int N = 1000;
+      std::vector<gr_complex> in(N + ntaps);
+      for(size_t k = 0; k < in.size(); k++)
+	in[k] = gr_complex(uniform(), uniform());
+
+      const float rates[] = {0.3f, 0.97f, 1.0f, 1.7f, 3.1415f};
+      for(size_t r = 0; r < sizeof(rates)/sizeof(rates[0]); r++) {
+	const unsigned int dec_rate = (unsigned int)floor(int_rate/rates[r]);
+	const float flt_rate = (int_rate/rates[r]) - dec_rate;
+
+	std::vector<gr_complex> expected(4*N), actual(4*N);
+	int count0 = 0, count1 = 0;
+	unsigned int j0 = 0, j1 = 0;
+	float acc0 = 0, acc1 = 0;
+	int n0 = 0, n1 = 0;
+	while(n0 < 4*N && count0 < N) {
+	  const int chunk = std::min(37, 4*N - n0);
+	  const int a = ref_resample(taps, dtaps, &expected[n0], chunk, &in[0], N,
+				     dec_rate, flt_rate, count0, j0, acc0);
+	  const int b = engine.resample(&actual[n1], chunk, &in[0], N,
+					dec_rate, flt_rate, count1, j1, acc1);
+	  CPPUNIT_ASSERT_EQUAL(a, b);
+	  n0 += a;
+	  n1 += b;
+	  if(a == 0)
+	    break;
+	}
+
+	CPPUNIT_ASSERT_EQUAL(count0, count1);
+	CPPUNIT_ASSERT_EQUAL(j0, j1);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(acc0, acc1, 1e-6);
+	for(int i = 0; i < n0; i++) {
+	  CPPUNIT_ASSERT_COMPLEXES_EQUAL(expected[i], actual[i], 1e-5);
+	}
+      }
+    }
+
+    /*
+     * Real resampling against the reference loop.
+     */
+    void
+    qa_polyphase_engine::t3()
+    {
+      const unsigned int int_rate = 16, ntaps = 12;
+      const std::vector< std::vector<float> > taps = random_bank(int_rate, ntaps);
+      const std::vector< std::vector<float> > dtaps = random_bank(int_rate, ntaps);
+      kernel::polyphase_engine_fff engine;
+      engine.set_taps(taps, dtaps);
+
+      const int N = 1000;
+      std::vector<float> in(N + ntaps);
+      for(size_t k = 0; k < in.size(); k++)
+	in[k] = uniform();
+
+      const float rates[] = {0.5f, 1.3f, 2.0f, 4.7f};
+      for(size_t r = 0; r < sizeof(rates)/sizeof(rates[0]); r++) {
+	const unsigned int dec_rate = (unsigned int)floor(int_rate/rates[r]);
+	const float flt_rate = (int_rate/rates[r]) - dec_rate;
+
+	std::vector<float> expected(5*N), actual(5*N);
+	int count0 = 0, count1 = 0;
+	unsigned int j0 = 0, j1 = 0;
+	float acc0 = 0, acc1 = 0;
+	const int n0 = ref_resample(taps, dtaps, &expected[0], 5*N, &in[0], N,
+				    dec_rate, flt_rate, count0, j0, acc0);
+	const int n1 = engine.resample(&actual[0], 5*N, &in[0], N,
+				       dec_rate, flt_rate, count1, j1, acc1);
+
+	CPPUNIT_ASSERT_EQUAL(n0, n1);
+	CPPUNIT_ASSERT_EQUAL(count0, count1);
+	for(int i = 0; i < n0; i++)
+	  CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], actual[i], 1e-5);
+      }
+    }
+
+    /*
+     * Without a derivative bank mu is ignored, and the generic bank
+     * matches the engine backed one.
+     */
+    void
+    qa_polyphase_engine::t4()
+    {
+      const std::vector< std::vector<float> > taps = random_bank(3, 9);
+      kernel::polyphase_engine_fff engine;
+      engine.set_taps(taps);
+      kernel::polyphase_bank<kernel::fir_filter_fff, float, float, float> fast;
+      fast.set_taps(taps);
+
+      std::vector<float> in(9);
+      for(size_t k = 0; k < in.size(); k++)
+	in[k] = uniform();
+
+      for(unsigned int p = 0; p < 3; p++) {
+	const float expected = ref_dot(taps[p], &in[0]);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, engine.filter(p, 0.5f, &in[0]), 1e-5);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, fast.filter(p, &in[0]), 1e-5);
+      }
+
+      std::vector< std::vector<float> > bad = taps;
+      bad[1].push_back(0);
+      CPPUNIT_ASSERT_THROW(engine.set_taps(bad), std::invalid_argument);
+    }
+
+  } /* namespace filter */
+} /* namespace gr */
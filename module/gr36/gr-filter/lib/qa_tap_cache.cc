@@ -0,0 +1,280 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cppunit/TestAssert.h>
+#include <qa_tap_cache.h>
+#include <filter/tap_cache.h>
+#include <filter/tap_designer.h>
+#include <filter/pm_remez.h>
+#include <gr_sys_paths.h>
+#include <gruel/thread.h>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+namespace gr {
+  namespace filter {
+
+    static std::vector<double>
+    lowpass(int order, double edge)
+    {
+      std::vector<double> bands, ampl, weight;
+      bands.push_back(0);
+      bands.push_back(edge);
+      bands.push_back(edge + 0.1);
+      bands.push_back(1);
+      ampl.push_back(1);
+      ampl.push_back(1);
+      ampl.push_back(0);
+      ampl.push_back(0);
+      return pm_remez(order, bands, ampl, weight);
+    }
+
+    // a fresh cache directory, so the tests never touch the user's
+    static std::string
+    make_test_dir()
+    {
+      std::ostringstream name;
+      name << "qa_tap_cache_" << getpid();
+      const fs::path dir = fs::path(gr_tmp_path()) / name.str();
+      fs::remove_all(dir);
+      return dir.string();
+    }
+
+    static size_t
+    count_files(const std::string &dir)
+    {
+      size_t n = 0;
+      fs::directory_iterator end;
+      for(fs::directory_iterator it(dir); it != end; it++) {
+	if(it->path().extension() == ".taps")
+	  n++;
+      }
+      return n;
+    }
+
+    /*
+     * Keys and the in memory cache.
+     */
+    void
+    qa_tap_cache::t1()
+    {
+      CPPUNIT_ASSERT(!tap_cache::persistent());
+      tap_cache::clear();
+
+      std::vector<double> p(2);
+      p[0] = 0.1;
+      p[1] = 1.0/3.0;
+      const std::string k1 = tap_cache::make_key("test", p);
+      p[1] = 1.0/3.0 + 1e-16;
+      const std::string k2 = tap_cache::make_key("test", p);
+      CPPUNIT_ASSERT(k1 != k2);
+      CPPUNIT_ASSERT(tap_cache::make_key("other", p) != k2);
+
+      std::vector<double> taps(3, 0.25), found;
+      CPPUNIT_ASSERT(!tap_cache::lookup(k1, found));
+      tap_cache::store(k1, taps);
+      CPPUNIT_ASSERT(tap_cache::lookup(k1, found));
+      CPPUNIT_ASSERT(found == taps);
+      CPPUNIT_ASSERT(!tap_cache::lookup(k2, found));
+
+      // the memory cache stays bounded
+      for(int i = 0; i < 1000; i++) {
+	std::vector<double> q(1, i);
+	tap_cache::store(tap_cache::make_key("fill", q), taps);
+      }
+      CPPUNIT_ASSERT(tap_cache::size() < 1000);
+
+      tap_cache::clear();
+      CPPUNIT_ASSERT_EQUAL(size_t(0), tap_cache::size());
+    }
+
+    /*
+     * pm_remez goes through the cache.
+     */
+    void
+    qa_tap_cache::t2()
+    {
+      tap_cache::clear();
+
+      const std::vector<double> a = lowpass(60, 0.2);
+      CPPUNIT_ASSERT_EQUAL(size_t(61), a.size());
+      CPPUNIT_ASSERT_EQUAL(size_t(1), tap_cache::size());
+      CPPUNIT_ASSERT(lowpass(60, 0.2) == a);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), tap_cache::size());
+
+      // a different design is not confused with the first
+      CPPUNIT_ASSERT(lowpass(60, 0.25) != a);
+      CPPUNIT_ASSERT_EQUAL(size_t(2), tap_cache::size());
+
+      // invalid designs still throw and are not stored
+      tap_cache::clear();
+      CPPUNIT_ASSERT_THROW(lowpass(2, 0.2), std::runtime_error);
+      CPPUNIT_ASSERT_EQUAL(size_t(0), tap_cache::size());
+    }
+
+    /*
+     * Designs come back from the cache directory after the memory is
+     * cleared, and the directory stays bounded.
+     */
+    void
+    qa_tap_cache::t3()
+    {
+      const std::string dir = make_test_dir();
+      tap_cache::set_directory(dir);
+      CPPUNIT_ASSERT(fs::path(tap_cache::directory()) == fs::path(dir));
+      tap_cache::set_persistent(true);
+      tap_cache::clear();
+
+      // a design is written to its own file
+      const std::vector<double> a = lowpass(60, 0.2);
+      CPPUNIT_ASSERT_EQUAL(size_t(1), count_files(dir));
+
+      std::vector<double> p(1, 0.5);
+      const std::string key = tap_cache::make_key("test", p);
+      const std::vector<double> taps(5, 0.125);
+      tap_cache::store(key, taps);
+      CPPUNIT_ASSERT(fs::exists(tap_cache::filename(key)));
+      CPPUNIT_ASSERT_EQUAL(size_t(2), count_files(dir));
+
+      // with the memory empty only the file can answer
+      tap_cache::clear();
+      std::vector<double> found;
+      CPPUNIT_ASSERT(tap_cache::lookup(key, found));
+      CPPUNIT_ASSERT(found == taps);
+      CPPUNIT_ASSERT(lowpass(60, 0.2) == a);
+
+      // without persistence the file is not read
+      tap_cache::clear();
+      tap_cache::set_persistent(false);
+      CPPUNIT_ASSERT(!tap_cache::lookup(key, found));
+      tap_cache::set_persistent(true);
+
+      // the least recently used files are removed first
+      for(size_t i = 0; i < tap_cache::max_files + 10; i++) {
+	std::vector<double> q(1, double(i));
+	tap_cache::store(tap_cache::make_key("fill", q), taps);
+      }
+      CPPUNIT_ASSERT_EQUAL(size_t(tap_cache::max_files), count_files(dir));
+      std::vector<double> q(1, double(tap_cache::max_files + 9));
+      CPPUNIT_ASSERT(fs::exists(tap_cache::filename(tap_cache::make_key("fill", q))));
+
+      tap_cache::set_persistent(false);
+      tap_cache::set_directory("");
+      tap_cache::clear();
+      fs::remove_all(dir);
+    }
+
+    struct tap_sink
+    {
+      gruel::mutex mutex;
+      std::vector<float> taps;
+      int count;
+
+      tap_sink() : count(0) {}
+
+      void set_taps(const std::vector<float> &t)
+      {
+	gruel::scoped_lock lock(mutex);
+	taps = t;
+	count++;
+      }
+    };
+
+    static std::vector<double>
+    slow_design(gruel::mutex *gate, int order)
+    {
+      gruel::scoped_lock lock(*gate);
+      return lowpass(order, 0.2);
+    }
+
+    /*
+     * Designs run on the worker; a design still queued for a target
+     * is replaced by a newer one.
+     */
+    void
+    qa_tap_cache::t4()
+    {
+      tap_designer &designer = tap_designer::instance();
+      tap_sink sink;
+      gruel::mutex gate;
+
+      {
+	// hold the first design on the worker while queueing more
+	gruel::scoped_lock lock(gate);
+	for(int order = 20; order <= 40; order += 4) {
+	  designer.submit<float, double>
+	    (&sink, boost::bind(&slow_design, &gate, order),
+	     boost::bind(&tap_sink::set_taps, &sink, _1));
+	}
+      }
+      designer.wait(&sink);
+
+      // the first design was running, of the rest only the newest ran
+      CPPUNIT_ASSERT(sink.count <= 2);
+      CPPUNIT_ASSERT_EQUAL(size_t(41), sink.taps.size());
+      const std::vector<double> expected = lowpass(40, 0.2);
+      for(size_t i = 0; i < expected.size(); i++)
+	CPPUNIT_ASSERT_EQUAL(float(expected[i]), sink.taps[i]);
+
+      // a failing design is not delivered
+      const int count = sink.count;
+      designer.submit<float, double>
+	(&sink, boost::bind(&lowpass, 2, 0.2),
+	 boost::bind(&tap_sink::set_taps, &sink, _1));
+      designer.wait();
+      CPPUNIT_ASSERT_EQUAL(count, sink.count);
+
+      // cancel drops a queued design
+      {
+	gruel::scoped_lock lock(gate);
+	tap_sink other;
+	designer.submit<float, double>
+	  (&other, boost::bind(&slow_design, &gate, 24),
+	   boost::bind(&tap_sink::set_taps, &other, _1));
+	designer.submit<float, double>
+	  (&sink, boost::bind(&lowpass, 28, 0.2),
+	   boost::bind(&tap_sink::set_taps, &sink, _1));
+	designer.cancel(&sink);
+	lock.unlock();
+	designer.cancel(&other);
+      }
+      designer.wait();
+      CPPUNIT_ASSERT_EQUAL(count, sink.count);
+    }
+
+  } /* namespace filter */
+} /* namespace gr */
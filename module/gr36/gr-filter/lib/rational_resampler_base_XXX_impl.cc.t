@@ -53,7 +53,6 @@ namespace gr {
       d_interpolation(interpolation),
       d_decimation(decimation),
       d_ctr(0),
-      d_firs(interpolation),
       d_updated(false)
     {
       if(interpolation == 0)
@@ -64,22 +63,12 @@ namespace gr {
       set_relative_rate(1.0 * interpolation / decimation);
       set_output_multiple(1);
 
-      std::vector<@TAP_TYPE@> dummy_taps;
-
-      for(unsigned i = 0; i < interpolation; i++) {
-	d_firs[i] = new kernel::@FIR_TYPE@(1, dummy_taps);
-      }
-
       set_taps(taps);
       install_taps(d_new_taps);
     }
 
     @IMPL_NAME@::~@IMPL_NAME@()
     {
-      int interp = interpolation();
-      for(int i = 0; i < interp; i++) {
-	delete d_firs[i];
-      }
     }
 
     void
@@ -116,8 +105,7 @@ namespace gr {
       for(int i = 0; i < (int)taps.size(); i++)
 	xtaps[i % nfilters][i / nfilters] = taps[i];
 
-      for(int n = 0; n < nfilters; n++)
-	d_firs[n]->set_taps(xtaps[n]);
+      d_firs.set_taps(xtaps);
 
       set_history(nt);
       d_updated = false;
@@ -157,7 +145,7 @@ namespace gr {
 
       int i = 0;
       while(i < noutput_items) {
-	out[i++] = d_firs[ctr]->filter(in);
+	out[i++] = d_firs.filter(ctr, in);
 	ctr += decimation();
 	while(ctr >= interpolation()) {
 	  ctr -= interpolation();
@@ -25,7 +25,7 @@
 #ifndef @GUARD_NAME@
 #define	@GUARD_NAME@
 
-#include <filter/fir_filter.h>
+#include <filter/polyphase_engine.h>
 #include <filter/@BASE_NAME@.h>
 
 namespace gr {
@@ -39,7 +39,7 @@ namespace gr {
       unsigned d_decimation;
       unsigned d_ctr;
       std::vector<@TAP_TYPE@> d_new_taps;
-      std::vector<kernel::@FIR_TYPE@ *> d_firs;
+      kernel::polyphase_bank<kernel::@FIR_TYPE@, @I_TYPE@, @O_TYPE@, @TAP_TYPE@> d_firs;
       bool d_updated;
 
       void install_taps(const std::vector<@TAP_TYPE@> &taps);
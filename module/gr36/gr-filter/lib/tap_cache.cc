@@ -0,0 +1,317 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <filter/tap_cache.h>
+#include <gr_sys_paths.h>
+#include <gruel/thread.h>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <cstdio>
+#include <ctime>
+
+#ifdef _MSC_VER
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+namespace gr {
+  namespace filter {
+
+    // designs kept in memory, the least recently used goes first
+    static const size_t max_entries = 64;
+
+    struct cache_entry {
+      std::vector<double> taps;
+      unsigned long last_used;
+    };
+
+    typedef std::map<std::string, cache_entry> cache_map;
+
+    struct cache_state {
+      gruel::mutex mutex;
+      cache_map entries;
+      unsigned long clock;
+      bool persistent;
+      std::string dir;
+
+      cache_state() : clock(0), persistent(false) {}
+    };
+
+    static cache_state &
+    state()
+    {
+      static cache_state s;
+      return s;
+    }
+
+    // callers hold the lock
+    static fs::path
+    cache_dir()
+    {
+      if(!state().dir.empty())
+	return fs::path(state().dir);
+      return fs::path(gr_appdata_path()) / ".gr_filter_taps";
+    }
+
+    // the file for a key is named by its 64 bit FNV-1a hash; the
+    // key itself is the first line, so a collision reads as a miss
+    static fs::path
+    cache_file(const std::string &key)
+    {
+      boost::uint64_t h = 14695981039346656037ULL;
+      for(size_t i = 0; i < key.size(); i++) {
+	h ^= (unsigned char)key[i];
+	h *= 1099511628211ULL;
+      }
+      char name[32];
+      snprintf(name, sizeof(name), "%016llx.taps", (unsigned long long)h);
+      return cache_dir() / name;
+    }
+
+    static bool
+    read_file(const std::string &key, std::vector<double> &taps)
+    {
+      const std::string filename = cache_file(key).string();
+      FILE *fp = fopen(filename.c_str(), "r");
+      if(fp == 0)
+	return false;
+
+      bool ok = false;
+      std::string line;
+      int c;
+      while((c = fgetc(fp)) != EOF && c != '\n')
+	line += char(c);
+      unsigned long ntaps = 0;
+      if(line == key && fscanf(fp, "%lu", &ntaps) == 1) {
+	std::vector<double> t(ntaps);
+	size_t i = 0;
+	while(i < ntaps && fscanf(fp, "%lg", &t[i]) == 1)
+	  i++;
+	if(i == ntaps) {
+	  taps.swap(t);
+	  ok = true;
+	}
+      }
+      fclose(fp);
+
+      // reading a design marks it as recently used
+      if(ok) {
+	try {
+	  fs::last_write_time(cache_file(key), std::time(0));
+	}
+	catch(const std::exception &) {}
+      }
+      return ok;
+    }
+
+    // remove the least recently used files until at most max_files
+    // designs are left; files written by other processes count too.
+    // Times only have a resolution of seconds, so the file just
+    // written is never a candidate.
+    static void
+    prune_dir(const fs::path &keep)
+    {
+      typedef std::pair<std::time_t, fs::path> dated_file;
+      std::vector<dated_file> files;
+      try {
+	fs::directory_iterator end;
+	for(fs::directory_iterator it(cache_dir()); it != end; it++) {
+	  if(it->path().extension() == ".taps" && it->path() != keep)
+	    files.push_back(dated_file(fs::last_write_time(it->path()), it->path()));
+	}
+      }
+      catch(const std::exception &) {
+	return;
+      }
+
+      if(files.size() < tap_cache::max_files)
+	return;
+      std::sort(files.begin(), files.end());
+      const size_t excess = files.size() + 1 - tap_cache::max_files;
+      for(size_t i = 0; i < excess; i++) {
+	try {
+	  fs::remove(files[i].second);
+	}
+	catch(const std::exception &) {}
+      }
+    }
+
+    static void
+    write_file(const std::string &key, const std::vector<double> &taps)
+    {
+      try {
+	fs::create_directories(cache_dir());
+      }
+      catch(const std::exception &) {
+	return;
+      }
+
+      const std::string filename = cache_file(key).string();
+      std::ostringstream tmpname;
+      tmpname << filename << "." << getpid() << ".tmp";
+      FILE *fp = fopen(tmpname.str().c_str(), "w");
+      if(fp == 0)
+	return;
+
+      fprintf(fp, "%s\n%lu\n", key.c_str(), (unsigned long)taps.size());
+      for(size_t i = 0; i < taps.size(); i++)
+	fprintf(fp, "%.17g\n", taps[i]);
+      const bool ok = (fclose(fp) == 0);
+      if(!ok || rename(tmpname.str().c_str(), filename.c_str()) != 0) {
+	remove(tmpname.str().c_str());
+	return;
+      }
+      prune_dir(filename);
+    }
+
+    // callers hold the lock
+    static void
+    insert(cache_state &s, const std::string &key, const std::vector<double> &taps)
+    {
+      if(s.entries.size() >= max_entries && s.entries.find(key) == s.entries.end()) {
+	cache_map::iterator oldest = s.entries.begin();
+	for(cache_map::iterator it = s.entries.begin(); it != s.entries.end(); it++) {
+	  if(it->second.last_used < oldest->second.last_used)
+	    oldest = it;
+	}
+	s.entries.erase(oldest);
+      }
+      cache_entry &e = s.entries[key];
+      e.taps = taps;
+      e.last_used = ++s.clock;
+    }
+
+    const size_t tap_cache::max_files;
+
+    std::string
+    tap_cache::make_key(const std::string &design,
+			const std::vector<double> &params)
+    {
+      std::string key = design;
+      char buf[32];
+      for(size_t i = 0; i < params.size(); i++) {
+	snprintf(buf, sizeof(buf), " %.17g", params[i]);
+	key += buf;
+      }
+      return key;
+    }
+
+    bool
+    tap_cache::lookup(const std::string &key, std::vector<double> &taps)
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+
+      cache_map::iterator it = s.entries.find(key);
+      if(it != s.entries.end()) {
+	it->second.last_used = ++s.clock;
+	taps = it->second.taps;
+	return true;
+      }
+
+      if(!s.persistent || !read_file(key, taps))
+	return false;
+      insert(s, key, taps);
+      return true;
+    }
+
+    void
+    tap_cache::store(const std::string &key, const std::vector<double> &taps)
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+
+      insert(s, key, taps);
+      if(s.persistent)
+	write_file(key, taps);
+    }
+
+    void
+    tap_cache::set_persistent(bool persistent)
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+      s.persistent = persistent;
+    }
+
+    bool
+    tap_cache::persistent()
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+      return s.persistent;
+    }
+
+    void
+    tap_cache::set_directory(const std::string &dir)
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+      s.dir = dir;
+    }
+
+    std::string
+    tap_cache::directory()
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+      return cache_dir().string();
+    }
+
+    std::string
+    tap_cache::filename(const std::string &key)
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+      return cache_file(key).string();
+    }
+
+    void
+    tap_cache::clear()
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+      s.entries.clear();
+    }
+
+    size_t
+    tap_cache::size()
+    {
+      cache_state &s = state();
+      gruel::scoped_lock lock(s.mutex);
+      return s.entries.size();
+    }
+
+  } /* namespace filter */
+} /* namespace gr */
@@ -0,0 +1,146 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <filter/tap_designer.h>
+#include <iostream>
+#include <stdexcept>
+
+namespace gr {
+  namespace filter {
+
+    tap_designer &
+    tap_designer::instance()
+    {
+      static tap_designer designer;
+      return designer;
+    }
+
+    tap_designer::tap_designer()
+      : d_running(NULL), d_done(false)
+    {
+      d_thread = boost::shared_ptr<gruel::thread>
+	(new gruel::thread(boost::bind(&tap_designer::run, this)));
+    }
+
+    tap_designer::~tap_designer()
+    {
+      {
+	gruel::scoped_lock lock(d_mutex);
+	d_done = true;
+      }
+      d_cond.notify_all();
+      d_thread->join();
+    }
+
+    void
+    tap_designer::post(const void *target, const job &j)
+    {
+      gruel::scoped_lock lock(d_mutex);
+      for(std::deque<entry>::iterator it = d_queue.begin(); it != d_queue.end(); it++) {
+	if(it->first == target) {
+	  it->second = j;	// newest design wins, keeps its place
+	  return;
+	}
+      }
+      d_queue.push_back(entry(target, j));
+      lock.unlock();
+      d_cond.notify_all();
+    }
+
+    void
+    tap_designer::cancel(const void *target)
+    {
+      gruel::scoped_lock lock(d_mutex);
+      for(std::deque<entry>::iterator it = d_queue.begin(); it != d_queue.end(); it++) {
+	if(it->first == target) {
+	  d_queue.erase(it);
+	  break;
+	}
+      }
+      while(d_running == target)
+	d_cond.wait(lock);
+    }
+
+    void
+    tap_designer::wait()
+    {
+      gruel::scoped_lock lock(d_mutex);
+      while(!d_queue.empty() || d_running != NULL)
+	d_cond.wait(lock);
+    }
+
+    // callers hold the lock
+    bool
+    tap_designer::pending(const void *target) const
+    {
+      if(d_running == target)
+	return true;
+      for(std::deque<entry>::const_iterator it = d_queue.begin(); it != d_queue.end(); it++) {
+	if(it->first == target)
+	  return true;
+      }
+      return false;
+    }
+
+    void
+    tap_designer::wait(const void *target)
+    {
+      gruel::scoped_lock lock(d_mutex);
+      while(pending(target))
+	d_cond.wait(lock);
+    }
+
+    void
+    tap_designer::run()
+    {
+      gruel::scoped_lock lock(d_mutex);
+      while(true) {
+	if(d_done)
+	  return;
+	if(d_queue.empty()) {
+	  d_cond.wait(lock);
+	  continue;
+	}
+
+	// run the job outside of the lock
+	const entry e = d_queue.front();
+	d_queue.pop_front();
+	d_running = e.first;
+	lock.unlock();
+	try {
+	  e.second();
+	}
+	catch(const std::exception &ex) {
+	  std::cerr << "tap_designer: design failed: " << ex.what() << std::endl;
+	}
+	lock.lock();
+	d_running = NULL;
+	d_cond.notify_all();
+      }
+    }
+
+  } /* namespace filter */
+} /* namespace gr */
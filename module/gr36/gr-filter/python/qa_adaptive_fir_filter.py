@@ -21,6 +21,7 @@
 
 from gnuradio import gr, gr_unittest
 import filter_swig as filter
+import random
 
 class test_adaptive_filter(gr_unittest.TestCase):
 
@@ -154,6 +155,48 @@ class test_adaptive_filter(gr_unittest.TestCase):
         result_data = dst.data()
         self.assertComplexTuplesAlmostEqual(expected_data, result_data, 5)
 
+    def test_adaptive_lms_cc_001(self):
+        # identify a channel: desired[n] = sum(h[j] * x[n-j])
+        random.seed(0)
+        h = (0.1-0.2j, 1.0+0.3j, -0.4+0.1j, 0.2, 0.05j)
+        x = [complex(random.uniform(-1, 1), random.uniform(-1, 1))
+             for i in range(4000)]
+        d = [sum(h[j]*x[n-j] for j in range(len(h)) if n >= j)
+             for n in range(len(x))]
+
+        for normalized, mu, block_size in ((False, 0.05, 1), (True, 0.2, 4)):
+            self.tb = gr.top_block()
+            src = gr.vector_source_c(x)
+            ref = gr.vector_source_c(d)
+            op  = filter.adaptive_lms_cc(len(h), mu, normalized, block_size)
+            dst = gr.vector_sink_c()
+            self.tb.connect(src, (op, 0))
+            self.tb.connect(ref, (op, 1))
+            self.tb.connect(op, dst)
+            self.tb.run()
+            self.assertComplexTuplesAlmostEqual(h, op.taps(), 3)
+            self.assertComplexTuplesAlmostEqual(d[-100:], dst.data()[-100:], 3)
+
+    def test_adaptive_cma_cc_001(self):
+        # QPSK through a two tap channel comes back to the unit circle
+        random.seed(0)
+        a = 0.7071
+        sym = [complex(random.choice((-a, a)), random.choice((-a, a)))
+               for i in range(4001)]
+        rx = [sym[i+1] + (0.3+0.2j)*sym[i] for i in range(4000)]
+
+        src = gr.vector_source_c(rx)
+        op  = filter.adaptive_cma_cc(7, 1.0, 0.005)
+        dst = gr.vector_sink_c()
+        self.tb.connect(src, op, dst)
+        self.tb.run()
+        result_data = dst.data()
+
+        before = sum(abs(abs(v)**2 - 1) for v in rx[:500])
+        after = sum(abs(abs(v)**2 - 1) for v in result_data[-500:])
+        self.assertEqual(len(rx), len(result_data))
+        self.assertTrue(after < 0.2*before)
+
 if __name__ == '__main__':
     gr_unittest.run(test_adaptive_filter, "test_adaptive_filter.xml")
 
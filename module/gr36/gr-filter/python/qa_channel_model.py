@@ -55,6 +55,26 @@ class test_channel_model(gr_unittest.TestCase):
         dst_data = snk.data()
         exp_data = snk1.data()
         self.assertComplexTuplesAlmostEqual(exp_data, dst_data, 5)
-        
+
+    def test_001(self):
+        # The noise only depends on the seed, and has the set power
+        N = 10000
+        src = gr.vector_source_c(N*[0,])
+        op0 = filter.channel_model(0.5, 0.0, 1.0, [1,], 42)
+        op1 = filter.channel_model(0.5, 0.0, 1.0, [1,], 42)
+        snk0 = gr.vector_sink_c()
+        snk1 = gr.vector_sink_c()
+
+        self.tb.connect(src, op0, snk0)
+        self.tb.connect(src, op1, snk1)
+        self.tb.run()
+
+        data0 = snk0.data()
+        data1 = snk1.data()
+        self.assertEqual(data0, data1)
+
+        power = sum([abs(x)**2 for x in data0]) / len(data0)
+        self.assertAlmostEqual(2*0.5**2, power, 1)
+
 if __name__ == '__main__':
     gr_unittest.run(test_channel_model, "test_channel_model.xml")
@@ -78,6 +78,21 @@ class test_filter(gr_unittest.TestCase):
         result_data = dst.data()
         self.assertFloatTuplesAlmostEqual(expected_data, result_data, 5)
 
+    def test_fir_filter_fff_003(self):
+        # taps designed on the worker replace the old ones when ready
+        bands = (0, 0.2, 0.3, 1)
+        ampls = (1, 1, 0, 0)
+        op  = filter.fir_filter_fff(1, 20*[0.5, 0.5])
+        op.set_taps_remez(60, bands, ampls, (1, 10))
+        op.wait_for_taps()
+        expected_taps = filter.pm_remez(60, bands, ampls, (1, 10))
+        self.assertFloatTuplesAlmostEqual(expected_taps, op.taps(), 5)
+
+        # a failing design leaves the taps alone
+        op.set_taps_remez(2, bands, ampls, (1, 10))
+        op.wait_for_taps()
+        self.assertFloatTuplesAlmostEqual(expected_taps, op.taps(), 5)
+
     def test_fir_filter_ccf_001(self):
         src_data = 40*[1+1j, 2+2j, 3+3j, 4+4j]
         expected_data = ((0.5+0.5j), (1.5+1.5j), (3+3j), (5+5j), (5.5+5.5j),
@@ -152,6 +152,40 @@ class test_iir_filter(gr_unittest.TestCase):
         result_data = dst.data()
         self.assertFloatTuplesAlmostEqual (expected_result, result_data)
 
+    def test_iir_vlen_009(self):
+        # two interleaved signals through the same filter
+        src_data = (1, 8, 2, 7, 3, 6, 4, 5, 5, 4, 6, 3, 7, 2, 8, 1)
+        expected_result = (2, 16, 13, 86, 21, 51, 59, 283,
+                           58, -67, 186, 966, 68, -1130, 583, 4052)
+        fftaps = (2, 11)
+        fbtaps = (0, -1, 3)
+        src = gr.vector_source_f(src_data, False, 2)
+        op = filter.iir_filter_ffd(fftaps, fbtaps, 2)
+        dst = gr.vector_sink_f(2)
+        self.tb.connect(src, op)
+        self.tb.connect(op, dst)
+        self.tb.run()
+        result_data = dst.data()
+        self.assertFloatTuplesAlmostEqual (expected_result, result_data)
+
+    def test_iir_sections_010(self):
+        # sections given directly replace the taps
+        src_data = (1, 2, 3, 4, 5, 6, 7, 8)
+        sections = ((1, 2, 1, 0.5, -0.25), (0.5, 0, -0.5, -0.25, 0))
+        expected_result = (0.5, 2.125, 3.96875, 4.6953125, 4.544921875,
+                           4.30126953125, 4.2137451171875, 4.231719970703125)
+        src = gr.vector_source_f(src_data)
+        op = filter.iir_filter_ffd((2,), (0,))
+        op.set_sections(sections)
+        dst = gr.vector_sink_f()
+        self.tb.connect(src, op)
+        self.tb.connect(op, dst)
+        self.tb.run()
+        result_data = dst.data()
+        self.assertFloatTuplesAlmostEqual (expected_result, result_data)
+
+        self.assertRaises(RuntimeError, lambda: op.set_sections(((1, 2, 1),)))
+
 if __name__ == '__main__':
     gr_unittest.run(test_iir_filter, "test_iir_filter.xml")
 
@@ -183,6 +183,22 @@ class test_pm_remez(gr_unittest.TestCase):
 
         self.assertFloatTuplesAlmostEqual(known_taps, new_taps, 5)
 
+    def test_cached(self):
+        # Asking again for a design returns the cached taps
+        filter.tap_cache.clear()
+        bands = (0, 0.2, 0.3, 1)
+        ampls = (1, 1, 0, 0)
+        taps1 = filter.pm_remez(80, bands, ampls, (1, 10), "bandpass")
+        self.assertEqual(1, filter.tap_cache.size())
+        taps2 = filter.pm_remez(80, bands, ampls, (1, 10), "bandpass")
+        self.assertEqual(1, filter.tap_cache.size())
+        self.assertEqual(taps1, taps2)
+
+        # other weights are another design
+        taps3 = filter.pm_remez(80, bands, ampls, (1, 20), "bandpass")
+        self.assertEqual(2, filter.tap_cache.size())
+        self.assertNotEqual(taps1, taps3)
+
 if __name__ == '__main__':
     gr_unittest.run(test_pm_remez, "test_pm_remez.xml")
 
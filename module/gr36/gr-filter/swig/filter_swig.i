@@ -30,8 +30,11 @@
 %{
 #include "filter/firdes.h"
 #include "filter/pm_remez.h"
+#include "filter/tap_cache.h"
 #include "filter/adaptive_fir_ccc.h"
 #include "filter/adaptive_fir_ccf.h"
+#include "filter/adaptive_lms_cc.h"
+#include "filter/adaptive_cma_cc.h"
 #include "filter/dc_blocker_cc.h"
 #include "filter/dc_blocker_ff.h"
 #include "filter/filter_delay_fc.h"
@@ -78,8 +81,11 @@
 
 %include "filter/firdes.h"
 %include "filter/pm_remez.h"
+%include "filter/tap_cache.h"
 %include "filter/adaptive_fir_ccc.h"
 %include "filter/adaptive_fir_ccf.h"
+%include "filter/adaptive_lms_cc.h"
+%include "filter/adaptive_cma_cc.h"
 %include "filter/dc_blocker_cc.h"
 %include "filter/dc_blocker_ff.h"
 %include "filter/filter_delay_fc.h"
@@ -125,6 +131,8 @@
 
 GR_SWIG_BLOCK_MAGIC2(filter, adaptive_fir_ccc);
 GR_SWIG_BLOCK_MAGIC2(filter, adaptive_fir_ccf);
+GR_SWIG_BLOCK_MAGIC2(filter, adaptive_lms_cc);
+GR_SWIG_BLOCK_MAGIC2(filter, adaptive_cma_cc);
 GR_SWIG_BLOCK_MAGIC2(filter, dc_blocker_cc);
 GR_SWIG_BLOCK_MAGIC2(filter, dc_blocker_ff);
 GR_SWIG_BLOCK_MAGIC2(filter, filter_delay_fc);
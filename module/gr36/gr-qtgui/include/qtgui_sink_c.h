@@ -27,11 +27,12 @@
 #include <gr_qtgui_api.h>
 #include <gr_block.h>
 #include <gr_firdes.h>
-#include <gri_fft.h>
 #include <qapplication.h>
 #include <gruel/high_res_timer.h>
 #include "SpectrumGUIClass.h"
 
+class SpectrumEngine;
+
 class qtgui_sink_c;
 typedef boost::shared_ptr<qtgui_sink_c> qtgui_sink_c_sptr;
 
@@ -75,18 +76,9 @@ private:
 
   int d_fftsize;
   gr_firdes::win_type d_wintype;
-  std::vector<float> d_window;
   double d_center_freq;
   double d_bandwidth;
   std::string d_name;
-  gruel::high_res_timer_type  d_last_update;
-  bool d_update_active;
-
-  bool d_shift;
-  gri_fft_complex *d_fft;
-
-  int d_index;
-  gr_complex *d_residbuf;
 
   bool d_plotfreq, d_plotwaterfall, d_plottime, d_plotconst;
 
@@ -94,11 +86,7 @@ private:
 
   QWidget *d_parent;
   SpectrumGUIClass *d_main_gui;
-
-  void windowreset();
-  void buildwindow();
-  void fftresize();
-  void fft(const gr_complex *data_in, int size);
+  SpectrumEngine *d_engine;
 
 public:
   ~qtgui_sink_c();
@@ -117,6 +105,14 @@ public:
 
   void set_update_time(double t);
 
+  /*!
+   * How the PSDs computed during one update period are combined
+   * into the displayed spectrum: 0 shows the latest one only
+   * (the sink then skips the samples in between), 1 averages
+   * them (default), 2 holds the maximum per bin.
+   */
+  void set_psd_mode(int mode);
+
   QApplication *d_qApplication;
 
   int general_work (int noutput_items,
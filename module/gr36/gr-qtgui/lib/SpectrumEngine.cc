@@ -0,0 +1,416 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <SpectrumEngine.h>
+#include <SpectrumGUIClass.h>
+#include <spectrumUpdateEvents.h>
+#include <gr_firdes.h>
+#include <gri_fft.h>
+#include <volk/volk.h>
+#include <QCoreApplication>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <string.h>
+#include <math.h>
+
+/***********************************************************************
+ * Triple buffer index exchange
+ **********************************************************************/
+SpectrumTripleBuffer::SpectrumTripleBuffer()
+  : _write(0), _read(1), _middle(2)
+{
+}
+
+bool
+SpectrumTripleBuffer::Publish()
+{
+  const int old = gruel::atomic_exchange(&_middle, _write | FRESH);
+  _write = old & ~FRESH;
+  return (old & FRESH) != 0;
+}
+
+bool
+SpectrumTripleBuffer::Acquire()
+{
+  // only the producer touches _middle in between, and it can only
+  // replace a fresh slot with a fresher one
+  if(!Pending()) {
+    return false;
+  }
+  const int old = gruel::atomic_exchange(&_middle, _read);
+  _read = old & ~FRESH;
+  return true;
+}
+
+bool
+SpectrumTripleBuffer::Pending() const
+{
+  return (gruel::atomic_load(&_middle) & FRESH) != 0;
+}
+
+/***********************************************************************
+ * Spectrum engine
+ **********************************************************************/
+SpectrumEngine::SpectrumEngine(SpectrumGUIClass *gui, const int maxFFTSize)
+  : _gui(gui), _maxFFTSize(maxFFTSize)
+{
+  for(int i = 0; i < 3; i++) {
+    _captureBuffer[i] = gri_fft_malloc_complex(_maxFFTSize);
+    _captureSize[i] = 0;
+    _captureTime[i] = 0;
+    _frames[i].fftSize = 0;
+    _frames[i].psd = gri_fft_malloc_float(_maxFFTSize);
+    _frames[i].samples = gri_fft_malloc_complex(_maxFFTSize);
+    _frames[i].timestamp = 0;
+    _frames[i].droppedFrames = 0;
+    _frames[i].averagedFrames = 0;
+  }
+  _captureFill = 0;
+  _captureTarget = 0;
+  _droppedCaptures = 0;
+  _frameEventPending = 0;
+
+  // the engine is made on the thread that set up the GUI,
+  // later changes come in through SetDisplaySettings
+  _requestedFFTSize = _gui->GetFFTSize();
+  _requestedWindowType = _gui->GetWindowType();
+  _fftSize = std::min(std::max(_requestedFFTSize, 2), _maxFFTSize);
+  _wantCapture = 1;
+  _psdMode = PSD_AVERAGE;
+  _running = 0;
+  SetFramePeriod(0.1);
+
+  _thread = NULL;
+  _fft = NULL;
+  _windowType = -1;
+  _window = gri_fft_malloc_float(_maxFFTSize);
+  _psd = gri_fft_malloc_float(_maxFFTSize);
+  _accumulated = gri_fft_malloc_float(_maxFFTSize);
+  _accumulatedCount = 0;
+  _accumulatedMode = PSD_AVERAGE;
+  _lastDroppedCaptures = 0;
+}
+
+SpectrumEngine::~SpectrumEngine()
+{
+  Stop();
+
+  // a frame event may still be queued with a pointer to us
+  QCoreApplication::removePostedEvents(_gui->qwidget(), 10011);
+
+  for(int i = 0; i < 3; i++) {
+    gri_fft_free(_captureBuffer[i]);
+    gri_fft_free(_frames[i].psd);
+    gri_fft_free(_frames[i].samples);
+  }
+  gri_fft_free(_window);
+  gri_fft_free(_psd);
+  gri_fft_free(_accumulated);
+  delete _fft;
+}
+
+void
+SpectrumEngine::Start()
+{
+  if(_thread != NULL) {
+    return;
+  }
+  gruel::atomic_store(&_running, 1);
+  _thread = new gruel::thread(boost::bind(&SpectrumEngine::_Run, this));
+}
+
+void
+SpectrumEngine::Stop()
+{
+  if(_thread == NULL) {
+    return;
+  }
+  gruel::atomic_store(&_running, 0);
+  _wakeCond.notify_one();
+  _thread->join();
+  delete _thread;
+  _thread = NULL;
+}
+
+void
+SpectrumEngine::SetDisplaySettings(const int fftSize, const int windowType)
+{
+  gruel::scoped_lock lock(_settingsMutex);
+  _requestedFFTSize = fftSize;
+  _requestedWindowType = windowType;
+}
+
+void
+SpectrumEngine::SetFramePeriod(const double seconds)
+{
+  _framePeriod = (gruel::high_res_timer_type)(seconds * gruel::high_res_timer_tps());
+}
+
+void
+SpectrumEngine::SetPSDMode(const int mode)
+{
+  if((mode < PSD_LATEST) || (mode > PSD_MAX_HOLD)) {
+    throw std::out_of_range("SpectrumEngine: invalid PSD mode");
+  }
+  gruel::atomic_store(&_psdMode, mode);
+  _wakeCond.notify_one();
+}
+
+int
+SpectrumEngine::GetPSDMode() const
+{
+  return gruel::atomic_load(&_psdMode);
+}
+
+/***********************************************************************
+ * Scheduler thread: copy samples into the capture buffer, never block
+ **********************************************************************/
+void
+SpectrumEngine::Push(const gr_complex *in, const int nitems)
+{
+  _Push(in, nitems);
+}
+
+void
+SpectrumEngine::Push(const float *in, const int nitems)
+{
+  _Push(in, nitems);
+}
+
+template <typename T> void
+SpectrumEngine::_Push(const T *in, const int nitems)
+{
+  int j = 0;
+  while(j < nitems) {
+    // Between captures, only start a new one when the worker wants it;
+    // the remaining samples are decimated away
+    if(_captureFill == 0) {
+      if(!gruel::atomic_load(&_wantCapture)) {
+	return;
+      }
+      _captureTarget = gruel::atomic_load(&_fftSize);
+    }
+
+    const int slot = _captures.WriteIndex();
+    const int n = std::min(nitems - j, _captureTarget - _captureFill);
+    std::copy(in + j, in + j + n, _captureBuffer[slot] + _captureFill);
+    _captureFill += n;
+    j += n;
+
+    if(_captureFill == _captureTarget) {
+      _captureSize[slot] = _captureTarget;
+      _captureTime[slot] = gruel::high_res_timer_now();
+      if(_captures.Publish()) {
+	gruel::atomic_add(&_droppedCaptures, 1);
+      }
+      _captureFill = 0;
+      _wakeCond.notify_one();
+    }
+  }
+}
+
+/***********************************************************************
+ * Worker thread: FFT, PSD and frame decimation
+ **********************************************************************/
+void
+SpectrumEngine::_Run()
+{
+  gruel::high_res_timer_type deadline = gruel::high_res_timer_now() + _framePeriod;
+
+  while(gruel::atomic_load(&_running)) {
+    _Configure();
+
+    if(_captures.Acquire()) {
+      const int slot = _captures.ReadIndex();
+      // captures started before an FFT size change are discarded
+      if(_captureSize[slot] == _fftSize) {
+	_ProcessCapture(slot);
+      }
+    }
+    else {
+      const gruel::high_res_timer_type remaining = deadline - gruel::high_res_timer_now();
+      const gruel::high_res_timer_type limit = gruel::high_res_timer_tps()/100;
+      const long usecs = (long)((std::min(remaining, limit) * 1000000) / gruel::high_res_timer_tps());
+      if(usecs > 0) {
+	// the producer notifies without the lock, so a wakeup can be
+	// missed; the timeout bounds the latency in that case
+	gruel::scoped_lock lock(_wakeMutex);
+	if(!_captures.Pending()) {
+	  _wakeCond.timed_wait(lock, boost::posix_time::microseconds(usecs));
+	}
+      }
+    }
+
+    const gruel::high_res_timer_type now = gruel::high_res_timer_now();
+    const bool latest = (gruel::atomic_load(&_psdMode) == PSD_LATEST);
+
+    // In latest mode one capture per frame period is enough:
+    // show it right away and stop the sink from copying more
+    if(latest && (_accumulatedCount > 0)) {
+      gruel::atomic_store(&_wantCapture, 0);
+      _PublishFrame();
+    }
+
+    if(now >= deadline) {
+      if(_accumulatedCount > 0) {
+	_PublishFrame();
+      }
+      if(latest) {
+	_captures.Acquire(); // drop a capture that finished after the last frame
+      }
+      gruel::atomic_store(&_wantCapture, 1);
+      deadline = now + _framePeriod;
+    }
+  }
+}
+
+void
+SpectrumEngine::_Configure()
+{
+  int fftSize, windowType;
+  {
+    gruel::scoped_lock lock(_settingsMutex);
+    fftSize = std::min(std::max(_requestedFFTSize, 2), _maxFFTSize);
+    windowType = _requestedWindowType;
+  }
+
+
+  if((_fft == NULL) || (fftSize != _fftSize)) {
+    delete _fft;
+    _fft = new gri_fft_complex(fftSize, true);
+    gruel::atomic_store(&_fftSize, fftSize);
+    _accumulatedCount = 0;
+    _windowType = -1;
+  }
+
+  if(windowType != _windowType) {
+    _windowType = windowType;
+    std::vector<float> window;
+    if(_windowType != 0) {
+      window = gr_firdes::window((gr_firdes::win_type)_windowType, fftSize, 6.76);
+    }
+    if(window.size() == (size_t)fftSize) {
+      std::copy(window.begin(), window.end(), _window);
+    }
+    else {
+      std::fill(_window, _window + fftSize, 1.0f);
+    }
+  }
+}
+
+void
+SpectrumEngine::_ProcessCapture(const int slot)
+{
+  const int n = _fftSize;
+  const int mode = gruel::atomic_load(&_psdMode);
+
+  // all buffers come from the fftw allocator and are aligned
+  volk_32fc_32f_multiply_32fc_a(_fft->get_inbuf(), _captureBuffer[slot], _window, n);
+  _fft->execute();
+  // keep linear power so that averaging is done on power, not on dB
+  volk_32fc_magnitude_squared_32f_a(_psd, _fft->get_outbuf(), n);
+
+  if((_accumulatedCount == 0) || (mode != _accumulatedMode) || (mode == PSD_LATEST)) {
+    memcpy(_accumulated, _psd, n*sizeof(float));
+    _accumulatedMode = mode;
+    _accumulatedCount = 0;
+  }
+  else if(mode == PSD_AVERAGE) {
+    volk_32f_x2_add_32f_a(_accumulated, _accumulated, _psd, n);
+  }
+  else {
+    volk_32f_x2_max_32f_a(_accumulated, _accumulated, _psd, n);
+  }
+  _accumulatedCount++;
+
+  // the display write slot belongs to this thread until it is published
+  SpectrumFrame &frame = _frames[_display.WriteIndex()];
+  memcpy(frame.samples, _captureBuffer[slot], n*sizeof(gr_complex));
+  frame.timestamp = _captureTime[slot];
+}
+
+void
+SpectrumEngine::_PublishFrame()
+{
+  const int n = _fftSize;
+  SpectrumFrame &frame = _frames[_display.WriteIndex()];
+
+  // normalize by the FFT size (and the number of averaged captures)
+  float scale = 1.0f/((float)n*(float)n);
+  if(_accumulatedMode == PSD_AVERAGE) {
+    scale /= _accumulatedCount;
+  }
+  volk_32f_s32f_multiply_32f_a(_accumulated, _accumulated, scale, n);
+
+  // Convert to dB once per frame, performing the fftshift operation
+  // while copying into the frame
+  const int half = n/2;
+  for(int i = 0; i < n; i++) {
+    const int k = (i < n - half)? i + half : i - (n - half);
+    frame.psd[i] = 10.0f*log10f(_accumulated[k] + 1e-20f);
+  }
+
+  const int dropped = gruel::atomic_load(&_droppedCaptures);
+  frame.fftSize = n;
+  frame.averagedFrames = _accumulatedCount;
+  frame.droppedFrames = dropped - _lastDroppedCaptures;
+  _lastDroppedCaptures = dropped;
+  _accumulatedCount = 0;
+
+  _display.Publish();
+  _PostFrameEvent();
+}
+
+void
+SpectrumEngine::_PostFrameEvent()
+{
+  // at most one frame event in the Qt event loop at any time
+  if(gruel::atomic_cas(&_frameEventPending, 0, 1)) {
+    QCoreApplication::postEvent(_gui->qwidget(), new SpectrumFrameEvent(this));
+  }
+}
+
+/***********************************************************************
+ * GUI thread: consume display frames
+ **********************************************************************/
+const SpectrumFrame *
+SpectrumEngine::AcquireFrame()
+{
+  if(!_display.Acquire()) {
+    return NULL;
+  }
+  return &_frames[_display.ReadIndex()];
+}
+
+void
+SpectrumEngine::FrameEventDone()
+{
+  gruel::atomic_store(&_frameEventPending, 0);
+
+  // a frame published while the event was being handled
+  // did not post its own event, so post one for it now
+  if(_display.Pending()) {
+    _PostFrameEvent();
+  }
+}
@@ -0,0 +1,180 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SPECTRUM_ENGINE_H
+#define SPECTRUM_ENGINE_H
+
+#include <gr_complex.h>
+#include <gruel/thread.h>
+#include <gruel/high_res_timer.h>
+#include <gruel/atomic.h>
+
+class SpectrumGUIClass;
+class gri_fft_complex;
+
+/*!
+ * Index bookkeeping for a lock-free triple buffer with one producer
+ * and one consumer. The producer always owns one slot to write, the
+ * consumer always owns one slot to read, and the third slot is
+ * exchanged between them. Neither side ever waits on the other; a
+ * slot published before the consumer took the previous one is simply
+ * overwritten (the frame is dropped).
+ */
+class SpectrumTripleBuffer
+{
+public:
+  SpectrumTripleBuffer();
+
+  int WriteIndex() const { return _write; }
+  int ReadIndex() const { return _read; }
+
+  //! Producer: hand over the write slot, returns true if an unread slot was dropped
+  bool Publish();
+
+  //! Consumer: take the most recently published slot, false if none is new
+  bool Acquire();
+
+  //! True when a published slot has not been taken yet
+  bool Pending() const;
+
+private:
+  enum { FRESH = 4 };
+  int _write;
+  int _read;
+  volatile int _middle;
+};
+
+/*!
+ * One display frame as handed to the GUI thread.
+ */
+struct SpectrumFrame
+{
+  int fftSize;
+  float *psd;              //!< fftshifted PSD in dB, fftSize points
+  gr_complex *samples;     //!< time domain samples of the last capture
+  gruel::high_res_timer_type timestamp;
+  int droppedFrames;       //!< captures overwritten since the last frame
+  int averagedFrames;      //!< PSDs combined into this frame
+};
+
+/*!
+ * Spectrum engine for the qtgui sinks.
+ *
+ * The scheduler thread only copies samples into a capture triple
+ * buffer (Push never blocks and never runs an FFT). A worker thread
+ * windows and FFTs the captures, combines their linear power over one
+ * frame period (latest, average or max hold), converts the result to
+ * dB and publishes it into a display triple buffer. The GUI thread is
+ * notified with at most one outstanding event.
+ *
+ * The worker never reads the GUI class; the GUI thread hands it the
+ * FFT size and window type with SetDisplaySettings.
+ *
+ * In PSD_LATEST mode the worker only asks for one capture per frame
+ * period, so the sink stops copying samples in between.
+ */
+class SpectrumEngine
+{
+public:
+  enum PSDMode {
+    PSD_LATEST = 0,
+    PSD_AVERAGE = 1,
+    PSD_MAX_HOLD = 2
+  };
+
+  SpectrumEngine(SpectrumGUIClass *gui, const int maxFFTSize);
+  ~SpectrumEngine();
+
+  void Start();
+  void Stop();
+
+  //! Scheduler thread: offer complex samples, all of them are consumed
+  void Push(const gr_complex *in, const int nitems);
+
+  //! Scheduler thread: offer real samples, all of them are consumed
+  void Push(const float *in, const int nitems);
+
+  //! GUI thread: snapshot of the FFT size and window type to use
+  void SetDisplaySettings(const int fftSize, const int windowType);
+
+  void SetFramePeriod(const double seconds);
+  void SetPSDMode(const int mode);
+  int GetPSDMode() const;
+
+  //! GUI thread: the newest frame, or NULL if nothing new was published
+  const SpectrumFrame *AcquireFrame();
+
+  //! GUI thread: done with the frame event, allows the next one to be posted
+  void FrameEventDone();
+
+private:
+  template <typename T> void _Push(const T *in, const int nitems);
+  void _Run();
+  void _Configure();
+  void _ProcessCapture(const int slot);
+  void _PublishFrame();
+  void _PostFrameEvent();
+
+  SpectrumGUIClass *_gui;
+  const int _maxFFTSize;
+
+  // capture triple buffer, filled by the scheduler thread
+  SpectrumTripleBuffer _captures;
+  gr_complex *_captureBuffer[3];
+  int _captureSize[3];
+  gruel::high_res_timer_type _captureTime[3];
+  int _captureFill;
+  int _captureTarget;
+  volatile int _droppedCaptures;
+
+  // display triple buffer, filled by the worker thread
+  SpectrumTripleBuffer _display;
+  SpectrumFrame _frames[3];
+  volatile int _frameEventPending;
+
+  // settings shared between the threads
+  volatile int _fftSize;
+  volatile int _wantCapture;
+  volatile int _psdMode;
+  volatile int _running;
+  volatile gruel::high_res_timer_type _framePeriod;
+
+  // display settings from the GUI thread, guarded by _settingsMutex
+  gruel::mutex _settingsMutex;
+  int _requestedFFTSize;
+  int _requestedWindowType;
+
+  // worker thread state
+  gruel::thread *_thread;
+  gruel::mutex _wakeMutex;
+  gruel::condition_variable _wakeCond;
+  gri_fft_complex *_fft;
+  int _windowType;
+  float *_window;
+  float *_psd;
+  float *_accumulated;     //!< linear power, converted to dB on publish
+  int _accumulatedCount;
+  int _accumulatedMode;
+  int _lastDroppedCaptures;
+};
+
+#endif /* SPECTRUM_ENGINE_H */
@@ -25,6 +25,7 @@
 #endif
 
 #include <qtgui_sink_c.h>
+#include <SpectrumEngine.h>
 #include <gr_io_signature.h>
 #include <string.h>
 
@@ -62,26 +63,15 @@ qtgui_sink_c::qtgui_sink_c (int fftsize, int wintype,
     d_parent(parent)
 {
   d_main_gui = NULL;
-
-  // Perform fftshift operation;
-  // this is usually desired when plotting
-  d_shift = true;
-
-  d_fft = new gri_fft_complex (d_fftsize, true);
-
-  d_index = 0;
-  d_residbuf = new gr_complex[d_fftsize];
-
-  buildwindow();
+  d_engine = NULL;
 
   initialize();
 }
 
 qtgui_sink_c::~qtgui_sink_c()
 {
+  delete d_engine;
   delete d_main_gui;
-  delete [] d_residbuf;
-  delete d_fft;
 }
 
 void
@@ -123,11 +113,13 @@ qtgui_sink_c::initialize()
 				 d_plotfreq, d_plotwaterfall,
 				 d_plottime, d_plotconst);
 
+  // The FFTs run on the engine's thread, general_work only hands it samples
+  d_engine = new SpectrumEngine(d_main_gui, SpectrumGUIClass::MAX_FFT_SIZE);
+
   // initialize update time to 10 times a second
   set_update_time(0.5);
 
-  d_last_update = gruel::high_res_timer_now();
-  d_update_active = false;
+  d_engine->Start();
 }
 
 
@@ -193,118 +185,26 @@ qtgui_sink_c::set_update_time(double t)
 {
   d_update_time = t * gruel::high_res_timer_tps();
   d_main_gui->SetUpdateTime(t);
+  d_engine->SetFramePeriod(t);
 }
 
 void
-qtgui_sink_c::fft(const gr_complex *data_in, int size)
+qtgui_sink_c::set_psd_mode(int mode)
 {
-  if (d_window.size()) {
-    gr_complex *dst = d_fft->get_inbuf();
-    int i;
-    for (i = 0; i < size; i++)		// apply window
-      dst[i] = data_in[i] * d_window[i];
-  }
-  else {
-    memcpy (d_fft->get_inbuf(), data_in, sizeof(gr_complex)*size);
-  }
-
-  d_fft->execute ();     // compute the fft
-}
-
-void
-qtgui_sink_c::windowreset()
-{
-  gr_firdes::win_type newwintype = (gr_firdes::win_type)d_main_gui->GetWindowType();
-  if(d_wintype != newwintype) {
-    d_wintype = newwintype;
-    buildwindow();
-  }
-}
-
-void
-qtgui_sink_c::buildwindow()
-{
-  d_window.clear();
-  if(d_wintype != 0) {
-    d_window = gr_firdes::window(d_wintype, d_fftsize, 6.76);
-  }
+  d_engine->SetPSDMode(mode);
 }
 
-void
-qtgui_sink_c::fftresize()
-{
-  int newfftsize = d_main_gui->GetFFTSize();
-
-  if(newfftsize != d_fftsize) {
-
-    // Resize residbuf and replace data
-    delete [] d_residbuf;
-    d_residbuf = new gr_complex[newfftsize];
-
-    // Set new fft size and reset buffer index
-    // (throws away any currently held data, but who cares?)
-    d_fftsize = newfftsize;
-    d_index = 0;
-
-    // Reset window to reflect new size
-    buildwindow();
-
-    // Reset FFTW plan for new size
-    delete d_fft;
-    d_fft = new gri_fft_complex (d_fftsize, true);
-  }
-}
-
-
 int
 qtgui_sink_c::general_work (int noutput_items,
 			    gr_vector_int &ninput_items,
 			    gr_vector_const_void_star &input_items,
 			    gr_vector_void_star &output_items)
 {
-  int j=0;
   const gr_complex *in = (const gr_complex*)input_items[0];
 
-  // Update the FFT size from the application
-  fftresize();
-  windowreset();
-
-  for(int i=0; i < noutput_items; i+=d_fftsize) {
-    unsigned int datasize = noutput_items - i;
-    unsigned int resid = d_fftsize-d_index;
-
-    if (!d_update_active && (gruel::high_res_timer_now() - d_last_update) < d_update_time) {
-      consume_each(noutput_items);
-      return noutput_items;
-    } else {
-      d_last_update = gruel::high_res_timer_now();
-      d_update_active = true;
-    }
-
-    // If we have enough input for one full FFT, do it
-    if(datasize >= resid) {
-      const gruel::high_res_timer_type currentTime = gruel::high_res_timer_now();
-
-      // Fill up residbuf with d_fftsize number of items
-      memcpy(d_residbuf+d_index, &in[j], sizeof(gr_complex)*resid);
-      d_index = 0;
-
-      j += resid;
-      fft(d_residbuf, d_fftsize);
-
-      d_main_gui->UpdateWindow(true, d_fft->get_outbuf(), d_fftsize,
-			       NULL, 0, (float*)d_residbuf, d_fftsize,
-			       currentTime, true);
-      d_update_active = false;
-    }
-    // Otherwise, copy what we received into the residbuf for next time
-    else {
-      memcpy(d_residbuf+d_index, &in[j], sizeof(gr_complex)*datasize);
-      d_index += datasize;
-      j += datasize;
-    }
-  }
+  // Never blocks: samples the spectrum engine does not want are dropped
+  d_engine->Push(in, noutput_items);
 
-  consume_each(j);
-  return j;
+  consume_each(noutput_items);
+  return noutput_items;
 }
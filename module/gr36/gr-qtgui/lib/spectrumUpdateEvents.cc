@@ -178,6 +178,22 @@ SpectrumFrequencyRangeEvent::GetStopFrequency() const
 }
 
 
+SpectrumFrameEvent::SpectrumFrameEvent(SpectrumEngine* engine)
+  : QEvent(QEvent::Type(10011))
+{
+  _engine = engine;
+}
+
+SpectrumFrameEvent::~SpectrumFrameEvent()
+{
+}
+
+SpectrumEngine*
+SpectrumFrameEvent::getEngine() const
+{
+  return _engine;
+}
+
 /***************************************************************************/
 #include <iostream>
 TimeUpdateEvent::TimeUpdateEvent(const std::vector<double*> timeDomainPoints,
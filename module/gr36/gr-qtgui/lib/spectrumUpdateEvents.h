@@ -8,6 +8,8 @@
 #include <vector>
 #include <gruel/high_res_timer.h>
 
+class SpectrumEngine;
+
 class SpectrumUpdateEvent:public QEvent{
 
 public:
@@ -89,6 +91,22 @@ private:
   double _stopFrequency;
 };
 
+/*!
+ * Tells the display that the spectrum engine published a new frame.
+ * The frame itself stays in the engine's display buffer.
+ */
+class SpectrumFrameEvent:public QEvent{
+public:
+  SpectrumFrameEvent(SpectrumEngine* engine);
+  ~SpectrumFrameEvent();
+  SpectrumEngine* getEngine() const;
+
+protected:
+
+private:
+  SpectrumEngine* _engine;
+};
+
 
 class TimeUpdateEvent: public QEvent
 {
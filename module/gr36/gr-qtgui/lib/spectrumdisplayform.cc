@@ -24,6 +24,8 @@
 #include <QColorDialog>
 #include <QMessageBox>
 #include <spectrumdisplayform.h>
+#include <SpectrumEngine.h>
+#include <algorithm>
 
 SpectrumDisplayForm::SpectrumDisplayForm(QWidget* parent)
   : QWidget(parent)
@@ -151,10 +153,6 @@ SpectrumDisplayForm::newFrequencyData( const SpectrumUpdateEvent* spectrumUpdate
   double* realTimeDomainDataPoints = (double*)spectrumUpdateEvent->getRealTimeDomainPoints();
   double* imagTimeDomainDataPoints = (double*)spectrumUpdateEvent->getImagTimeDomainPoints();
 
-  std::vector<double*> timeDomainDataPoints;
-  timeDomainDataPoints.push_back(realTimeDomainDataPoints);
-  timeDomainDataPoints.push_back(imagTimeDomainDataPoints);
-
   // REMEMBER: The dataTimestamp is NOT valid when the repeat data flag is true...
   ResizeBuffers(numFFTDataPoints, numTimeDomainDataPoints);
 
@@ -162,24 +160,11 @@ SpectrumDisplayForm::newFrequencyData( const SpectrumUpdateEvent* spectrumUpdate
   const std::complex<float>* complexDataPointsPtr = complexDataPoints+numFFTDataPoints/2;
   double* realFFTDataPointsPtr = _realFFTDataPoints;
 
-  double sumMean = 0.0;
-  double localPeakAmplitude = -HUGE_VAL;
-  double localPeakFrequency = 0.0;
-  const double fftBinSize = (_stopFrequency-_startFrequency) /
-    static_cast<double>(numFFTDataPoints);
-
   // Run this twice to perform the fftshift operation on the data here as well
   std::complex<float> scaleFactor = std::complex<float>((float)numFFTDataPoints);
   for(uint64_t point = 0; point < numFFTDataPoints/2; point++){
     std::complex<float> pt = (*complexDataPointsPtr) / scaleFactor;
     *realFFTDataPointsPtr = 10.0*log10((pt.real() * pt.real() + pt.imag()*pt.imag()) + 1e-20);
-
-    if(*realFFTDataPointsPtr > localPeakAmplitude) {
-      localPeakFrequency = static_cast<float>(point) * fftBinSize;
-      localPeakAmplitude = *realFFTDataPointsPtr;
-    }
-    sumMean += *realFFTDataPointsPtr;
-
     complexDataPointsPtr++;
     realFFTDataPointsPtr++;
   }
@@ -190,15 +175,70 @@ SpectrumDisplayForm::newFrequencyData( const SpectrumUpdateEvent* spectrumUpdate
   for(uint64_t point = 0; point < numFFTDataPoints/2; point++){
     std::complex<float> pt = (*complexDataPointsPtr) / scaleFactor;
     *realFFTDataPointsPtr = 10.0*log10((pt.real() * pt.real() + pt.imag()*pt.imag()) + 1e-20);
+    complexDataPointsPtr++;
+    realFFTDataPointsPtr++;
+  }
+
+  _plotFrequencyData(numFFTDataPoints,
+		     realTimeDomainDataPoints, imagTimeDomainDataPoints,
+		     numTimeDomainDataPoints, dataTimestamp,
+		     repeatDataFlag, lastOfMultipleUpdatesFlag,
+		     spectrumUpdateEvent->getDroppedFFTFrames());
+
+  // Tell the system the GUI has been updated
+  if(lastOfMultipleUpdatesFlag && _systemSpecifiedFlag){
+    _system->SetLastGUIUpdateTime(generatedTimestamp);
+    _system->DecrementPendingGUIUpdateEvents();
+  }
+}
+
+void
+SpectrumDisplayForm::newSpectrumFrame( const SpectrumFrame* frame )
+{
+  // The engine already computed the fftshifted PSD in dB
+  const uint64_t numFFTDataPoints = frame->fftSize;
+  ResizeBuffers(numFFTDataPoints, numFFTDataPoints);
+  std::copy(frame->psd, frame->psd + numFFTDataPoints, _realFFTDataPoints);
+
+  _realTimeDomainPoints.resize(numFFTDataPoints);
+  _imagTimeDomainPoints.resize(numFFTDataPoints);
+  for(uint64_t number = 0; number < numFFTDataPoints; number++){
+    _realTimeDomainPoints[number] = frame->samples[number].real();
+    _imagTimeDomainPoints[number] = frame->samples[number].imag();
+  }
+
+  _plotFrequencyData(numFFTDataPoints,
+		     &_realTimeDomainPoints[0], &_imagTimeDomainPoints[0],
+		     numFFTDataPoints, frame->timestamp,
+		     false, true, frame->droppedFrames);
+}
 
-    if(*realFFTDataPointsPtr > localPeakAmplitude) {
+void
+SpectrumDisplayForm::_plotFrequencyData(const uint64_t numFFTDataPoints,
+					double* realTimeDomainDataPoints,
+					double* imagTimeDomainDataPoints,
+					const uint64_t numTimeDomainDataPoints,
+					const gruel::high_res_timer_type dataTimestamp,
+					const bool repeatDataFlag,
+					const bool lastOfMultipleUpdatesFlag,
+					const int droppedFFTFrames)
+{
+  std::vector<double*> timeDomainDataPoints;
+  timeDomainDataPoints.push_back(realTimeDomainDataPoints);
+  timeDomainDataPoints.push_back(imagTimeDomainDataPoints);
+
+  double sumMean = 0.0;
+  double localPeakAmplitude = -HUGE_VAL;
+  double localPeakFrequency = 0.0;
+  const double fftBinSize = (_stopFrequency-_startFrequency) /
+    static_cast<double>(numFFTDataPoints);
+
+  for(uint64_t point = 0; point < numFFTDataPoints; point++){
+    if(_realFFTDataPoints[point] > localPeakAmplitude) {
       localPeakFrequency = static_cast<float>(point) * fftBinSize;
-      localPeakAmplitude = *realFFTDataPointsPtr;
+      localPeakAmplitude = _realFFTDataPoints[point];
     }
-    sumMean += *realFFTDataPointsPtr;
-
-    complexDataPointsPtr++;
-    realFFTDataPointsPtr++;
+    sumMean += _realFFTDataPoints[point];
   }
 
   // Don't update the averaging history if this is repeated data
@@ -254,15 +294,9 @@ SpectrumDisplayForm::newFrequencyData( const SpectrumUpdateEvent* spectrumUpdate
       if(tabindex == d_plot_waterfall) {
 	_waterfallDisplayPlot->PlotNewData(_realFFTDataPoints, numFFTDataPoints,
 					   d_update_time, dataTimestamp,
-					   spectrumUpdateEvent->getDroppedFFTFrames());
+					   droppedFFTFrames);
       }
     }
-
-    // Tell the system the GUI has been updated
-    if(_systemSpecifiedFlag){
-      _system->SetLastGUIUpdateTime(generatedTimestamp);
-      _system->DecrementPendingGUIUpdateEvents();
-    }
   }
 }
 
@@ -306,6 +340,18 @@ SpectrumDisplayForm::customEvent( QEvent * e)
     SpectrumUpdateEvent* spectrumUpdateEvent = (SpectrumUpdateEvent*)e;
     newFrequencyData(spectrumUpdateEvent);
   }
+  else if(e->type() == 10011){
+    SpectrumEngine* engine = ((SpectrumFrameEvent*)e)->getEngine();
+    if(_systemSpecifiedFlag){
+      // hand the worker the settings as seen from the GUI thread
+      engine->SetDisplaySettings(_system->GetFFTSize(), _system->GetWindowType());
+    }
+    const SpectrumFrame* frame = engine->AcquireFrame();
+    if(frame != NULL){
+      newSpectrumFrame(frame);
+    }
+    engine->FrameEventDone();
+  }
   else if(e->type() == 10008){
     setWindowTitle(((SpectrumWindowCaptionEvent*)e)->getLabel());
   }
@@ -26,6 +26,7 @@
 #include "spectrumdisplayform.ui.h"
 
 class SpectrumGUIClass;
+struct SpectrumFrame;
 #include <SpectrumGUIClass.h>
 
 #include <SpectrumGUIClass.h>
@@ -91,6 +92,7 @@ public slots:
 
 private slots:
   void newFrequencyData( const SpectrumUpdateEvent* );
+  void newSpectrumFrame( const SpectrumFrame* );
   void UpdateGuiTimer();
 
   void onFFTPlotPointSelected(const QPointF p);
@@ -103,6 +105,14 @@ signals:
 
 private:
   void _AverageHistory( const double * newBuffer );
+  void _plotFrequencyData( const uint64_t numFFTDataPoints,
+			   double* realTimeDomainDataPoints,
+			   double* imagTimeDomainDataPoints,
+			   const uint64_t numTimeDomainDataPoints,
+			   const gruel::high_res_timer_type dataTimestamp,
+			   const bool repeatDataFlag,
+			   const bool lastOfMultipleUpdatesFlag,
+			   const int droppedFFTFrames );
 
   int _historyEntryCount;
   int _historyEntry;
@@ -110,6 +120,8 @@ private:
   double* _averagedValues;
   uint64_t _numRealDataPoints;
   double* _realFFTDataPoints;
+  std::vector<double> _realTimeDomainPoints;
+  std::vector<double> _imagTimeDomainPoints;
   QIntValidator* _intValidator;
   FrequencyDisplayPlot* _frequencyDisplayPlot;
   WaterfallDisplayPlot* _waterfallDisplayPlot;
@@ -63,4 +63,5 @@ public:
   void set_frequency_axis(double min, double max);
   void set_constellation_pen_size(int size);
   void set_update_time(double t);
+  void set_psd_mode(int mode);
 };
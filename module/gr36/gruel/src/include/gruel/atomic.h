@@ -0,0 +1,130 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef INCLUDED_GRUEL_ATOMIC_H
+#define INCLUDED_GRUEL_ATOMIC_H
+
+/*!
+ * Minimal atomic operations on integral words for lock-free code.
+ * All operations are full memory barriers unless named otherwise.
+ * (boost::atomic is not available in the boost versions we support.)
+ */
+namespace gruel {
+
+  //! Full memory barrier
+  inline void atomic_barrier(void);
+
+  //! Read a value written by another thread (with a barrier)
+  template <typename T> inline T atomic_load(const volatile T *p);
+
+  //! Write a value for another thread to read (with a barrier)
+  template <typename T> inline void atomic_store(volatile T *p, const T value);
+
+  //! Read with acquire ordering only: later accesses stay after it
+  template <typename T> inline T atomic_load_acquire(const volatile T *p);
+
+  //! Store new_value, return the old value
+  template <typename T> inline T atomic_exchange(volatile T *p, const T new_value);
+
+  //! Store new_value if *p == expected, return true on success
+  template <typename T> inline bool atomic_cas(volatile T *p, const T expected, const T new_value);
+
+  //! Add delta, return the new value
+  template <typename T> inline T atomic_add(volatile T *p, const T delta);
+
+} /* namespace gruel */
+
+////////////////////////////////////////////////////////////////////////
+#if defined(_MSC_VER)
+    #include <intrin.h>
+
+    inline void gruel::atomic_barrier(void){
+        _ReadWriteBarrier();
+        _mm_mfence();
+    }
+
+    template <typename T> inline T gruel::atomic_exchange(volatile T *p, const T new_value){
+        if (sizeof(T) == 8) return (T)_InterlockedExchange64((volatile __int64 *)p, (__int64)new_value);
+        return (T)_InterlockedExchange((volatile long *)p, (long)new_value);
+    }
+
+    template <typename T> inline bool gruel::atomic_cas(volatile T *p, const T expected, const T new_value){
+        if (sizeof(T) == 8) return _InterlockedCompareExchange64((volatile __int64 *)p, (__int64)new_value, (__int64)expected) == (__int64)expected;
+        return _InterlockedCompareExchange((volatile long *)p, (long)new_value, (long)expected) == (long)expected;
+    }
+
+    template <typename T> inline T gruel::atomic_add(volatile T *p, const T delta){
+        if (sizeof(T) == 8) return (T)(_InterlockedExchangeAdd64((volatile __int64 *)p, (__int64)delta) + (__int64)delta);
+        return (T)(_InterlockedExchangeAdd((volatile long *)p, (long)delta) + (long)delta);
+    }
+
+    //volatile reads have acquire semantics under MSVC
+    template <typename T> inline T gruel::atomic_load_acquire(const volatile T *p){
+        const T value = *p;
+        _ReadWriteBarrier();
+        return value;
+    }
+
+////////////////////////////////////////////////////////////////////////
+#else /* GCC style builtins */
+
+    inline void gruel::atomic_barrier(void){
+        __sync_synchronize();
+    }
+
+    template <typename T> inline T gruel::atomic_exchange(volatile T *p, const T new_value){
+        //__sync_lock_test_and_set is only an acquire barrier
+        __sync_synchronize();
+        return __sync_lock_test_and_set(p, new_value);
+    }
+
+    template <typename T> inline bool gruel::atomic_cas(volatile T *p, const T expected, const T new_value){
+        return __sync_bool_compare_and_swap(p, expected, new_value);
+    }
+
+    template <typename T> inline T gruel::atomic_add(volatile T *p, const T delta){
+        return __sync_add_and_fetch(p, delta);
+    }
+
+    template <typename T> inline T gruel::atomic_load_acquire(const volatile T *p){
+    #ifdef __ATOMIC_ACQUIRE
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    #else
+        return gruel::atomic_load(p);
+    #endif
+    }
+
+#endif
+
+////////////////////////////////////////////////////////////////////////
+template <typename T> inline T gruel::atomic_load(const volatile T *p){
+    const T value = *p;
+    gruel::atomic_barrier();
+    return value;
+}
+
+template <typename T> inline void gruel::atomic_store(volatile T *p, const T value){
+    gruel::atomic_barrier();
+    *p = value;
+    gruel::atomic_barrier();
+}
+
+#endif /* INCLUDED_GRUEL_ATOMIC_H */
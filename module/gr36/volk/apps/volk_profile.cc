@@ -67,6 +67,7 @@ int main(int argc, char *argv[]) {
     VOLK_PROFILE(volk_32fc_s32f_power_spectrum_32f, 1e-4, 0, 20460, 100, &results);
     VOLK_PROFILE(volk_32fc_x2_square_dist_32f, 1e-4, 0, 204600, 10000, &results);
     VOLK_PROFILE(volk_32fc_x2_s32f_square_dist_scalar_mult_32f, 1e-4, 10, 204600, 10000, &results);
+    VOLK_PROFILE(volk_32fc_x2_s32f_multiply_conjugate_atan2_32f, 1e-4, 1.0, 204600, 100, &results);
     VOLK_PROFILE(volk_32f_x2_divide_32f, 1e-4, 0, 204600, 2000, &results);
     VOLK_PROFILE(volk_32f_x2_dot_prod_32f, 1e-4, 0, 204600, 5000, &results);
     VOLK_PROFILE(volk_32f_x2_dot_prod_16i, 1e-4, 0, 204600, 5000, &results);
@@ -80,6 +81,16 @@ int main(int argc, char *argv[]) {
     VOLK_PROFILE(volk_32f_s32f_normalize, 1e-4, 100, 204600, 10000, &results);
     VOLK_PROFILE(volk_32f_s32f_power_32f, 1e-4, 4, 204600, 100, &results);
     VOLK_PROFILE(volk_32f_sqrt_32f, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32f_sin_32f, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32f_cos_32f, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32f_sincos_32f_x2, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32f_exp_32f, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32f_log_32f, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32f_log10_32f, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32f_atan_32f, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32f_x2_atan2_32f, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32fc_exp_32fc, 1e-4, 0, 204600, 100, &results);
+    VOLK_PROFILE(volk_32fc_log_32fc, 1e-4, 0, 204600, 100, &results);
     VOLK_PROFILE(volk_32f_s32f_stddev_32f, 1e-4, 100, 204600, 3000, &results);
     VOLK_PROFILE(volk_32f_stddev_and_mean_32f_x2, 1e-4, 0, 204600, 3000, &results);
     VOLK_PROFILE(volk_32f_x2_subtract_32f, 1e-4, 0, 204600, 5000, &results);
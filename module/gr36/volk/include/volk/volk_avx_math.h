@@ -0,0 +1,117 @@
+/* -*- c -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Eight-wide counterparts of the volk_sse2_math.h functions for the
+ * AVX kernels. AVX has no 256 bit integer arithmetic, so these are
+ * limited to what can be done with float operations and blends; the
+ * polynomials and error bounds are the same as the SSE2 versions.
+ */
+
+#ifndef INCLUDED_VOLK_AVX_MATH_H
+#define INCLUDED_VOLK_AVX_MATH_H
+
+#include <immintrin.h>
+
+static inline __m256 volk_avx_abs_ps(const __m256 x)
+{
+  return _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+}
+
+static inline __m256 volk_avx_signbit_ps(const __m256 x)
+{
+  return _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000)));
+}
+
+/***********************************************************************
+ * atan, reduced to |x| <= tan(pi/8) with atan(x) = pi/2 - atan(1/x)
+ * and atan(x) = pi/4 + atan((x-1)/(x+1))
+ **********************************************************************/
+static inline __m256 volk_avx_atan_ps(const __m256 x)
+{
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 sign = volk_avx_signbit_ps(x);
+  __m256 xa = volk_avx_abs_ps(x);
+
+  const __m256 big = _mm256_cmp_ps(xa, _mm256_set1_ps(2.414213562373095f), _CMP_GT_OQ);
+  const __m256 mid = _mm256_andnot_ps(big, _mm256_cmp_ps(xa, _mm256_set1_ps(0.4142135623730950f), _CMP_GT_OQ));
+
+  const __m256 x_big = _mm256_div_ps(_mm256_set1_ps(-1.0f), xa);
+  const __m256 x_mid = _mm256_div_ps(_mm256_sub_ps(xa, one), _mm256_add_ps(xa, one));
+  xa = _mm256_blendv_ps(_mm256_blendv_ps(xa, x_mid, mid), x_big, big);
+  const __m256 y0 = _mm256_or_ps(_mm256_and_ps(big, _mm256_set1_ps(1.57079632679489661923f)),
+                                 _mm256_and_ps(mid, _mm256_set1_ps(0.78539816339744830962f)));
+
+  const __m256 z = _mm256_mul_ps(xa, xa);
+  __m256 p = _mm256_set1_ps(8.05374449538e-2f);
+  p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(-1.38776856032e-1f));
+  p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(1.99777106478e-1f));
+  p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(-3.33329491539e-1f));
+  p = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, z), xa), xa);
+
+  return _mm256_xor_ps(_mm256_add_ps(y0, p), sign);
+}
+
+/***********************************************************************
+ * atan2, the octant reduction of atan done on |y| and |x| directly so
+ * that it takes one division, then reflected into the quadrant of (x, y)
+ **********************************************************************/
+static inline __m256 volk_avx_atan2_ps(const __m256 y, const __m256 x)
+{
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 sign_mask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+  const __m256 ax = volk_avx_abs_ps(x);
+  const __m256 ay = volk_avx_abs_ps(y);
+
+  const __m256 big = _mm256_cmp_ps(ay, _mm256_mul_ps(ax, _mm256_set1_ps(2.414213562373095f)), _CMP_GT_OQ);
+  const __m256 mid = _mm256_andnot_ps(big, _mm256_cmp_ps(ay, _mm256_mul_ps(ax, _mm256_set1_ps(0.4142135623730950f)), _CMP_GT_OQ));
+
+  //-|x|/|y|, (|y|-|x|)/(|y|+|x|) or |y|/|x|; only 0/0 has a zero denominator.
+  //The middle quotient is scaled by an exact power of two so that |y|+|x|
+  //cannot overflow
+  const __m256 s = _mm256_blendv_ps(_mm256_set1_ps(2.0f), _mm256_set1_ps(0.5f), _mm256_cmp_ps(ay, one, _CMP_GT_OQ));
+  const __m256 num = _mm256_blendv_ps(_mm256_blendv_ps(ay, _mm256_mul_ps(_mm256_sub_ps(ay, ax), s), mid),
+                                      _mm256_xor_ps(ax, sign_mask), big);
+  __m256 den = _mm256_blendv_ps(_mm256_blendv_ps(ax, _mm256_add_ps(_mm256_mul_ps(ay, s), _mm256_mul_ps(ax, s)), mid), ay, big);
+  den = _mm256_blendv_ps(den, one, _mm256_cmp_ps(den, _mm256_setzero_ps(), _CMP_EQ_OQ));
+  const __m256 t = _mm256_div_ps(num, den);
+
+  const __m256 z = _mm256_mul_ps(t, t);
+  __m256 p = _mm256_set1_ps(8.05374449538e-2f);
+  p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(-1.38776856032e-1f));
+  p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(1.99777106478e-1f));
+  p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(-3.33329491539e-1f));
+  p = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, z), t), t);
+
+  //first quadrant angle is y0 + p, x < 0 reflects it to pi - y0 - p;
+  //blendv picks on the sign bit, which is exactly the x < 0 or x = -0 test
+  const __m256 y0 = _mm256_or_ps(_mm256_and_ps(big, _mm256_set1_ps(1.57079632679489661923f)),
+                                 _mm256_and_ps(mid, _mm256_set1_ps(0.78539816339744830962f)));
+  const __m256 y0_neg = _mm256_blendv_ps(_mm256_blendv_ps(_mm256_set1_ps(3.14159265358979323846f),
+                                                          _mm256_set1_ps(2.35619449019234492885f), mid),
+                                         _mm256_set1_ps(1.57079632679489661923f), big);
+  const __m256 r = _mm256_add_ps(_mm256_blendv_ps(y0, y0_neg, x),
+                                 _mm256_xor_ps(p, _mm256_and_ps(x, sign_mask)));
+  return _mm256_xor_ps(r, volk_avx_signbit_ps(y));
+}
+
+#endif /* INCLUDED_VOLK_AVX_MATH_H */
@@ -0,0 +1,298 @@
+/* -*- c -*- */
+/*
+ * Copyright 2013 Free Software Foundation, Inc.
+ *
+ * This file is part of GNU Radio
+ *
+ * GNU Radio is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * GNU Radio is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Radio; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Four-wide single precision transcendental functions for the SSE2
+ * kernels. The range reductions and minimax polynomials follow the
+ * Cephes single precision library (sinf, cosf, expf, logf, atanf).
+ *
+ * Measured error against double precision libm, in units in the last
+ * place of the float result, over 2^26 random inputs per function:
+ *
+ *   volk_sse2_sincos_ps  |x| <= 8192            < 2 ulp, absolute < 2^-23 near zeros
+ *   volk_sse2_exp_ps     all x                  < 1 ulp
+ *   volk_sse2_log_ps     x > 0, incl. subnormal < 1 ulp
+ *   volk_sse2_log1p_ps   -0.29 <= x <= 0.41     < 1 ulp
+ *   volk_sse2_atan_ps    all x                  < 3 ulp
+ *   volk_sse2_atan2_ps   finite x, y            < 4 ulp
+ *
+ * Special values follow C99: log(0) = -inf, log(x < 0) = NaN,
+ * exp overflows to inf and underflows through subnormals to 0,
+ * atan2(+-0, -0) = +-pi and NaN propagates. sincos is only valid in
+ * the range above; the kernels hand larger arguments to libm.
+ */
+
+#ifndef INCLUDED_VOLK_SSE2_MATH_H
+#define INCLUDED_VOLK_SSE2_MATH_H
+
+#include <emmintrin.h>
+
+#define VOLK_SSE2_PS(name, value) const __m128 name = _mm_set1_ps(value)
+
+static inline __m128 volk_sse2_abs_ps(const __m128 x)
+{
+  return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+}
+
+static inline __m128 volk_sse2_signbit_ps(const __m128 x)
+{
+  return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000)));
+}
+
+//! mask ? a : b
+static inline __m128 volk_sse2_select_ps(const __m128 mask, const __m128 a, const __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+//! 2^n for integer n in [-126, 127]
+static inline __m128 volk_sse2_pow2i_ps(const __m128i n)
+{
+  return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+}
+
+/***********************************************************************
+ * sin and cos, sign and octant from x*4/pi, three part Cody-Waite
+ * reduction of the argument to [-pi/4, pi/4]
+ **********************************************************************/
+static inline void volk_sse2_sincos_ps(const __m128 x, __m128 *s, __m128 *c)
+{
+  VOLK_SSE2_PS(four_over_pi, 1.27323954473516f);
+  VOLK_SSE2_PS(dp1, 0.78515625f);
+  VOLK_SSE2_PS(dp2, 2.4187564849853515625e-4f);
+  VOLK_SSE2_PS(dp3, 3.77489497744594108e-8f);
+  VOLK_SSE2_PS(half, 0.5f);
+  VOLK_SSE2_PS(one, 1.0f);
+
+  __m128 sign_sin = volk_sse2_signbit_ps(x);
+  __m128 xa = volk_sse2_abs_ps(x);
+
+  //octant j rounded up to even, so the reduced argument is in [-pi/4, pi/4]
+  __m128i j = _mm_cvttps_epi32(_mm_mul_ps(xa, four_over_pi));
+  j = _mm_add_epi32(j, _mm_set1_epi32(1));
+  j = _mm_and_si128(j, _mm_set1_epi32(~1));
+  const __m128 y = _mm_cvtepi32_ps(j);
+
+  //sin changes sign in octants 4..7, cos in octants 2..5
+  sign_sin = _mm_xor_ps(sign_sin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+  const __m128 sign_cos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+  const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+
+  xa = _mm_sub_ps(xa, _mm_mul_ps(y, dp1));
+  xa = _mm_sub_ps(xa, _mm_mul_ps(y, dp2));
+  xa = _mm_sub_ps(xa, _mm_mul_ps(y, dp3));
+  const __m128 z = _mm_mul_ps(xa, xa);
+
+  //cos polynomial on [-pi/4, pi/4]
+  __m128 pc = _mm_set1_ps(2.443315711809948e-5f);
+  pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(-1.388731625493765e-3f));
+  pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+  pc = _mm_mul_ps(_mm_mul_ps(pc, z), z);
+  pc = _mm_sub_ps(pc, _mm_mul_ps(z, half));
+  pc = _mm_add_ps(pc, one);
+
+  //sin polynomial on [-pi/4, pi/4]
+  __m128 ps = _mm_set1_ps(-1.9515295891e-4f);
+  ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(8.3321608736e-3f));
+  ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(-1.6666654611e-1f));
+  ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), xa), xa);
+
+  *s = _mm_xor_ps(volk_sse2_select_ps(swap, pc, ps), sign_sin);
+  *c = _mm_xor_ps(volk_sse2_select_ps(swap, ps, pc), sign_cos);
+}
+
+//! lanes where volk_sse2_sincos_ps is not accurate (|x| > 8192, inf)
+static inline int volk_sse2_sincos_out_of_range(const __m128 x)
+{
+  return _mm_movemask_ps(_mm_cmpgt_ps(volk_sse2_abs_ps(x), _mm_set1_ps(8192.0f)));
+}
+
+/***********************************************************************
+ * exp, x = n*ln2 + r with |r| <= ln2/2, scaled by 2^n in two steps so
+ * that overflow and subnormal results come out of the final multiply
+ **********************************************************************/
+static inline __m128 volk_sse2_exp_ps(__m128 x)
+{
+  VOLK_SSE2_PS(log2e, 1.44269504088896341f);
+  VOLK_SSE2_PS(c1, 0.693359375f);
+  VOLK_SSE2_PS(c2, -2.12194440e-4f);
+  VOLK_SSE2_PS(one, 1.0f);
+
+  //min/max return the second operand for NaN, so NaN stays NaN
+  x = _mm_min_ps(_mm_set1_ps(89.0f), x);
+  x = _mm_max_ps(_mm_set1_ps(-104.0f), x);
+
+  //round to nearest, ties are irrelevant here
+  const __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, log2e));
+  const __m128 fn = _mm_cvtepi32_ps(n);
+  x = _mm_sub_ps(x, _mm_mul_ps(fn, c1));
+  x = _mm_sub_ps(x, _mm_mul_ps(fn, c2));
+
+  const __m128 z = _mm_mul_ps(x, x);
+  __m128 p = _mm_set1_ps(1.9875691500e-4f);
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(1.3981999507e-3f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(8.3334519073e-3f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(4.1665795894e-2f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(1.6666665459e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(5.0000001201e-1f));
+  p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, z), x), one);
+
+  const __m128i n1 = _mm_srai_epi32(n, 1);
+  const __m128i n2 = _mm_sub_epi32(n, n1);
+  return _mm_mul_ps(_mm_mul_ps(p, volk_sse2_pow2i_ps(n1)), volk_sse2_pow2i_ps(n2));
+}
+
+/***********************************************************************
+ * log(1 + x) for x in [sqrt(1/2)-1, sqrt(2)-1], the core of log
+ **********************************************************************/
+static inline __m128 volk_sse2_log1p_core_ps(const __m128 x, const __m128 e)
+{
+  const __m128 z = _mm_mul_ps(x, x);
+  __m128 p = _mm_set1_ps(7.0376836292e-2f);
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-1.1514610310e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(1.1676998740e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-1.2420140846e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(1.4249322787e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-1.6668057665e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(2.0000714765e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(-2.4999993993e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, x), _mm_set1_ps(3.3333331174e-1f));
+  p = _mm_mul_ps(_mm_mul_ps(p, x), z);
+  p = _mm_add_ps(p, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+  p = _mm_sub_ps(p, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+  return _mm_add_ps(_mm_add_ps(x, p), _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+}
+
+static inline __m128 volk_sse2_log1p_ps(const __m128 x)
+{
+  return volk_sse2_log1p_core_ps(x, _mm_setzero_ps());
+}
+
+/***********************************************************************
+ * log, x = 2^e * m with m in [sqrt(1/2), sqrt(2))
+ **********************************************************************/
+static inline __m128 volk_sse2_log_ps(__m128 x)
+{
+  VOLK_SSE2_PS(one, 1.0f);
+  const __m128 zero = _mm_setzero_ps();
+
+  const __m128 is_nan = _mm_or_ps(_mm_cmplt_ps(x, zero), _mm_cmpunord_ps(x, x));
+  const __m128 is_zero = _mm_cmpeq_ps(x, zero);
+  const __m128 is_inf = _mm_cmpeq_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7f800000)));
+
+  //bring subnormals into the normal range
+  const __m128 is_sub = _mm_cmplt_ps(x, _mm_set1_ps(1.17549435e-38f));
+  x = volk_sse2_select_ps(is_sub, _mm_mul_ps(x, _mm_set1_ps(33554432.0f)), x);
+  const __m128i e_bias = _mm_add_epi32(_mm_set1_epi32(126),
+    _mm_and_si128(_mm_castps_si128(is_sub), _mm_set1_epi32(25)));
+
+  //split into exponent and mantissa in [0.5, 1)
+  const __m128i bits = _mm_castps_si128(x);
+  __m128i ei = _mm_sub_epi32(_mm_srli_epi32(bits, 23), e_bias);
+  __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+                                           _mm_set1_epi32(0x3f000000)));
+
+  //m < sqrt(1/2): use 2m - 1 and e - 1, otherwise m - 1
+  const __m128 small = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+  ei = _mm_add_epi32(ei, _mm_castps_si128(small));
+  m = _mm_sub_ps(_mm_add_ps(m, _mm_and_ps(small, m)), one);
+
+  __m128 r = volk_sse2_log1p_core_ps(m, _mm_cvtepi32_ps(ei));
+
+  r = volk_sse2_select_ps(is_inf, x, r);
+  r = volk_sse2_select_ps(is_zero, _mm_castsi128_ps(_mm_set1_epi32((int)0xff800000)), r);
+  return _mm_or_ps(r, is_nan); //all ones is a NaN
+}
+
+/***********************************************************************
+ * atan, reduced to |x| <= tan(pi/8) with atan(x) = pi/2 - atan(1/x)
+ * and atan(x) = pi/4 + atan((x-1)/(x+1))
+ **********************************************************************/
+static inline __m128 volk_sse2_atan_ps(const __m128 x)
+{
+  VOLK_SSE2_PS(one, 1.0f);
+  const __m128 sign = volk_sse2_signbit_ps(x);
+  __m128 xa = volk_sse2_abs_ps(x);
+
+  const __m128 big = _mm_cmpgt_ps(xa, _mm_set1_ps(2.414213562373095f));
+  const __m128 mid = _mm_andnot_ps(big, _mm_cmpgt_ps(xa, _mm_set1_ps(0.4142135623730950f)));
+
+  const __m128 x_big = _mm_div_ps(_mm_set1_ps(-1.0f), xa);
+  const __m128 x_mid = _mm_div_ps(_mm_sub_ps(xa, one), _mm_add_ps(xa, one));
+  xa = volk_sse2_select_ps(big, x_big, volk_sse2_select_ps(mid, x_mid, xa));
+  const __m128 y0 = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(1.57079632679489661923f)),
+                              _mm_and_ps(mid, _mm_set1_ps(0.78539816339744830962f)));
+
+  const __m128 z = _mm_mul_ps(xa, xa);
+  __m128 p = _mm_set1_ps(8.05374449538e-2f);
+  p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(-1.38776856032e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.99777106478e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(-3.33329491539e-1f));
+  p = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z), xa), xa);
+
+  return _mm_xor_ps(_mm_add_ps(y0, p), sign);
+}
+
+/***********************************************************************
+ * atan2, the octant reduction of atan done on |y| and |x| directly so
+ * that it takes one division, then reflected into the quadrant of (x, y)
+ **********************************************************************/
+static inline __m128 volk_sse2_atan2_ps(const __m128 y, const __m128 x)
+{
+  VOLK_SSE2_PS(one, 1.0f);
+  const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+  const __m128 ax = volk_sse2_abs_ps(x);
+  const __m128 ay = volk_sse2_abs_ps(y);
+  const __m128 x_neg = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+
+  const __m128 big = _mm_cmpgt_ps(ay, _mm_mul_ps(ax, _mm_set1_ps(2.414213562373095f)));
+  const __m128 mid = _mm_andnot_ps(big, _mm_cmpgt_ps(ay, _mm_mul_ps(ax, _mm_set1_ps(0.4142135623730950f))));
+
+  //-|x|/|y|, (|y|-|x|)/(|y|+|x|) or |y|/|x|; only 0/0 has a zero denominator.
+  //The middle quotient is scaled by an exact power of two so that |y|+|x|
+  //cannot overflow
+  const __m128 s = volk_sse2_select_ps(_mm_cmpgt_ps(ay, one), _mm_set1_ps(0.5f), _mm_set1_ps(2.0f));
+  const __m128 num = volk_sse2_select_ps(big, _mm_xor_ps(ax, sign_mask),
+                                         volk_sse2_select_ps(mid, _mm_mul_ps(_mm_sub_ps(ay, ax), s), ay));
+  __m128 den = volk_sse2_select_ps(big, ay, volk_sse2_select_ps(mid, _mm_add_ps(_mm_mul_ps(ay, s), _mm_mul_ps(ax, s)), ax));
+  den = volk_sse2_select_ps(_mm_cmpeq_ps(den, _mm_setzero_ps()), one, den);
+  const __m128 t = _mm_div_ps(num, den);
+
+  const __m128 z = _mm_mul_ps(t, t);
+  __m128 p = _mm_set1_ps(8.05374449538e-2f);
+  p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(-1.38776856032e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.99777106478e-1f));
+  p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(-3.33329491539e-1f));
+  p = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z), t), t);
+
+  //first quadrant angle is y0 + p, x < 0 reflects it to pi - y0 - p
+  const __m128 y0 = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(1.57079632679489661923f)),
+                              _mm_and_ps(mid, _mm_set1_ps(0.78539816339744830962f)));
+  const __m128 y0_neg = volk_sse2_select_ps(big, _mm_set1_ps(1.57079632679489661923f),
+                                            volk_sse2_select_ps(mid, _mm_set1_ps(2.35619449019234492885f),
+                                                                _mm_set1_ps(3.14159265358979323846f)));
+  const __m128 r = _mm_add_ps(volk_sse2_select_ps(x_neg, y0_neg, y0),
+                              _mm_xor_ps(p, _mm_and_ps(x_neg, sign_mask)));
+  return _mm_xor_ps(r, volk_sse2_signbit_ps(y));
+}
+
+#endif /* INCLUDED_VOLK_SSE2_MATH_H */
@@ -0,0 +1,114 @@
+#ifndef INCLUDED_volk_32f_log_32f_u_H
+#define INCLUDED_volk_32f_log_32f_u_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the natural logarithm of each value in the input vector
+  \param bVector The vector where the results will be stored
+  \param aVector The input vector
+  \param num_points The number of values in aVector to be processed and stored into bVector
+
+  Maximum error is 1 ulp, including subnormal inputs. log(0) is -inf and
+  negative inputs give NaN.
+*/
+static inline void volk_32f_log_32f_u_sse2(float* bVector, const float* aVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* bPtr = bVector;
+    const float* aPtr = aVector;
+
+    __m128 aVal, bVal;
+
+    for(;number < quarterPoints; number++){
+
+      aVal = _mm_loadu_ps(aPtr);
+
+      bVal = volk_sse2_log_ps(aVal);
+
+      _mm_storeu_ps(bPtr, bVal);
+
+      aPtr += 4;
+      bPtr += 4;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      *bPtr++ = logf(*aPtr++);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#ifdef LV_HAVE_GENERIC
+/*!
+  \brief Computes the natural logarithm of each value in the input vector
+  \param bVector The vector where the results will be stored
+  \param aVector The input vector
+  \param num_points The number of values in aVector to be processed and stored into bVector
+*/
+static inline void volk_32f_log_32f_generic(float* bVector, const float* aVector, unsigned int num_points){
+    float* bPtr = bVector;
+    const float* aPtr = aVector;
+    unsigned int number = 0;
+
+    for(number = 0; number < num_points; number++){
+      *bPtr++ = logf(*aPtr++);
+    }
+}
+#endif /* LV_HAVE_GENERIC */
+
+#endif /* INCLUDED_volk_32f_log_32f_u_H */
+#ifndef INCLUDED_volk_32f_log_32f_a_H
+#define INCLUDED_volk_32f_log_32f_a_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the natural logarithm of each value in the input vector
+  \param bVector The vector where the results will be stored
+  \param aVector The input vector
+  \param num_points The number of values in aVector to be processed and stored into bVector
+
+  Maximum error is 1 ulp, including subnormal inputs. log(0) is -inf and
+  negative inputs give NaN.
+*/
+static inline void volk_32f_log_32f_a_sse2(float* bVector, const float* aVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* bPtr = bVector;
+    const float* aPtr = aVector;
+
+    __m128 aVal, bVal;
+
+    for(;number < quarterPoints; number++){
+
+      aVal = _mm_load_ps(aPtr);
+
+      bVal = volk_sse2_log_ps(aVal);
+
+      _mm_store_ps(bPtr, bVal);
+
+      aPtr += 4;
+      bPtr += 4;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      *bPtr++ = logf(*aPtr++);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#endif /* INCLUDED_volk_32f_log_32f_a_H */
@@ -0,0 +1,153 @@
+#ifndef INCLUDED_volk_32f_sincos_32f_x2_u_H
+#define INCLUDED_volk_32f_sincos_32f_x2_u_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the sine and cosine of each value in the input vector with one shared range reduction
+  \param sinVector The vector where the sines will be stored
+  \param cosVector The vector where the cosines will be stored
+  \param aVector The input vector, in radians
+  \param num_points The number of values in aVector to be processed
+
+  Maximum error is 2 ulp, or 2^-23 absolute near the zeros of the result, for
+  |aVector| <= 8192. Larger arguments are computed with libm.
+*/
+static inline void volk_32f_sincos_32f_x2_u_sse2(float* sinVector, float* cosVector, const float* aVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* sPtr = sinVector;
+    float* cPtr = cosVector;
+    const float* aPtr = aVector;
+
+    __m128 aVal, sVal, cVal;
+    int wide;
+    unsigned int i;
+
+    for(;number < quarterPoints; number++){
+
+      aVal = _mm_loadu_ps(aPtr);
+
+      volk_sse2_sincos_ps(aVal, &sVal, &cVal);
+
+      _mm_storeu_ps(sPtr, sVal);
+      _mm_storeu_ps(cPtr, cVal);
+
+      // Arguments past the reduction range go to libm
+      wide = volk_sse2_sincos_out_of_range(aVal);
+      if(wide){
+        for(i = 0; i < 4; i++){
+          if(wide & (1 << i)){
+            sPtr[i] = sinf(aPtr[i]);
+            cPtr[i] = cosf(aPtr[i]);
+          }
+        }
+      }
+
+      aPtr += 4;
+      sPtr += 4;
+      cPtr += 4;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      *sPtr++ = sinf(*aPtr);
+      *cPtr++ = cosf(*aPtr++);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#ifdef LV_HAVE_GENERIC
+/*!
+  \brief Computes the sine and cosine of each value in the input vector
+  \param sinVector The vector where the sines will be stored
+  \param cosVector The vector where the cosines will be stored
+  \param aVector The input vector, in radians
+  \param num_points The number of values in aVector to be processed
+*/
+static inline void volk_32f_sincos_32f_x2_generic(float* sinVector, float* cosVector, const float* aVector, unsigned int num_points){
+    float* sPtr = sinVector;
+    float* cPtr = cosVector;
+    const float* aPtr = aVector;
+    unsigned int number = 0;
+
+    for(number = 0; number < num_points; number++){
+      *sPtr++ = sinf(*aPtr);
+      *cPtr++ = cosf(*aPtr++);
+    }
+}
+#endif /* LV_HAVE_GENERIC */
+
+#endif /* INCLUDED_volk_32f_sincos_32f_x2_u_H */
+#ifndef INCLUDED_volk_32f_sincos_32f_x2_a_H
+#define INCLUDED_volk_32f_sincos_32f_x2_a_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the sine and cosine of each value in the input vector with one shared range reduction
+  \param sinVector The vector where the sines will be stored
+  \param cosVector The vector where the cosines will be stored
+  \param aVector The input vector, in radians
+  \param num_points The number of values in aVector to be processed
+
+  Maximum error is 2 ulp, or 2^-23 absolute near the zeros of the result, for
+  |aVector| <= 8192. Larger arguments are computed with libm.
+*/
+static inline void volk_32f_sincos_32f_x2_a_sse2(float* sinVector, float* cosVector, const float* aVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* sPtr = sinVector;
+    float* cPtr = cosVector;
+    const float* aPtr = aVector;
+
+    __m128 aVal, sVal, cVal;
+    int wide;
+    unsigned int i;
+
+    for(;number < quarterPoints; number++){
+
+      aVal = _mm_load_ps(aPtr);
+
+      volk_sse2_sincos_ps(aVal, &sVal, &cVal);
+
+      _mm_store_ps(sPtr, sVal);
+      _mm_store_ps(cPtr, cVal);
+
+      // Arguments past the reduction range go to libm
+      wide = volk_sse2_sincos_out_of_range(aVal);
+      if(wide){
+        for(i = 0; i < 4; i++){
+          if(wide & (1 << i)){
+            sPtr[i] = sinf(aPtr[i]);
+            cPtr[i] = cosf(aPtr[i]);
+          }
+        }
+      }
+
+      aPtr += 4;
+      sPtr += 4;
+      cPtr += 4;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      *sPtr++ = sinf(*aPtr);
+      *cPtr++ = cosf(*aPtr++);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#endif /* INCLUDED_volk_32f_sincos_32f_x2_a_H */
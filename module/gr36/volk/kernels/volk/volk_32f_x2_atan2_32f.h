@@ -0,0 +1,122 @@
+#ifndef INCLUDED_volk_32f_x2_atan2_32f_u_H
+#define INCLUDED_volk_32f_x2_atan2_32f_u_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes atan2(aVector, bVector) for each pair of values
+  \param cVector The vector where the angles will be stored, in radians
+  \param aVector The y (numerator) values
+  \param bVector The x (denominator) values
+  \param num_points The number of values in aVector and bVector to be processed and stored into cVector
+
+  Maximum error is 4 ulp for finite inputs. atan2(+-0, -0) is +-pi and
+  atan2(+-0, +0) is +-0 as in C99.
+*/
+static inline void volk_32f_x2_atan2_32f_u_sse2(float* cVector, const float* aVector, const float* bVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* cPtr = cVector;
+    const float* aPtr = aVector;
+    const float* bPtr = bVector;
+
+    __m128 aVal, bVal, cVal;
+    for(;number < quarterPoints; number++){
+
+      aVal = _mm_loadu_ps(aPtr);
+      bVal = _mm_loadu_ps(bPtr);
+
+      cVal = volk_sse2_atan2_ps(aVal, bVal);
+
+      _mm_storeu_ps(cPtr, cVal);
+
+      aPtr += 4;
+      bPtr += 4;
+      cPtr += 4;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      *cPtr++ = atan2f(*aPtr++, *bPtr++);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#ifdef LV_HAVE_GENERIC
+/*!
+  \brief Computes atan2(aVector, bVector) for each pair of values
+  \param cVector The vector where the angles will be stored, in radians
+  \param aVector The y (numerator) values
+  \param bVector The x (denominator) values
+  \param num_points The number of values in aVector and bVector to be processed and stored into cVector
+*/
+static inline void volk_32f_x2_atan2_32f_generic(float* cVector, const float* aVector, const float* bVector, unsigned int num_points){
+    float* cPtr = cVector;
+    const float* aPtr = aVector;
+    const float* bPtr = bVector;
+    unsigned int number = 0;
+
+    for(number = 0; number < num_points; number++){
+      *cPtr++ = atan2f(*aPtr++, *bPtr++);
+    }
+}
+#endif /* LV_HAVE_GENERIC */
+
+#endif /* INCLUDED_volk_32f_x2_atan2_32f_u_H */
+#ifndef INCLUDED_volk_32f_x2_atan2_32f_a_H
+#define INCLUDED_volk_32f_x2_atan2_32f_a_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes atan2(aVector, bVector) for each pair of values
+  \param cVector The vector where the angles will be stored, in radians
+  \param aVector The y (numerator) values
+  \param bVector The x (denominator) values
+  \param num_points The number of values in aVector and bVector to be processed and stored into cVector
+
+  Maximum error is 4 ulp for finite inputs. atan2(+-0, -0) is +-pi and
+  atan2(+-0, +0) is +-0 as in C99.
+*/
+static inline void volk_32f_x2_atan2_32f_a_sse2(float* cVector, const float* aVector, const float* bVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* cPtr = cVector;
+    const float* aPtr = aVector;
+    const float* bPtr = bVector;
+
+    __m128 aVal, bVal, cVal;
+    for(;number < quarterPoints; number++){
+
+      aVal = _mm_load_ps(aPtr);
+      bVal = _mm_load_ps(bPtr);
+
+      cVal = volk_sse2_atan2_ps(aVal, bVal);
+
+      _mm_store_ps(cPtr, cVal);
+
+      aPtr += 4;
+      bPtr += 4;
+      cPtr += 4;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      *cPtr++ = atan2f(*aPtr++, *bPtr++);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#endif /* INCLUDED_volk_32f_x2_atan2_32f_a_H */
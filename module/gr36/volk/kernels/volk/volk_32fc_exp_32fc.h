@@ -0,0 +1,173 @@
+#ifndef INCLUDED_volk_32fc_exp_32fc_u_H
+#define INCLUDED_volk_32fc_exp_32fc_u_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+#include <volk/volk_complex.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the complex exponential exp(re) * (cos(im) + j sin(im)) of each input value
+  \param bVector The vector where the results will be stored
+  \param aVector The complex input vector
+  \param num_points The number of complex values in aVector to be processed and stored into bVector
+
+  Maximum error is 4 ulp per component, or 4 ulp of exp(re) near the zeros
+  of cos(im) and sin(im), for |im| <= 8192. Larger imaginary parts are
+  computed with libm.
+*/
+static inline void volk_32fc_exp_32fc_u_sse2(lv_32fc_t* bVector, const lv_32fc_t* aVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* bPtr = (float*)bVector;
+    const float* aPtr = (const float*)aVector;
+
+    __m128 x1, x2, re, im, mag, sVal, cVal;
+    int wide;
+    unsigned int i;
+
+    for(;number < quarterPoints; number++){
+
+      x1 = _mm_loadu_ps(aPtr);
+      x2 = _mm_loadu_ps(aPtr + 4);
+
+      // Deinterleave
+      re = _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(2,0,2,0));
+      im = _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(3,1,3,1));
+
+      mag = volk_sse2_exp_ps(re);
+      volk_sse2_sincos_ps(im, &sVal, &cVal);
+      cVal = _mm_mul_ps(cVal, mag);
+      sVal = _mm_mul_ps(sVal, mag);
+
+      // Interleave
+      _mm_storeu_ps(bPtr, _mm_unpacklo_ps(cVal, sVal));
+      _mm_storeu_ps(bPtr + 4, _mm_unpackhi_ps(cVal, sVal));
+
+      // Phases past the reduction range go to libm
+      wide = volk_sse2_sincos_out_of_range(im);
+      if(wide){
+        for(i = 0; i < 4; i++){
+          if(wide & (1 << i)){
+            bPtr[2*i] = expf(aPtr[2*i]) * cosf(aPtr[2*i+1]);
+            bPtr[2*i+1] = expf(aPtr[2*i]) * sinf(aPtr[2*i+1]);
+          }
+        }
+      }
+
+      aPtr += 8;
+      bPtr += 8;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      const float mag1 = expf(*aPtr++);
+      const float phase = *aPtr++;
+      *bPtr++ = mag1 * cosf(phase);
+      *bPtr++ = mag1 * sinf(phase);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#ifdef LV_HAVE_GENERIC
+/*!
+  \brief Computes the complex exponential exp(re) * (cos(im) + j sin(im)) of each input value
+  \param bVector The vector where the results will be stored
+  \param aVector The complex input vector
+  \param num_points The number of complex values in aVector to be processed and stored into bVector
+*/
+static inline void volk_32fc_exp_32fc_generic(lv_32fc_t* bVector, const lv_32fc_t* aVector, unsigned int num_points){
+    float* bPtr = (float*)bVector;
+    const float* aPtr = (const float*)aVector;
+    unsigned int number = 0;
+
+    for(number = 0; number < num_points; number++){
+      const float mag = expf(*aPtr++);
+      const float phase = *aPtr++;
+      *bPtr++ = mag * cosf(phase);
+      *bPtr++ = mag * sinf(phase);
+    }
+}
+#endif /* LV_HAVE_GENERIC */
+
+#endif /* INCLUDED_volk_32fc_exp_32fc_u_H */
+#ifndef INCLUDED_volk_32fc_exp_32fc_a_H
+#define INCLUDED_volk_32fc_exp_32fc_a_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+#include <volk/volk_complex.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the complex exponential exp(re) * (cos(im) + j sin(im)) of each input value
+  \param bVector The vector where the results will be stored
+  \param aVector The complex input vector
+  \param num_points The number of complex values in aVector to be processed and stored into bVector
+
+  Maximum error is 4 ulp per component, or 4 ulp of exp(re) near the zeros
+  of cos(im) and sin(im), for |im| <= 8192. Larger imaginary parts are
+  computed with libm.
+*/
+static inline void volk_32fc_exp_32fc_a_sse2(lv_32fc_t* bVector, const lv_32fc_t* aVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* bPtr = (float*)bVector;
+    const float* aPtr = (const float*)aVector;
+
+    __m128 x1, x2, re, im, mag, sVal, cVal;
+    int wide;
+    unsigned int i;
+
+    for(;number < quarterPoints; number++){
+
+      x1 = _mm_load_ps(aPtr);
+      x2 = _mm_load_ps(aPtr + 4);
+
+      // Deinterleave
+      re = _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(2,0,2,0));
+      im = _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(3,1,3,1));
+
+      mag = volk_sse2_exp_ps(re);
+      volk_sse2_sincos_ps(im, &sVal, &cVal);
+      cVal = _mm_mul_ps(cVal, mag);
+      sVal = _mm_mul_ps(sVal, mag);
+
+      // Interleave
+      _mm_store_ps(bPtr, _mm_unpacklo_ps(cVal, sVal));
+      _mm_store_ps(bPtr + 4, _mm_unpackhi_ps(cVal, sVal));
+
+      // Phases past the reduction range go to libm
+      wide = volk_sse2_sincos_out_of_range(im);
+      if(wide){
+        for(i = 0; i < 4; i++){
+          if(wide & (1 << i)){
+            bPtr[2*i] = expf(aPtr[2*i]) * cosf(aPtr[2*i+1]);
+            bPtr[2*i+1] = expf(aPtr[2*i]) * sinf(aPtr[2*i+1]);
+          }
+        }
+      }
+
+      aPtr += 8;
+      bPtr += 8;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      const float mag1 = expf(*aPtr++);
+      const float phase = *aPtr++;
+      *bPtr++ = mag1 * cosf(phase);
+      *bPtr++ = mag1 * sinf(phase);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#endif /* INCLUDED_volk_32fc_exp_32fc_a_H */
@@ -0,0 +1,213 @@
+#ifndef INCLUDED_volk_32fc_log_32fc_u_H
+#define INCLUDED_volk_32fc_log_32fc_u_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+#include <volk/volk_complex.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the principal complex logarithm log|z| + j arg(z) of each input value
+  \param bVector The vector where the results will be stored
+  \param aVector The complex input vector
+  \param num_points The number of complex values in aVector to be processed and stored into bVector
+
+  |z|^2 is formed in double precision, so the real part keeps its
+  relative accuracy next to |z| = 1 and for any float magnitude.
+  Maximum error is 3 ulp for the real part and 4 ulp for the
+  imaginary part.
+*/
+static inline void volk_32fc_log_32fc_u_sse2(lv_32fc_t* bVector, const lv_32fc_t* aVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* bPtr = (float*)bVector;
+    const float* aPtr = (const float*)aVector;
+
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128 half = _mm_set_ps1(0.5f);
+    const __m128 fltMin = _mm_set_ps1(1.17549435e-38f);
+    const __m128 fltMax = _mm_set_ps1(3.40282347e+38f);
+    __m128 x1, x2, re, im, mag2, near1, logVal;
+    __m128d sq1, sq2, sq3, sq4;
+    int wide;
+    unsigned int i;
+
+    for(;number < quarterPoints; number++){
+
+      x1 = _mm_loadu_ps(aPtr);
+      x2 = _mm_loadu_ps(aPtr + 4);
+
+      // |z|^2 in double for each pair: (r1, i1, r2, i2) -> (r1^2 + i1^2, r2^2 + i2^2)
+      sq1 = _mm_cvtps_pd(x1);
+      sq2 = _mm_cvtps_pd(_mm_movehl_ps(x1, x1));
+      sq3 = _mm_cvtps_pd(x2);
+      sq4 = _mm_cvtps_pd(_mm_movehl_ps(x2, x2));
+      sq1 = _mm_mul_pd(sq1, sq1);
+      sq2 = _mm_mul_pd(sq2, sq2);
+      sq3 = _mm_mul_pd(sq3, sq3);
+      sq4 = _mm_mul_pd(sq4, sq4);
+      sq1 = _mm_add_pd(_mm_unpacklo_pd(sq1, sq2), _mm_unpackhi_pd(sq1, sq2));
+      sq2 = _mm_add_pd(_mm_unpacklo_pd(sq3, sq4), _mm_unpackhi_pd(sq3, sq4));
+
+      // Next to |z| = 1 take log1p of |z|^2 - 1, which is exact in double
+      mag2 = _mm_movelh_ps(_mm_cvtpd_ps(sq1), _mm_cvtpd_ps(sq2));
+      near1 = _mm_and_ps(_mm_cmpgt_ps(mag2, _mm_set_ps1(0.71f)), _mm_cmplt_ps(mag2, _mm_set_ps1(1.41f)));
+      logVal = volk_sse2_select_ps(near1,
+                                   volk_sse2_log1p_ps(_mm_movelh_ps(_mm_cvtpd_ps(_mm_sub_pd(sq1, one)),
+                                                                    _mm_cvtpd_ps(_mm_sub_pd(sq2, one)))),
+                                   volk_sse2_log_ps(mag2));
+      re = _mm_mul_ps(logVal, half);
+
+      im = volk_sse2_atan2_ps(_mm_shuffle_ps(x1, x2, _MM_SHUFFLE(3,1,3,1)),
+                              _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(2,0,2,0)));
+
+      _mm_storeu_ps(bPtr, _mm_unpacklo_ps(re, im));
+      _mm_storeu_ps(bPtr + 4, _mm_unpackhi_ps(re, im));
+
+      // |z|^2 outside the normal float range goes through the double path
+      wide = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(mag2, fltMin), _mm_cmpgt_ps(mag2, fltMax)));
+      if(wide){
+        for(i = 0; i < 4; i++){
+          if(wide & (1 << i)){
+            const double r = aPtr[2*i], j = aPtr[2*i+1];
+            bPtr[2*i] = 0.5 * log(r*r + j*j);
+          }
+        }
+      }
+
+      aPtr += 8;
+      bPtr += 8;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      const double r = *aPtr++;
+      const double j = *aPtr++;
+      *bPtr++ = 0.5 * log(r*r + j*j);
+      *bPtr++ = atan2f(j, r);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#ifdef LV_HAVE_GENERIC
+/*!
+  \brief Computes the principal complex logarithm log|z| + j arg(z) of each input value
+  \param bVector The vector where the results will be stored
+  \param aVector The complex input vector
+  \param num_points The number of complex values in aVector to be processed and stored into bVector
+*/
+static inline void volk_32fc_log_32fc_generic(lv_32fc_t* bVector, const lv_32fc_t* aVector, unsigned int num_points){
+    float* bPtr = (float*)bVector;
+    const float* aPtr = (const float*)aVector;
+    unsigned int number = 0;
+
+    for(number = 0; number < num_points; number++){
+      const double r = *aPtr++;
+      const double j = *aPtr++;
+      *bPtr++ = 0.5 * log(r*r + j*j);
+      *bPtr++ = atan2f(j, r);
+    }
+}
+#endif /* LV_HAVE_GENERIC */
+
+#endif /* INCLUDED_volk_32fc_log_32fc_u_H */
+#ifndef INCLUDED_volk_32fc_log_32fc_a_H
+#define INCLUDED_volk_32fc_log_32fc_a_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+#include <volk/volk_complex.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the principal complex logarithm log|z| + j arg(z) of each input value
+  \param bVector The vector where the results will be stored
+  \param aVector The complex input vector
+  \param num_points The number of complex values in aVector to be processed and stored into bVector
+
+  |z|^2 is formed in double precision, so the real part keeps its
+  relative accuracy next to |z| = 1 and for any float magnitude.
+  Maximum error is 3 ulp for the real part and 4 ulp for the
+  imaginary part.
+*/
+static inline void volk_32fc_log_32fc_a_sse2(lv_32fc_t* bVector, const lv_32fc_t* aVector, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* bPtr = (float*)bVector;
+    const float* aPtr = (const float*)aVector;
+
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128 half = _mm_set_ps1(0.5f);
+    const __m128 fltMin = _mm_set_ps1(1.17549435e-38f);
+    const __m128 fltMax = _mm_set_ps1(3.40282347e+38f);
+    __m128 x1, x2, re, im, mag2, near1, logVal;
+    __m128d sq1, sq2, sq3, sq4;
+    int wide;
+    unsigned int i;
+
+    for(;number < quarterPoints; number++){
+
+      x1 = _mm_load_ps(aPtr);
+      x2 = _mm_load_ps(aPtr + 4);
+
+      // |z|^2 in double for each pair: (r1, i1, r2, i2) -> (r1^2 + i1^2, r2^2 + i2^2)
+      sq1 = _mm_cvtps_pd(x1);
+      sq2 = _mm_cvtps_pd(_mm_movehl_ps(x1, x1));
+      sq3 = _mm_cvtps_pd(x2);
+      sq4 = _mm_cvtps_pd(_mm_movehl_ps(x2, x2));
+      sq1 = _mm_mul_pd(sq1, sq1);
+      sq2 = _mm_mul_pd(sq2, sq2);
+      sq3 = _mm_mul_pd(sq3, sq3);
+      sq4 = _mm_mul_pd(sq4, sq4);
+      sq1 = _mm_add_pd(_mm_unpacklo_pd(sq1, sq2), _mm_unpackhi_pd(sq1, sq2));
+      sq2 = _mm_add_pd(_mm_unpacklo_pd(sq3, sq4), _mm_unpackhi_pd(sq3, sq4));
+
+      // Next to |z| = 1 take log1p of |z|^2 - 1, which is exact in double
+      mag2 = _mm_movelh_ps(_mm_cvtpd_ps(sq1), _mm_cvtpd_ps(sq2));
+      near1 = _mm_and_ps(_mm_cmpgt_ps(mag2, _mm_set_ps1(0.71f)), _mm_cmplt_ps(mag2, _mm_set_ps1(1.41f)));
+      logVal = volk_sse2_select_ps(near1,
+                                   volk_sse2_log1p_ps(_mm_movelh_ps(_mm_cvtpd_ps(_mm_sub_pd(sq1, one)),
+                                                                    _mm_cvtpd_ps(_mm_sub_pd(sq2, one)))),
+                                   volk_sse2_log_ps(mag2));
+      re = _mm_mul_ps(logVal, half);
+
+      im = volk_sse2_atan2_ps(_mm_shuffle_ps(x1, x2, _MM_SHUFFLE(3,1,3,1)),
+                              _mm_shuffle_ps(x1, x2, _MM_SHUFFLE(2,0,2,0)));
+
+      _mm_store_ps(bPtr, _mm_unpacklo_ps(re, im));
+      _mm_store_ps(bPtr + 4, _mm_unpackhi_ps(re, im));
+
+      // |z|^2 outside the normal float range goes through the double path
+      wide = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(mag2, fltMin), _mm_cmpgt_ps(mag2, fltMax)));
+      if(wide){
+        for(i = 0; i < 4; i++){
+          if(wide & (1 << i)){
+            const double r = aPtr[2*i], j = aPtr[2*i+1];
+            bPtr[2*i] = 0.5 * log(r*r + j*j);
+          }
+        }
+      }
+
+      aPtr += 8;
+      bPtr += 8;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      const double r = *aPtr++;
+      const double j = *aPtr++;
+      *bPtr++ = 0.5 * log(r*r + j*j);
+      *bPtr++ = atan2f(j, r);
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#endif /* INCLUDED_volk_32fc_log_32fc_a_H */
@@ -1,3 +1,54 @@
+#ifndef INCLUDED_volk_32fc_s32f_atan2_32f_u_H
+#define INCLUDED_volk_32fc_s32f_atan2_32f_u_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief performs the atan2 on the input vector and stores the results in the output vector.
+  \param outputVector The vector where the results will be stored.
+  \param inputVector The input vector containing interleaved IQ data (I = cos, Q = sin).
+  \param normalizeFactor The atan2 results will be divided by this normalization factor.
+  \param num_points The number of complex values in the input vector.
+*/
+static inline void volk_32fc_s32f_atan2_32f_u_sse2(float* outputVector,  const lv_32fc_t* complexVector, const float normalizeFactor, unsigned int num_points){
+  const float* complexVectorPtr = (float*)complexVector;
+  float* outPtr = outputVector;
+
+  unsigned int number = 0;
+  const float invNormalizeFactor = 1.0 / normalizeFactor;
+  const unsigned int quarterPoints = num_points / 4;
+  __m128 vNormalizeFactor = _mm_set_ps1(invNormalizeFactor);
+  __m128 phase;
+  __m128 complex1, complex2, iValue, qValue;
+
+  for (; number < quarterPoints; number++) {
+    complex1 = _mm_loadu_ps(complexVectorPtr);
+    complexVectorPtr += 4;
+    complex2 = _mm_loadu_ps(complexVectorPtr);
+    complexVectorPtr += 4;
+    iValue = _mm_shuffle_ps(complex1, complex2, _MM_SHUFFLE(2,0,2,0));
+    qValue = _mm_shuffle_ps(complex1, complex2, _MM_SHUFFLE(3,1,3,1));
+    phase = volk_sse2_atan2_ps(qValue, iValue);
+    phase = _mm_mul_ps(phase, vNormalizeFactor);
+    _mm_storeu_ps((float*)outPtr, phase);
+    outPtr += 4;
+  }
+  number = quarterPoints * 4;
+
+  for (; number < num_points; number++) {
+    const float real = *complexVectorPtr++;
+    const float imag = *complexVectorPtr++;
+    *outPtr++ = atan2f(imag, real) * invNormalizeFactor;
+  }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#endif /* INCLUDED_volk_32fc_s32f_atan2_32f_u_H */
 #ifndef INCLUDED_volk_32fc_s32f_atan2_32f_a_H
 #define INCLUDED_volk_32fc_s32f_atan2_32f_a_H
 
@@ -10,6 +61,8 @@
 
 #ifdef LV_HAVE_LIB_SIMDMATH
 #include <simdmath.h>
+#else
+#include <volk/volk_sse2_math.h>
 #endif /* LV_HAVE_LIB_SIMDMATH */
 
 /*!
@@ -56,6 +109,26 @@ static inline void volk_32fc_s32f_atan2_32f_a_sse4_1(float* outputVector,  const
     outPtr += 4;
   }
   number = quarterPoints * 4;
+#else
+  const unsigned int quarterPoints = num_points / 4;
+  __m128 vNormalizeFactor = _mm_set_ps1(invNormalizeFactor);
+  __m128 phase;
+  __m128 complex1, complex2, iValue, qValue;
+
+  for (; number < quarterPoints; number++) {
+    complex1 = _mm_load_ps(complexVectorPtr);
+    complexVectorPtr += 4;
+    complex2 = _mm_load_ps(complexVectorPtr);
+    complexVectorPtr += 4;
+    iValue = _mm_shuffle_ps(complex1, complex2, _MM_SHUFFLE(2,0,2,0));
+    qValue = _mm_shuffle_ps(complex1, complex2, _MM_SHUFFLE(3,1,3,1));
+    // Polynomial atan2, < 4 ulp for finite inputs, atan2(+-0, -0) = +-pi
+    phase = volk_sse2_atan2_ps(qValue, iValue);
+    phase = _mm_mul_ps(phase, vNormalizeFactor);
+    _mm_store_ps((float*)outPtr, phase);
+    outPtr += 4;
+  }
+  number = quarterPoints * 4;
 #endif /* LV_HAVE_SIMDMATH_H */
 
   for (; number < num_points; number++) {
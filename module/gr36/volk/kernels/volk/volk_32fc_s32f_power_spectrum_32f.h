@@ -10,6 +10,8 @@
 
 #ifdef LV_HAVE_LIB_SIMDMATH
 #include <simdmath.h>
+#else
+#include <volk/volk_sse2_math.h>
 #endif /* LV_HAVE_LIB_SIMDMATH */
 
 /*!
@@ -27,6 +29,12 @@ static inline void volk_32fc_s32f_power_spectrum_32f_a_sse3(float* logPowerOutpu
 #ifdef LV_HAVE_LIB_SIMDMATH
   __m128 magScalar = _mm_set_ps1(10.0);
   magScalar = _mm_div_ps(magScalar, logf4(magScalar));
+#else
+  // 10 / ln(10)
+  __m128 magScalar = _mm_set_ps1(4.34294481903251828);
+#endif /* LV_HAVE_LIB_SIMDMATH */
+  // Keeps empty bins at -200 dB like the scalar tail
+  __m128 tinyPower = _mm_set_ps1(1e-20);
 
   __m128 invNormalizationFactor = _mm_set_ps1(iNormalizationFactor);
 
@@ -54,8 +62,14 @@ static inline void volk_32fc_s32f_power_spectrum_32f_a_sse3(float* logPowerOutpu
     // (r1*r1)+(i1*i1), (r2*r2) + (i2*i2), (r3*r3)+(i3*i3), (r4*r4)+(i4*i4)
     power = _mm_hadd_ps(input1, input2);
 
+    power = _mm_add_ps(power, tinyPower);
+
     // Calculate the natural log power
+#ifdef LV_HAVE_LIB_SIMDMATH
     power = logf4(power);
+#else
+    power = volk_sse2_log_ps(power);
+#endif /* LV_HAVE_LIB_SIMDMATH */
 
     // Convert to log10 and multiply by 10.0
     power = _mm_mul_ps(power, magScalar);
@@ -67,7 +81,6 @@ static inline void volk_32fc_s32f_power_spectrum_32f_a_sse3(float* logPowerOutpu
   }
 
   number = quarterPoints*4;
-#endif /* LV_HAVE_LIB_SIMDMATH */
   // Calculate the FFT for any remaining points
 
   for(; number < num_points; number++){
@@ -0,0 +1,305 @@
+#ifndef INCLUDED_volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_u_H
+#define INCLUDED_volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_u_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+#include <volk/volk_complex.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the angle of aVector times the conjugate of bVector, multiplied by gain
+  \param cVector The vector where gain * arg(a * conj(b)) will be stored
+  \param aVector The vector of complex values
+  \param bVector The vector of complex values that is conjugated
+  \param gain The angle in radians is multiplied by this value
+  \param num_points The number of complex values in aVector and bVector to be processed and stored into cVector
+
+  With bVector pointing one sample behind aVector this is the quadrature
+  FM discriminator. Maximum error is 4 ulp of the angle for finite inputs.
+  A zero product, such as against zero history, gives an angle of 0.
+*/
+static inline void volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_u_sse2(float* cVector, const lv_32fc_t* aVector, const lv_32fc_t* bVector, const float gain, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* cPtr = cVector;
+    const float* aPtr = (const float*)aVector;
+    const float* bPtr = (const float*)bVector;
+
+    const __m128 vGain = _mm_set1_ps(gain);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 a1, a2, b1, b2, ar, ai, br, bi, re, im;
+    for(;number < quarterPoints; number++){
+
+      a1 = _mm_loadu_ps(aPtr);
+      a2 = _mm_loadu_ps(aPtr + 4);
+      b1 = _mm_loadu_ps(bPtr);
+      b2 = _mm_loadu_ps(bPtr + 4);
+
+      // Deinterleave
+      ar = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(2,0,2,0));
+      ai = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(3,1,3,1));
+      br = _mm_shuffle_ps(b1, b2, _MM_SHUFFLE(2,0,2,0));
+      bi = _mm_shuffle_ps(b1, b2, _MM_SHUFFLE(3,1,3,1));
+
+      // a * conj(b); adding +0 turns a real part of -0 into +0
+      re = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi)), zero);
+      im = _mm_sub_ps(_mm_mul_ps(ai, br), _mm_mul_ps(ar, bi));
+
+      _mm_storeu_ps(cPtr, _mm_mul_ps(volk_sse2_atan2_ps(im, re), vGain));
+
+      aPtr += 8;
+      bPtr += 8;
+      cPtr += 4;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      const float re = aPtr[0]*bPtr[0] + aPtr[1]*bPtr[1] + 0.0f;
+      const float im = aPtr[1]*bPtr[0] - aPtr[0]*bPtr[1];
+      *cPtr++ = gain * atan2f(im, re);
+      aPtr += 2;
+      bPtr += 2;
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#ifdef LV_HAVE_AVX
+#include <immintrin.h>
+#include <volk/volk_avx_math.h>
+/*!
+  \brief Computes the angle of aVector times the conjugate of bVector, multiplied by gain
+  \param cVector The vector where gain * arg(a * conj(b)) will be stored
+  \param aVector The vector of complex values
+  \param bVector The vector of complex values that is conjugated
+  \param gain The angle in radians is multiplied by this value
+  \param num_points The number of complex values in aVector and bVector to be processed and stored into cVector
+
+  With bVector pointing one sample behind aVector this is the quadrature
+  FM discriminator. Maximum error is 4 ulp of the angle for finite inputs.
+  A zero product, such as against zero history, gives an angle of 0.
+*/
+static inline void volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_u_avx(float* cVector, const lv_32fc_t* aVector, const lv_32fc_t* bVector, const float gain, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int eighthPoints = num_points / 8;
+
+    float* cPtr = cVector;
+    const float* aPtr = (const float*)aVector;
+    const float* bPtr = (const float*)bVector;
+
+    const __m256 vGain = _mm256_set1_ps(gain);
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 a1, a2, b1, b2, ar, ai, br, bi, re, im, lo, hi, out;
+    for(;number < eighthPoints; number++){
+
+      a1 = _mm256_loadu_ps(aPtr);
+      a2 = _mm256_loadu_ps(aPtr + 8);
+      b1 = _mm256_loadu_ps(bPtr);
+      b2 = _mm256_loadu_ps(bPtr + 8);
+
+      // Deinterleave within each 128 bit lane, giving points 0 1 4 5 | 2 3 6 7
+      ar = _mm256_shuffle_ps(a1, a2, _MM_SHUFFLE(2,0,2,0));
+      ai = _mm256_shuffle_ps(a1, a2, _MM_SHUFFLE(3,1,3,1));
+      br = _mm256_shuffle_ps(b1, b2, _MM_SHUFFLE(2,0,2,0));
+      bi = _mm256_shuffle_ps(b1, b2, _MM_SHUFFLE(3,1,3,1));
+
+      // a * conj(b); adding +0 turns a real part of -0 into +0
+      re = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ar, br), _mm256_mul_ps(ai, bi)), zero);
+      im = _mm256_sub_ps(_mm256_mul_ps(ai, br), _mm256_mul_ps(ar, bi));
+
+      out = _mm256_mul_ps(volk_avx_atan2_ps(im, re), vGain);
+
+      // Put the pairs of points back in order
+      lo = _mm256_permute2f128_ps(out, out, 0x00);
+      hi = _mm256_permute2f128_ps(out, out, 0x11);
+      out = _mm256_castpd_ps(_mm256_shuffle_pd(_mm256_castps_pd(lo), _mm256_castps_pd(hi), 0xc));
+
+      _mm256_storeu_ps(cPtr, out);
+
+      aPtr += 16;
+      bPtr += 16;
+      cPtr += 8;
+    }
+
+    number = eighthPoints * 8;
+    for(;number < num_points; number++){
+      const float re = aPtr[0]*bPtr[0] + aPtr[1]*bPtr[1] + 0.0f;
+      const float im = aPtr[1]*bPtr[0] - aPtr[0]*bPtr[1];
+      *cPtr++ = gain * atan2f(im, re);
+      aPtr += 2;
+      bPtr += 2;
+    }
+}
+#endif /* LV_HAVE_AVX */
+
+#ifdef LV_HAVE_GENERIC
+/*!
+  \brief Computes the angle of aVector times the conjugate of bVector, multiplied by gain
+  \param cVector The vector where gain * arg(a * conj(b)) will be stored
+  \param aVector The vector of complex values
+  \param bVector The vector of complex values that is conjugated
+  \param gain The angle in radians is multiplied by this value
+  \param num_points The number of complex values in aVector and bVector to be processed and stored into cVector
+
+  With bVector pointing one sample behind aVector this is the quadrature
+  FM discriminator. Maximum error is 4 ulp of the angle for finite inputs.
+  A zero product, such as against zero history, gives an angle of 0.
+*/
+static inline void volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_generic(float* cVector, const lv_32fc_t* aVector, const lv_32fc_t* bVector, const float gain, unsigned int num_points){
+    float* cPtr = cVector;
+    const float* aPtr = (const float*)aVector;
+    const float* bPtr = (const float*)bVector;
+    unsigned int number = 0;
+
+    for(;number < num_points; number++){
+      const float re = aPtr[0]*bPtr[0] + aPtr[1]*bPtr[1] + 0.0f;
+      const float im = aPtr[1]*bPtr[0] - aPtr[0]*bPtr[1];
+      *cPtr++ = gain * atan2f(im, re);
+      aPtr += 2;
+      bPtr += 2;
+    }
+}
+#endif /* LV_HAVE_GENERIC */
+
+#endif /* INCLUDED_volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_u_H */
+#ifndef INCLUDED_volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_a_H
+#define INCLUDED_volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_a_H
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <math.h>
+#include <volk/volk_complex.h>
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+#include <volk/volk_sse2_math.h>
+/*!
+  \brief Computes the angle of aVector times the conjugate of bVector, multiplied by gain
+  \param cVector The byte-aligned vector where gain * arg(a * conj(b)) will be stored
+  \param aVector The byte-aligned vector of complex values
+  \param bVector The byte-aligned vector of complex values that is conjugated
+  \param gain The angle in radians is multiplied by this value
+  \param num_points The number of complex values in aVector and bVector to be processed and stored into cVector
+
+  With bVector pointing one sample behind aVector this is the quadrature
+  FM discriminator. Maximum error is 4 ulp of the angle for finite inputs.
+  A zero product, such as against zero history, gives an angle of 0.
+*/
+static inline void volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_a_sse2(float* cVector, const lv_32fc_t* aVector, const lv_32fc_t* bVector, const float gain, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int quarterPoints = num_points / 4;
+
+    float* cPtr = cVector;
+    const float* aPtr = (const float*)aVector;
+    const float* bPtr = (const float*)bVector;
+
+    const __m128 vGain = _mm_set1_ps(gain);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 a1, a2, b1, b2, ar, ai, br, bi, re, im;
+    for(;number < quarterPoints; number++){
+
+      a1 = _mm_load_ps(aPtr);
+      a2 = _mm_load_ps(aPtr + 4);
+      b1 = _mm_load_ps(bPtr);
+      b2 = _mm_load_ps(bPtr + 4);
+
+      // Deinterleave
+      ar = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(2,0,2,0));
+      ai = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(3,1,3,1));
+      br = _mm_shuffle_ps(b1, b2, _MM_SHUFFLE(2,0,2,0));
+      bi = _mm_shuffle_ps(b1, b2, _MM_SHUFFLE(3,1,3,1));
+
+      // a * conj(b); adding +0 turns a real part of -0 into +0
+      re = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi)), zero);
+      im = _mm_sub_ps(_mm_mul_ps(ai, br), _mm_mul_ps(ar, bi));
+
+      _mm_store_ps(cPtr, _mm_mul_ps(volk_sse2_atan2_ps(im, re), vGain));
+
+      aPtr += 8;
+      bPtr += 8;
+      cPtr += 4;
+    }
+
+    number = quarterPoints * 4;
+    for(;number < num_points; number++){
+      const float re = aPtr[0]*bPtr[0] + aPtr[1]*bPtr[1] + 0.0f;
+      const float im = aPtr[1]*bPtr[0] - aPtr[0]*bPtr[1];
+      *cPtr++ = gain * atan2f(im, re);
+      aPtr += 2;
+      bPtr += 2;
+    }
+}
+#endif /* LV_HAVE_SSE2 */
+
+#ifdef LV_HAVE_AVX
+#include <immintrin.h>
+#include <volk/volk_avx_math.h>
+/*!
+  \brief Computes the angle of aVector times the conjugate of bVector, multiplied by gain
+  \param cVector The 32 byte aligned vector where gain * arg(a * conj(b)) will be stored
+  \param aVector The 32 byte aligned vector of complex values
+  \param bVector The 32 byte aligned vector of complex values that is conjugated
+  \param gain The angle in radians is multiplied by this value
+  \param num_points The number of complex values in aVector and bVector to be processed and stored into cVector
+
+  With bVector pointing one sample behind aVector this is the quadrature
+  FM discriminator. Maximum error is 4 ulp of the angle for finite inputs.
+  A zero product, such as against zero history, gives an angle of 0.
+*/
+static inline void volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_a_avx(float* cVector, const lv_32fc_t* aVector, const lv_32fc_t* bVector, const float gain, unsigned int num_points){
+    unsigned int number = 0;
+    const unsigned int eighthPoints = num_points / 8;
+
+    float* cPtr = cVector;
+    const float* aPtr = (const float*)aVector;
+    const float* bPtr = (const float*)bVector;
+
+    const __m256 vGain = _mm256_set1_ps(gain);
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 a1, a2, b1, b2, ar, ai, br, bi, re, im, lo, hi, out;
+    for(;number < eighthPoints; number++){
+
+      a1 = _mm256_load_ps(aPtr);
+      a2 = _mm256_load_ps(aPtr + 8);
+      b1 = _mm256_load_ps(bPtr);
+      b2 = _mm256_load_ps(bPtr + 8);
+
+      // Deinterleave within each 128 bit lane, giving points 0 1 4 5 | 2 3 6 7
+      ar = _mm256_shuffle_ps(a1, a2, _MM_SHUFFLE(2,0,2,0));
+      ai = _mm256_shuffle_ps(a1, a2, _MM_SHUFFLE(3,1,3,1));
+      br = _mm256_shuffle_ps(b1, b2, _MM_SHUFFLE(2,0,2,0));
+      bi = _mm256_shuffle_ps(b1, b2, _MM_SHUFFLE(3,1,3,1));
+
+      // a * conj(b); adding +0 turns a real part of -0 into +0
+      re = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ar, br), _mm256_mul_ps(ai, bi)), zero);
+      im = _mm256_sub_ps(_mm256_mul_ps(ai, br), _mm256_mul_ps(ar, bi));
+
+      out = _mm256_mul_ps(volk_avx_atan2_ps(im, re), vGain);
+
+      // Put the pairs of points back in order
+      lo = _mm256_permute2f128_ps(out, out, 0x00);
+      hi = _mm256_permute2f128_ps(out, out, 0x11);
+      out = _mm256_castpd_ps(_mm256_shuffle_pd(_mm256_castps_pd(lo), _mm256_castps_pd(hi), 0xc));
+
+      _mm256_store_ps(cPtr, out);
+
+      aPtr += 16;
+      bPtr += 16;
+      cPtr += 8;
+    }
+
+    number = eighthPoints * 8;
+    for(;number < num_points; number++){
+      const float re = aPtr[0]*bPtr[0] + aPtr[1]*bPtr[1] + 0.0f;
+      const float im = aPtr[1]*bPtr[0] - aPtr[0]*bPtr[1];
+      *cPtr++ = gain * atan2f(im, re);
+      aPtr += 2;
+      bPtr += 2;
+    }
+}
+#endif /* LV_HAVE_AVX */
+
+#endif /* INCLUDED_volk_32fc_x2_s32f_multiply_conjugate_atan2_32f_a_H */
@@ -46,6 +46,7 @@ VOLK_RUN_TESTS(volk_32f_s32f_convert_8i, 1, 128, 20460, 1);
 VOLK_RUN_TESTS(volk_32fc_s32f_power_spectrum_32f, 1e-4, 0, 2046, 1);
 VOLK_RUN_TESTS(volk_32fc_x2_square_dist_32f, 1e-4, 0, 20460, 1);
 VOLK_RUN_TESTS(volk_32fc_x2_s32f_square_dist_scalar_mult_32f, 1e-4, 10, 20460, 1);
+VOLK_RUN_TESTS(volk_32fc_x2_s32f_multiply_conjugate_atan2_32f, 1e-4, 1.0, 20460, 1);
 VOLK_RUN_TESTS(volk_32f_x2_divide_32f, 1e-4, 0, 20460, 1);
 VOLK_RUN_TESTS(volk_32f_x2_dot_prod_32f, 1e-4, 0, 204600, 1);
 VOLK_RUN_TESTS(volk_32f_x2_dot_prod_16i, 1e-4, 0, 204600, 1);
@@ -58,6 +59,16 @@ VOLK_RUN_TESTS(volk_32f_x2_min_32f, 1e-4, 0, 20460, 1);
 VOLK_RUN_TESTS(volk_32f_s32f_normalize, 1e-4, 100, 20460, 1);
 VOLK_RUN_TESTS(volk_32f_s32f_power_32f, 1e-4, 4, 20460, 1);
 VOLK_RUN_TESTS(volk_32f_sqrt_32f, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32f_sin_32f, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32f_cos_32f, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32f_sincos_32f_x2, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32f_exp_32f, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32f_log_32f, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32f_log10_32f, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32f_atan_32f, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32f_x2_atan2_32f, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32fc_exp_32fc, 1e-4, 0, 20460, 1);
+VOLK_RUN_TESTS(volk_32fc_log_32fc, 1e-4, 0, 20460, 1);
 VOLK_RUN_TESTS(volk_32f_s32f_stddev_32f, 1e-4, 100, 20460, 1);
 VOLK_RUN_TESTS(volk_32f_stddev_and_mean_32f_x2, 1e-4, 0, 20460, 1);
 VOLK_RUN_TESTS(volk_32f_x2_subtract_32f, 1e-4, 0, 20460, 1);
@@ -54,4 +54,9 @@ def py_jit_factory(*args):
     try_load_dll("gras")
     try_load_dll("pmc")
     jit_factory(*args)
+
+def py_jit_factory_parallel(*args):
+    try_load_dll("gras")
+    try_load_dll("pmc")
+    jit_factory_parallel(*args)
 %}
@@ -82,6 +82,12 @@ struct TopBlockPython : TopBlock
         this->reset();
     }
 
+    void commit(void)
+    {
+        PyTSPhondler phil;
+        TopBlock::commit();
+    }
+
     void start(void)
     {
         PyTSPhondler phil;
@@ -68,6 +68,22 @@ GrasChartPortCounts.prototype.update = function(point)
         });
     });
 
+    //achieved vs target rate when the block is rate limited
+    if (block_data.rate_target > 0)
+    {
+        var rate_duration = (block_data.stats_time - block_data.rate_start_time)/block_data.tps;
+        var rate = (rate_duration > 0)? block_data.rate_items/rate_duration : 0;
+        var rate_error = 100*(rate - block_data.rate_target)/block_data.rate_target;
+        make_entry('Rate', rate.toFixed(1).toString() + ' items/sec (' + rate_error.toFixed(2).toString() + '%)');
+        make_entry('Rate waits', block_data.rate_wait_count.toString());
+    }
+
+    //helper threads held from the thread budget, caller included
+    if (block_data.threads_granted > 1)
+    {
+        make_entry('Threads', block_data.threads_granted.toString());
+    }
+
     var actor_depth = block_data.actor_queue_depth;
     if (actor_depth > 10) //only show if its large
     {
@@ -2,6 +2,7 @@
 
 import unittest
 import gras
+import time
 import numpy
 from gras import TestUtils
 
@@ -85,5 +86,36 @@ class BlockTest(unittest.TestCase):
         self.tb.connect(source, sink)
         self.tb.run()
 
+    def test_rate_limit(self):
+        src_data = range(1000)
+        source = TestUtils.VectorSource(numpy.uint32, src_data)
+        sink = TestUtils.VectorSink(numpy.uint32)
+        sink.global_config().maximum_items_per_sec = 10e3
+
+        self.tb.connect(source, sink)
+        t0 = time.time()
+        self.tb.run()
+        t1 = time.time()
+
+        #the sink is held back by the scheduler, not by sleeping in work
+        self.assertEqual(sink.data(), tuple(src_data))
+        self.assertGreater(t1 - t0, 0.09)
+
+    def test_wait_returns_when_done(self):
+        source = TestUtils.VectorSource(numpy.uint32, [0, 9, 8, 7, 6])
+        sink = TestUtils.VectorSink(numpy.uint32)
+
+        self.tb.connect(source, sink)
+        self.tb.start()
+        t0 = time.time()
+        done = self.tb.wait(10.0)
+        t1 = time.time()
+        self.tb.stop()
+
+        #woken up by the blocks, not by the timeout
+        self.assertTrue(done)
+        self.assertLess(t1 - t0, 1.0)
+        self.assertEqual(sink.data(), (0, 9, 8, 7, 6))
+
 if __name__ == '__main__':
     unittest.main()
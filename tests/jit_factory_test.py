@@ -4,6 +4,8 @@ import unittest
 import gras
 import numpy
 import time
+import sys
+import subprocess
 from gras import TestUtils
 
 #figure out the local include directories
@@ -171,5 +173,63 @@ GRAS_REGISTER_FACTORY0("/tests/my_foo_bar", FooBar)
 """
         gras.jit_factory(SOURCE, ["-O3", "-I"+gras_inc, "-I"+pmc_inc])
 
+    def test_jit_parallel_and_cache(self):
+        SOURCE = """
+#include <gras/block.hpp>
+#include <gras/factory.hpp>
+
+struct Nop%d : gras::Block
+{
+    Nop%d(void): gras::Block("Nop%d"){}
+    void work(const InputItems &, const OutputItems &){}
+};
+
+GRAS_REGISTER_FACTORY0("/tests/my_nop%d", Nop%d)
+"""
+        sources = [SOURCE.replace('%d', str(i)) for i in range(3)]
+        gras.jit_factory_parallel(sources, ["-O3", "-I"+gras_inc, "-I"+pmc_inc])
+        for i in range(3): gras.make("/tests/my_nop%d"%i)
+
+        #the same sources again are not reloaded into this process
+        before = self.tb.query(dict(path="/jit.json"))
+        gras.jit_factory_parallel(sources, ["-O3", "-I"+gras_inc, "-I"+pmc_inc])
+        after = self.tb.query(dict(path="/jit.json"))
+        self.assertEqual(after['memory_hit_count'] - before['memory_hit_count'], 3)
+        self.assertEqual(after['compile_count'], before['compile_count'])
+
+    def test_jit_corrupt_cache(self):
+        cache_dir = os.environ.get('GRAS_JIT_CACHE', os.path.join(os.path.expanduser('~'), '.gras', 'jit_cache'))
+        if not cache_dir: return #cache disabled
+
+        SOURCE = """
+#include <gras/block.hpp>
+#include <gras/factory.hpp>
+
+struct CorruptNop : gras::Block
+{
+    CorruptNop(void): gras::Block("CorruptNop"){}
+    void work(const InputItems &, const OutputItems &){}
+};
+
+GRAS_REGISTER_FACTORY0("/tests/my_corrupt_nop", CorruptNop)
+"""
+        #a unique define gives this run its own cache entry
+        flags = ["-O3", "-I"+gras_inc, "-I"+pmc_inc, "-DGRAS_TEST_TAG=%d"%int(time.time()*1e6)]
+
+        #compile in another process so this one has not loaded the source
+        before = set(os.listdir(cache_dir)) if os.path.isdir(cache_dir) else set()
+        subprocess.check_call([sys.executable, '-c',
+            'import gras, sys; gras.jit_factory(sys.argv[1], sys.argv[2:])', SOURCE] + flags)
+        new_files = [f for f in os.listdir(cache_dir) if f not in before and f.endswith('.bc')]
+        self.assertEqual(len(new_files), 1)
+        open(os.path.join(cache_dir, new_files[0]), 'wb').write('not bitcode')
+
+        #the corrupt entry is compiled again instead of failing the load
+        before = self.tb.query(dict(path="/jit.json"))
+        gras.jit_factory(SOURCE, flags)
+        gras.make("/tests/my_corrupt_nop")
+        after = self.tb.query(dict(path="/jit.json"))
+        self.assertEqual(after['compile_count'] - before['compile_count'], 1)
+
 if __name__ == '__main__':
     unittest.main()
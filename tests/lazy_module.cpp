@@ -0,0 +1,25 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <gras/block.hpp>
+#include <gras/factory.hpp>
+
+//this module lives in an indexed directory,
+//so it is only loaded when its factory path is made
+struct MyLazyBlock : gras::Block
+{
+    MyLazyBlock(void):
+        gras::Block("MyLazyBlock")
+    {
+        this->register_call("get_num", &MyLazyBlock::get_num);
+    }
+
+    int get_num(void)
+    {
+        return 7;
+    }
+
+    //dummy work
+    void work(const InputItems &, const OutputItems &){}
+};
+
+GRAS_REGISTER_FACTORY0("/tests/my_lazy_block", MyLazyBlock)
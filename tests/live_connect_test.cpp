@@ -8,6 +8,7 @@
 #include <gras/top_block.hpp>
 
 #include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 
 struct MySource : gras::Block
 {
@@ -84,3 +85,86 @@ BOOST_AUTO_TEST_CASE(test_live_connect)
     tb.stop();
     tb.wait();
 }
+
+struct MyCountingSink : MySink
+{
+    MyCountingSink(void):
+        num_allocs(0)
+    {
+        //NOP
+    }
+
+    gras::BufferQueueSptr input_buffer_allocator(const size_t which, const gras::SBufferConfig &config)
+    {
+        num_allocs++;
+        return MySink::input_buffer_allocator(which, config);
+    }
+
+    size_t num_allocs;
+};
+
+BOOST_AUTO_TEST_CASE(test_live_connect_unrelated)
+{
+    MySource my_source;
+    MySink my_sink;
+    MySource other_source;
+    MyCountingSink other_sink;
+    gras::TopBlock tb("Top");
+
+    tb.connect(my_source, 0, my_sink, 0);
+    tb.connect(other_source, 0, other_sink, 0);
+    tb.start();
+    sleep_rand();
+    BOOST_CHECK_EQUAL(other_sink.num_allocs, size_t(1));
+
+    //live changes to one chain must not re-plumb the other
+    for (size_t i = 0; i < 20; i++)
+    {
+        MySink my_sink_tmp;
+        tb.connect(my_source, 0, my_sink_tmp, 0);
+        tb.commit();
+        sleep_rand();
+        tb.disconnect(my_source, 0, my_sink_tmp, 0);
+        tb.commit();
+        BOOST_CHECK(my_sink_tmp.get_consumed(0) > 0);
+    }
+
+    const gras::item_index_t consumed = other_sink.get_consumed(0);
+    sleep_rand();
+    BOOST_CHECK(other_sink.get_consumed(0) > consumed);
+    BOOST_CHECK_EQUAL(other_sink.num_allocs, size_t(1));
+
+    tb.stop();
+    tb.wait();
+}
+
+static void wait_top_block(gras::TopBlock *tb)
+{
+    tb->wait();
+}
+
+BOOST_AUTO_TEST_CASE(test_live_connect_wait_removed)
+{
+    MySource my_source;
+    MySink my_sink;
+    gras::TopBlock tb("Top");
+
+    tb.connect(my_source, 0, my_sink, 0);
+    tb.start();
+
+    //a block removed by commit outlives the flow graph
+    MySink *my_sink_tmp = new MySink();
+    tb.connect(my_source, 0, *my_sink_tmp, 0);
+    tb.commit();
+    sleep_rand();
+    tb.disconnect(my_source, 0, *my_sink_tmp, 0);
+    tb.commit();
+
+    //wait() is already sleeping when the removed block goes away
+    tb.stop();
+    boost::thread waiter(boost::bind(&wait_top_block, &tb));
+    sleep_rand();
+    delete my_sink_tmp;
+    BOOST_CHECK(waiter.timed_join(boost::posix_time::seconds(5)));
+    if (waiter.joinable()) waiter.detach();
+}
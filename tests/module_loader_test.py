@@ -2,6 +2,7 @@
 
 import unittest
 import gras
+import os
 
 class ModuleLoaderTest(unittest.TestCase):
 
@@ -13,5 +14,23 @@ class ModuleLoaderTest(unittest.TestCase):
         my_block = gras.make("/tests/my_block1")
         self.assertEqual(my_block.get_num(), 42)
 
+    def test_module_loader_stats(self):
+        tb = gras.TopBlock()
+        stats = tb.query(dict(path="/modules.json"))
+        self.assertTrue(stats['eager_load_count'] >= 1)
+        self.assertTrue(stats['startup_time'] >= 0)
+
+    @unittest.skipIf(os.name == 'nt', "lazy module directory is only on the unix module path")
+    def test_load_module_lazy(self):
+        tb = gras.TopBlock()
+        before = tb.query(dict(path="/modules.json"))
+        self.assertTrue(before['indexed_path_count'] >= 1)
+
+        #the indexed library is loaded by the first make of its path
+        my_block = gras.make("/tests/my_lazy_block")
+        self.assertEqual(my_block.get_num(), 7)
+        after = tb.query(dict(path="/modules.json"))
+        self.assertEqual(after['lazy_load_count'], before['lazy_load_count']+1)
+
 if __name__ == '__main__':
     unittest.main()
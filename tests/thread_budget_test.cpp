@@ -0,0 +1,104 @@
+// Copyright (C) by Josh Blum. See LICENSE.txt for licensing information.
+
+#include <boost/test/unit_test.hpp>
+#include <iostream>
+
+#include <gras/thread_budget.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_thread_budget_grants)
+{
+    gras::ThreadBudget::set_capacity(3);
+    BOOST_CHECK_EQUAL(gras::ThreadBudget::capacity(), size_t(3));
+    BOOST_CHECK_EQUAL(gras::ThreadBudget::available(), size_t(3));
+
+    {
+        gras::ThreadGrant g0("block0", 3);
+        BOOST_CHECK_EQUAL(g0.size(), size_t(3));
+        BOOST_CHECK_EQUAL(gras::ThreadBudget::available(), size_t(1));
+
+        //the second block only gets what is left
+        gras::ThreadGrant g1("block1", 4);
+        BOOST_CHECK_EQUAL(g1.size(), size_t(2));
+        BOOST_CHECK_EQUAL(gras::ThreadBudget::available(), size_t(0));
+
+        //and a third runs on its own thread
+        gras::ThreadGrant g2("block2", 4);
+        BOOST_CHECK_EQUAL(g2.size(), size_t(1));
+
+        BOOST_CHECK_EQUAL(gras::ThreadBudget::granted("block0"), size_t(3));
+        BOOST_CHECK_EQUAL(gras::ThreadBudget::granted("block1"), size_t(2));
+        BOOST_CHECK_EQUAL(gras::ThreadBudget::granted("block2"), size_t(1));
+
+        //copies share the grant
+        gras::ThreadGrant copy = g0;
+        g0 = gras::ThreadGrant();
+        BOOST_CHECK_EQUAL(g0.size(), size_t(1));
+        BOOST_CHECK_EQUAL(copy.size(), size_t(3));
+        BOOST_CHECK_EQUAL(gras::ThreadBudget::available(), size_t(0));
+    }
+
+    BOOST_CHECK_EQUAL(gras::ThreadBudget::available(), size_t(3));
+    BOOST_CHECK_EQUAL(gras::ThreadBudget::granted("block0"), size_t(0));
+    BOOST_CHECK_EQUAL(gras::ThreadBudget::granted("block1"), size_t(0));
+}
+
+struct LoopRecorder
+{
+    LoopRecorder(const size_t n):
+        hits(n, 0), active(0), max_active(0)
+    {
+        //pass
+    }
+
+    void operator()(const size_t i)
+    {
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            max_active = std::max(max_active, ++active);
+        }
+        boost::this_thread::sleep(boost::posix_time::milliseconds(2));
+        boost::mutex::scoped_lock lock(mutex);
+        hits[i]++;
+        active--;
+    }
+
+    boost::mutex mutex;
+    std::vector<size_t> hits;
+    size_t active;
+    size_t max_active;
+};
+
+BOOST_AUTO_TEST_CASE(test_thread_budget_parallel_for)
+{
+    gras::ThreadBudget::set_capacity(3);
+    gras::ThreadGrant grant("loop", 3);
+    BOOST_CHECK_EQUAL(grant.size(), size_t(3));
+
+    for (size_t n = 0; n < 40; n += 7)
+    {
+        LoopRecorder rec(n);
+        grant.parallel_for(n, boost::ref(rec));
+        for (size_t i = 0; i < n; i++) BOOST_CHECK_EQUAL(rec.hits[i], size_t(1));
+        BOOST_CHECK(rec.max_active <= grant.size());
+        std::cout << "n " << n << " max_active " << rec.max_active << std::endl;
+    }
+
+    //an empty grant runs everything on the caller
+    LoopRecorder rec(10);
+    gras::ThreadGrant().parallel_for(10, boost::ref(rec));
+    BOOST_CHECK_EQUAL(rec.max_active, size_t(1));
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_budget_no_helpers)
+{
+    //the loop completes on the caller even when no helper threads exist
+    gras::ThreadBudget::set_capacity(0);
+    LoopRecorder rec(5);
+    gras::ThreadBudget::parallel_for(5, boost::ref(rec));
+    for (size_t i = 0; i < 5; i++) BOOST_CHECK_EQUAL(rec.hits[i], size_t(1));
+}
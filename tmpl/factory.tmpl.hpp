@@ -24,11 +24,24 @@ namespace gras
  * Users may leave this empty unless headers
  * are installed into non-standard directories.
  *
+ * Compiled bitcode is cached on disk and reused across processes.
+ * The cache key is a hash of the source, the flags, and the clang version.
+ * The cache lives in GRAS_JIT_CACHE, or ~/.gras/jit_cache by default;
+ * set GRAS_JIT_CACHE to an empty string to disable the cache.
+ *
  * \param source C++ source code in a string
  * \param flags optional compiler flags
  */
 GRAS_API void jit_factory(const std::string &source, const std::vector<std::string> &flags);
 
+/*!
+ * Compile multiple independent C++ sources and load them into the element factory.
+ * Cache misses are compiled concurrently, one clang process per source.
+ * \param sources a list of C++ source code strings
+ * \param flags optional compiler flags used for every source
+ */
+GRAS_API void jit_factory_parallel(const std::vector<std::string> &sources, const std::vector<std::string> &flags);
+
 /***********************************************************************
  * Register API - don't look here, template magic, not helpful
  * Example register a factory function: